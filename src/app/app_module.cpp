@@ -27,6 +27,7 @@
 #include <QtCore/QtDebug>
 
 #include <fmt/format.h>
+#include <algorithm>
 #include <iterator>
 
 namespace Mayo {
@@ -408,6 +409,29 @@ void AppModule::computeBRepMesh(const TDF_Label& labelEntity, TaskProgress* prog
         this->computeBRepMesh(XCaf::shape(labelEntity), progress);
 }
 
+bool AppModule::isBRepMeshLevelOfDetailEnabled() const
+{
+    return BRepMeshLod::isSupported() && m_props.meshingLevelOfDetail.value();
+}
+
+OccBRepMeshParameters AppModule::brepMeshCoarseParameters(const TopoDS_Shape& shape) const
+{
+    OccBRepMeshParameters params = this->brepMeshParameters(shape);
+    params.Deflection *= 8;
+    params.Angle = std::min(2 * params.Angle, UnitSystem::radians(60 * Quantity_Degree).value);
+    return params;
+}
+
+void AppModule::computeBRepMeshCoarse(const TopoDS_Shape& shape, TaskProgress* progress)
+{
+    BRepUtils::computeMesh(shape, this->brepMeshCoarseParameters(shape), progress);
+}
+
+BRepMeshLod::Level AppModule::computeBRepMeshFineLevel(const TopoDS_Shape& shape, TaskProgress* progress) const
+{
+    return BRepMeshLod::computeLevel(shape, this->brepMeshParameters(shape), progress);
+}
+
 void AppModule::addPropertiesProvider(std::unique_ptr<DocumentTreeNodePropertiesProvider> ptr)
 {
     m_vecDocTreeNodePropsProvider.push_back(std::move(ptr));
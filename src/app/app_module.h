@@ -10,6 +10,7 @@
 #include "qstring_utils.h"
 
 #include "../base/application.h"
+#include "../base/brep_mesh_lod.h"
 #include "../base/document_tree_node_properties_provider.h"
 #include "../base/io_parameters_provider.h"
 #include "../base/io_system.h"
@@ -99,6 +100,14 @@ public:
     void computeBRepMesh(const TopoDS_Shape& shape, TaskProgress* progress = nullptr);
     void computeBRepMesh(const TDF_Label& labelEntity, TaskProgress* progress = nullptr);
 
+    // Level of detail of BRep meshes displayed in 3D views
+    // When enabled, a coarse mesh is first computed(fast display) and the regular mesh is computed
+    // afterwards as a finer level of detail with computeBRepMeshFineLevel()
+    bool isBRepMeshLevelOfDetailEnabled() const;
+    OccBRepMeshParameters brepMeshCoarseParameters(const TopoDS_Shape& shape) const;
+    void computeBRepMeshCoarse(const TopoDS_Shape& shape, TaskProgress* progress = nullptr);
+    BRepMeshLod::Level computeBRepMeshFineLevel(const TopoDS_Shape& shape, TaskProgress* progress = nullptr) const;
+
     // Providers to query document tree node properties
     void addPropertiesProvider(std::unique_ptr<DocumentTreeNodePropertiesProvider> ptr);
     std::unique_ptr<PropertyGroupSignals> properties(const DocumentTreeNode& treeNode) const;
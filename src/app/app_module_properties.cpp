@@ -7,6 +7,8 @@
 #include "app_module_properties.h"
 #include "app_module.h"
 
+#include "../base/brep_deferred_mesh.h"
+#include "../base/brep_mesh_lod.h"
 #include "../base/io_reader.h"
 #include "../base/io_writer.h"
 #include "../base/io_system.h"
@@ -62,12 +64,22 @@ AppModuleProperties::AppModuleProperties(Settings* settings)
     settings->addSetting(&this->meshingChordalDeflection, groupId_meshing);
     settings->addSetting(&this->meshingAngularDeflection, groupId_meshing);
     settings->addSetting(&this->meshingRelative, groupId_meshing);
+    settings->addSetting(&this->meshingLevelOfDetail, groupId_meshing);
+    settings->addSetting(&this->meshingLodScreenSpaceError, groupId_meshing);
+    this->meshingLodScreenSpaceError.setRange(0.1, 100.);
+    this->meshingLodScreenSpaceError.setSingleStep(0.5);
+    this->meshingLodScreenSpaceError.setConstraintsEnabled(true);
+    this->meshingLevelOfDetail.setEnabled(BRepMeshLod::isSupported());
+    settings->addSetting(&this->meshingDeferredDataMemoryLimit, groupId_meshing);
+    this->meshingDeferredDataMemoryLimit.setRange(16, 1024 * 1024);
+    this->meshingDeferredDataMemoryLimit.setConstraintsEnabled(true);
 
     // Graphics
     settings->addSetting(&this->navigationStyle, groupId_graphics);
     settings->addSetting(&this->defaultShowOriginTrihedron, groupId_graphics);
     settings->addSetting(&this->instantZoomFactor, groupId_graphics);
     settings->addSetting(&this->turnViewAngleIncrement, groupId_graphics);
+    settings->addSetting(&this->mergedDisplay, groupId_graphics);
     // -- Clip planes
     settings->addSetting(&this->clipPlanesCappingOn, sectionId_graphicsClipPlanes);
     settings->addSetting(&this->clipPlanesCappingHatchOn, sectionId_graphicsClipPlanes);
@@ -102,12 +114,16 @@ AppModuleProperties::AppModuleProperties(Settings* settings)
         this->defaultShowOriginTrihedron.setValue(true);
         this->instantZoomFactor.setValue(5.);
         this->turnViewAngleIncrement.setQuantity(5 * Quantity_Degree);
+        this->mergedDisplay.setValue(false);
     });
     settings->addResetFunction(groupId_meshing, [&]{
         this->meshingQuality.setValue(BRepMeshQuality::Normal);
         this->meshingChordalDeflection.setQuantity(1 * Quantity_Millimeter);
         this->meshingAngularDeflection.setQuantity(20 * Quantity_Degree);
         this->meshingRelative.setValue(false);
+        this->meshingLevelOfDetail.setValue(BRepMeshLod::isSupported());
+        this->meshingLodScreenSpaceError.setValue(1.);
+        this->meshingDeferredDataMemoryLimit.setValue(1024);
     });
     settings->addResetFunction(sectionId_graphicsClipPlanes, [=]{
         this->clipPlanesCappingOn.setValue(true);
@@ -214,6 +230,23 @@ void AppModuleProperties::retranslate()
                  "`ChordalDeflection` &#215; `SizeOfEdge`. The deflection used for the faces will be "
                  "the maximum deflection of their edges.")
     );
+    this->meshingLevelOfDetail.setDescription(
+        textIdTr("Mesh BRep shapes at two levels of detail\n\n"
+                 "If activated, a coarse mesh is first computed so imported shapes are quickly "
+                 "displayed. The mesh with the precision defined above is then computed in "
+                 "background, the 3D view selecting the appropriate mesh for each part depending "
+                 "on its distance to the camera.\n\n"
+                 "This option is applicable when OpenCascade ≥ 7.6 version")
+    );
+    this->meshingLodScreenSpaceError.setDescription(
+        textIdTr("Maximum error in pixels tolerated on screen when the 3D view selects the coarse "
+                 "mesh of a part")
+    );
+    this->meshingDeferredDataMemoryLimit.setDescription(
+        textIdTr("Memory limit(MiB) of mesh data loaded on demand(eg glTF files read with deferred "
+                 "mesh data loading)\n\n"
+                 "Mesh data of parts not displayed is unloaded when this limit is exceeded")
+    );
 
     // Graphics
     this->navigationStyle.setDescription(
@@ -222,6 +255,13 @@ void AppModuleProperties::retranslate()
     this->turnViewAngleIncrement.setDescription(
         textIdTr("Angle increment used to turn(rotate) the 3D view around the normal of the view plane(Z axis frame reference)")
     );
+    this->mergedDisplay.setDescription(
+        textIdTr("Draw small parts sharing the same color with a few large graphics objects\n\n"
+                 "This speeds up display of assemblies made of many parts. Merged parts can still "
+                 "be selected and hidden individually, but they can't be measured, they aren't "
+                 "exploded, their face boundaries aren't drawn and their mesh isn't refined afterwards.\n\n"
+                 "This doesn't affect 3D view of currently opened documents")
+    );
 
     // -- Graphics/ClipPlanes
     this->defaultShowOriginTrihedron.setDescription(
@@ -259,6 +299,12 @@ void AppModuleProperties::onPropertyChanged(Property* prop)
         this->meshingAngularDeflection.setEnabled(isUserDefined);
         this->meshingRelative.setEnabled(isUserDefined);
     }
+    else if (prop == &this->meshingLevelOfDetail) {
+        this->meshingLodScreenSpaceError.setEnabled(this->meshingLevelOfDetail.value());
+    }
+    else if (prop == &this->meshingDeferredDataMemoryLimit) {
+        BRepDeferredMesh::setMemoryLimit(size_t(this->meshingDeferredDataMemoryLimit.value()) * 1024 * 1024);
+    }
 
     PropertyGroup::onPropertyChanged(prop);
 }
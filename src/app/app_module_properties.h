@@ -69,12 +69,16 @@ public:
     PropertyLength meshingChordalDeflection{ this, textId("meshingChordalDeflection") };
     PropertyAngle meshingAngularDeflection{ this, textId("meshingAngularDeflection") };
     PropertyBool meshingRelative{ this, textId("meshingRelative") };
+    PropertyBool meshingLevelOfDetail{ this, textId("meshingLevelOfDetail") };
+    PropertyDouble meshingLodScreenSpaceError{ this, textId("meshingLodScreenSpaceError") };
+    PropertyInt meshingDeferredDataMemoryLimit{ this, textId("meshingDeferredDataMemoryLimit") }; // MiB
     // Graphics
     const Settings::GroupIndex groupId_graphics;
     PropertyEnum<View3dNavigationStyle> navigationStyle{ this, textId("navigationStyle") };
     PropertyBool defaultShowOriginTrihedron{ this, textId("defaultShowOriginTrihedron") };
     PropertyDouble instantZoomFactor{ this, textId("instantZoomFactor") };
     PropertyAngle turnViewAngleIncrement{ this, textId("turnViewAngleIncrement") };
+    PropertyBool mergedDisplay{ this, textId("mergedDisplay") };
     // -- Graphics/ClipPlanes
     PropertyBool clipPlanesCappingOn{ this, textId("cappingOn") };
     PropertyBool clipPlanesCappingHatchOn{ this, textId("cappingHatchOn") };
@@ -7,16 +7,24 @@
 #include "commands_file.h"
 
 #include "../base/application.h"
+#include "../base/brep_mesh_lod.h"
 #include "../base/task_manager.h"
+#include "../base/xcaf.h"
 #include "../gui/gui_application.h"
+#include "../gui/gui_document.h"
 #include "../qtcommon/filepath_conv.h"
 #include "../qtcommon/qstring_conv.h"
 #include "app_module.h"
 #include "recent_files.h"
 #include "theme.h"
 
+#include <algorithm>
 #include <cassert>
+#include <memory>
+#include <unordered_set>
+#include <vector>
 #include <fmt/format.h>
+#include <gsl/util>
 #include <QtCore/QtDebug>
 #include <QtCore/QElapsedTimer>
 #include <QtCore/QMimeData>
@@ -110,6 +118,7 @@ struct OpenFileNames {
         for (IO::Format format : AppModule::get()->ioSystem()->readerFormats())
             listFormatFilter += fileFilter(format);
 
+        listFormatFilter.append(Command::tr("Mayo documents(*.myb *.myx)"));
         const QString allFilesFilter = Command::tr("All files(*.*)");
         listFormatFilter.append(allFilesFilter);
         const QString dlgTitle = Command::tr("Select Part File");
@@ -157,6 +166,21 @@ QString strFilepathQuoted(const QString& filepath)
     return filepath;
 }
 
+// Imports files 'listFilepath' into document identified by 'docId'
+// BRep shapes aren't meshed here, GuiDocument takes care of that in background tasks so imported
+// entities can be explored as soon as possible
+bool importFilesInDocument(Document::Identifier docId, Span<const FilePath> listFilepath, TaskProgress* progress)
+{
+    auto appModule = AppModule::get();
+    return appModule->ioSystem()->importInDocument()
+            .targetDocument(appModule->application()->findDocumentByIdentifier(docId))
+            .withFilepaths(listFilepath)
+            .withParametersProvider(appModule)
+            .withMessenger(appModule)
+            .withTaskProgress(progress)
+            .execute();
+}
+
 } // namespace
 
 
@@ -176,7 +200,26 @@ void FileCommandTools::openDocumentsFromList(IAppContext* context, Span<const Fi
     auto appModule = AppModule::get();
     for (const FilePath& fp : listFilePath) {
         DocumentPtr docPtr = app->findDocumentByLocation(fp);
-        if (docPtr.IsNull()) {
+        if (docPtr.IsNull() && FileCommandTools::isMayoDocumentFile(fp)) {
+            // Native document: XCAF data, triangulations and view state are read back as is, so
+            // there is no import nor meshing
+            QElapsedTimer chrono;
+            chrono.start();
+            PCDM_ReaderStatus readStatus = PCDM_RS_OK;
+            docPtr = app->openDocument(fp, &readStatus);
+            if (docPtr.IsNull() || readStatus != PCDM_RS_OK) {
+                appModule->emitError(fmt::format(Command::textIdTr("Failed to open document '{}'"), fp.u8string()));
+                continue;
+            }
+
+            GuiDocument* guiDoc = context->guiApp()->findGuiDocument(docPtr);
+            if (guiDoc)
+                guiDoc->restoreViewState();
+
+            appModule->emitInfo(fmt::format(Command::textIdTr("Open time: {}ms"), chrono.elapsed()));
+            appModule->prependRecentFile(fp);
+        }
+        else if (docPtr.IsNull()) {
             docPtr = app->newDocument();
             docPtr->setName(fp.filename().u8string());
             docPtr->setFilePath(fp);
@@ -187,19 +230,9 @@ void FileCommandTools::openDocumentsFromList(IAppContext* context, Span<const Fi
             const TaskId taskId = context->taskMgr()->newTask([=](TaskProgress* progress) {
                 QElapsedTimer chrono;
                 chrono.start();
-                const bool okImport =
-                        appModule->ioSystem()->importInDocument()
-                        .targetDocument(app->findDocumentByIdentifier(newDocId))
-                        .withFilepath(fp)
-                        .withParametersProvider(appModule)
-                        .withEntityPostProcess([=](TDF_Label labelEntity, TaskProgress* progress) {
-                            appModule->computeBRepMesh(labelEntity, progress);
-                        })
-                        .withEntityPostProcessRequiredIf(&IO::formatProvidesBRep)
-                        .withEntityPostProcessInfoProgress(20, Command::textIdTr("Mesh BRep shapes"))
-                        .withMessenger(appModule)
-                        .withTaskProgress(progress)
-                        .execute();
+                const bool okImport = importFilesInDocument(
+                    newDocId, Span<const FilePath>(&fp, 1), progress
+                );
                 if (okImport)
                     appModule->emitInfo(fmt::format(Command::textIdTr("Import time: {}ms"), chrono.elapsed()));
             });
@@ -219,6 +252,12 @@ void FileCommandTools::openDocument(IAppContext* context, const FilePath& filePa
     FileCommandTools::openDocumentsFromList(context, Span<const FilePath>(&filePath, 1));
 }
 
+bool FileCommandTools::isMayoDocumentFile(const FilePath& filePath)
+{
+    const std::string suffix = filePath.extension().u8string();
+    return suffix == ".myb" || suffix == ".myx";
+}
+
 void FileCommandTools::importInDocument(
         IAppContext* context, const DocumentPtr& targetDoc, Span<const FilePath> listFilePaths
     )
@@ -229,19 +268,7 @@ void FileCommandTools::importInDocument(
         QElapsedTimer chrono;
         chrono.start();
 
-        auto doc = appModule->application()->findDocumentByIdentifier(targetDocId);
-        const bool okImport = appModule->ioSystem()->importInDocument()
-                                  .targetDocument(doc)
-                                  .withFilepaths(listFilePaths)
-                                  .withParametersProvider(appModule)
-                                  .withEntityPostProcess([=](TDF_Label labelEntity, TaskProgress* progress) {
-                                      appModule->computeBRepMesh(labelEntity, progress);
-                                  })
-                                  .withEntityPostProcessRequiredIf(&IO::formatProvidesBRep)
-                                  .withEntityPostProcessInfoProgress(20, Command::textIdTr("Mesh BRep shapes"))
-                                  .withMessenger(appModule)
-                                  .withTaskProgress(progress)
-                                  .execute();
+        const bool okImport = importFilesInDocument(targetDocId, listFilePaths, progress);
         if (okImport)
             appModule->emitInfo(fmt::format(Command::textIdTr("Import time: {}ms"), chrono.elapsed()));
     });
@@ -445,25 +472,91 @@ void CommandExportSelectedApplicationItems::execute()
         return;
 
     lastSettings.openDir = filepathFrom(strFilepath);
-    const IO::Format format = formatFromFilter(lastSettings.selectedFilter);
-    const TaskId taskId = this->taskMgr()->newTask([=](TaskProgress* progress) {
-        QElapsedTimer chrono;
-        chrono.start();
-        const bool okExport =
-                appModule->ioSystem()->exportApplicationItems()
-                .targetFile(filepathFrom(strFilepath))
-                .targetFormat(format)
-                .withItems(this->guiApp()->selectionModel()->selectedItems())
-                .withParameters(appModule->findWriterParameters(format))
-                .withMessenger(appModule)
-                .withTaskProgress(progress)
-                .execute();
-        if (okExport)
-            appModule->emitInfo(fmt::format(Command::textIdTr("Export time: {}ms"), chrono.elapsed()));
-    });
-    this->taskMgr()->setTitle(taskId, to_stdString(QFileInfo(strFilepath).fileName()));
-    this->taskMgr()->run(taskId);
     ImportExportSettings::save(lastSettings);
+    const IO::Format format = formatFromFilter(lastSettings.selectedFilter);
+    const Span<const ApplicationItem> spanSelectedItem = this->guiApp()->selectionModel()->selectedItems();
+    const std::vector<ApplicationItem> vecItem(spanSelectedItem.begin(), spanSelectedItem.end());
+    auto fnRunExport = [=]{
+        // Export finest BRep meshes, whatever the levels of detail currently displayed
+        // Faces are pinned here as the 3D view changes active triangulations in this thread
+        std::vector<TopoDS_Shape> vecShape;
+        for (const ApplicationItem& item : vecItem) {
+            if (item.isDocument()) {
+                for (int i = 0; i < item.document()->entityCount(); ++i)
+                    vecShape.push_back(XCaf::shape(item.document()->entityLabel(i)));
+            }
+            else if (item.isDocumentTreeNode()) {
+                vecShape.push_back(XCaf::shape(item.documentTreeNode().label()));
+            }
+        }
+
+        auto finestLevelPin = std::make_shared<BRepMeshLod::FinestLevelPin>(vecShape);
+        const TaskId taskId = this->taskMgr()->newTask([=](TaskProgress* progress) mutable {
+            auto _ = gsl::finally([&]{ finestLevelPin.reset(); });
+            QElapsedTimer chrono;
+            chrono.start();
+            const bool okExport =
+                    appModule->ioSystem()->exportApplicationItems()
+                    .targetFile(filepathFrom(strFilepath))
+                    .targetFormat(format)
+                    .withItems(vecItem)
+                    .withParameters(appModule->findWriterParameters(format))
+                    .withMessenger(appModule)
+                    .withTaskProgress(progress)
+                    .execute();
+            if (okExport)
+                appModule->emitInfo(fmt::format(Command::textIdTr("Export time: {}ms"), chrono.elapsed()));
+        });
+        this->taskMgr()->setTitle(taskId, to_stdString(QFileInfo(strFilepath).fileName()));
+        this->taskMgr()->run(taskId);
+    };
+
+    // BRep shapes of imported documents are meshed in background, export waits only for the
+    // products of the selected items
+    auto fnHasPendingMeshing = [=]{
+        return std::any_of(vecItem.cbegin(), vecItem.cend(), [=](const ApplicationItem& item) {
+            const GuiDocument* guiDoc = this->guiApp()->findGuiDocument(item.document());
+            if (!guiDoc)
+                return false;
+
+            if (item.isDocumentTreeNode())
+                return guiDoc->hasPendingMeshing(item.documentTreeNode().id());
+
+            const DocumentPtr& doc = item.document();
+            for (int i = 0; i < doc->entityCount(); ++i) {
+                if (guiDoc->hasPendingMeshing(doc->entityTreeNodeId(i)))
+                    return true;
+            }
+
+            return false;
+        });
+    };
+    if (!fnHasPendingMeshing()) {
+        fnRunExport();
+        return;
+    }
+
+    // Check is queued as signalProductsMeshed is sent while processing mesh results
+    appModule->emitInfo(Command::textIdTr("Export will start once BRep shapes are meshed"));
+    auto vecConnection = std::make_shared<std::vector<SignalConnectionHandle>>();
+    auto fnOnProductsMeshed = [=]{
+        QMetaObject::invokeMethod(this, [=]{
+            if (vecConnection->empty() || fnHasPendingMeshing())
+                return;
+
+            for (SignalConnectionHandle& conn : *vecConnection)
+                conn.disconnect();
+
+            vecConnection->clear();
+            fnRunExport();
+        }, Qt::QueuedConnection);
+    };
+    std::unordered_set<const GuiDocument*> setGuiDoc;
+    for (const ApplicationItem& item : vecItem) {
+        const GuiDocument* guiDoc = this->guiApp()->findGuiDocument(item.document());
+        if (guiDoc && setGuiDoc.insert(guiDoc).second)
+            vecConnection->push_back(guiDoc->signalProductsMeshed.connectSlot(fnOnProductsMeshed));
+    }
 }
 
 bool CommandExportSelectedApplicationItems::getEnabledStatus() const
@@ -472,6 +565,63 @@ bool CommandExportSelectedApplicationItems::getEnabledStatus() const
             && this->context()->currentPage() == IAppContext::Page::Documents;
 }
 
+CommandSaveCurrentDocument::CommandSaveCurrentDocument(IAppContext* context)
+    : Command(context)
+{
+    auto action = new QAction(this);
+    action->setText(Command::tr("Save"));
+    action->setToolTip(Command::tr("Save current document in Mayo format"));
+    action->setShortcut(Qt::CTRL + Qt::Key_S);
+    this->setAction(action);
+}
+
+void CommandSaveCurrentDocument::execute()
+{
+    GuiDocument* guiDoc = this->currentGuiDocument();
+    if (!guiDoc)
+        return;
+
+    const DocumentPtr& doc = guiDoc->document();
+    FilePath filepath = doc->filePath();
+    if (!FileCommandTools::isMayoDocumentFile(filepath)) {
+        // Document was imported from a file in another format, ask for the Mayo document file
+        auto lastSettings = ImportExportSettings::load();
+        FilePath proposedFilepath = lastSettings.openDir;
+        proposedFilepath.replace_filename(filepath.stem()).replace_extension(".myb");
+        const QString strFilepath =
+                QFileDialog::getSaveFileName(
+                    this->widgetMain(),
+                    Command::tr("Save Document"),
+                    filepathTo<QString>(proposedFilepath),
+                    Command::tr("Binary Mayo Document(*.myb)")
+                );
+        if (strFilepath.isEmpty())
+            return;
+
+        filepath = filepathFrom(strFilepath);
+        lastSettings.openDir = filepath;
+        ImportExportSettings::save(lastSettings);
+    }
+
+    auto appModule = AppModule::get();
+    QElapsedTimer chrono;
+    chrono.start();
+    guiDoc->storeViewState();
+    if (this->app()->saveDocument(doc, filepath) == PCDM_SS_OK) {
+        appModule->emitInfo(fmt::format(Command::textIdTr("Save time: {}ms"), chrono.elapsed()));
+        appModule->prependRecentFile(filepath);
+    }
+    else {
+        appModule->emitError(fmt::format(Command::textIdTr("Failed to save document '{}'"), filepath.u8string()));
+    }
+}
+
+bool CommandSaveCurrentDocument::getEnabledStatus() const
+{
+    return this->app()->documentCount() != 0
+           && this->context()->currentPage() == IAppContext::Page::Documents;
+}
+
 CommandCloseCurrentDocument::CommandCloseCurrentDocument(IAppContext* context)
     : Command(context)
 {
@@ -17,6 +17,8 @@ public:
     static void closeDocument(IAppContext* context, Document::Identifier docId);
     static void openDocumentsFromList(IAppContext* context, Span<const FilePath> listFilePath);
     static void openDocument(IAppContext* context, const FilePath& filePath);
+    // Whether 'filePath' refers to a document stored in Mayo native format(ie not to be imported)
+    static bool isMayoDocumentFile(const FilePath& filePath);
     static void importInDocument(
         IAppContext* context,
         const DocumentPtr& targetDoc,
@@ -74,6 +76,15 @@ public:
     static constexpr std::string_view Name = "export";
 };
 
+class CommandSaveCurrentDocument : public Command {
+public:
+    CommandSaveCurrentDocument(IAppContext* context);
+    void execute() override;
+    bool getEnabledStatus() const override;
+
+    static constexpr std::string_view Name = "save-doc";
+};
+
 class CommandCloseCurrentDocument : public Command {
 public:
     CommandCloseCurrentDocument(IAppContext* context);
@@ -12,6 +12,7 @@
 #include "../gui/gui_document.h"
 #include "app_module.h"
 #include "dialog_inspect_xde.h"
+#include "dialog_instrumentation.h"
 #include "dialog_options.h"
 #include "dialog_save_image_view.h"
 #include "qtwidgets_utils.h"
@@ -83,6 +84,27 @@ bool CommandInspectXde::getEnabledStatus() const
         ;
 }
 
+CommandShowInstrumentation::CommandShowInstrumentation(IAppContext* context)
+    : Command(context)
+{
+    auto action = new QAction(this);
+    action->setText(Command::tr("Import/Export Metrics"));
+    action->setToolTip(Command::tr("Show timing and memory metrics of import/export operations"));
+    this->setAction(action);
+}
+
+void CommandShowInstrumentation::execute()
+{
+    // Created on first use, so import/export stages aren't measured until the user asks for it
+    auto dlg = this->widgetMain()->findChild<DialogInstrumentation*>();
+    if (!dlg)
+        dlg = new DialogInstrumentation(AppModule::get()->ioSystem(), this->widgetMain());
+
+    dlg->show();
+    dlg->raise();
+    dlg->activateWindow();
+}
+
 CommandEditOptions::CommandEditOptions(IAppContext* context)
     : Command(context)
 {
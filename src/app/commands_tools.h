@@ -28,6 +28,14 @@ public:
     static constexpr std::string_view Name = "inspect-xde";
 };
 
+class CommandShowInstrumentation : public Command {
+public:
+    CommandShowInstrumentation(IAppContext* context);
+    void execute() override;
+
+    static constexpr std::string_view Name = "show-instrumentation";
+};
+
 class CommandEditOptions : public Command {
 public:
     CommandEditOptions(IAppContext* context);
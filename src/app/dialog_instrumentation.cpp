@@ -0,0 +1,89 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "dialog_instrumentation.h"
+
+#include "../base/filepath_conv.h"
+#include "../base/io_system.h"
+#include "../qtcommon/qstring_conv.h"
+#include "ui_dialog_instrumentation.h"
+#include "app_module.h"
+#include "qstring_utils.h"
+
+#include <QtCore/QMetaObject>
+#include <QtWidgets/QPushButton>
+#include <cstdlib>
+
+namespace Mayo {
+
+DialogInstrumentation::DialogInstrumentation(IO::System* ioSystem, QWidget* parent)
+    : QDialog(parent),
+      m_ui(new Ui_DialogInstrumentation),
+      m_ioSystem(ioSystem)
+{
+    m_ui->setupUi(this);
+    m_ui->buttonBox->button(QDialogButtonBox::Reset)->setText(tr("Clear"));
+    QObject::connect(
+        m_ui->buttonBox->button(QDialogButtonBox::Reset), &QPushButton::clicked,
+        m_ui->treeWidget_Records, &QTreeWidget::clear
+    );
+}
+
+DialogInstrumentation::~DialogInstrumentation()
+{
+    if (m_ioSystem && m_ioSystem->instrumentationSink() == this)
+        m_ioSystem->setInstrumentationSink(nullptr);
+
+    delete m_ui;
+}
+
+void DialogInstrumentation::addRecord(const InstrumentationRecord& record)
+{
+    QMetaObject::invokeMethod(this, [=]{ this->appendRecordItem(record); }, Qt::QueuedConnection);
+}
+
+void DialogInstrumentation::showEvent(QShowEvent* event)
+{
+    if (m_ioSystem)
+        m_ioSystem->setInstrumentationSink(this);
+
+    QDialog::showEvent(event);
+}
+
+void DialogInstrumentation::hideEvent(QHideEvent* event)
+{
+    if (m_ioSystem && m_ioSystem->instrumentationSink() == this)
+        m_ioSystem->setInstrumentationSink(nullptr);
+
+    QDialog::hideEvent(event);
+}
+
+void DialogInstrumentation::appendRecordItem(const InstrumentationRecord& record)
+{
+    const QLocale& locale = AppModule::get()->qtLocale();
+    auto fnBytesText = [&](std::uint64_t bytes) { return QStringUtils::bytesText(bytes, locale); };
+    const QString strDeltaSign = record.rssDeltaBytes < 0 ? QStringLiteral("-") : QStringLiteral("+");
+    const auto absRssDelta = static_cast<std::uint64_t>(std::abs(record.rssDeltaBytes));
+
+    auto item = new QTreeWidgetItem;
+    item->setText(0, to_QString(record.operation));
+    item->setText(1, to_QString(record.stage));
+    item->setText(2, filepathTo<QString>(record.filepath.filename()));
+    item->setToolTip(2, filepathTo<QString>(record.filepath));
+    item->setText(3, to_QString(record.format));
+    item->setText(4, record.ok ? tr("OK") : tr("Failed"));
+    item->setText(5, tr("%1s").arg(locale.toString(record.seconds, 'f', 3)));
+    item->setText(6, fnBytesText(record.rssBytes));
+    item->setText(7, strDeltaSign + fnBytesText(absRssDelta));
+    item->setText(8, fnBytesText(record.peakRssBytes));
+    for (int col = 5; col < m_ui->treeWidget_Records->columnCount(); ++col)
+        item->setTextAlignment(col, Qt::AlignRight | Qt::AlignVCenter);
+
+    m_ui->treeWidget_Records->addTopLevelItem(item);
+    m_ui->treeWidget_Records->scrollToItem(item);
+}
+
+} // namespace Mayo
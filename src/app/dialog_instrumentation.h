@@ -0,0 +1,40 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "../base/instrumentation.h"
+
+#include <QtWidgets/QDialog>
+
+namespace Mayo {
+
+namespace IO { class System; }
+
+// Dialog listing the timing/memory measures taken for each stage of import/export operations
+// The dialog registers itself as the InstrumentationSink of the IO::System object only while it's
+// shown, so no measure is taken otherwise
+class DialogInstrumentation : public QDialog, public InstrumentationSink {
+    Q_OBJECT
+public:
+    DialogInstrumentation(IO::System* ioSystem, QWidget* parent = nullptr);
+    ~DialogInstrumentation();
+
+    // Thread-safe, the record is appended to the view in the thread of the dialog
+    void addRecord(const InstrumentationRecord& record) override;
+
+protected:
+    void showEvent(QShowEvent* event) override;
+    void hideEvent(QHideEvent* event) override;
+
+private:
+    void appendRecordItem(const InstrumentationRecord& record);
+
+    class Ui_DialogInstrumentation* m_ui = nullptr;
+    IO::System* m_ioSystem = nullptr;
+};
+
+} // namespace Mayo
@@ -7,6 +7,7 @@
 #include "document_tree_node_properties_providers.h"
 
 #include "../base/caf_utils.h"
+#include "../base/cpp_utils.h"
 #include "../base/label_data.h"
 #include "../base/triangulation_annex_data.h"
 #include "../base/document.h"
@@ -202,7 +203,7 @@ public:
 
 bool XCaf_DocumentTreeNodePropertiesProvider::supports(const DocumentTreeNode& treeNode) const
 {
-    return GraphicsShapeObjectDriver::shapeSupportStatus(treeNode.label()) == GraphicsObjectDriver::Support::Complete;
+    return GraphicsShapeObjectDriver::shapeSupportStatus(treeNode.labelDataFlags()) == GraphicsObjectDriver::Support::Complete;
 }
 
 std::unique_ptr<PropertyGroupSignals>
@@ -240,7 +241,7 @@ public:
 
 bool Mesh_DocumentTreeNodePropertiesProvider::supports(const DocumentTreeNode& treeNode) const
 {
-    return GraphicsMeshObjectDriver::meshSupportStatus(treeNode.label()) == GraphicsObjectDriver::Support::Complete;
+    return GraphicsMeshObjectDriver::meshSupportStatus(treeNode.labelDataFlags()) == GraphicsObjectDriver::Support::Complete;
 }
 
 std::unique_ptr<PropertyGroupSignals>
@@ -259,15 +260,12 @@ public:
     {
         auto attrPointCloudData = CafUtils::findAttribute<PointCloudData>(treeNode.label());
 
-        const bool hasAttrData = !attrPointCloudData.IsNull() && !attrPointCloudData->points().IsNull();
-        m_propertyPointCount.setValue(hasAttrData ? attrPointCloudData->points()->VertexNumber() : 0);
-        m_propertyHasColors.setValue(hasAttrData ? attrPointCloudData->points()->HasVertexColors() : false);
-        if (hasAttrData) {
-            Bnd_Box bndBox;
-            const int pntCount = attrPointCloudData->points()->VertexNumber();
-            for (int i = 1; i <= pntCount; ++i)
-                bndBox.Add(attrPointCloudData->points()->Vertice(i));
-
+        const bool hasAttrData = !attrPointCloudData.IsNull() && attrPointCloudData->pointCloud();
+        const PointCloud* pointCloud = hasAttrData ? attrPointCloudData->pointCloud().get() : nullptr;
+        m_propertyPointCount.setValue(pointCloud ? CppUtils::safeStaticCast<int>(pointCloud->pointCount()) : 0);
+        m_propertyHasColors.setValue(pointCloud ? pointCloud->hasColors() : false);
+        if (pointCloud && !pointCloud->isEmpty()) {
+            const Bnd_Box bndBox = pointCloud->computeBoundingBox();
             m_propertyCornerMin.setValue(bndBox.CornerMin());
             m_propertyCornerMax.setValue(bndBox.CornerMax());
         }
@@ -284,7 +282,7 @@ public:
 
 bool PointCloud_DocumentTreeNodePropertiesProvider::supports(const DocumentTreeNode& treeNode) const
 {
-    return GraphicsPointCloudObjectDriver::pointCloudSupportStatus(treeNode.label()) == GraphicsObjectDriver::Support::Complete;
+    return GraphicsPointCloudObjectDriver::pointCloudSupportStatus(treeNode.labelDataFlags()) == GraphicsObjectDriver::Support::Complete;
 }
 
 std::unique_ptr<PropertyGroupSignals>
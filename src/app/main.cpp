@@ -17,6 +17,8 @@
 #include "../io_off/io_off_writer.h"
 #include "../io_ply/io_ply_reader.h"
 #include "../io_ply/io_ply_writer.h"
+#include "../io_pointcloud/io_las_reader.h"
+#include "../io_pointcloud/io_xyz_reader.h"
 #include "../graphics/graphics_mesh_object_driver.h"
 #include "../graphics/graphics_point_cloud_object_driver.h"
 #include "../graphics/graphics_shape_object_driver.h"
@@ -389,6 +391,8 @@ static int runApp(QCoreApplication* qtApp)
     ioSystem->addFactoryReader(std::make_unique<IO::OccFactoryReader>());
     ioSystem->addFactoryReader(std::make_unique<IO::OffFactoryReader>());
     ioSystem->addFactoryReader(std::make_unique<IO::PlyFactoryReader>());
+    ioSystem->addFactoryReader(std::make_unique<IO::XyzFactoryReader>());
+    ioSystem->addFactoryReader(std::make_unique<IO::LasFactoryReader>());
     ioSystem->addFactoryReader(IO::AssimpFactoryReader::create());
     ioSystem->addFactoryWriter(std::make_unique<IO::OccFactoryWriter>());
     ioSystem->addFactoryWriter(std::make_unique<IO::OffFactoryWriter>());
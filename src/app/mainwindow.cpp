@@ -128,6 +128,7 @@ void MainWindow::createCommands()
     this->addCommand<CommandRecentFiles>(m_ui->menu_File);
     this->addCommand<CommandImportInCurrentDocument>();
     this->addCommand<CommandExportSelectedApplicationItems>();
+    this->addCommand<CommandSaveCurrentDocument>();
     this->addCommand<CommandCloseCurrentDocument>();
     this->addCommand<CommandCloseAllDocuments>();
     this->addCommand<CommandCloseAllDocumentsExceptCurrent>();
@@ -146,6 +147,7 @@ void MainWindow::createCommands()
     // "Tools" commands
     this->addCommand<CommandSaveViewImage>();
     this->addCommand<CommandInspectXde>();
+    this->addCommand<CommandShowInstrumentation>();
     this->addCommand<CommandEditOptions>();
 
     // "Window" commands
@@ -175,6 +177,7 @@ void MainWindow::createMenus()
         fnAddAction(menu, CommandNewDocument::Name);
         fnAddAction(menu, CommandOpenDocuments::Name);
         fnAddAction(menu, CommandRecentFiles::Name);
+        fnAddAction(menu, CommandSaveCurrentDocument::Name);
         menu->addSeparator();
         fnAddAction(menu, CommandImportInCurrentDocument::Name);
         fnAddAction(menu, CommandExportSelectedApplicationItems::Name);
@@ -203,6 +206,7 @@ void MainWindow::createMenus()
         auto menu = m_ui->menu_Tools;
         fnAddAction(menu, CommandSaveViewImage::Name);
         fnAddAction(menu, CommandInspectXde::Name);
+        fnAddAction(menu, CommandShowInstrumentation::Name);
         menu->addSeparator();
         fnAddAction(menu, CommandEditOptions::Name);
     }
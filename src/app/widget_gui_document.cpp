@@ -23,6 +23,7 @@
 #include "qtwidgets_utils.h"
 
 #include <QtCore/QtDebug>
+#include <QtCore/QTimer>
 #include <QtGui/QPainter>
 #include <QtGui/QGuiApplication>
 #include <QtWidgets/QBoxLayout>
@@ -75,6 +76,10 @@ private:
 // Default margin to be used in widgets
 const int Internal_widgetMargin = 4;
 
+// Progressive graphics mapping: interval between two steps and time budget allowed for each step
+const int Internal_graphicsMappingInterval_ms = 15;
+const std::chrono::milliseconds Internal_graphicsMappingBudget{ 8 };
+
 } // namespace
 
 WidgetGuiDocument::WidgetGuiDocument(GuiDocument* guiDoc, QWidget* parent)
@@ -132,7 +137,11 @@ WidgetGuiDocument::WidgetGuiDocument(GuiDocument* guiDoc, QWidget* parent)
     QObject::connect(m_btnExplode, &ButtonFlat::checked, this, &WidgetGuiDocument::toggleWidgetExplode);
     QObject::connect(m_btnMeasure, &ButtonFlat::checked, this, &WidgetGuiDocument::toggleWidgetMeasure);
     m_controller->signalDynamicActionStarted.connectSlot([=]{ m_guiDoc->stopViewCameraAnimation(); });
-    m_controller->signalViewScaled.connectSlot([=]{ m_guiDoc->stopViewCameraAnimation(); });
+    m_controller->signalViewScaled.connectSlot([=]{
+        m_guiDoc->stopViewCameraAnimation();
+        m_guiDoc->updateLevelOfDetail();
+    });
+    m_controller->signalDynamicActionEnded.connectSlot([=]{ m_guiDoc->updateLevelOfDetail(); });
     m_controller->signalMouseButtonClicked.connectSlot([=](Aspect_VKeyMouse btn) {
         if (btn == Aspect_VKeyMouse_LeftButton && !m_guiDoc->processAction(gfxScene->currentHighlightedOwner())) {
             gfxScene->select();
@@ -144,6 +153,20 @@ WidgetGuiDocument::WidgetGuiDocument(GuiDocument* guiDoc, QWidget* parent)
         gfxScene->setSelectionMode(mode);
     });
 
+    // Pump progressive graphics mapping, the event loop keeps running between steps so the 3D view
+    // stays interactive
+    m_timerGraphicsMapping = new QTimer(this);
+    m_timerGraphicsMapping->setInterval(Internal_graphicsMappingInterval_ms);
+    QObject::connect(m_timerGraphicsMapping, &QTimer::timeout, this, [=]{
+        m_guiDoc->processPendingGraphicsMapping(Internal_graphicsMappingBudget);
+        if (!m_guiDoc->hasPendingGraphicsMapping())
+            m_timerGraphicsMapping->stop();
+    });
+    m_guiDoc->signalGraphicsMappingPending.connectSlot([=]{
+        if (!m_timerGraphicsMapping->isActive())
+            m_timerGraphicsMapping->start();
+    });
+
     m_guiDoc->viewCameraAnimation()->setBackend(std::make_unique<QtAnimationBackend>(QEasingCurve::OutExpo));
     m_guiDoc->viewCameraAnimation()->setRenderFunction([=](const OccHandle<V3d_View>& view){
         if (view == m_qtOccView->v3dView())
@@ -13,6 +13,7 @@
 #include <QtWidgets/QWidget>
 #include <V3d_TypeOfOrientation.hxx>
 #include <vector>
+class QTimer;
 
 namespace Mayo {
 
@@ -66,6 +67,7 @@ private:
     WidgetGrid* m_widgetGrid = nullptr;
     WidgetMeasure* m_widgetMeasure = nullptr;
     QRect m_rectControls;
+    QTimer* m_timerGraphicsMapping = nullptr;
 
     ButtonFlat* m_btnFitAll = nullptr;
     ButtonFlat* m_btnGrid = nullptr;
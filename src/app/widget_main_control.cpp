@@ -424,6 +424,33 @@ void WidgetMainControl::onGuiDocumentAdded(GuiDocument* guiDoc)
     auto widgetCtrl = widget->controller();
     widgetCtrl->setInstantZoomFactor(appProps->instantZoomFactor);
     widgetCtrl->setNavigationStyle(appProps->navigationStyle);
+    guiDoc->setLodScreenSpaceError(appProps->meshingLodScreenSpaceError);
+    if (appProps->mergedDisplay) {
+        GuiDocument::MergedDisplay mergedDisplay;
+        mergedDisplay.enabled = true;
+        guiDoc->setMergedDisplay(mergedDisplay);
+    }
+
+    if (m_appContext) {
+        // Create graphics of document entities progressively, BRep shapes are meshed in background
+        GuiDocument::ProgressiveMapping progressiveMapping;
+        progressiveMapping.taskMgr = m_appContext->taskMgr();
+        progressiveMapping.fnMeshShape = [=](const TopoDS_Shape& shape, TaskProgress* progress) {
+            if (appModule->isBRepMeshLevelOfDetailEnabled())
+                appModule->computeBRepMeshCoarse(shape, progress);
+            else
+                appModule->computeBRepMesh(shape, progress);
+        };
+        progressiveMapping.fnMeshShapeFineLevel = [=](const TopoDS_Shape& shape, TaskProgress* progress) {
+            if (!appModule->isBRepMeshLevelOfDetailEnabled())
+                return BRepMeshLod::Level{};
+
+            return appModule->computeBRepMeshFineLevel(shape, progress);
+        };
+
+        guiDoc->enableProgressiveMapping(progressiveMapping);
+    }
+
     if (appProps->defaultShowOriginTrihedron) {
         guiDoc->toggleOriginTrihedronVisibility();
         gfxScene->redraw();
@@ -434,6 +461,8 @@ void WidgetMainControl::onGuiDocumentAdded(GuiDocument* guiDoc)
             widgetCtrl->setInstantZoomFactor(appProps->instantZoomFactor);
         else if (setting == &appProps->navigationStyle)
             widgetCtrl->setNavigationStyle(appProps->navigationStyle);
+        else if (setting == &appProps->meshingLodScreenSpaceError)
+            guiDoc->setLodScreenSpaceError(appProps->meshingLodScreenSpaceError);
     });
 
     // React to mouse move in 3D view:
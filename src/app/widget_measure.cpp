@@ -9,41 +9,38 @@
 #include "theme.h"
 #include "ui_widget_measure.h"
 
+#include "../base/brep_mesh_lod.h"
 #include "../base/unit_system.h"
+#include "../base/xcaf.h"
 #include "../gui/gui_document.h"
 #include "../measure/measure_tool_brep.h"
+#include "../measure/measure_tool_mesh.h"
 #include "../qtcommon/qstring_conv.h"
 
 #include <QtCore/QtDebug>
 #include <QtGui/QFontDatabase>
+#include <QtWidgets/QHBoxLayout>
+#include <QtWidgets/QProgressBar>
+#include <QtWidgets/QPushButton>
 
+#include <OSD_Parallel.hxx>
+#include <StdSelect_BRepOwner.hxx>
+
+#include <gsl/util>
 #include <cmath>
 #include <codecvt>
+#include <memory>
 #include <vector>
 
 namespace Mayo {
 
 namespace {
 
-using IMeasureToolPtr = std::unique_ptr<IMeasureTool>;
-
-// Get global array of available measurement tool objects
-std::vector<IMeasureToolPtr>& getMeasureTools()
+// Get global array of the functions creating measurement tool objects
+std::vector<WidgetMeasure::MeasureToolCreator>& getMeasureToolCreators()
 {
-    static std::vector<IMeasureToolPtr> vecTool;
-    return vecTool;
-}
-
-// Returns the tool object adapted for the graphics object 'gfxObject' and measure type
-// Note: the search is performed in the array returned by getMeasureTools() function
-IMeasureTool* findSupportingMeasureTool(const GraphicsObjectPtr& gfxObject, MeasureType measureType)
-{
-    for (const IMeasureToolPtr& ptr : getMeasureTools()) {
-        if (ptr->supports(measureType) && ptr->supports(gfxObject))
-            return ptr.get();
-    }
-
-    return nullptr;
+    static std::vector<WidgetMeasure::MeasureToolCreator> vecCreator;
+    return vecCreator;
 }
 
 // Helper function to iterate and execute function 'fn' on all the graphics objects owned by a
@@ -69,10 +66,26 @@ void foreachGraphicsObject(const std::unique_ptr<IMeasureDisplay>& ptr, Function
 WidgetMeasure::WidgetMeasure(GuiDocument* guiDoc, QWidget* parent)
     : QWidget(parent),
       m_ui(new Ui_WidgetMeasure),
-      m_guiDoc(guiDoc)
+      m_guiDoc(guiDoc),
+      m_cache(std::make_shared<MeasureCache>())
 {
-    if (getMeasureTools().empty())
-        getMeasureTools().push_back(std::make_unique<MeasureToolBRep>());
+    if (getMeasureToolCreators().empty()) {
+        getMeasureToolCreators().push_back([](const std::shared_ptr<MeasureCache>& cache) {
+            return std::make_unique<MeasureToolBRep>(cache);
+        });
+        getMeasureToolCreators().push_back([](const std::shared_ptr<MeasureCache>& cache) {
+            return std::make_unique<MeasureToolMesh>(cache);
+        });
+    }
+
+    // Tools are created per document and share the same cache, released along with the document
+    for (const MeasureToolCreator& fnCreateTool : getMeasureToolCreators())
+        m_vecTool.push_back(fnCreateTool(m_cache));
+
+    // Running task, memoized values and cached results can refer to graphics of destroyed entities
+    m_connEntityAboutToBeDestroyed = m_guiDoc->document()->signalEntityAboutToBeDestroyed.connectSlot(
+        &WidgetMeasure::onEntityAboutToBeDestroyed, this
+    );
 
     m_ui->setupUi(this);
     QObject::connect(
@@ -96,18 +109,31 @@ WidgetMeasure::WidgetMeasure(GuiDocument* guiDoc, QWidget* parent)
                 this, &WidgetMeasure::onMeasureUnitsChanged
     );
 
+    // Task signals are emitted from worker threads, slots are queued so they run in the GUI thread
+    // Note: queued calls are discarded if this widget gets destroyed in the meantime
+    m_taskMgr.signalProgressChanged.connect([=](TaskId taskId, int percent) {
+        QMetaObject::invokeMethod(this, [=]{ this->onTaskProgressChanged(taskId, percent); }, Qt::QueuedConnection);
+    });
+    m_taskMgr.signalEnded.connect([=](TaskId taskId) {
+        QMetaObject::invokeMethod(this, [=]{ this->onTaskEnded(taskId); }, Qt::QueuedConnection);
+    });
+
     this->onMeasureTypeChanged(m_ui->combo_MeasureType->currentIndex());
     this->updateMessagePanel();
 }
 
 WidgetMeasure::~WidgetMeasure()
 {
+    this->abortMeasureTask();
+    m_taskMgr.foreachTask([=](TaskId taskId) { m_taskMgr.waitForDone(taskId); });
+    m_connEntityAboutToBeDestroyed.disconnect();
     delete m_ui;
 }
 
 void WidgetMeasure::setMeasureOn(bool on)
 {
     m_errorMessage.clear();
+    this->abortMeasureTask();
     auto gfxScene = m_guiDoc->graphicsScene();
     if (on) {
         this->onMeasureTypeChanged(m_ui->combo_MeasureType->currentIndex());
@@ -121,13 +147,25 @@ void WidgetMeasure::setMeasureOn(bool on)
         });
         gfxScene->clearSelection();
         m_connGraphicsSelectionChanged.disconnect();
+        m_mapMeasureValue.clear();
     }
 }
 
-void WidgetMeasure::addTool(std::unique_ptr<IMeasureTool> tool)
+void WidgetMeasure::addTool(MeasureToolCreator fnCreateTool)
 {
-    if (tool)
-        getMeasureTools().push_back(std::move(tool));
+    if (fnCreateTool)
+        getMeasureToolCreators().push_back(std::move(fnCreateTool));
+}
+
+// Returns the tool object adapted for the graphics object 'gfxObject' and measure type
+const IMeasureTool* WidgetMeasure::findSupportingMeasureTool(const GraphicsObjectPtr& gfxObject, MeasureType measureType) const
+{
+    for (const std::unique_ptr<IMeasureTool>& ptr : m_vecTool) {
+        if (ptr->supports(measureType) && ptr->supports(gfxObject))
+            return ptr.get();
+    }
+
+    return nullptr;
 }
 
 MeasureType WidgetMeasure::toMeasureType(int comboBoxId)
@@ -142,6 +180,7 @@ MeasureType WidgetMeasure::toMeasureType(int comboBoxId)
     case 6: return MeasureType::Length;
     case 7: return MeasureType::Area;
     case 8: return MeasureType::BoundingBox;
+    case 9: return MeasureType::MassProperties;
     }
     return MeasureType::None;
 }
@@ -203,7 +242,8 @@ void WidgetMeasure::onMeasureTypeChanged(int id)
     const bool measureIsLengthBased = measureType != MeasureType::Angle;
     const bool measureIsAngle = measureType == MeasureType::Angle;
     const bool measureIsArea = measureType == MeasureType::Area;
-    const bool measureIsVolume = measureType == MeasureType::BoundingBox;
+    const bool measureIsVolume =
+        measureType == MeasureType::BoundingBox || measureType == MeasureType::MassProperties;
     // Note: don't call "ui->comboUnit->setVisible(labelUnit->isVisible())" because at this point
     //       QWidget::isVisible() might not be effective(probably needs to process eventloop)
     m_ui->label_LengthUnit->setVisible(measureIsLengthBased && !measureIsArea);
@@ -216,23 +256,19 @@ void WidgetMeasure::onMeasureTypeChanged(int id)
     m_ui->combo_VolumeUnit->setVisible(measureIsVolume);
 
     auto gfxScene = m_guiDoc->graphicsScene();
+    this->abortMeasureTask();
 
-    // Find measure tool
-    m_tool = nullptr;
-    gfxScene->foreachDisplayedObject([=](const GraphicsObjectPtr& gfxObject) {
-        if (!m_tool)
-            m_tool = findSupportingMeasureTool(gfxObject, measureType);
-    });
-
-    // Apply 3D selection modes required by the measure tool
+    // Apply 3D selection modes required by the measure tool of each graphics object
+    // Note: objects can be measured by different tools(eg BRep shapes and meshes)
     gfxScene->clearSelection();
     gfxScene->foreachDisplayedObject([=](const GraphicsObjectPtr& gfxObject) {
         if (GuiDocument::isAisViewCubeObject(gfxObject))
             return; // Skip
 
         gfxScene->deactivateObjectSelection(gfxObject);
-        if (m_tool) {
-            for (GraphicsObjectSelectionMode mode : m_tool->selectionModes(measureType))
+        const IMeasureTool* tool = this->findSupportingMeasureTool(gfxObject, measureType);
+        if (tool) {
+            for (GraphicsObjectSelectionMode mode : tool->selectionModes(measureType))
                 gfxScene->activateObjectSelection(gfxObject, mode);
         }
     });
@@ -279,85 +315,108 @@ void WidgetMeasure::onGraphicsSelectionChanged()
     {
         // Store currently selected graphics
         std::vector<GraphicsOwnerPtr> vecSelected;
+        std::unordered_set<GraphicsOwnerPtr> setSelected;
         gfxScene->foreachSelectedOwner([&](const GraphicsOwnerPtr& owner) {
-            vecSelected.push_back(owner);
+            if (setSelected.insert(owner).second)
+                vecSelected.push_back(owner);
         });
 
         // Find new selected graphics
         for (const GraphicsOwnerPtr& owner : vecSelected) {
-            auto itFound = std::find(m_vecSelectedOwner.begin(), m_vecSelectedOwner.end(), owner);
-            if (itFound == m_vecSelectedOwner.end())
+            if (m_setSelectedOwner.find(owner) == m_setSelectedOwner.cend())
                 vecNewSelected.push_back(owner);
         }
 
         // Find deselected graphics
         for (const GraphicsOwnerPtr& owner : m_vecSelectedOwner) {
-            auto itFound = std::find(vecSelected.begin(), vecSelected.end(), owner);
-            if (itFound == vecSelected.end())
+            if (setSelected.find(owner) == setSelected.cend())
                 vecDeselected.push_back(owner);
         }
 
         m_vecSelectedOwner = std::move(vecSelected);
+        m_setSelectedOwner = std::move(setSelected);
     }
 
     // Erase objects associated to deselected graphics
     for (const GraphicsOwnerPtr& owner : vecDeselected) {
-        for (auto link = this->findLink(owner); link != nullptr; link = this->findLink(owner)) {
-            this->eraseMeasureDisplay(link->measureDisplay);
-            this->eraseLink(link);
-        }
+        auto [itBegin, itEnd] = m_mapOwnerMeasureDisplay.equal_range(owner);
+        std::vector<const IMeasureDisplay*> vecMeasureDisplay;
+        for (auto it = itBegin; it != itEnd; ++it)
+            vecMeasureDisplay.push_back(it->second);
+
+        for (const IMeasureDisplay* measure : vecMeasureDisplay)
+            this->eraseMeasureDisplay(measure);
     }
 
     m_guiDoc->graphicsScene()->redraw();
     m_errorMessage.clear();
 
-    // Exit if no measure tool available
-    if (!m_tool)
-        return;
-
-    // Holds MeasureDisplay objects created for new selected graphics
-    std::vector<IMeasureDisplayPtr> vecNewMeasureDisplay;
+    const MeasureType measureType = this->currentMeasureType();
+    auto fnFindTool = [=](const GraphicsOwnerPtr& owner) {
+        auto gfxObject = GraphicsObjectPtr::DownCast(owner->Selectable());
+        return this->findSupportingMeasureTool(gfxObject, measureType);
+    };
 
-    // Helper to ease addition(registration) of MeasureDisplay object
-    auto fnAddMeasureDisplay = [&](
-            std::unique_ptr<IMeasureDisplay> ptr,
-            std::initializer_list<GraphicsOwnerPtr> listOwner)
-    {
-        if (ptr) {
-            vecNewMeasureDisplay.push_back(std::move(ptr));
-            for (const GraphicsOwnerPtr& owner : listOwner)
-                this->addLink(owner, vecNewMeasureDisplay.back());
+    std::vector<MeasureRequest> vecRequest;
+    // Requests needing a newly single selected graphics object
+    // Requests of the current task not computed yet are issued again, unless deselected
+    if (m_task) {
+        for (const MeasureRequest& request : m_task->vecRequest) {
+            if (!request.owner2 && this->isSelected(request.owner1))
+                vecRequest.push_back({ request.tool, request.owner1, {}, request.density });
         }
-    };
+    }
 
-    const MeasureType measureType = this->currentMeasureType();
-    // Create MeasureDisplay objects needing a newly single selected graphics object
     for (const GraphicsOwnerPtr& owner : vecNewSelected) {
-        try {
-            const MeasureValue value = IMeasureTool_computeValue(*m_tool, measureType, owner);
-            if (MeasureValue_isValid(value))
-                fnAddMeasureDisplay(BaseMeasureDisplay::createFrom(measureType, value), { owner });
-        } catch (const IMeasureError& err) {
-            m_errorMessage = to_QString(err.message());
-        }
+        const IMeasureTool* tool = fnFindTool(owner);
+        if (!tool)
+            continue;
+
+        const QuantityDensity density =
+            measureType == MeasureType::MassProperties ? this->findMaterialDensity(owner) : QuantityDensity{};
+        vecRequest.push_back({ tool, owner, {}, density });
     }
 
-    // Create MeasureDisplay objects needing currently two selected graphics objects
+    // Request needing currently two selected graphics objects, both handled by the same tool
     if (m_vecSelectedOwner.size() == 2) {
         const GraphicsOwnerPtr& owner1 = m_vecSelectedOwner.front();
         const GraphicsOwnerPtr& owner2 = m_vecSelectedOwner.back();
-        try {
-            const MeasureValue value = IMeasureTool_computeValue(*m_tool, measureType, owner1, owner2);
-            if (MeasureValue_isValid(value))
-                fnAddMeasureDisplay(BaseMeasureDisplay::createFrom(measureType, value), { owner1, owner2 });
-        } catch (const IMeasureError& err) {
-            m_errorMessage = to_QString(err.message());
+        const IMeasureTool* tool = fnFindTool(owner1);
+        if (tool && tool == fnFindTool(owner2))
+            vecRequest.push_back({ tool, owner1, owner2 });
+    }
+
+    // Memoized values are displayed at once, others are computed in a new task
+    this->abortMeasureTask();
+    std::vector<IMeasureDisplayPtr> vecNewMeasureDisplay;
+    std::vector<MeasureRequest> vecRequestToCompute;
+    for (MeasureRequest& request : vecRequest) {
+        auto itValue = m_mapMeasureValue.find({ measureType, request.owner1, request.owner2 });
+        if (itValue != m_mapMeasureValue.cend()) {
+            request.value = itValue->second;
+            this->addMeasureDisplay(measureType, request, &vecNewMeasureDisplay);
+        }
+        else {
+            vecRequestToCompute.push_back(std::move(request));
         }
     }
 
+    this->addMeasureDisplays(std::move(vecNewMeasureDisplay));
+    if (!vecRequestToCompute.empty())
+        this->runMeasureTask(measureType, std::move(vecRequestToCompute));
+
+    this->updateMessagePanel();
+}
+
+void WidgetMeasure::addMeasureDisplays(std::vector<IMeasureDisplayPtr> vecMeasureDisplay)
+{
+    if (vecMeasureDisplay.empty())
+        return;
+
     // Display new measure graphics objects
+    auto gfxScene = m_guiDoc->graphicsScene();
     auto measureDisplayConfig = this->currentMeasureDisplayConfig();
-    for (IMeasureDisplayPtr& measure : vecNewMeasureDisplay) {
+    for (IMeasureDisplayPtr& measure : vecMeasureDisplay) {
         measure->update(measureDisplayConfig);
         measure->adaptGraphics(gfxScene->v3dViewer()->Driver());
         foreachGraphicsObject(measure, [=](const GraphicsObjectPtr& gfxObject) {
@@ -367,18 +426,197 @@ void WidgetMeasure::onGraphicsSelectionChanged()
         m_vecMeasureDisplay.push_back(std::move(measure));
     }
 
+    gfxScene->redraw();
+}
+
+void WidgetMeasure::runMeasureTask(MeasureType measureType, std::vector<MeasureRequest> vecRequest)
+{
+    auto task = std::make_shared<MeasureTask>();
+    task->measureType = measureType;
+    task->vecRequest = std::move(vecRequest);
+    // Measures are computed on finest BRep meshes, whatever the levels of detail displayed
+    // Faces are pinned here as the 3D view changes active triangulations in this thread
+    std::vector<TopoDS_Shape> vecShape;
+    for (const MeasureRequest& request : task->vecRequest) {
+        for (const GraphicsOwnerPtr& owner : { request.owner1, request.owner2 }) {
+            auto brepOwner = OccHandle<StdSelect_BRepOwner>::DownCast(owner);
+            if (brepOwner)
+                vecShape.push_back(brepOwner->Shape());
+        }
+    }
+
+    auto finestLevelPin = std::make_shared<BRepMeshLod::FinestLevelPin>(vecShape);
+    task->id = m_taskMgr.newTask([=](TaskProgress* progress) mutable {
+        auto _ = gsl::finally([&]{ finestLevelPin.reset(); });
+        // Requests are independent, so computed concurrently(eg sum of areas of many faces)
+        const int requestCount = int(task->vecRequest.size());
+        const double requestPortion = 100. / requestCount;
+        OSD_Parallel::For(0, requestCount, [&](int i) {
+            if (progress->isAbortRequested())
+                return;
+
+            MeasureRequest& request = task->vecRequest.at(i);
+            TaskProgress requestProgress(progress, requestPortion);
+            try {
+                if (request.owner2) {
+                    request.value = IMeasureTool_computeValue(*request.tool, measureType, request.owner1, request.owner2);
+                }
+                else {
+                    request.value = IMeasureTool_computeValue(*request.tool, measureType, request.owner1, &requestProgress);
+                    if (auto measure = std::get_if<MeasureMassProperties>(&request.value))
+                        MeasureMassProperties_applyDensity(measure, request.density);
+                }
+            } catch (const IMeasureError& err) {
+                request.errorMessage = std::string(err.message());
+            }
+        }, requestCount == 1);
+    });
+    m_taskMgr.setTitle(task->id, to_stdString(tr("Measure")));
+    m_task = task;
+    m_taskMgr.run(task->id);
+}
+
+void WidgetMeasure::abortMeasureTask()
+{
+    if (m_task) {
+        // Task results will be ignored by onTaskEnded()
+        m_taskMgr.requestAbort(m_task->id);
+        m_task.reset();
+    }
+}
+
+void WidgetMeasure::onEntityAboutToBeDestroyed(TreeNodeId entityTreeNodeId)
+{
+    // Note: GuiDocument may have already unmapped the graphics of the entity
+    auto fnIsEntityOwner = [=](const GraphicsOwnerPtr& owner) {
+        if (!owner)
+            return false;
+
+        const TreeNodeId nodeId = m_guiDoc->nodeFromGraphicsOwner(owner);
+        return nodeId == 0 || m_guiDoc->document()->modelTree().nodeRoot(nodeId) == entityTreeNodeId;
+    };
+
+    // Abort the running task as it reads the cache, requests of other entities are computed again
+    MeasureType measureType = MeasureType::None;
+    std::vector<MeasureRequest> vecRequest;
+    if (m_task) {
+        measureType = m_task->measureType;
+        for (const MeasureRequest& request : m_task->vecRequest) {
+            if (!fnIsEntityOwner(request.owner1) && !fnIsEntityOwner(request.owner2))
+                vecRequest.push_back({ request.tool, request.owner1, request.owner2, request.density });
+        }
+
+        const TaskId taskId = m_task->id;
+        this->abortMeasureTask();
+        m_taskMgr.waitForDone(taskId);
+    }
+
+    for (auto it = m_mapMeasureValue.begin(); it != m_mapMeasureValue.end();) {
+        if (fnIsEntityOwner(it->first.owner1) || fnIsEntityOwner(it->first.owner2))
+            it = m_mapMeasureValue.erase(it);
+        else
+            ++it;
+    }
+
+    m_cache->clear();
+    if (!vecRequest.empty())
+        this->runMeasureTask(measureType, std::move(vecRequest));
+
     this->updateMessagePanel();
 }
 
+void WidgetMeasure::onTaskProgressChanged(TaskId taskId, int percent)
+{
+    if (m_task && m_task->id == taskId && m_progressBarTask)
+        m_progressBarTask->setValue(percent);
+}
+
+void WidgetMeasure::onTaskEnded(TaskId taskId)
+{
+    if (!m_task || m_task->id != taskId)
+        return; // Aborted(stale) task
+
+    const std::shared_ptr<MeasureTask> task = std::move(m_task);
+    std::vector<IMeasureDisplayPtr> vecNewMeasureDisplay;
+    for (const MeasureRequest& request : task->vecRequest) {
+        if (!request.errorMessage.empty())
+            m_errorMessage = to_QString(request.errorMessage);
+
+        if (!MeasureValue_isValid(request.value))
+            continue;
+
+        m_mapMeasureValue.insert({ { task->measureType, request.owner1, request.owner2 }, request.value });
+        const bool isRequestSelected =
+            this->isSelected(request.owner1) && (!request.owner2 || this->isSelected(request.owner2));
+        if (isRequestSelected)
+            this->addMeasureDisplay(task->measureType, request, &vecNewMeasureDisplay);
+    }
+
+    this->addMeasureDisplays(std::move(vecNewMeasureDisplay));
+    this->updateMessagePanel();
+}
+
+void WidgetMeasure::addMeasureDisplay(
+        MeasureType measureType, const MeasureRequest& request, std::vector<IMeasureDisplayPtr>* vecMeasureDisplay
+    )
+{
+    auto measure = BaseMeasureDisplay::createFrom(measureType, request.value);
+    if (!measure)
+        return;
+
+    m_mapOwnerMeasureDisplay.insert({ request.owner1, measure.get() });
+    if (request.owner2)
+        m_mapOwnerMeasureDisplay.insert({ request.owner2, measure.get() });
+
+    vecMeasureDisplay->push_back(std::move(measure));
+}
+
+QuantityDensity WidgetMeasure::findMaterialDensity(const GraphicsOwnerPtr& owner) const
+{
+    auto gfxObject = GraphicsObjectPtr::DownCast(
+        owner ? owner->Selectable() : OccHandle<SelectMgr_SelectableObject>()
+    );
+    // Density is the one of the nearest material found from the node up to the root
+    const DocumentPtr& doc = m_guiDoc->document();
+    const Tree<TDF_Label>& modelTree = doc->modelTree();
+    for (TreeNodeId nodeId = m_guiDoc->nodeFromGraphicsObject(gfxObject); nodeId != 0; nodeId = modelTree.nodeParent(nodeId)) {
+        const QuantityDensity density = XCaf::shapeMaterialDensity(modelTree.nodeData(nodeId));
+        if (density.value() > 0.)
+            return density;
+    }
+
+    return {};
+}
+
 void WidgetMeasure::updateMessagePanel()
 {
     // Clear message panel
+    m_progressBarTask = nullptr;
     while (m_ui->layout_Message->count() > 0) {
         QLayoutItem* item = m_ui->layout_Message->takeAt(m_ui->layout_Message->count() - 1);
         delete item->widget();
         delete item;
     }
 
+    // Running task is reported first, it can be cancelled
+    if (m_task) {
+        auto widgetTask = new QWidget(m_ui->widget_Message);
+        auto layoutTask = new QHBoxLayout(widgetTask);
+        layoutTask->setContentsMargins(m_ui->layout_Main->contentsMargins());
+        m_progressBarTask = new QProgressBar(widgetTask);
+        m_progressBarTask->setRange(0, 100);
+        m_progressBarTask->setValue(std::max(0, m_taskMgr.progress(m_task->id)));
+        m_progressBarTask->setFormat(tr("Measure %p%"));
+        auto btnCancel = new QPushButton(tr("Cancel"), widgetTask);
+        QObject::connect(btnCancel, &QPushButton::clicked, this, [=]{
+            this->abortMeasureTask();
+            this->updateMessagePanel();
+        });
+        layoutTask->addWidget(m_progressBarTask);
+        layoutTask->addWidget(btnCancel);
+        m_ui->layout_Message->addWidget(widgetTask);
+    }
+
     // Error message takes precedence
     if (!m_errorMessage.isEmpty() || m_vecMeasureDisplay.empty()) {
         auto labelMessage = new QLabel(m_ui->widget_Message);
@@ -397,7 +635,10 @@ void WidgetMeasure::updateMessagePanel()
                     .arg(mayoTheme()->color(msgTextColorRole).name(),
                          mayoTheme()->color(msgBackgroundColorRole).name())
         );
-        const QString msg = m_errorMessage.isEmpty() ? tr("Select entities to measure") : m_errorMessage;
+        QString msg = m_errorMessage;
+        if (msg.isEmpty())
+            msg = m_task ? tr("Computing...") : tr("Select entities to measure");
+
         labelMessage->setText(msg);
     }
     else {
@@ -447,30 +688,27 @@ void WidgetMeasure::eraseMeasureDisplay(const IMeasureDisplay* measure)
 
         m_vecMeasureDisplay.erase(it);
     }
-}
 
-void WidgetMeasure::addLink(const GraphicsOwnerPtr& owner, const IMeasureDisplayPtr& measure)
-{
-    if (owner && measure)
-        m_vecLinkGfxOwnerMeasure.push_back({ owner, measure.get() });
+    // Remove links to the erased measure, it can be shared by two owners
+    for (auto itLink = m_mapOwnerMeasureDisplay.begin(); itLink != m_mapOwnerMeasureDisplay.end(); ) {
+        if (itLink->second == measure)
+            itLink = m_mapOwnerMeasureDisplay.erase(itLink);
+        else
+            ++itLink;
+    }
 }
 
-void WidgetMeasure::eraseLink(const GraphicsOwner_MeasureDisplay* link)
+bool WidgetMeasure::isSelected(const GraphicsOwnerPtr& owner) const
 {
-    if (!link)
-        return;
-
-    m_vecLinkGfxOwnerMeasure.erase(m_vecLinkGfxOwnerMeasure.begin() + (link - &m_vecLinkGfxOwnerMeasure.front()));
+    return m_setSelectedOwner.find(owner) != m_setSelectedOwner.cend();
 }
 
-const WidgetMeasure::GraphicsOwner_MeasureDisplay* WidgetMeasure::findLink(const GraphicsOwnerPtr& owner) const
+size_t WidgetMeasure::MeasureKeyHash::operator()(const MeasureKey& key) const
 {
-    auto itFound = std::find_if(
-                m_vecLinkGfxOwnerMeasure.begin(),
-                m_vecLinkGfxOwnerMeasure.end(),
-                [=](const GraphicsOwner_MeasureDisplay& link) { return link.gfxOwner == owner; }
-    );
-    return itFound != m_vecLinkGfxOwnerMeasure.end() ? &(*itFound) : nullptr;
+    size_t hash = std::hash<GraphicsOwnerPtr>{}(key.owner1);
+    hash ^= std::hash<GraphicsOwnerPtr>{}(key.owner2) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= std::hash<int>{}(int(key.measureType)) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    return hash;
 }
 
 } // namespace Mayo
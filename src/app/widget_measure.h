@@ -6,19 +6,26 @@
 
 #pragma once
 
+#include "../base/libtree.h"
 #include "../base/signal.h"
+#include "../base/task_manager.h"
+#include "../measure/measure_cache.h"
 #include "../measure/measure_display.h"
 #include "../measure/measure_tool.h"
 
 #include <QtWidgets/QWidget>
+#include <functional>
 #include <memory>
 #include <string>
 #include <string_view>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace Mayo {
 
 class GuiDocument;
+class QProgressBar;
 
 // Widget panel dedicated to measurements in 3D view
 class WidgetMeasure : public QWidget {
@@ -29,7 +36,10 @@ public:
 
     void setMeasureOn(bool on);
 
-    static void addTool(std::unique_ptr<IMeasureTool> tool);
+    // Function creating a measure tool, called for each WidgetMeasure(ie document)
+    // Tools should store their intermediate results in the cache shared by the tools of the document
+    using MeasureToolCreator = std::function<std::unique_ptr<IMeasureTool>(const std::shared_ptr<MeasureCache>&)>;
+    static void addTool(MeasureToolCreator fnCreateTool);
 
 signals:
     void sizeAdjustmentRequested();
@@ -44,34 +54,79 @@ private:
     static AreaUnit toMeasureAreaUnit(int comboBoxId);
     static VolumeUnit toMeasureVolumeUnit(int comboBoxId);
 
+    const IMeasureTool* findSupportingMeasureTool(const GraphicsObjectPtr& gfxObject, MeasureType measureType) const;
     MeasureType currentMeasureType() const;
     MeasureDisplayConfig currentMeasureDisplayConfig() const;
 
     void onGraphicsSelectionChanged();
 
-    void updateMessagePanel();
-
     using IMeasureDisplayPtr = std::unique_ptr<IMeasureDisplay>;
+    void addMeasureDisplays(std::vector<IMeasureDisplayPtr> vecMeasureDisplay);
     void eraseMeasureDisplay(const IMeasureDisplay* measure);
 
-    // Provides link between GraphicsOwner and IMeasureDisplay object
-    struct GraphicsOwner_MeasureDisplay {
-        GraphicsOwnerPtr gfxOwner;
-        const IMeasureDisplay* measureDisplay = nullptr;
+    // Measure of one entity(null 'owner2') or of two entities, to be computed or already computed
+    struct MeasureRequest {
+        const IMeasureTool* tool = nullptr;
+        GraphicsOwnerPtr owner1;
+        GraphicsOwnerPtr owner2;
+        QuantityDensity density; // Material density, relevant for mass properties only
+        // Results written by the task, to be read only once the task has ended
+        MeasureValue value;
+        std::string errorMessage;
+    };
+
+    // Measures are computed in a task, as some of them can be long with complex models
+    // Requests are computed concurrently, results are delivered in the GUI thread by onTaskEnded()
+    // Only one task is current, any previous one is aborted and its results are ignored. The task
+    // can be cancelled from the message panel
+    struct MeasureTask {
+        TaskId id = TaskId_null;
+        MeasureType measureType = MeasureType::None;
+        std::vector<MeasureRequest> vecRequest;
+    };
+    void runMeasureTask(MeasureType measureType, std::vector<MeasureRequest> vecRequest);
+    void abortMeasureTask();
+    void onEntityAboutToBeDestroyed(TreeNodeId entityTreeNodeId);
+    void onTaskProgressChanged(TaskId taskId, int percent);
+    void onTaskEnded(TaskId taskId);
+    void addMeasureDisplay(MeasureType measureType, const MeasureRequest& request, std::vector<IMeasureDisplayPtr>* vecMeasureDisplay);
+    QuantityDensity findMaterialDensity(const GraphicsOwnerPtr& owner) const;
+    bool isSelected(const GraphicsOwnerPtr& owner) const;
+
+    void updateMessagePanel();
+
+    // Key of memoized measure values
+    struct MeasureKey {
+        MeasureType measureType;
+        GraphicsOwnerPtr owner1;
+        GraphicsOwnerPtr owner2;
+        bool operator==(const MeasureKey& other) const {
+            return measureType == other.measureType && owner1 == other.owner1 && owner2 == other.owner2;
+        }
+    };
+    struct MeasureKeyHash {
+        size_t operator()(const MeasureKey& key) const;
     };
-    void addLink(const GraphicsOwnerPtr& owner, const IMeasureDisplayPtr& measure);
-    void eraseLink(const GraphicsOwner_MeasureDisplay* link);
-    const GraphicsOwner_MeasureDisplay* findLink(const GraphicsOwnerPtr& owner) const;
 
     // -- Attributes
     class Ui_WidgetMeasure* m_ui = nullptr;
     GuiDocument* m_guiDoc = nullptr;
+    std::shared_ptr<MeasureCache> m_cache;
+    std::vector<std::unique_ptr<IMeasureTool>> m_vecTool;
     std::vector<GraphicsOwnerPtr> m_vecSelectedOwner;
+    std::unordered_set<GraphicsOwnerPtr> m_setSelectedOwner;
     std::vector<IMeasureDisplayPtr> m_vecMeasureDisplay;
-    std::vector<GraphicsOwner_MeasureDisplay> m_vecLinkGfxOwnerMeasure;
-    IMeasureTool* m_tool = nullptr;
+    // Links between GraphicsOwner and the IMeasureDisplay objects created for it
+    std::unordered_multimap<GraphicsOwnerPtr, const IMeasureDisplay*> m_mapOwnerMeasureDisplay;
+    // Valid measure values computed so far, cleared when measure mode is switched off
+    // Values of an entity are erased when it gets destroyed
+    std::unordered_map<MeasureKey, MeasureValue, MeasureKeyHash> m_mapMeasureValue;
     QString m_errorMessage;
     SignalConnectionHandle m_connGraphicsSelectionChanged;
+    SignalConnectionHandle m_connEntityAboutToBeDestroyed;
+    TaskManager m_taskMgr;
+    std::shared_ptr<MeasureTask> m_task; // Null if no task is running
+    QProgressBar* m_progressBarTask = nullptr;
 };
 
 } // namespace Mayo
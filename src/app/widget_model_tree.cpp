@@ -379,6 +379,7 @@ void WidgetModelTree::onTreeWidgetDocumentSelectionChanged(
         vecDeselected.push_back(Internal::toApplicationItem(treeItem));
     }
 
+    ApplicationItemSelectionModel::BatchScope batchScope(m_guiApp->selectionModel());
     m_guiApp->selectionModel()->add(vecSelected);
     m_guiApp->selectionModel()->remove(vecDeselected);
 }
@@ -389,23 +390,36 @@ void WidgetModelTree::onApplicationItemSelectionModelChanged(
     this->connectTreeWidgetDocumentSelectionChanged(false);
     auto _ = gsl::finally([=] { this->connectTreeWidgetDocumentSelectionChanged(true); });
 
-    auto fnSetSelected = [=](Span<const ApplicationItem> spanAppItem, bool on) {
+    // Selection state to apply on tree items, deselection takes precedence
+    std::unordered_map<ApplicationItem, bool> mapAppItemSelected;
+    auto fnSetSelected = [&](Span<const ApplicationItem> spanAppItem, bool on) {
         for (const ApplicationItem& appItem : spanAppItem) {
-            if (!appItem.isDocumentTreeNode())
-                continue;
-
-            QTreeWidgetItem* treeItem = this->findTreeItem(appItem.documentTreeNode());
-            if (!treeItem)
-                continue;
-
-            treeItem->setSelected(on);
-            if (on)
-                m_ui->treeWidget_Model->scrollToItem(treeItem);
+            if (appItem.isDocumentTreeNode())
+                mapAppItemSelected[appItem] = on;
         }
     };
-
     fnSetSelected(selected, true);
     fnSetSelected(deselected, false);
+
+    // Single traversal of the tree widget, whatever the count of items
+    QTreeWidgetItem* lastSelectedTreeItem = nullptr;
+    for (QTreeWidgetItemIterator it(m_ui->treeWidget_Model); *it && !mapAppItemSelected.empty(); ++it) {
+        const DocumentTreeNode node = Internal::treeItemDocumentTreeNode(*it);
+        if (!node.isValid())
+            continue;
+
+        auto itAppItem = mapAppItemSelected.find(ApplicationItem(node));
+        if (itAppItem != mapAppItemSelected.end()) {
+            (*it)->setSelected(itAppItem->second);
+            if (itAppItem->second)
+                lastSelectedTreeItem = *it;
+
+            mapAppItemSelected.erase(itAppItem);
+        }
+    }
+
+    if (lastSelectedTreeItem)
+        m_ui->treeWidget_Model->scrollToItem(lastSelectedTreeItem);
 }
 
 void WidgetModelTree::connectTreeModelDataChanged(bool on)
@@ -16,7 +16,7 @@ namespace Mayo {
 
 bool WidgetModelTreeBuilder_Mesh::supportsDocumentTreeNode(const DocumentTreeNode& node) const
 {
-    return GraphicsMeshObjectDriver::meshSupportStatus(node.label()) == GraphicsObjectDriver::Support::Complete;
+    return GraphicsMeshObjectDriver::meshSupportStatus(node.labelDataFlags()) == GraphicsObjectDriver::Support::Complete;
 }
 
 QTreeWidgetItem* WidgetModelTreeBuilder_Mesh::createTreeItem(const DocumentTreeNode& node)
@@ -82,7 +82,7 @@ private:
 
 bool WidgetModelTreeBuilder_Xde::supportsDocumentTreeNode(const DocumentTreeNode& node) const
 {
-    return GraphicsShapeObjectDriver::shapeSupportStatus(node.label()) == GraphicsObjectDriver::Support::Complete;
+    return GraphicsShapeObjectDriver::shapeSupportStatus(node.labelDataFlags()) == GraphicsObjectDriver::Support::Complete;
 }
 
 void WidgetModelTreeBuilder_Xde::refreshTextTreeItem(
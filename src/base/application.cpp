@@ -14,6 +14,7 @@
 #include <BinXCAFDrivers_DocumentStorageDriver.hxx>
 #include <XmlXCAFDrivers_DocumentRetrievalDriver.hxx>
 #include <XmlXCAFDrivers_DocumentStorageDriver.hxx>
+#include <Message.hxx>
 #if OCC_VERSION_HEX < OCC_VERSION_CHECK(7, 5, 0)
 #  include <CDF_Session.hxx>
 #endif
@@ -91,10 +92,31 @@ DocumentPtr Application::openDocument(const FilePath& filepath, PCDM_ReaderStatu
         *ptrReadStatus = readStatus;
 
     DocumentPtr doc = DocumentPtr::DownCast(stdDoc);
-    this->addDocument(doc);
+    if (doc.IsNull())
+        return doc;
+
+    // With OpenCascade >= v7.6.0 the document was already added when created by the retrieval driver
+    if (this->findDocumentByIdentifier(doc->identifier()) != doc)
+        this->addDocument(doc);
+
+    doc->setName(filepath.filename().u8string());
+    doc->setFilePath(filepath);
+    doc->rebuildModelTree();
+    for (const TreeNodeId entityId : doc->modelTree().roots())
+        doc->signalEntityAdded.send(entityId);
+
     return doc;
 }
 
+PCDM_StoreStatus Application::saveDocument(const DocumentPtr& doc, const FilePath& filepath)
+{
+    const PCDM_StoreStatus storeStatus = this->SaveAs(doc, filepathTo<TCollection_ExtendedString>(filepath));
+    if (storeStatus == PCDM_SS_OK)
+        doc->setFilePath(filepath);
+
+    return storeStatus;
+}
+
 DocumentPtr Application::findDocumentByIndex(int docIndex) const
 {
     OccHandle<TDocStd_Document> doc;
@@ -142,10 +164,15 @@ void Application::closeDocument(const DocumentPtr& doc)
 void Application::defineMayoFormat(const ApplicationPtr& app)
 {
     const char strFougueCopyright[] = "Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>";
+    OccHandle<BinXCAFDrivers_DocumentStorageDriver> binStorageDriver = new BinXCAFDrivers_DocumentStorageDriver;
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+    // Embed triangulations of BRep shapes, avoids meshing when a document is reopened
+    binStorageDriver->SetWithTriangles(Message::DefaultMessenger(), true);
+#endif
     app->DefineFormat(
         Document::NameFormatBinary, ApplicationI18N::textIdTr("Binary Mayo Document Format").data(), "myb",
         new Document::FormatBinaryRetrievalDriver(app),
-        new BinXCAFDrivers_DocumentStorageDriver
+        binStorageDriver
     );
     app->DefineFormat(
         Document::NameFormatXml, ApplicationI18N::textIdTr("XML Mayo Document Format").data(), "myx",
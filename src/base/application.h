@@ -39,6 +39,10 @@ public:
     int documentCount() const;
     DocumentPtr newDocument(Document::Format docFormat = Document::Format::Binary);
     DocumentPtr openDocument(const FilePath& filepath, PCDM_ReaderStatus* ptrReadStatus = nullptr);
+    // Stores 'doc' in file 'filepath' using the storage format of the document(see Document::Format)
+    // With binary format, BRep triangulations are stored too(requires OpenCascade >= v7.6.0), so
+    // the document can be displayed once reopened without meshing again
+    PCDM_StoreStatus saveDocument(const DocumentPtr& doc, const FilePath& filepath);
     DocumentPtr findDocumentByIndex(int docIndex) const;
     DocumentPtr findDocumentByIdentifier(Document::Identifier docIdent) const;
     DocumentPtr findDocumentByLocation(const FilePath& location) const;
@@ -6,90 +6,130 @@
 
 #include "application_item_selection_model.h"
 
-namespace Mayo {
-
-namespace Internal {
-
-static bool hasApplicationItem(Span<ApplicationItem> vec, const ApplicationItem& item)
-{
-    auto itFound = std::find(vec.begin(), vec.end(), item);
-    return itFound != vec.end();
-}
-
-static std::vector<ApplicationItem>::iterator findApplicationItem(
-        std::vector<ApplicationItem>& vec, const ApplicationItem& item)
-{
-    return std::find(vec.begin(), vec.end(), item);
-}
+#include <algorithm>
+#include <unordered_set>
 
-} // namespace Internal
+namespace Mayo {
 
 Span<const ApplicationItem> ApplicationItemSelectionModel::selectedItems() const
 {
     return m_vecSelectedItem;
 }
 
-bool ApplicationItemSelectionModel::isSelected(const ApplicationItem& item)
+bool ApplicationItemSelectionModel::isSelected(const ApplicationItem& item) const
 {
-    return Internal::hasApplicationItem(m_vecSelectedItem, item);
+    return m_mapItemPos.find(item) != m_mapItemPos.cend();
 }
 
 void ApplicationItemSelectionModel::add(const ApplicationItem& item)
 {
-    if (!Internal::hasApplicationItem(m_vecSelectedItem, item)) {
-        m_vecSelectedItem.push_back(item);
-        std::vector<ApplicationItem> vecItem = { item };
-        this->signalChanged.send(vecItem, {});
-    }
+    this->add(Span<const ApplicationItem>(&item, 1));
 }
 
-void ApplicationItemSelectionModel::add(Span<ApplicationItem> vecItem)
+void ApplicationItemSelectionModel::add(Span<const ApplicationItem> spanItem)
 {
     std::vector<ApplicationItem> signalVecItem;
-    for (const ApplicationItem& item : vecItem) {
-        if (!Internal::hasApplicationItem(m_vecSelectedItem, item)) {
+    for (const ApplicationItem& item : spanItem) {
+        if (m_mapItemPos.insert({ item, m_vecSelectedItem.size() }).second) {
             m_vecSelectedItem.push_back(item);
             signalVecItem.push_back(item);
         }
     }
 
     if (!signalVecItem.empty())
-        this->signalChanged.send(signalVecItem, {});
+        this->notifyChanged(std::move(signalVecItem), {});
 }
 
 void ApplicationItemSelectionModel::remove(const ApplicationItem& item)
 {
-    auto itFound = Internal::findApplicationItem(m_vecSelectedItem, item);
-    if (itFound != m_vecSelectedItem.end()) {
-        m_vecSelectedItem.erase(itFound);
-        std::vector<ApplicationItem> vecItem = { item };
-        this->signalChanged.send({}, vecItem);
-    }
+    this->remove(Span<const ApplicationItem>(&item, 1));
 }
 
-void ApplicationItemSelectionModel::remove(Span<ApplicationItem> vecItem)
+void ApplicationItemSelectionModel::remove(Span<const ApplicationItem> spanItem)
 {
     std::vector<ApplicationItem> signalVecItem;
-    for (const ApplicationItem& item : vecItem) {
-        auto itFound = Internal::findApplicationItem(m_vecSelectedItem, item);
-        if (itFound != m_vecSelectedItem.end()) {
-            m_vecSelectedItem.erase(itFound);
+    size_t firstErasedPos = m_vecSelectedItem.size();
+    for (const ApplicationItem& item : spanItem) {
+        auto itFound = m_mapItemPos.find(item);
+        if (itFound != m_mapItemPos.end()) {
+            firstErasedPos = std::min(firstErasedPos, itFound->second);
+            m_mapItemPos.erase(itFound);
             signalVecItem.push_back(item);
         }
     }
 
-    if (!signalVecItem.empty())
-        this->signalChanged.send({}, signalVecItem);
+    if (signalVecItem.empty())
+        return;
+
+    // Erase in one pass the items not indexed anymore, keeping selection order
+    auto itEnd = std::remove_if(
+        m_vecSelectedItem.begin() + firstErasedPos, m_vecSelectedItem.end(),
+        [=](const ApplicationItem& item) { return m_mapItemPos.find(item) == m_mapItemPos.cend(); }
+    );
+    m_vecSelectedItem.erase(itEnd, m_vecSelectedItem.end());
+    this->rebuildIndex(firstErasedPos);
+    this->notifyChanged({}, std::move(signalVecItem));
 }
 
 void ApplicationItemSelectionModel::clear()
 {
     if (!m_vecSelectedItem.empty()) {
         // Warning: slots connected to changed() signal may indirectly access m_vecSelectedItem
-        const auto vecDeselectedItem = m_vecSelectedItem;
+        auto vecDeselectedItem = std::move(m_vecSelectedItem);
         m_vecSelectedItem.clear();
-        this->signalChanged.send({}, vecDeselectedItem);
+        m_mapItemPos.clear();
+        this->notifyChanged({}, std::move(vecDeselectedItem));
+    }
+}
+
+void ApplicationItemSelectionModel::beginBatch()
+{
+    ++m_batchDepth;
+}
+
+void ApplicationItemSelectionModel::endBatch()
+{
+    if (m_batchDepth == 0 || --m_batchDepth > 0)
+        return;
+
+    // Drop items whose selection state finally didn't change
+    std::unordered_set<ApplicationItem> setItem;
+    std::vector<ApplicationItem> vecSelected;
+    for (const ApplicationItem& item : m_vecBatchSelected) {
+        if (this->isSelected(item) && setItem.insert(item).second)
+            vecSelected.push_back(item);
     }
+
+    setItem.clear();
+    std::vector<ApplicationItem> vecDeselected;
+    for (const ApplicationItem& item : m_vecBatchDeselected) {
+        if (!this->isSelected(item) && setItem.insert(item).second)
+            vecDeselected.push_back(item);
+    }
+
+    m_vecBatchSelected.clear();
+    m_vecBatchDeselected.clear();
+    if (!vecSelected.empty() || !vecDeselected.empty())
+        this->signalChanged.send(vecSelected, vecDeselected);
+}
+
+void ApplicationItemSelectionModel::notifyChanged(
+        std::vector<ApplicationItem>&& vecSelected, std::vector<ApplicationItem>&& vecDeselected
+    )
+{
+    if (m_batchDepth > 0) {
+        m_vecBatchSelected.insert(m_vecBatchSelected.end(), vecSelected.begin(), vecSelected.end());
+        m_vecBatchDeselected.insert(m_vecBatchDeselected.end(), vecDeselected.begin(), vecDeselected.end());
+    }
+    else {
+        this->signalChanged.send(vecSelected, vecDeselected);
+    }
+}
+
+void ApplicationItemSelectionModel::rebuildIndex(size_t firstPos)
+{
+    for (size_t pos = firstPos; pos < m_vecSelectedItem.size(); ++pos)
+        m_mapItemPos[m_vecSelectedItem.at(pos)] = pos;
 }
 
 } // namespace Mayo
@@ -10,28 +10,57 @@
 #include "signal.h"
 #include "span.h"
 
+#include <unordered_map>
+#include <vector>
+
 namespace Mayo {
 
 // Keeps track of the items selected in an Application object
+// Selected items are kept in selection order, membership queries are done in constant time
 class ApplicationItemSelectionModel {
 public:
     Span<const ApplicationItem> selectedItems() const;
 
-    bool isSelected(const ApplicationItem& item);
+    bool isSelected(const ApplicationItem& item) const;
 
     void add(const ApplicationItem& item);
-    void add(Span<ApplicationItem> vecItem);
+    void add(Span<const ApplicationItem> spanItem);
     void remove(const ApplicationItem& item);
-    void remove(Span<ApplicationItem> vecItem);
+    void remove(Span<const ApplicationItem> spanItem);
 //    void toggle(const ApplicationItem& item);
 //    void toggle(Span<ApplicationItem> item);
 
     void clear();
 
+    // Changes done between beginBatch() and endBatch() are notified with a single emission of
+    // signalChanged. Calls can be nested, notification occurs at the outermost endBatch()
+    void beginBatch();
+    void endBatch();
+
+    // Calls beginBatch()/endBatch() in its constructor/destructor
+    class BatchScope {
+    public:
+        BatchScope(ApplicationItemSelectionModel* model) : m_model(model) { m_model->beginBatch(); }
+        ~BatchScope() { m_model->endBatch(); }
+
+        BatchScope(const BatchScope&) = delete;
+        BatchScope& operator=(const BatchScope&) = delete;
+
+    private:
+        ApplicationItemSelectionModel* m_model = nullptr;
+    };
+
     Signal<Span<const ApplicationItem>, Span<const ApplicationItem>> signalChanged;
 
 private:
+    void notifyChanged(std::vector<ApplicationItem>&& vecSelected, std::vector<ApplicationItem>&& vecDeselected);
+    void rebuildIndex(size_t firstPos);
+
     std::vector<ApplicationItem> m_vecSelectedItem;
+    std::unordered_map<ApplicationItem, size_t> m_mapItemPos; // Position in m_vecSelectedItem
+    int m_batchDepth = 0;
+    std::vector<ApplicationItem> m_vecBatchSelected;
+    std::vector<ApplicationItem> m_vecBatchDeselected;
 };
 
 } // namespace Mayo
@@ -0,0 +1,232 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "assembly_graph.h"
+
+#include "xcaf.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace Mayo {
+
+AssemblyGraph::OccurrenceId AssemblyGraph::addRoot(const TDF_Label& label)
+{
+    const OccurrenceId rootId = this->addOccurrence(0, label);
+    m_vecRoot.push_back(rootId);
+
+    // Expand new products, each one being expanded only once
+    while (!m_vecProductToExpand.empty()) {
+        const ProductId productId = m_vecProductToExpand.back();
+        m_vecProductToExpand.pop_back();
+        const TDF_Label productLabel = this->product(productId).label;
+        if (!XCaf::isShapeAssembly(productLabel))
+            continue;
+
+        for (const TDF_Label& componentLabel : XCaf::shapeComponents(productLabel)) {
+            const OccurrenceId occurrenceId = this->addOccurrence(productId, componentLabel);
+            m_vecProduct.at(productId - 1).vecChildOccurrence.push_back(occurrenceId);
+        }
+    }
+
+    return rootId;
+}
+
+void AssemblyGraph::removeRoot(OccurrenceId rootId)
+{
+    auto itRoot = std::find(m_vecRoot.begin(), m_vecRoot.end(), rootId);
+    if (itRoot == m_vecRoot.end())
+        return;
+
+    m_vecRoot.erase(itRoot);
+    // Products whose last occurrence is removed release their own child occurrences
+    std::vector<OccurrenceId> vecOccurrenceToRemove = { rootId };
+    while (!vecOccurrenceToRemove.empty()) {
+        const OccurrenceId occurrenceId = vecOccurrenceToRemove.back();
+        vecOccurrenceToRemove.pop_back();
+        const ProductId productId = this->occurrence(occurrenceId).product;
+        m_vecOccurrence.at(occurrenceId - 1) = {};
+        m_vecFreeOccurrenceId.push_back(occurrenceId);
+        if (--m_vecProductUseCount.at(productId - 1) > 0)
+            continue;
+
+        Product& product = m_vecProduct.at(productId - 1);
+        for (OccurrenceId childId : product.vecChildOccurrence)
+            vecOccurrenceToRemove.push_back(childId);
+
+        m_mapLabelProduct.erase(product.label);
+        product = {};
+        m_vecFreeProductId.push_back(productId);
+    }
+}
+
+void AssemblyGraph::clear()
+{
+    m_vecProduct.clear();
+    m_vecProductUseCount.clear();
+    m_vecFreeProductId.clear();
+    m_vecOccurrence.clear();
+    m_vecFreeOccurrenceId.clear();
+    m_vecRoot.clear();
+    m_mapLabelProduct.clear();
+    m_vecProductToExpand.clear();
+}
+
+AssemblyGraph::ProductId AssemblyGraph::findProduct(const TDF_Label& label) const
+{
+    auto it = m_mapLabelProduct.find(label);
+    return it != m_mapLabelProduct.cend() ? it->second : 0;
+}
+
+uint64_t AssemblyGraph::occurrencePathCount() const
+{
+    // Count of occurrence paths below each product, computed bottom-up with an explicit stack
+    constexpr uint64_t Unknown = UINT64_MAX;
+    std::vector<uint64_t> vecProductPathCount(m_vecProduct.size(), Unknown);
+    std::vector<ProductId> stack;
+    auto fnProductPathCount = [&](ProductId rootProductId) {
+        stack.push_back(rootProductId);
+        while (!stack.empty()) {
+            const ProductId productId = stack.back();
+            uint64_t count = 0;
+            bool childrenCounted = true;
+            for (OccurrenceId childId : this->product(productId).vecChildOccurrence) {
+                const ProductId childProductId = this->occurrence(childId).product;
+                const uint64_t childCount = vecProductPathCount.at(childProductId - 1);
+                if (childCount == Unknown) {
+                    stack.push_back(childProductId);
+                    childrenCounted = false;
+                }
+                else {
+                    count += 1 + childCount;
+                }
+            }
+
+            if (childrenCounted) {
+                vecProductPathCount.at(productId - 1) = count;
+                stack.pop_back();
+            }
+        }
+
+        return vecProductPathCount.at(rootProductId - 1);
+    };
+
+    uint64_t count = 0;
+    for (OccurrenceId rootId : m_vecRoot)
+        count += 1 + fnProductPathCount(this->occurrence(rootId).product);
+
+    return count;
+}
+
+TopLoc_Location AssemblyGraph::absoluteLocation(OccurrencePath path) const
+{
+    TopLoc_Location location;
+    for (OccurrenceId id : path)
+        location = location * this->occurrence(id).location;
+
+    return location;
+}
+
+void AssemblyGraph::traverseOccurrencePaths(const std::function<bool(OccurrencePath)>& fn) const
+{
+    for (OccurrenceId rootId : m_vecRoot)
+        this->traverseOccurrencePaths(rootId, fn);
+}
+
+void AssemblyGraph::traverseOccurrencePaths(OccurrenceId rootId, const std::function<bool(OccurrencePath)>& fn) const
+{
+    // Each stack item is an occurrence path and the index of the next child occurrence to visit
+    std::vector<OccurrenceId> path;
+    std::vector<size_t> stackChildIndex;
+    path.push_back(rootId);
+    stackChildIndex.push_back(fn(path) ? 0 : SIZE_MAX);
+    while (!path.empty()) {
+        const Product& product = this->product(this->occurrence(path.back()).product);
+        size_t& childIndex = stackChildIndex.back();
+        if (childIndex >= product.vecChildOccurrence.size()) {
+            path.pop_back();
+            stackChildIndex.pop_back();
+            continue;
+        }
+
+        path.push_back(product.vecChildOccurrence.at(childIndex++));
+        const bool visitChildren = fn(path);
+        stackChildIndex.push_back(visitChildren ? 0 : SIZE_MAX);
+    }
+}
+
+void AssemblyGraph::traverseProducts(OccurrenceId rootId, const std::function<void(ProductId)>& fn) const
+{
+    std::vector<bool> vecProductVisited(m_vecProduct.size(), false);
+    std::vector<ProductId> stack = { this->occurrence(rootId).product };
+    while (!stack.empty()) {
+        const ProductId productId = stack.back();
+        stack.pop_back();
+        if (vecProductVisited.at(productId - 1))
+            continue;
+
+        vecProductVisited.at(productId - 1) = true;
+        fn(productId);
+        const std::vector<OccurrenceId>& vecChild = this->product(productId).vecChildOccurrence;
+        for (auto it = vecChild.rbegin(); it != vecChild.rend(); ++it)
+            stack.push_back(this->occurrence(*it).product);
+    }
+}
+
+AssemblyGraph::OccurrenceId AssemblyGraph::addOccurrence(ProductId parentId, const TDF_Label& label)
+{
+    // Mirrors Document model tree: a reference node is followed by the node of the referred product
+    Occurrence occurrence;
+    occurrence.parent = parentId;
+    occurrence.label = label;
+    occurrence.location = XCaf::shapeReferenceLocation(label);
+    if (XCaf::isShapeReference(label)) {
+        const TDF_Label referredLabel = XCaf::shapeReferred(label);
+        occurrence.product = this->findOrAddProduct(referredLabel);
+        occurrence.location = occurrence.location * XCaf::shapeReferenceLocation(referredLabel);
+    }
+    else {
+        occurrence.product = this->findOrAddProduct(label);
+    }
+
+    if (!m_vecFreeOccurrenceId.empty()) {
+        const OccurrenceId occurrenceId = m_vecFreeOccurrenceId.back();
+        m_vecFreeOccurrenceId.pop_back();
+        m_vecOccurrence.at(occurrenceId - 1) = std::move(occurrence);
+        return occurrenceId;
+    }
+
+    m_vecOccurrence.push_back(std::move(occurrence));
+    return OccurrenceId(m_vecOccurrence.size());
+}
+
+AssemblyGraph::ProductId AssemblyGraph::findOrAddProduct(const TDF_Label& label)
+{
+    auto it = m_mapLabelProduct.find(label);
+    if (it != m_mapLabelProduct.cend()) {
+        ++m_vecProductUseCount.at(it->second - 1);
+        return it->second;
+    }
+
+    ProductId productId = 0;
+    if (!m_vecFreeProductId.empty()) {
+        productId = m_vecFreeProductId.back();
+        m_vecFreeProductId.pop_back();
+        m_vecProduct.at(productId - 1) = Product{ label, {} };
+        m_vecProductUseCount.at(productId - 1) = 1;
+    }
+    else {
+        m_vecProduct.push_back(Product{ label, {} });
+        m_vecProductUseCount.push_back(1);
+        productId = ProductId(m_vecProduct.size());
+    }
+
+    m_mapLabelProduct.insert({ label, productId });
+    m_vecProductToExpand.push_back(productId);
+    return productId;
+}
+
+} // namespace Mayo
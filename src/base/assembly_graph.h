@@ -0,0 +1,98 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "caf_utils.h"
+#include "span.h"
+
+#include <TDF_Label.hxx>
+#include <TDF_LabelSequence.hxx>
+#include <TopLoc_Location.hxx>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace Mayo {
+
+// Instance-aware representation of XCAF assemblies
+//
+// Unlike the model tree of Document where references are recursively expanded, a product(ie an
+// assembly or a simple shape) is stored once whatever the count of its instances. An occurrence is
+// a lightweight record linking a parent product to a referred product with a placement
+// Paths of occurrences from the roots(ie the nodes of the expanded tree) are computed on demand
+// Building and traversal are iterative, so deep assemblies can't overflow the call stack
+class AssemblyGraph {
+public:
+    // Identifiers are indexes starting at 1, 0 refers to null product/occurrence
+    using ProductId = uint32_t;
+    using OccurrenceId = uint32_t;
+    using OccurrencePath = Span<const OccurrenceId>;
+
+    struct Product {
+        TDF_Label label;
+        std::vector<OccurrenceId> vecChildOccurrence;
+    };
+
+    struct Occurrence {
+        ProductId parent = 0; // Null for root occurrences
+        ProductId product = 0;
+        TDF_Label label; // Component(reference) label, or product label if not a reference
+        TopLoc_Location location; // Relative to parent product
+    };
+
+    // Adds root occurrence for 'label'(typically a top-level free shape) and the products it
+    // depends on. Products already in the graph are not expanded again
+    OccurrenceId addRoot(const TDF_Label& label);
+    // Removes root occurrence 'rootId' along with the products no longer used by other occurrences
+    // Identifiers of removed items are reused by next calls to addRoot()
+    void removeRoot(OccurrenceId rootId);
+    void clear();
+
+    Span<const OccurrenceId> roots() const { return m_vecRoot; }
+
+    // Count of products in the graph. Identifiers range from 1 to lastProductId(), removed products
+    // having a null label
+    int productCount() const { return int(m_vecProduct.size() - m_vecFreeProductId.size()); }
+    ProductId lastProductId() const { return ProductId(m_vecProduct.size()); }
+    const Product& product(ProductId id) const { return m_vecProduct.at(id - 1); }
+    ProductId findProduct(const TDF_Label& label) const;
+
+    int occurrenceCount() const { return int(m_vecOccurrence.size() - m_vecFreeOccurrenceId.size()); }
+    const Occurrence& occurrence(OccurrenceId id) const { return m_vecOccurrence.at(id - 1); }
+
+    // Count of occurrence paths, ie count of occurrences once all instances are expanded
+    uint64_t occurrencePathCount() const;
+
+    // Location of the last occurrence in 'path' relative to the root
+    TopLoc_Location absoluteLocation(OccurrencePath path) const;
+
+    // Depth-first traversal of all occurrence paths, starting from root occurrences
+    // 'fn' is called with the path of the current occurrence(the last item) and returns false to
+    // skip its sub-occurrences
+    void traverseOccurrencePaths(const std::function<bool(OccurrencePath)>& fn) const;
+    void traverseOccurrencePaths(OccurrenceId rootId, const std::function<bool(OccurrencePath)>& fn) const;
+
+    // Depth-first traversal of the products below root occurrence 'rootId', each product being
+    // visited once whatever the count of its occurrences
+    void traverseProducts(OccurrenceId rootId, const std::function<void(ProductId)>& fn) const;
+
+private:
+    OccurrenceId addOccurrence(ProductId parentId, const TDF_Label& label);
+    ProductId findOrAddProduct(const TDF_Label& label);
+
+    std::vector<Product> m_vecProduct;
+    std::vector<int> m_vecProductUseCount; // Count of occurrences referring to each product
+    std::vector<ProductId> m_vecFreeProductId;
+    std::vector<Occurrence> m_vecOccurrence;
+    std::vector<OccurrenceId> m_vecFreeOccurrenceId;
+    std::vector<OccurrenceId> m_vecRoot;
+    std::unordered_map<TDF_Label, ProductId> m_mapLabelProduct;
+    std::vector<ProductId> m_vecProductToExpand;
+};
+
+} // namespace Mayo
@@ -0,0 +1,225 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "brep_bnd_box_cache.h"
+
+#include "assembly_graph.h"
+#include "bnd_utils.h"
+#include "brep_mesh_lod.h"
+#include "xcaf.h"
+
+#include <BRepBndLib.hxx>
+#include <OSD_Parallel.hxx>
+#include <TopExp_Explorer.hxx>
+
+#include <vector>
+
+namespace Mayo {
+
+namespace {
+
+// Minimum count of faces in a shape so that optimal box computation is split in parallel tasks
+constexpr size_t ParallelFaceCountThreshold = 8;
+
+Bnd_Box computeBndBox(const TopoDS_Shape& shape, BRepBndBoxCache::Mode mode, bool useParallel)
+{
+    Bnd_Box bndBox;
+    if (shape.IsNull())
+        return bndBox;
+
+    if (mode == BRepBndBoxCache::Mode::Fast) {
+        BRepBndLib::Add(shape, bndBox, true/*useTriangulation*/);
+        return bndBox;
+    }
+
+    std::vector<TopoDS_Shape> vecFace;
+    if (useParallel) {
+        for (TopExp_Explorer expl(shape, TopAbs_FACE); expl.More(); expl.Next())
+            vecFace.push_back(expl.Current());
+    }
+
+    if (vecFace.size() < ParallelFaceCountThreshold) {
+        BRepBndLib::AddOptimal(shape, bndBox);
+        return bndBox;
+    }
+
+    std::vector<Bnd_Box> vecFaceBndBox(vecFace.size());
+    OSD_Parallel::For(0, int(vecFace.size()), [&](int i) {
+        BRepBndLib::AddOptimal(vecFace.at(i), vecFaceBndBox.at(i));
+    });
+    for (const Bnd_Box& faceBndBox : vecFaceBndBox)
+        BndUtils::add(&bndBox, faceBndBox);
+
+    // Edges and vertices not bound to faces
+    for (TopExp_Explorer expl(shape, TopAbs_EDGE, TopAbs_FACE); expl.More(); expl.Next())
+        BRepBndLib::AddOptimal(expl.Current(), bndBox);
+
+    for (TopExp_Explorer expl(shape, TopAbs_VERTEX, TopAbs_EDGE); expl.More(); expl.Next())
+        BRepBndLib::AddOptimal(expl.Current(), bndBox);
+
+    return bndBox;
+}
+
+// Whether a box transformed by 'loc' stays as tight as the box of the located shape
+bool isExactlyTransformable(const TopLoc_Location& loc)
+{
+    if (loc.IsIdentity())
+        return true;
+
+    const gp_TrsfForm form = loc.Transformation().Form();
+    return form == gp_Identity || form == gp_Translation;
+}
+
+} // namespace
+
+Bnd_Box BRepBndBoxCache::get(const TopoDS_Shape& shape)
+{
+    return this->get(Span<const TopoDS_Shape>(&shape, 1));
+}
+
+Bnd_Box BRepBndBoxCache::get(Span<const TopoDS_Shape> spanShape)
+{
+    // Optimal boxes of rotated(or scaled) instances are computed from the located shapes
+    std::vector<TopoDS_Shape> vecShapeCached;
+    std::vector<TopoDS_Shape> vecShapeUncached;
+    for (const TopoDS_Shape& shape : spanShape) {
+        if (shape.IsNull())
+            continue;
+
+        if (m_mode == Mode::Optimal && !isExactlyTransformable(shape.Location()))
+            vecShapeUncached.push_back(shape);
+        else
+            vecShapeCached.push_back(shape);
+    }
+
+    const MapBndBox mapBndBox = this->findOrCompute(vecShapeCached);
+    const bool isSingleShape = vecShapeUncached.size() == 1;
+    std::vector<Bnd_Box> vecBndBoxUncached(vecShapeUncached.size());
+    OSD_Parallel::For(0, int(vecShapeUncached.size()), [&](int i) {
+        vecBndBoxUncached.at(i) = computeBndBox(vecShapeUncached.at(i), m_mode, isSingleShape/*useParallel*/);
+    }, isSingleShape/*forceSingleThreadExecution*/);
+
+    Bnd_Box bndBox;
+    for (const Bnd_Box& shapeBndBox : vecBndBoxUncached)
+        BndUtils::add(&bndBox, shapeBndBox);
+
+    for (const TopoDS_Shape& shape : vecShapeCached) {
+        const Bnd_Box& shapeBndBox = mapBndBox.at(shape.TShape().get());
+        if (shape.Location().IsIdentity())
+            BndUtils::add(&bndBox, shapeBndBox);
+        else
+            BndUtils::add(&bndBox, shapeBndBox.Transformed(shape.Location().Transformation()));
+    }
+
+    return bndBox;
+}
+
+Bnd_Box BRepBndBoxCache::get(const AssemblyGraph& graph)
+{
+    // Shapes of the products having no components, null for assemblies and removed products
+    std::vector<TopoDS_Shape> vecProductShape(graph.lastProductId());
+    for (AssemblyGraph::ProductId id = 1; id <= graph.lastProductId(); ++id) {
+        const AssemblyGraph::Product& product = graph.product(id);
+        if (!product.label.IsNull() && product.vecChildOccurrence.empty())
+            vecProductShape.at(id - 1) = XCaf::shape(product.label);
+    }
+
+    // Compute product boxes first, so all of them are processed in parallel
+    this->findOrCompute(vecProductShape);
+
+    std::vector<TopoDS_Shape> vecOccurrenceShape;
+    graph.traverseOccurrencePaths([&](AssemblyGraph::OccurrencePath path) {
+        const AssemblyGraph::Occurrence& occurrence = graph.occurrence(path.back());
+        const TopoDS_Shape& productShape = vecProductShape.at(occurrence.product - 1);
+        if (!productShape.IsNull())
+            vecOccurrenceShape.push_back(productShape.Moved(graph.absoluteLocation(path)));
+
+        return true;
+    });
+
+    return this->get(vecOccurrenceShape);
+}
+
+void BRepBndBoxCache::remove(const TopoDS_Shape& shape)
+{
+    if (shape.IsNull())
+        return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_mapEntry.erase(shape.TShape().get());
+}
+
+void BRepBndBoxCache::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_mapEntry.clear();
+}
+
+int BRepBndBoxCache::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return int(m_mapEntry.size());
+}
+
+Bnd_Box BRepBndBoxCache::compute(const TopoDS_Shape& shape, Mode mode)
+{
+    return computeBndBox(shape, mode, true/*useParallel*/);
+}
+
+BRepBndBoxCache::MapBndBox BRepBndBoxCache::findOrCompute(Span<const TopoDS_Shape> spanShape)
+{
+    // Location-free shapes whose box isn't cached yet(or is stale), each TShape being listed once
+    MapBndBox mapBndBox;
+    std::vector<TopoDS_Shape> vecShape;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const TopoDS_Shape& shape : spanShape) {
+            if (shape.IsNull())
+                continue;
+
+            const TopoDS_TShape* tshape = shape.TShape().get();
+            if (mapBndBox.find(tshape) != mapBndBox.cend())
+                continue;
+
+            auto itEntry = m_mapEntry.find(tshape);
+            if (itEntry != m_mapEntry.cend() && this->isValid(itEntry->second)) {
+                mapBndBox.insert({ tshape, itEntry->second.bndBox });
+            }
+            else {
+                mapBndBox.insert({ tshape, Bnd_Box() });
+                vecShape.push_back(shape.Located(TopLoc_Location()));
+            }
+        }
+    }
+
+    if (vecShape.empty())
+        return mapBndBox;
+
+    // Parallelism is at shape level when there are many shapes, otherwise at face level
+    const uint64_t lodChangeCount = BRepMeshLod::activeLevelChangeCount();
+    const bool isSingleShape = vecShape.size() == 1;
+    std::vector<Bnd_Box> vecBndBox(vecShape.size());
+    OSD_Parallel::For(0, int(vecShape.size()), [&](int i) {
+        vecBndBox.at(i) = computeBndBox(vecShape.at(i), m_mode, isSingleShape/*useParallel*/);
+    }, isSingleShape/*forceSingleThreadExecution*/);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (size_t i = 0; i < vecShape.size(); ++i) {
+        const TopoDS_TShape* tshape = vecShape.at(i).TShape().get();
+        mapBndBox.at(tshape) = vecBndBox.at(i);
+        m_mapEntry.insert_or_assign(tshape, Entry{ vecShape.at(i), vecBndBox.at(i), lodChangeCount });
+    }
+
+    return mapBndBox;
+}
+
+bool BRepBndBoxCache::isValid(const Entry& entry) const
+{
+    // Fast mode boxes are computed from the active triangulations
+    return m_mode != Mode::Fast || entry.lodChangeCount == BRepMeshLod::activeLevelChangeCount();
+}
+
+} // namespace Mayo
@@ -0,0 +1,80 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "span.h"
+
+#include <Bnd_Box.hxx>
+#include <TopoDS_Shape.hxx>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+namespace Mayo {
+
+class AssemblyGraph;
+
+// Provides bounding boxes of BRep shapes, cached per product
+//
+// A box is computed once per TopoDS_TShape(ie location-free shape shared by all instances of a
+// product) and then transformed by the location of the shape being queried
+// With optimal mode, boxes of shapes whose location isn't a translation aren't cached but
+// computed from the located shapes, as transformed boxes wouldn't be tight anymore
+// When many shapes are queried at once, missing boxes are computed in parallel
+// With fast mode, boxes cached before active triangulations got changed(see BRepMeshLod) are
+// computed again
+// All functions are thread-safe
+class BRepBndBoxCache {
+public:
+    enum class Mode {
+        Fast,   // Uses triangulations if any, boxes can be enlarged by shape tolerances
+        Optimal // Tight boxes computed from geometry, much slower
+    };
+
+    BRepBndBoxCache(Mode mode = Mode::Fast) : m_mode(mode) {}
+
+    Mode mode() const { return m_mode; }
+
+    // Returns the bounding box of 'shape', computed if not yet in the cache
+    Bnd_Box get(const TopoDS_Shape& shape);
+
+    // Returns the union of the bounding boxes of shapes in 'spanShape'
+    Bnd_Box get(Span<const TopoDS_Shape> spanShape);
+
+    // Returns the union of the bounding boxes of all product occurrences in 'graph'
+    // Boxes are computed once per product, whatever the count of its occurrences
+    Bnd_Box get(const AssemblyGraph& graph);
+
+    // Drops the cached box of 'shape'(eg shape was modified or isn't needed anymore)
+    void remove(const TopoDS_Shape& shape);
+    void clear();
+    int size() const;
+
+    // Computes the bounding box of 'shape' without caching
+    // With optimal mode, faces of 'shape' are processed in parallel
+    static Bnd_Box compute(const TopoDS_Shape& shape, Mode mode);
+
+private:
+    struct Entry {
+        TopoDS_Shape shape; // Location-free
+        Bnd_Box bndBox;
+        uint64_t lodChangeCount = 0; // BRepMeshLod::activeLevelChangeCount() before computation
+    };
+
+    using MapBndBox = std::unordered_map<const TopoDS_TShape*, Bnd_Box>;
+
+    // Returns the boxes of the location-free shapes of 'spanShape', missing ones being computed
+    // and cached. Boxes are copied so they don't depend on entries removed by another thread
+    MapBndBox findOrCompute(Span<const TopoDS_Shape> spanShape);
+    bool isValid(const Entry& entry) const;
+
+    Mode m_mode = Mode::Fast;
+    mutable std::mutex m_mutex;
+    std::unordered_map<const TopoDS_TShape*, Entry> m_mapEntry;
+};
+
+} // namespace Mayo
@@ -0,0 +1,210 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "brep_deferred_mesh.h"
+
+#include "occ_handle.h"
+#include "tkernel_utils.h"
+
+#include <BRep_Tool.hxx>
+#include <Poly_Triangulation.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS.hxx>
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace Mayo {
+
+namespace {
+
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+struct DeferredMeshCache {
+    struct Entry {
+        OccHandle<Poly_Triangulation> triangulation;
+        int pinCount = 0;
+        size_t bytes = 0; // Zero if not loaded
+        std::list<const Poly_Triangulation*>::iterator itLru; // Valid if not pinned
+    };
+
+    std::mutex mutex;
+    std::unordered_map<const Poly_Triangulation*, Entry> mapEntry;
+    std::list<const Poly_Triangulation*> listLru; // Unpinned entries, front is the most recently used
+    size_t memoryLimit = size_t(1024) * 1024 * 1024;
+    size_t residentMemory = 0;
+};
+
+DeferredMeshCache& deferredMeshCache()
+{
+    static DeferredMeshCache cache;
+    return cache;
+}
+
+// Returns the triangulations with deferred data found in 'shape', each one being listed once
+std::vector<OccHandle<Poly_Triangulation>> deferredTriangulations(const TopoDS_Shape& shape)
+{
+    std::vector<OccHandle<Poly_Triangulation>> vecTriangulation;
+    std::unordered_set<const TopoDS_TShape*> setTFace;
+    for (TopExp_Explorer expl(shape, TopAbs_FACE); expl.More(); expl.Next()) {
+        const TopoDS_Face& face = TopoDS::Face(expl.Current());
+        if (!setTFace.insert(face.TShape().get()).second)
+            continue;
+
+        TopLoc_Location loc;
+        const OccHandle<Poly_Triangulation>& triangulation = BRep_Tool::Triangulation(face, loc);
+        if (triangulation && triangulation->HasDeferredData())
+            vecTriangulation.push_back(triangulation);
+    }
+
+    return vecTriangulation;
+}
+
+size_t memorySize(const Poly_Triangulation& triangulation)
+{
+    const size_t nodeCount = triangulation.NbNodes();
+    const size_t realSize = triangulation.IsDoublePrecision() ? sizeof(double) : sizeof(float);
+    size_t bytes = nodeCount * 3 * realSize + triangulation.NbTriangles() * sizeof(Poly_Triangle);
+    if (triangulation.HasNormals())
+        bytes += nodeCount * 3 * sizeof(float);
+
+    if (triangulation.HasUVNodes())
+        bytes += nodeCount * 2 * realSize;
+
+    return bytes;
+}
+
+// Unloads least recently used triangulations until resident memory fits the limit
+// Cache mutex must be locked
+void evictTriangulations(DeferredMeshCache& cache)
+{
+    while (cache.residentMemory > cache.memoryLimit && !cache.listLru.empty()) {
+        auto itEntry = cache.mapEntry.find(cache.listLru.back());
+        cache.listLru.pop_back();
+        DeferredMeshCache::Entry& entry = itEntry->second;
+        entry.triangulation->UnloadDeferredData();
+        cache.residentMemory -= entry.bytes;
+        cache.mapEntry.erase(itEntry);
+    }
+}
+#endif
+
+} // namespace
+
+bool BRepDeferredMesh::hasDeferredData([[maybe_unused]] const TopoDS_Shape& shape)
+{
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+    for (TopExp_Explorer expl(shape, TopAbs_FACE); expl.More(); expl.Next()) {
+        TopLoc_Location loc;
+        const OccHandle<Poly_Triangulation>& triangulation = BRep_Tool::Triangulation(TopoDS::Face(expl.Current()), loc);
+        if (triangulation && triangulation->HasDeferredData())
+            return true;
+    }
+#endif
+
+    return false;
+}
+
+void BRepDeferredMesh::pin([[maybe_unused]] const TopoDS_Shape& shape)
+{
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+    const auto vecTriangulation = deferredTriangulations(shape);
+    if (vecTriangulation.empty())
+        return;
+
+    DeferredMeshCache& cache = deferredMeshCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    for (const OccHandle<Poly_Triangulation>& triangulation : vecTriangulation) {
+        DeferredMeshCache::Entry& entry = cache.mapEntry[triangulation.get()];
+        if (!entry.triangulation) {
+            entry.triangulation = triangulation;
+            if (!triangulation->HasGeometry())
+                triangulation->LoadDeferredData();
+
+            entry.bytes = memorySize(*triangulation);
+            cache.residentMemory += entry.bytes;
+        }
+        else if (entry.pinCount == 0) {
+            cache.listLru.erase(entry.itLru);
+        }
+
+        ++entry.pinCount;
+    }
+#endif
+}
+
+void BRepDeferredMesh::unpin([[maybe_unused]] const TopoDS_Shape& shape)
+{
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+    const auto vecTriangulation = deferredTriangulations(shape);
+    if (vecTriangulation.empty())
+        return;
+
+    DeferredMeshCache& cache = deferredMeshCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    for (const OccHandle<Poly_Triangulation>& triangulation : vecTriangulation) {
+        auto itEntry = cache.mapEntry.find(triangulation.get());
+        if (itEntry == cache.mapEntry.end() || itEntry->second.pinCount == 0)
+            continue; // Unbalanced call
+
+        DeferredMeshCache::Entry& entry = itEntry->second;
+        if (--entry.pinCount == 0) {
+            cache.listLru.push_front(triangulation.get());
+            entry.itLru = cache.listLru.begin();
+        }
+    }
+
+    evictTriangulations(cache);
+#endif
+}
+
+size_t BRepDeferredMesh::memoryLimit()
+{
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+    DeferredMeshCache& cache = deferredMeshCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    return cache.memoryLimit;
+#else
+    return 0;
+#endif
+}
+
+void BRepDeferredMesh::setMemoryLimit([[maybe_unused]] size_t bytes)
+{
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+    DeferredMeshCache& cache = deferredMeshCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    cache.memoryLimit = bytes;
+    evictTriangulations(cache);
+#endif
+}
+
+size_t BRepDeferredMesh::residentMemory()
+{
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+    DeferredMeshCache& cache = deferredMeshCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    return cache.residentMemory;
+#else
+    return 0;
+#endif
+}
+
+BRepDeferredMesh::Scope::Scope(Span<const TopoDS_Shape> spanShape)
+    : m_vecShape(spanShape.begin(), spanShape.end())
+{
+    for (const TopoDS_Shape& shape : m_vecShape)
+        BRepDeferredMesh::pin(shape);
+}
+
+BRepDeferredMesh::Scope::~Scope()
+{
+    for (const TopoDS_Shape& shape : m_vecShape)
+        BRepDeferredMesh::unpin(shape);
+}
+
+} // namespace Mayo
@@ -0,0 +1,55 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "span.h"
+
+#include <TopoDS_Shape.hxx>
+#include <cstddef>
+#include <vector>
+
+namespace Mayo {
+
+// Manages BRep face triangulations with deferred data, ie mesh data loaded on demand from the
+// source file(eg glTF buffers when the reader skips "late" data loading)
+//
+// Triangulations are loaded when a shape gets pinned, and stay resident as long as the shape is
+// pinned. Triangulations not pinned anymore are kept in a LRU cache and unloaded when resident
+// memory exceeds memoryLimit()
+// All functions are thread-safe. Requires OpenCascade >= v7.6.0, otherwise they do nothing
+struct BRepDeferredMesh {
+    // Whether 'shape' contains at least one triangulation with deferred data(loaded or not)
+    static bool hasDeferredData(const TopoDS_Shape& shape);
+
+    // Loads deferred triangulations of 'shape' and prevents them to be unloaded
+    // Calls to pin()/unpin() are counted and must be balanced
+    static void pin(const TopoDS_Shape& shape);
+    static void unpin(const TopoDS_Shape& shape);
+
+    // Maximum memory(bytes) of resident triangulation data, pinned data is never unloaded so this
+    // limit can be exceeded
+    static size_t memoryLimit();
+    static void setMemoryLimit(size_t bytes);
+
+    // Estimated memory(bytes) of the triangulation data currently loaded
+    static size_t residentMemory();
+
+    // Pins shapes for the lifetime of the scope object
+    class Scope {
+    public:
+        Scope(Span<const TopoDS_Shape> spanShape);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        std::vector<TopoDS_Shape> m_vecShape;
+    };
+};
+
+} // namespace Mayo
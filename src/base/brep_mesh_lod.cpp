@@ -0,0 +1,325 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "brep_mesh_lod.h"
+
+#include "brep_utils.h"
+#include "global.h"
+#include "tkernel_utils.h"
+
+#include <BRepBuilderAPI_Copy.hxx>
+#include <BRep_Builder.hxx>
+#include <BRep_TFace.hxx>
+#include <BRep_Tool.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS.hxx>
+
+#include <algorithm>
+#include <atomic>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace Mayo {
+
+namespace {
+
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+BRep_TFace* toTFace(const TopoDS_Face& face)
+{
+    return static_cast<BRep_TFace*>(face.TShape().get());
+}
+
+// Returns triangulation at index 'level' in 'listTriangulation', clamped to the last one
+const OccHandle<Poly_Triangulation>& triangulationAt(const Poly_ListOfTriangulation& listTriangulation, int level)
+{
+    int index = 0;
+    for (const OccHandle<Poly_Triangulation>& triangulation : listTriangulation) {
+        if (index == level || index == listTriangulation.Size() - 1)
+            return triangulation;
+
+        ++index;
+    }
+
+    static const OccHandle<Poly_Triangulation> null;
+    return null;
+}
+#endif
+
+// Pin count of faces(see BRepMeshLod::FinestLevelPin), guarded by BRepMeshLod::mutex()
+std::unordered_map<const TopoDS_TShape*, int>& pinnedFaces()
+{
+    static std::unordered_map<const TopoDS_TShape*, int> map;
+    return map;
+}
+
+bool isPinned(const TopoDS_Face& face)
+{
+    return pinnedFaces().find(face.TShape().get()) != pinnedFaces().cend();
+}
+
+std::atomic<uint64_t> globalUnpinCount = 0;
+std::atomic<uint64_t> globalActiveLevelChangeCount = 0;
+
+} // namespace
+
+bool BRepMeshLod::isSupported()
+{
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+    return true;
+#else
+    return false;
+#endif
+}
+
+BRepMeshLod::Level BRepMeshLod::computeLevel(
+        const TopoDS_Shape& shape, const OccBRepMeshParameters& params, TaskProgress* progress
+    )
+{
+    Level level;
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+    // Geometry is shared with the copy, only topology is duplicated(without triangulations)
+    BRepBuilderAPI_Copy copier(shape, false/*copyGeom*/, false/*copyMesh*/);
+    const TopoDS_Shape& shapeCopy = copier.Shape();
+    BRepUtils::computeMesh(shapeCopy, params, progress);
+
+    // Copy has the same topological structure, so explorers visit sub-shapes in the same order
+    std::unordered_set<const TopoDS_TShape*> setTFace;
+    TopExp_Explorer explFace(shape, TopAbs_FACE);
+    TopExp_Explorer explFaceCopy(shapeCopy, TopAbs_FACE);
+    for (; explFace.More() && explFaceCopy.More(); explFace.Next(), explFaceCopy.Next()) {
+        const TopoDS_Face& face = TopoDS::Face(explFace.Current());
+        const TopoDS_Face& faceCopy = TopoDS::Face(explFaceCopy.Current());
+        if (!setTFace.insert(face.TShape().get()).second)
+            continue; // Face already processed(shared by many locations)
+
+        FaceMesh faceMesh;
+        faceMesh.face = face;
+        faceMesh.triangulation = BRep_Tool::Triangulation(faceCopy, faceMesh.location);
+        if (!faceMesh.triangulation)
+            continue;
+
+        std::unordered_set<const TopoDS_TShape*> setTEdge;
+        TopExp_Explorer explEdge(face, TopAbs_EDGE);
+        TopExp_Explorer explEdgeCopy(faceCopy, TopAbs_EDGE);
+        for (; explEdge.More() && explEdgeCopy.More(); explEdge.Next(), explEdgeCopy.Next()) {
+            const TopoDS_Edge& edge = TopoDS::Edge(explEdge.Current());
+            const TopoDS_Edge& edgeCopy = TopoDS::Edge(explEdgeCopy.Current());
+            if (!setTEdge.insert(edge.TShape().get()).second)
+                continue; // Seam edge, both orientations are handled at first visit
+
+            FaceMesh::EdgePolygon edgePolygon;
+            edgePolygon.edge = edge;
+            edgePolygon.polygon = BRep_Tool::PolygonOnTriangulation(
+                TopoDS::Edge(edgeCopy.Oriented(TopAbs_FORWARD)), faceMesh.triangulation, faceMesh.location
+            );
+            if (BRep_Tool::IsClosed(edgeCopy, faceCopy)) {
+                edgePolygon.polygonSeam = BRep_Tool::PolygonOnTriangulation(
+                    TopoDS::Edge(edgeCopy.Oriented(TopAbs_REVERSED)), faceMesh.triangulation, faceMesh.location
+                );
+            }
+
+            if (edgePolygon.polygon)
+                faceMesh.vecEdgePolygon.push_back(std::move(edgePolygon));
+        }
+
+        level.push_back(std::move(faceMesh));
+    }
+#else
+    MAYO_UNUSED(shape);
+    MAYO_UNUSED(params);
+    MAYO_UNUSED(progress);
+#endif
+
+    return level;
+}
+
+bool BRepMeshLod::addLevel(const Level& level)
+{
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+    const bool hasPinnedFace = std::any_of(level.cbegin(), level.cend(), [](const FaceMesh& faceMesh) {
+        return isPinned(faceMesh.face);
+    });
+    if (hasPinnedFace)
+        return false;
+
+    BRep_Builder builder;
+    for (const FaceMesh& faceMesh : level) {
+        BRep_TFace* tface = toTFace(faceMesh.face);
+        Poly_ListOfTriangulation listTriangulation = tface->Triangulations();
+        OccHandle<Poly_Triangulation> activeTriangulation = tface->ActiveTriangulation();
+        listTriangulation.Append(faceMesh.triangulation);
+        if (!activeTriangulation)
+            activeTriangulation = faceMesh.triangulation;
+
+        tface->Triangulations(listTriangulation, activeTriangulation);
+        for (const FaceMesh::EdgePolygon& edgePolygon : faceMesh.vecEdgePolygon) {
+            if (edgePolygon.polygonSeam) {
+                builder.UpdateEdge(
+                    edgePolygon.edge,
+                    edgePolygon.polygon,
+                    edgePolygon.polygonSeam,
+                    faceMesh.triangulation,
+                    faceMesh.location
+                );
+            }
+            else {
+                builder.UpdateEdge(edgePolygon.edge, edgePolygon.polygon, faceMesh.triangulation, faceMesh.location);
+            }
+        }
+    }
+#else
+    MAYO_UNUSED(level);
+#endif
+
+    return true;
+}
+
+int BRepMeshLod::levelCount(const TopoDS_Shape& shape)
+{
+    int count = 0;
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+    BRepUtils::forEachUniqueFace(shape, [&](const TopoDS_Face& face) {
+        count = std::max(count, toTFace(face)->NbTriangulations());
+    });
+#else
+    for (TopExp_Explorer expl(shape, TopAbs_FACE); expl.More() && count == 0; expl.Next()) {
+        TopLoc_Location loc;
+        if (BRep_Tool::Triangulation(TopoDS::Face(expl.Current()), loc))
+            count = 1;
+    }
+#endif
+
+    return count;
+}
+
+double BRepMeshLod::levelDeflection(const TopoDS_Shape& shape, int level)
+{
+    double deflection = 0.;
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+    BRepUtils::forEachUniqueFace(shape, [&](const TopoDS_Face& face) {
+        const OccHandle<Poly_Triangulation>& triangulation = triangulationAt(toTFace(face)->Triangulations(), level);
+        if (triangulation)
+            deflection = std::max(deflection, triangulation->Deflection());
+    });
+#else
+    MAYO_UNUSED(level);
+    for (TopExp_Explorer expl(shape, TopAbs_FACE); expl.More(); expl.Next()) {
+        TopLoc_Location loc;
+        const OccHandle<Poly_Triangulation>& triangulation = BRep_Tool::Triangulation(TopoDS::Face(expl.Current()), loc);
+        if (triangulation)
+            deflection = std::max(deflection, triangulation->Deflection());
+    }
+#endif
+
+    return deflection;
+}
+
+int BRepMeshLod::activeLevel(const TopoDS_Shape& shape)
+{
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+    for (TopExp_Explorer expl(shape, TopAbs_FACE); expl.More(); expl.Next()) {
+        const BRep_TFace* tface = toTFace(TopoDS::Face(expl.Current()));
+        if (tface->NbTriangulations() < 2)
+            continue;
+
+        int index = 0;
+        for (const OccHandle<Poly_Triangulation>& triangulation : tface->Triangulations()) {
+            if (triangulation == tface->ActiveTriangulation())
+                return index;
+
+            ++index;
+        }
+    }
+#else
+    MAYO_UNUSED(shape);
+#endif
+
+    return 0;
+}
+
+bool BRepMeshLod::setActiveLevel(const TopoDS_Shape& shape, int level)
+{
+    bool changed = false;
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+    BRepUtils::forEachUniqueFace(shape, [&](const TopoDS_Face& face) {
+        BRep_TFace* tface = toTFace(face);
+        if (tface->NbTriangulations() < 2 || isPinned(face))
+            return;
+
+        const OccHandle<Poly_Triangulation> triangulation = triangulationAt(tface->Triangulations(), level);
+        if (triangulation && triangulation != tface->ActiveTriangulation()) {
+            const Poly_ListOfTriangulation listTriangulation = tface->Triangulations();
+            tface->Triangulations(listTriangulation, triangulation);
+            changed = true;
+        }
+    });
+#else
+    MAYO_UNUSED(shape);
+    MAYO_UNUSED(level);
+#endif
+
+    if (changed)
+        ++globalActiveLevelChangeCount;
+
+    return changed;
+}
+
+std::mutex& BRepMeshLod::mutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+uint64_t BRepMeshLod::activeLevelChangeCount()
+{
+    return globalActiveLevelChangeCount;
+}
+
+uint64_t BRepMeshLod::unpinCount()
+{
+    return globalUnpinCount;
+}
+
+BRepMeshLod::FinestLevelPin::FinestLevelPin(Span<const TopoDS_Shape> spanShape)
+{
+    std::lock_guard<std::mutex> lock(BRepMeshLod::mutex());
+    std::unordered_set<const TopoDS_TShape*> setTFace;
+    for (const TopoDS_Shape& shape : spanShape) {
+        BRepUtils::forEachUniqueFace(shape, [&](const TopoDS_Face& face) {
+            if (!setTFace.insert(face.TShape().get()).second)
+                return; // Face shared by many shapes
+
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+            BRep_TFace* tface = toTFace(face);
+            if (tface->NbTriangulations() > 1) {
+                const OccHandle<Poly_Triangulation> finestTriangulation = tface->Triangulations().Last();
+                if (finestTriangulation != tface->ActiveTriangulation()) {
+                    const Poly_ListOfTriangulation listTriangulation = tface->Triangulations();
+                    tface->Triangulations(listTriangulation, finestTriangulation);
+                    ++globalActiveLevelChangeCount;
+                }
+            }
+#endif
+
+            ++pinnedFaces()[face.TShape().get()];
+            m_vecFace.push_back(face);
+        });
+    }
+}
+
+BRepMeshLod::FinestLevelPin::~FinestLevelPin()
+{
+    std::lock_guard<std::mutex> lock(BRepMeshLod::mutex());
+    for (const TopoDS_Face& face : m_vecFace) {
+        auto it = pinnedFaces().find(face.TShape().get());
+        if (it != pinnedFaces().end() && --(it->second) == 0)
+            pinnedFaces().erase(it);
+    }
+
+    ++globalUnpinCount;
+}
+
+} // namespace Mayo
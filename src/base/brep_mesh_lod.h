@@ -0,0 +1,112 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "occ_brep_mesh_parameters.h"
+#include "occ_handle.h"
+#include "span.h"
+
+#include <Poly_PolygonOnTriangulation.hxx>
+#include <Poly_Triangulation.hxx>
+#include <TopLoc_Location.hxx>
+#include <TopoDS_Edge.hxx>
+#include <TopoDS_Face.hxx>
+#include <TopoDS_Shape.hxx>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace Mayo {
+
+class TaskProgress;
+
+// Provides multiple levels of detail(LOD) for the triangulations of BRep faces
+//
+// Each face keeps a list of triangulations ordered from the coarsest(level 0) to the finest, only
+// one of them being "active" at a time(ie used by presentations and algorithms)
+// Requires OpenCascade >= v7.6.0 which allows many triangulations per face, otherwise shapes always
+// have a single level of detail
+//
+// Triangulations of faces are shared by all the threads, so addLevel() and setActiveLevel() must be
+// called with mutex() locked, from the thread owning the graphics. Algorithms reading triangulations
+// in a worker thread(eg exporters, measure tools) should be given a FinestLevelPin created by that
+// thread: workers then never change triangulations themselves
+struct BRepMeshLod {
+    // Mesh data of a face to be added as a new level of detail
+    struct FaceMesh {
+        struct EdgePolygon {
+            TopoDS_Edge edge;
+            OccHandle<Poly_PolygonOnTriangulation> polygon;
+            OccHandle<Poly_PolygonOnTriangulation> polygonSeam; // Null if edge isn't a seam
+        };
+
+        TopoDS_Face face;
+        TopLoc_Location location;
+        OccHandle<Poly_Triangulation> triangulation;
+        std::vector<EdgePolygon> vecEdgePolygon;
+    };
+    using Level = std::vector<FaceMesh>;
+
+    // Whether multiple levels of detail are supported by the OpenCascade version in use
+    static bool isSupported();
+
+    // Computes a new level of detail for 'shape' with the BRepMesh parameters 'params'
+    // Meshing is done on a copy of 'shape' so it can safely run in a worker thread while 'shape' is
+    // being displayed. Call addLevel() afterwards, from the thread owning the graphics
+    static Level computeLevel(
+            const TopoDS_Shape& shape, const OccBRepMeshParameters& params, TaskProgress* progress = nullptr
+    );
+
+    // Appends 'level' to the triangulations of its faces, active triangulations are left unchanged
+    // Returns false and does nothing if a face of 'level' is pinned(see FinestLevelPin), caller
+    // should try again later
+    static bool addLevel(const Level& level);
+
+    // Returns the count of levels of detail available for 'shape'(maximum count found among faces)
+    static int levelCount(const TopoDS_Shape& shape);
+
+    // Returns the maximum chordal deflection of triangulations at level 'level'
+    static double levelDeflection(const TopoDS_Shape& shape, int level);
+
+    // Returns the level of detail of the triangulations currently active in 'shape'
+    static int activeLevel(const TopoDS_Shape& shape);
+
+    // Activates the triangulations at level 'level'(clamped to the levels available in each face)
+    // Pinned faces are skipped(see FinestLevelPin)
+    // Returns true if at least one face got its active triangulation changed
+    static bool setActiveLevel(const TopoDS_Shape& shape, int level);
+
+    // Guards the changes of the triangulations of faces(added levels and active levels)
+    static std::mutex& mutex();
+
+    // Count of changes of active triangulations so far(by setActiveLevel() or FinestLevelPin)
+    // Data computed from triangulations is stale once it has changed
+    static uint64_t activeLevelChangeCount();
+
+    // Count of FinestLevelPin objects destroyed so far, active levels skipped meanwhile by
+    // setActiveLevel() can be applied again once it has changed
+    static uint64_t unpinCount();
+
+    // Activates the finest level of detail of 'spanShape' and pins it: triangulations of the faces
+    // aren't changed by addLevel() and setActiveLevel() until the object is destroyed
+    // mutex() is only locked during construction and destruction, so a worker thread can read the
+    // triangulations meanwhile. Construction has to be done in the thread owning the graphics,
+    // destruction can happen in any thread(active triangulations aren't restored)
+    class FinestLevelPin {
+    public:
+        explicit FinestLevelPin(Span<const TopoDS_Shape> spanShape);
+        ~FinestLevelPin();
+
+        FinestLevelPin(const FinestLevelPin&) = delete;
+        FinestLevelPin& operator=(const FinestLevelPin&) = delete;
+
+    private:
+        std::vector<TopoDS_Face> m_vecFace;
+    };
+};
+
+} // namespace Mayo
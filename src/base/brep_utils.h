@@ -16,6 +16,7 @@
 #include <TopExp_Explorer.hxx>
 #include <TopoDS.hxx>
 #include <string>
+#include <unordered_set>
 
 namespace Mayo {
 
@@ -47,6 +48,11 @@ struct BRepUtils {
     template<typename Function>
     static void forEachSubFace(const TopoDS_Shape& shape, Function fn);
 
+    // Explores 'shape' and executes 'fn' for each sub-face, faces sharing the same TopoDS_TShape
+    // are visited once
+    template<typename Function>
+    static void forEachUniqueFace(const TopoDS_Shape& shape, Function fn);
+
     // Is shape type 'lhs' more complex than 'rhs'?
     // Complexity here is the degree of abstraction provided(eg face type is more complex than edge type)
     static bool moreComplex(TopAbs_ShapeEnum lhs, TopAbs_ShapeEnum rhs);
@@ -105,4 +111,15 @@ void BRepUtils::forEachSubFace(const TopoDS_Shape& shape, Function fn)
         fn(TopoDS::Face(expl.Current()));
 }
 
+template<typename Function>
+void BRepUtils::forEachUniqueFace(const TopoDS_Shape& shape, Function fn)
+{
+    std::unordered_set<const TopoDS_TShape*> setTFace;
+    for (TopExp_Explorer expl(shape, TopAbs_FACE); expl.More(); expl.Next()) {
+        const TopoDS_Face& face = TopoDS::Face(expl.Current());
+        if (setTFace.insert(face.TShape().get()).second)
+            fn(face);
+    }
+}
+
 } // namespace Mayo
@@ -0,0 +1,135 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "data_reduction.h"
+
+#include "brep_utils.h"
+#include "caf_utils.h"
+#include "math_utils.h"
+#include "mesh_utils.h"
+#include "point_cloud_data.h"
+#include "point_cloud_utils.h"
+#include "task_progress.h"
+#include "triangulation_annex_data.h"
+#include "xcaf.h"
+
+#include <BRep_Builder.hxx>
+#include <BRep_Tool.hxx>
+
+#include <memory>
+#include <vector>
+
+namespace Mayo {
+
+namespace {
+
+void reducePointCloud(const PointCloudDataPtr& data, const DataReduction::Parameters& params, TaskProgress* progress)
+{
+    if (!data->pointCloud())
+        return;
+
+    std::shared_ptr<PointCloud> pointCloud;
+    auto fnSource = [&]() -> const PointCloud& {
+        return pointCloud ? *pointCloud : *data->pointCloud();
+    };
+
+    if (!params.cropBox.IsVoid())
+        pointCloud = std::make_shared<PointCloud>(PointCloudUtils::cropBox(fnSource(), params.cropBox));
+
+    progress->setValue(20);
+    if (params.outlierNeighborCount > 0) {
+        pointCloud = std::make_shared<PointCloud>(
+            PointCloudUtils::removeStatisticalOutliers(fnSource(), params.outlierNeighborCount, params.outlierStdDevRatio)
+        );
+    }
+
+    progress->setValue(70);
+    if (params.voxelSize > 0.)
+        pointCloud = std::make_shared<PointCloud>(PointCloudUtils::voxelGridDownsample(fnSource(), params.voxelSize));
+
+    if (pointCloud)
+        PointCloudData::Set(data->Label(), pointCloud);
+}
+
+// Node colors of the merged nodes are averaged
+std::vector<Quantity_Color> remapNodeColors(Span<const Quantity_Color> spanNodeColor, const std::vector<int>& nodeMap, int newNodeCount)
+{
+    std::vector<gp_XYZ> vecColorSum(newNodeCount);
+    std::vector<int> vecColorCount(newNodeCount, 0);
+    for (size_t i = 0; i < nodeMap.size() && i < spanNodeColor.size(); ++i) {
+        const Quantity_Color& color = spanNodeColor[i];
+        vecColorSum[nodeMap[i] - 1] += gp_XYZ(color.Red(), color.Green(), color.Blue());
+        ++vecColorCount[nodeMap[i] - 1];
+    }
+
+    std::vector<Quantity_Color> vecNodeColor;
+    vecNodeColor.reserve(newNodeCount);
+    for (int i = 0; i < newNodeCount; ++i) {
+        const gp_XYZ rgb = vecColorCount[i] > 0 ? vecColorSum[i] / vecColorCount[i] : gp_XYZ{};
+        vecNodeColor.emplace_back(rgb.X(), rgb.Y(), rgb.Z(), Quantity_TOC_RGB);
+    }
+
+    return vecNodeColor;
+}
+
+void reduceShapeMeshes(const TDF_Label& labelEntity, double cellSize, TaskProgress* progress)
+{
+    // Faces sharing a TShape share the triangulation, which must be decimated once
+    std::vector<TopoDS_Face> vecFace;
+    BRepUtils::forEachUniqueFace(XCaf::shape(labelEntity), [&](const TopoDS_Face& face) {
+        vecFace.push_back(face);
+    });
+
+    // Node colors are only provided by pure mesh entities, made of a single face
+    auto annexData = CafUtils::findAttribute<TriangulationAnnexData>(labelEntity);
+    const bool hasNodeColors = annexData && !annexData->nodeColors().empty() && vecFace.size() == 1;
+    BRep_Builder builder;
+    for (size_t i = 0; i < vecFace.size(); ++i) {
+        if (progress->isAbortRequested())
+            return;
+
+        TopLoc_Location loc;
+        const TopoDS_Face& face = vecFace.at(i);
+        const OccHandle<Poly_Triangulation>& triangulation = BRep_Tool::Triangulation(face, loc);
+        if (triangulation) {
+            std::vector<int> nodeMap;
+            auto mesh = MeshUtils::decimateVertexClustering(triangulation, cellSize, hasNodeColors ? &nodeMap : nullptr);
+            if (hasNodeColors) {
+                TriangulationAnnexData::Set(
+                    labelEntity, remapNodeColors(annexData->nodeColors(), nodeMap, mesh->NbNodes())
+                );
+            }
+
+            builder.UpdateFace(face, mesh);
+        }
+
+        progress->setValue(MathUtils::toPercent(i + 1, 0, vecFace.size()));
+    }
+}
+
+} // namespace
+
+bool DataReduction::Parameters::isPointCloudReductionEnabled() const
+{
+    return !cropBox.IsVoid() || outlierNeighborCount > 0 || voxelSize > 0.;
+}
+
+void DataReduction::applyToEntity(const TDF_Label& labelEntity, const Parameters& params, TaskProgress* progress)
+{
+    progress = progress ? progress : &TaskProgress::null();
+    auto pointCloudData = CafUtils::findAttribute<PointCloudData>(labelEntity);
+    if (pointCloudData) {
+        if (params.isPointCloudReductionEnabled())
+            reducePointCloud(pointCloudData, params, progress);
+    }
+    else if (XCaf::isShape(labelEntity) && params.isMeshReductionEnabled()) {
+        reduceShapeMeshes(labelEntity, params.meshClusterCellSize, progress);
+    }
+
+    progress->setValue(100);
+}
+
+} // namespace Mayo
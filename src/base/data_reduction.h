@@ -0,0 +1,39 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include <Bnd_Box.hxx>
+#include <TDF_Label.hxx>
+
+namespace Mayo {
+
+class TaskProgress;
+
+// Reduces the data held by a document entity before display or export
+// Meant to be used as post-process of import operations(see IO::System::ImportHelper::withEntityPostProcess())
+struct DataReduction {
+    struct Parameters {
+        // Point clouds, reductions are applied in this order
+        Bnd_Box cropBox; // Void box means no cropping
+        int outlierNeighborCount = 0; // Statistical outlier removal is disabled if <= 0
+        double outlierStdDevRatio = 1.;
+        double voxelSize = 0.; // Voxel grid downsampling is disabled if <= 0
+
+        // Meshes
+        double meshClusterCellSize = 0.; // Vertex clustering decimation is disabled if <= 0
+
+        bool isPointCloudReductionEnabled() const;
+        bool isMeshReductionEnabled() const { return meshClusterCellSize > 0.; }
+        bool isEnabled() const { return this->isPointCloudReductionEnabled() || this->isMeshReductionEnabled(); }
+    };
+
+    // Applies 'params' to the point cloud or the face triangulations of entity 'labelEntity'
+    // Node colors of pure mesh entities(TriangulationAnnexData) are averaged per merged node
+    static void applyToEntity(const TDF_Label& labelEntity, const Parameters& params, TaskProgress* progress = nullptr);
+};
+
+} // namespace Mayo
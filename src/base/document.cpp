@@ -12,6 +12,7 @@
 #include <TDF_ChildIterator.hxx>
 #include <TDF_TagSource.hxx>
 #include <XCAFDoc_DocumentTool.hxx>
+#include <cassert>
 
 namespace Mayo {
 
@@ -106,6 +107,11 @@ DocumentTreeNode Document::entityTreeNode(int index) const
 void Document::rebuildModelTree()
 {
     m_modelTree.clear();
+    {
+        std::unique_lock<std::shared_mutex> lock(m_mutexMapLabelDataFlags);
+        m_mapLabelDataFlags.clear();
+    }
+
     const bool xcafIsNull = m_xcaf.isNull();
     if (!xcafIsNull) {
         for (const TDF_Label& label : m_xcaf.topLevelFreeShapes())
@@ -121,6 +127,11 @@ void Document::rebuildModelTree()
             m_modelTree.appendChild(0, childLabel);
         }
     }
+
+    for (TreeNodeId nodeId : m_modelTree.roots())
+        this->addLabelDataFlags(nodeId);
+
+    this->rebuildAssemblyGraph();
 }
 
 DocumentPtr Document::findFrom(const TDF_Label& label)
@@ -163,6 +174,8 @@ void Document::addEntityTreeNode(const TDF_Label& label)
     // TODO Allow custom population of the model tree for the new entity
     if (this->containsLabel(label) && this->findEntity(label) == 0) {
         const TreeNodeId nodeId = m_xcaf.deepBuildAssemblyTree(0, label);
+        this->addAssemblyGraphRoot(nodeId);
+        this->addLabelDataFlags(nodeId);
         this->signalEntityAdded.send(nodeId);
     }
 }
@@ -174,6 +187,8 @@ void Document::addEntityTreeNodeSequence(const TDF_LabelSequence& seqLabel)
     for (const TDF_Label& label : seqLabel) {
         if (this->containsLabel(label) && this->findEntity(label) == 0) {
             const TreeNodeId treeNodeId = m_xcaf.deepBuildAssemblyTree(0, label);
+            this->addAssemblyGraphRoot(treeNodeId);
+            this->addLabelDataFlags(treeNodeId);
             vecTreeNodeId.push_back(treeNodeId);
         }
     }
@@ -191,11 +206,111 @@ void Document::destroyEntity(TreeNodeId entityTreeNodeId)
         return;
 
     this->signalEntityAboutToBeDestroyed.send(entityTreeNodeId);
+    this->removeLabelDataFlags(entityTreeNodeId);
+    this->removeAssemblyGraphRoot(entityTreeNodeId);
     entityLabel.ForgetAllAttributes();
     entityLabel.Nullify();
     m_modelTree.removeRoot(entityTreeNodeId);
 }
 
+AssemblyGraph::OccurrenceId Document::assemblyGraphRoot(TreeNodeId entityTreeNodeId) const
+{
+    auto it = m_mapEntityGraphRoot.find(entityTreeNodeId);
+    return it != m_mapEntityGraphRoot.cend() ? it->second : 0;
+}
+
+void Document::traverseAssemblyGraphPaths(
+        TreeNodeId entityTreeNodeId,
+        const std::function<void(AssemblyGraph::OccurrencePath, TreeNodeId)>& fn
+    ) const
+{
+    const AssemblyGraph::OccurrenceId rootId = this->assemblyGraphRoot(entityTreeNodeId);
+    if (rootId == 0)
+        return;
+
+    // Nodes of the entity were appended contiguously by XCaf::deepBuildAssemblyTree() in the same
+    // depth-first order, each non-root path adding a reference node then the referred product node
+    TreeNodeId nodeId = entityTreeNodeId;
+    m_assemblyGraph.traverseOccurrencePaths(rootId, [&](AssemblyGraph::OccurrencePath path) {
+        if (path.size() > 1)
+            nodeId += 2;
+
+        assert(m_modelTree.nodeData(nodeId)
+               == m_assemblyGraph.product(m_assemblyGraph.occurrence(path.back()).product).label);
+        fn(path, nodeId);
+        return true;
+    });
+}
+
+void Document::addAssemblyGraphRoot(TreeNodeId entityTreeNodeId)
+{
+    const TDF_Label& label = m_modelTree.nodeData(entityTreeNodeId);
+    if (XCaf::isShape(label))
+        m_mapEntityGraphRoot.insert({ entityTreeNodeId, m_assemblyGraph.addRoot(label) });
+}
+
+void Document::removeAssemblyGraphRoot(TreeNodeId entityTreeNodeId)
+{
+    auto it = m_mapEntityGraphRoot.find(entityTreeNodeId);
+    if (it != m_mapEntityGraphRoot.end()) {
+        m_assemblyGraph.removeRoot(it->second);
+        m_mapEntityGraphRoot.erase(it);
+    }
+}
+
+void Document::rebuildAssemblyGraph()
+{
+    m_assemblyGraph.clear();
+    m_mapEntityGraphRoot.clear();
+    for (int i = 0; i < this->entityCount(); ++i)
+        this->addAssemblyGraphRoot(this->entityTreeNodeId(i));
+}
+
+LabelDataFlags Document::labelDataFlags(const TDF_Label& label) const
+{
+    {
+        std::shared_lock<std::shared_mutex> lock(m_mutexMapLabelDataFlags);
+        auto it = m_mapLabelDataFlags.find(label);
+        if (it != m_mapLabelDataFlags.cend())
+            return it->second;
+    }
+
+    return findLabelDataFlags(label);
+}
+
+LabelDataFlags Document::labelDataFlags(TreeNodeId nodeId) const
+{
+    return this->labelDataFlags(m_modelTree.nodeData(nodeId));
+}
+
+void Document::invalidateLabelDataFlags(const TDF_Label& label)
+{
+    std::unique_lock<std::shared_mutex> lock(m_mutexMapLabelDataFlags);
+    m_mapLabelDataFlags.erase(label);
+}
+
+void Document::addLabelDataFlags(TreeNodeId nodeId)
+{
+    // Flags are evaluated before locking, products shared by several instances are evaluated once
+    std::unordered_map<TDF_Label, LabelDataFlags> mapNodeFlags;
+    traverseTree(nodeId, m_modelTree, [&](TreeNodeId id) {
+        const TDF_Label& label = m_modelTree.nodeData(id);
+        if (mapNodeFlags.find(label) == mapNodeFlags.cend())
+            mapNodeFlags.insert({ label, findLabelDataFlags(label) });
+    });
+
+    std::unique_lock<std::shared_mutex> lock(m_mutexMapLabelDataFlags);
+    m_mapLabelDataFlags.merge(mapNodeFlags);
+}
+
+void Document::removeLabelDataFlags(TreeNodeId nodeId)
+{
+    std::unique_lock<std::shared_mutex> lock(m_mutexMapLabelDataFlags);
+    traverseTree(nodeId, m_modelTree, [&](TreeNodeId id) {
+        m_mapLabelDataFlags.erase(m_modelTree.nodeData(id));
+    });
+}
+
 void Document::BeforeClose()
 {
     TDocStd_Document::BeforeClose();
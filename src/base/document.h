@@ -7,15 +7,19 @@
 #pragma once
 
 #include "application_ptr.h"
+#include "assembly_graph.h"
 #include "document_ptr.h"
 #include "document_tree_node.h"
 #include "filepath.h"
+#include "label_data.h"
 #include "libtree.h"
 #include "signal.h"
 #include "xcaf.h"
 
+#include <shared_mutex>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 
 namespace Mayo {
 
@@ -56,6 +60,28 @@ public:
     const Tree<TDF_Label>& modelTree() const { return m_modelTree; }
     void rebuildModelTree();
 
+    // Instance-aware counterpart of modelTree(), covering the XCAF shape entities
+    // Prefer it over modelTree() for processing that can be shared by the instances of a product
+    const AssemblyGraph& assemblyGraph() const { return m_assemblyGraph; }
+    // Root occurrence of entity 'entityTreeNodeId' in assemblyGraph(), null if not a shape entity
+    AssemblyGraph::OccurrenceId assemblyGraphRoot(TreeNodeId entityTreeNodeId) const;
+    // Depth-first traversal of the occurrence paths of entity 'entityTreeNodeId', 'fn' is called
+    // with each path and the model tree node of the product of its last occurrence
+    void traverseAssemblyGraphPaths(
+            TreeNodeId entityTreeNodeId,
+            const std::function<void(AssemblyGraph::OccurrencePath, TreeNodeId)>& fn
+    ) const;
+
+    // Data flags of the labels in the model tree, computed once when the entity is added
+    // Labels out of the model tree fall back to findLabelDataFlags()
+    // Functions are safe to call concurrently with the addition of entities
+    LabelDataFlags labelDataFlags(const TDF_Label& label) const;
+    LabelDataFlags labelDataFlags(TreeNodeId nodeId) const;
+    // Drops the cached data flags of 'label', which is evaluated on the fly from then on
+    // Called by XCaf::setShape() and by Mayo attributes when they are added or forgotten. Must be
+    // called after any other change affecting findLabelDataFlags()
+    void invalidateLabelDataFlags(const TDF_Label& label);
+
     static DocumentPtr findFrom(const TDF_Label& label);
 
     // Creates general-purpose entity, not bound to a specific type
@@ -92,6 +118,11 @@ private:
     void setIdentifier(Identifier ident) { m_identifier = ident; }
     TreeNodeId findEntity(const TDF_Label& label) const;
     bool containsLabel(const TDF_Label& label) const;
+    void addAssemblyGraphRoot(TreeNodeId entityTreeNodeId);
+    void removeAssemblyGraphRoot(TreeNodeId entityTreeNodeId);
+    void rebuildAssemblyGraph();
+    void addLabelDataFlags(TreeNodeId nodeId);
+    void removeLabelDataFlags(TreeNodeId nodeId);
 
     ApplicationPtr m_app;
     Identifier m_identifier = -1;
@@ -99,6 +130,10 @@ private:
     FilePath m_filePath;
     XCaf m_xcaf;
     Tree<TDF_Label> m_modelTree;
+    AssemblyGraph m_assemblyGraph;
+    std::unordered_map<TreeNodeId, AssemblyGraph::OccurrenceId> m_mapEntityGraphRoot;
+    std::unordered_map<TDF_Label, LabelDataFlags> m_mapLabelDataFlags;
+    mutable std::shared_mutex m_mutexMapLabelDataFlags;
 };
 
 } // namespace Mayo
@@ -32,6 +32,11 @@ TDF_Label DocumentTreeNode::label() const
         return TDF_Label();
 }
 
+LabelDataFlags DocumentTreeNode::labelDataFlags() const
+{
+    return this->isValid() ? m_document->labelDataFlags(m_id) : LabelData_None;
+}
+
 bool DocumentTreeNode::isEntity() const
 {
     return this->isValid() ? m_document->isEntity(m_id) : false;
@@ -7,6 +7,7 @@
 #pragma once
 
 #include "document_ptr.h"
+#include "label_data.h"
 #include "libtree.h"
 
 namespace Mayo {
@@ -21,6 +22,7 @@ public:
     static const DocumentTreeNode& null();
 
     TDF_Label label() const;
+    LabelDataFlags labelDataFlags() const; // Cached by Document
     bool isEntity() const;
     bool isLeaf() const;
 
@@ -0,0 +1,81 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "instrumentation.h"
+#include "memory_utils.h"
+#include "string_conv.h"
+
+#include <fmt/format.h>
+
+namespace Mayo {
+
+InstrumentationJsonLinesSink::InstrumentationJsonLinesSink(std::ostream& ostr)
+    : m_ostr(ostr)
+{
+}
+
+void InstrumentationJsonLinesSink::addRecord(const InstrumentationRecord& record)
+{
+    const std::string strJson = InstrumentationJsonLinesSink::toJson(record);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_ostr << strJson << std::endl;
+}
+
+std::string InstrumentationJsonLinesSink::toJson(const InstrumentationRecord& record)
+{
+    return fmt::format(
+        "{{\"operation\":{},\"stage\":{},\"file\":{},\"format\":{},\"ok\":{},"
+        "\"seconds\":{:.6f},\"rss_bytes\":{},\"rss_delta_bytes\":{},\"peak_rss_bytes\":{}}}",
+        to_jsonString(record.operation),
+        to_jsonString(record.stage),
+        to_jsonString(record.filepath.u8string()),
+        to_jsonString(record.format),
+        record.ok ? "true" : "false",
+        record.seconds,
+        record.rssBytes,
+        record.rssDeltaBytes,
+        record.peakRssBytes
+    );
+}
+
+ScopedInstrumentationTimer::ScopedInstrumentationTimer(
+        InstrumentationSink* sink,
+        std::string_view operation,
+        std::string_view stage,
+        const FilePath& filepath
+    )
+    : m_sink(sink)
+{
+    if (!m_sink)
+        return;
+
+    m_record.operation = operation;
+    m_record.stage = stage;
+    m_record.filepath = filepath;
+    m_rssStart = MemoryUtils::residentSetSize();
+    m_timeStart = std::chrono::steady_clock::now();
+}
+
+ScopedInstrumentationTimer::~ScopedInstrumentationTimer()
+{
+    if (!m_sink)
+        return;
+
+    const auto timeEnd = std::chrono::steady_clock::now();
+    m_record.seconds = std::chrono::duration<double>(timeEnd - m_timeStart).count();
+    m_record.rssBytes = MemoryUtils::residentSetSize();
+    m_record.rssDeltaBytes = static_cast<std::int64_t>(m_record.rssBytes - m_rssStart);
+    m_record.peakRssBytes = MemoryUtils::peakResidentSetSize();
+    m_sink->addRecord(m_record);
+}
+
+void ScopedInstrumentationTimer::setFormat(std::string_view format)
+{
+    if (m_sink)
+        m_record.format = format;
+}
+
+} // namespace Mayo
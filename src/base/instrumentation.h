@@ -0,0 +1,81 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "filepath.h"
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace Mayo {
+
+// Measures taken for a single stage of some operation, eg reading of a file during import
+struct InstrumentationRecord {
+    std::string operation; // Operation the stage belongs to, eg "import" or "export"
+    std::string stage;     // Name of the stage, eg "readFile", "transfer", "postProcess", ...
+    FilePath filepath;     // File processed by the stage, might be empty
+    std::string format;    // Identifier of the file format, might be empty
+    bool ok = true;
+    double seconds = 0.;
+    std::uint64_t rssBytes = 0;      // Resident set size once stage is finished
+    std::int64_t rssDeltaBytes = 0;  // Difference of resident set size between end and start of stage
+    std::uint64_t peakRssBytes = 0;  // Peak resident set size of the process once stage is finished
+};
+
+// Abstract receiver of InstrumentationRecord objects
+// Note: addRecord() can be called concurrently from several threads
+class InstrumentationSink {
+public:
+    virtual ~InstrumentationSink() = default;
+    virtual void addRecord(const InstrumentationRecord& record) = 0;
+};
+
+// Writes records as JSON lines(ie one JSON object per line) into an output stream
+class InstrumentationJsonLinesSink : public InstrumentationSink {
+public:
+    InstrumentationJsonLinesSink(std::ostream& ostr);
+    void addRecord(const InstrumentationRecord& record) override;
+
+    static std::string toJson(const InstrumentationRecord& record);
+
+private:
+    std::ostream& m_ostr;
+    std::mutex m_mutex;
+};
+
+// Measures elapsed time and memory usage between construction and destruction of the object,
+// then reports an InstrumentationRecord to the sink
+// Does nothing at all(no clock or memory query) if the sink is null
+class ScopedInstrumentationTimer {
+public:
+    ScopedInstrumentationTimer(
+        InstrumentationSink* sink,
+        std::string_view operation,
+        std::string_view stage,
+        const FilePath& filepath = {}
+    );
+    ~ScopedInstrumentationTimer();
+
+    void setOk(bool on) { m_record.ok = on; }
+    void setFormat(std::string_view format);
+
+    // Not copyable
+    ScopedInstrumentationTimer(const ScopedInstrumentationTimer&) = delete;
+    ScopedInstrumentationTimer& operator=(const ScopedInstrumentationTimer&) = delete;
+
+private:
+    InstrumentationSink* m_sink = nullptr;
+    InstrumentationRecord m_record;
+    std::chrono::steady_clock::time_point m_timeStart;
+    std::uint64_t m_rssStart = 0;
+};
+
+} // namespace Mayo
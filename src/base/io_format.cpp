@@ -34,6 +34,9 @@ std::string_view formatIdentifier(Format format)
     case Format_X3D:   return "X3D";
     case Format_DirectX: return "X";
     case Format_Blender: return "Blender";
+    case Format_XYZ:   return "XYZ";
+    case Format_PTS:   return "PTS";
+    case Format_LAS:   return "LAS";
     }
 
     return "";
@@ -62,6 +65,9 @@ std::string_view formatName(Format format)
     case Format_X3D:   return "Extensible 3D Graphics(ISO/IEC 19775/19776/19777)";
     case Format_DirectX: return "DirectX File Format";
     case Format_Blender: return "Blender File Format";
+    case Format_XYZ:   return "ASCII Point Cloud(XYZ, CSV)";
+    case Format_PTS:   return "Leica PTS Point Cloud";
+    case Format_LAS:   return "ASPRS LiDAR Data Exchange Format";
     }
 
     return "";
@@ -79,7 +85,7 @@ Span<std::string_view> formatFileSuffixes(Format format)
     static std::string_view suffix_gltf[] = { "gltf", "glb" };
     static std::string_view suffix_iges[] = { "iges", "igs" };
     static std::string_view suffix_obj[]  = { "obj" };
-    static std::string_view suffix_occ[]  = { "brep", "rle", "occ" };
+    static std::string_view suffix_occ[]  = { "brep", "rle", "occ", "bbrep" };
     static std::string_view suffix_off[]  = { "off" };
     static std::string_view suffix_ply[]  = { "ply" };
     static std::string_view suffix_step[] = { "step", "stp" };
@@ -88,6 +94,9 @@ Span<std::string_view> formatFileSuffixes(Format format)
     static std::string_view suffix_x3d[]  = { "x3d", "x3dv", "x3db", "x3dz", "x3dbz", "x3dvz" };
     static std::string_view suffix_directx[]  = { "x" };
     static std::string_view suffix_blender[]  = { "blend", "blender", "blend1", "blend2" };
+    static std::string_view suffix_xyz[]  = { "xyz", "xyzn", "xyzrgb", "asc", "csv" };
+    static std::string_view suffix_pts[]  = { "pts" };
+    static std::string_view suffix_las[]  = { "las" };
 
     switch (format) {
     case Format_Unknown: return {};
@@ -110,6 +119,9 @@ Span<std::string_view> formatFileSuffixes(Format format)
     case Format_X3D:   return suffix_x3d;
     case Format_DirectX: return suffix_directx;
     case Format_Blender: return suffix_blender;
+    case Format_XYZ:   return suffix_xyz;
+    case Format_PTS:   return suffix_pts;
+    case Format_LAS:   return suffix_las;
     }
 
     return {};
@@ -33,7 +33,10 @@ enum Format {
     Format_VRML,
     Format_X3D,
     Format_DirectX,
-    Format_Blender
+    Format_Blender,
+    Format_XYZ,
+    Format_PTS,
+    Format_LAS
 };
 
 // Returns identifier(unique short name) corresponding to 'format'
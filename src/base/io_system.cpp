@@ -6,9 +6,11 @@
 
 #include "io_system.h"
 
+#include "brep_deferred_mesh.h"
 #include "caf_utils.h"
 #include "cpp_utils.h"
 #include "document.h"
+#include "instrumentation.h"
 #include "io_parameters_provider.h"
 #include "io_reader.h"
 #include "io_writer.h"
@@ -38,6 +40,28 @@ bool containsFormat(Span<const Format> spanFormat, Format format)
     return itFormat != spanFormat.end();
 }
 
+// Returns the BRep shapes referred by application items
+std::vector<TopoDS_Shape> applicationItemShapes(Span<const ApplicationItem> spanAppItem)
+{
+    std::vector<TopoDS_Shape> vecShape;
+    auto fnAddShape = [&](const TDF_Label& label) {
+        if (XCaf::isShape(label))
+            vecShape.push_back(XCaf::shape(label));
+    };
+    for (const ApplicationItem& appItem : spanAppItem) {
+        if (appItem.isDocument()) {
+            const DocumentPtr doc = appItem.document();
+            for (int i = 0; i < doc->entityCount(); ++i)
+                fnAddShape(doc->entityLabel(i));
+        }
+        else if (appItem.isDocumentTreeNode()) {
+            fnAddShape(appItem.documentTreeNode().label());
+        }
+    }
+
+    return vecShape;
+}
+
 } // namespace
 
 void System::addFormatProbe(const FormatProbe& probe)
@@ -182,6 +206,7 @@ bool System::importInDocument(const Args_ImportInDocument& args)
     TaskProgress* rootProgress = args.progress ? args.progress : &TaskProgress::null();
     Messenger* messenger = args.messenger ? args.messenger : &Messenger::null();
 
+    ScopedInstrumentationTimer timerImport(m_instrumentationSink, "import", "total");
     bool ok = true;
 
     using ReaderPtr = std::unique_ptr<Reader>;
@@ -211,7 +236,13 @@ bool System::importInDocument(const Args_ImportInDocument& args)
         return false;
     };
     auto fnReadFile = [&](TaskData& taskData) {
-        taskData.fileFormat = this->probeFormat(taskData.filepath);
+        {
+            ScopedInstrumentationTimer timer(m_instrumentationSink, "import", "probe", taskData.filepath);
+            taskData.fileFormat = this->probeFormat(taskData.filepath);
+            timer.setFormat(formatIdentifier(taskData.fileFormat));
+            timer.setOk(taskData.fileFormat != Format_Unknown);
+        }
+
         if (taskData.fileFormat == Format_Unknown)
             return fnReadFileError(taskData.filepath, textIdTr("Unknown format"));
 
@@ -231,8 +262,12 @@ bool System::importInDocument(const Args_ImportInDocument& args)
             );
         }
 
-        if (!taskData.reader->readFile(taskData.filepath, &progress))
+        ScopedInstrumentationTimer timer(m_instrumentationSink, "import", "readFile", taskData.filepath);
+        timer.setFormat(formatIdentifier(taskData.fileFormat));
+        if (!taskData.reader->readFile(taskData.filepath, &progress)) {
+            timer.setOk(false);
             return fnReadFileError(taskData.filepath, textIdTr("File read problem"));
+        }
 
         return true;
     };
@@ -243,9 +278,13 @@ bool System::importInDocument(const Args_ImportInDocument& args)
 
         TaskProgress progress(taskData.progress, portionSize, textIdTr("Transferring file"));
         if (taskData.reader && !TaskProgress::isAbortRequested(&progress)) {
+            ScopedInstrumentationTimer timer(m_instrumentationSink, "import", "transfer", taskData.filepath);
+            timer.setFormat(formatIdentifier(taskData.fileFormat));
             taskData.seqTransferredEntity = taskData.reader->transfer(doc, &progress);
-            if (taskData.seqTransferredEntity.IsEmpty())
+            if (taskData.seqTransferredEntity.IsEmpty()) {
+                timer.setOk(false);
                 fnAddError(taskData.filepath, textIdTr("File transfer problem"));
+            }
         }
 
         taskData.transferred = true;
@@ -259,6 +298,8 @@ bool System::importInDocument(const Args_ImportInDocument& args)
                     args.entityPostProcessProgressSize,
                     args.entityPostProcessProgressStep
         );
+        ScopedInstrumentationTimer timer(m_instrumentationSink, "import", "postProcess", taskData.filepath);
+        timer.setFormat(formatIdentifier(taskData.fileFormat));
         const double subPortionSize = 100. / double(taskData.seqTransferredEntity.Size());
         for (const TDF_Label& labelEntity : taskData.seqTransferredEntity) {
             TaskProgress subProgress(&progress, subPortionSize);
@@ -324,6 +365,7 @@ bool System::importInDocument(const Args_ImportInDocument& args)
         } // endwhile
     }
 
+    timerImport.setOk(ok);
     return ok;
 }
 
@@ -335,9 +377,12 @@ bool System::exportApplicationItems(const Args_ExportApplicationItems& args)
 {
     TaskProgress* progress = args.progress ? args.progress : &TaskProgress::null();
     Messenger* messenger = args.messenger ? args.messenger : &Messenger::null();
-    auto fnError = [=](std::string_view errorMsg) {
+    ScopedInstrumentationTimer timerExport(m_instrumentationSink, "export", "total", args.targetFilepath);
+    timerExport.setFormat(formatIdentifier(args.targetFormat));
+    auto fnError = [&](std::string_view errorMsg) {
         const std::string strFilepath = args.targetFilepath.u8string();
         messenger->emitError(fmt::format(textIdTr("Error during export to '{}'\n{}"), strFilepath, errorMsg));
+        timerExport.setOk(false);
         return false;
     };
 
@@ -347,16 +392,36 @@ bool System::exportApplicationItems(const Args_ExportApplicationItems& args)
 
     writer->setMessenger(args.messenger);
     writer->applyProperties(args.parameters);
+    // Mesh data loaded on demand has to be resident until the file is written
+    const BRepDeferredMesh::Scope deferredMeshScope(applicationItemShapes(args.applicationItems));
+    if (writer->supportsStreaming()) {
+        TaskProgress writeProgress(progress, 100, textIdTr("Write"));
+        ScopedInstrumentationTimer timer(m_instrumentationSink, "export", "writeStreamed", args.targetFilepath);
+        timer.setFormat(formatIdentifier(args.targetFormat));
+        const bool okWrite = writer->writeStreamed(args.applicationItems, args.targetFilepath, &writeProgress);
+        timer.setOk(okWrite);
+        if (!okWrite)
+            return fnError(textIdTr("File write problem"));
+
+        return true;
+    }
+
     {
         TaskProgress transferProgress(progress, 40, textIdTr("Transfer"));
+        ScopedInstrumentationTimer timer(m_instrumentationSink, "export", "transfer", args.targetFilepath);
+        timer.setFormat(formatIdentifier(args.targetFormat));
         const bool okTransfer = writer->transfer(args.applicationItems, &transferProgress);
+        timer.setOk(okTransfer);
         if (!okTransfer)
             return fnError(textIdTr("File transfer problem"));
     }
 
     {
         TaskProgress writeProgress(progress, 60, textIdTr("Write"));
+        ScopedInstrumentationTimer timer(m_instrumentationSink, "export", "writeFile", args.targetFilepath);
+        timer.setFormat(formatIdentifier(args.targetFormat));
         const bool okWriteFile = writer->writeFile(args.targetFilepath, &writeProgress);
+        timer.setOk(okWriteFile);
         if (!okWriteFile)
             return fnError(textIdTr("File write problem"));
     }
@@ -548,6 +613,48 @@ bool matchRegExp_anyWhere(std::string_view str, const std::regex& rx)
     return std::regex_search(str.cbegin(), str.cend(), rx);
 }
 
+// Returns the complete lines of 'input' excerpt(last line is dropped if it might be truncated)
+// Blank lines and comment lines('#' or '//') are skipped
+std::vector<std::string_view> probeDataLines(const System::FormatProbeInput& input, size_t maxCount)
+{
+    std::vector<std::string_view> vecLine;
+    std::string_view str = input.contentsBegin;
+    const bool isComplete = str.size() == input.hintFullSize;
+    while (!str.empty() && vecLine.size() < maxCount) {
+        const size_t posNewLine = str.find('\n');
+        if (posNewLine == std::string_view::npos && !isComplete)
+            break;
+
+        std::string_view line = str.substr(0, posNewLine);
+        str = posNewLine != std::string_view::npos ? str.substr(posNewLine + 1) : std::string_view{};
+        const size_t posFirst = line.find_first_not_of(" \t\r");
+        if (posFirst == std::string_view::npos)
+            continue;
+
+        line.remove_prefix(posFirst);
+        if (line.front() == '#' || line.substr(0, 2) == "//")
+            continue;
+
+        vecLine.push_back(line);
+    }
+
+    return vecLine;
+}
+
+// Returns the count of numbers in 'line' if it's made of numbers only(separated by blanks, ',' or ';')
+int countNumbers(std::string_view line)
+{
+    static const std::regex rxNumbers{
+        R"(^\s*[-+]?([0-9]+\.?[0-9]*|\.[0-9]+)([eE][-+]?[0-9]+)?(\s*[,;\s]\s*[-+]?([0-9]+\.?[0-9]*|\.[0-9]+)([eE][-+]?[0-9]+)?)*\s*$)"
+    };
+    static const std::regex rxNumber{ R"([-+]?([0-9]+\.?[0-9]*|\.[0-9]+)([eE][-+]?[0-9]+)?)" };
+    if (!std::regex_match(line.cbegin(), line.cend(), rxNumbers))
+        return 0;
+
+    using Iterator = std::regex_iterator<std::string_view::const_iterator>;
+    return int(std::distance(Iterator(line.cbegin(), line.cend(), rxNumber), Iterator()));
+}
+
 } // namespace
 
 Format probeFormat_STEP(const System::FormatProbeInput& input)
@@ -564,7 +671,13 @@ Format probeFormat_IGES(const System::FormatProbeInput& input)
 
 Format probeFormat_OCCBREP(const System::FormatProbeInput& input)
 {
-    const std::regex rx{ R"(^\s*DBRep_DrawableShape)" };
+    // Binary variant(BinTools) starts with the header of the shape set
+    constexpr std::string_view binaryHeader = "Open CASCADE Topology V";
+    if (input.contentsBegin.substr(0, binaryHeader.size()) == binaryHeader)
+        return Format_OCCBREP;
+
+    // Text variant, "DBRep_DrawableShape" line is optional
+    const std::regex rx{ R"(^\s*(DBRep_DrawableShape\s+)?CASCADE Topology V[0-9]+,)" };
     return matchRegExp_atStart(input.contentsBegin, rx) ? Format_OCCBREP : Format_Unknown;
 }
 
@@ -617,6 +730,47 @@ Format probeFormat_OFF(const System::FormatProbeInput& input)
     return matchRegExp_atStart(input.contentsBegin, rx) ? Format_OFF : Format_Unknown;
 }
 
+Format probeFormat_XYZ(const System::FormatProbeInput& input)
+{
+    std::vector<std::string_view> vecLine = probeDataLines(input, 4);
+    // CSV files might start with a header line providing column names
+    if (!vecLine.empty() && countNumbers(vecLine.front()) == 0) {
+        const std::regex rxHeader{ R"(^\W*[xX]\W*[,;\s]\s*\W*[yY]\W*[,;\s]\s*\W*[zZ]\W*([,;\s].*)?$)" };
+        if (!std::regex_match(vecLine.front().cbegin(), vecLine.front().cend(), rxHeader))
+            return Format_Unknown;
+
+        vecLine.erase(vecLine.begin());
+    }
+
+    if (vecLine.empty())
+        return Format_Unknown;
+
+    // All lines must provide the same count of values, at least the 3 coordinates
+    const int valueCount = countNumbers(vecLine.front());
+    const bool isXyz = valueCount >= 3 && std::all_of(vecLine.cbegin(), vecLine.cend(), [=](std::string_view line) {
+        return countNumbers(line) == valueCount;
+    });
+    return isXyz ? Format_XYZ : Format_Unknown;
+}
+
+Format probeFormat_PTS(const System::FormatProbeInput& input)
+{
+    // Count of points on first line, then one point per line
+    const std::vector<std::string_view> vecLine = probeDataLines(input, 3);
+    if (vecLine.size() < 2 || !std::regex_match(vecLine.front().cbegin(), vecLine.front().cend(), std::regex{ R"(^[0-9]+\s*$)" }))
+        return Format_Unknown;
+
+    const bool isPts = std::all_of(vecLine.cbegin() + 1, vecLine.cend(), [](std::string_view line) {
+        return countNumbers(line) >= 3;
+    });
+    return isPts ? Format_PTS : Format_Unknown;
+}
+
+Format probeFormat_LAS(const System::FormatProbeInput& input)
+{
+    return input.contentsBegin.substr(0, 4) == "LASF" ? Format_LAS : Format_Unknown;
+}
+
 void addPredefinedFormatProbes(System* system)
 {
     if (!system)
@@ -629,6 +783,9 @@ void addPredefinedFormatProbes(System* system)
     system->addFormatProbe(probeFormat_OBJ);
     system->addFormatProbe(probeFormat_PLY);
     system->addFormatProbe(probeFormat_OFF);
+    system->addFormatProbe(probeFormat_LAS);
+    system->addFormatProbe(probeFormat_PTS);
+    system->addFormatProbe(probeFormat_XYZ);
 }
 
 } // namespace IO
@@ -16,6 +16,7 @@
 #include "span.h"
 #include "text_id.h"
 
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <string>
@@ -23,6 +24,7 @@
 
 namespace Mayo {
 
+class InstrumentationSink;
 class Messenger;
 class TaskProgress;
 
@@ -58,6 +60,11 @@ public:
     Span<const Format> readerFormats() const { return m_vecReaderFormat; }
     Span<const Format> writerFormats() const { return m_vecWriterFormat; }
 
+    // Optional receiver of timing/memory measures taken for each stage of import/export operations
+    // No measure is taken at all when null(the default). Can be changed while operations are running
+    InstrumentationSink* instrumentationSink() const { return m_instrumentationSink; }
+    void setInstrumentationSink(InstrumentationSink* sink) { m_instrumentationSink = sink; }
+
     //
     // Import service
     //
@@ -202,6 +209,7 @@ private:
     std::vector<Format> m_vecWriterFormat;
     std::vector<std::unique_ptr<FactoryReader>> m_vecFactoryReader;
     std::vector<std::unique_ptr<FactoryWriter>> m_vecFactoryWriter;
+    std::atomic<InstrumentationSink*> m_instrumentationSink = nullptr;
 };
 
 // Predefined
@@ -212,6 +220,9 @@ Format probeFormat_STL(const System::FormatProbeInput& input);
 Format probeFormat_OBJ(const System::FormatProbeInput& input);
 Format probeFormat_PLY(const System::FormatProbeInput& input);
 Format probeFormat_OFF(const System::FormatProbeInput& input);
+Format probeFormat_XYZ(const System::FormatProbeInput& input);
+Format probeFormat_PTS(const System::FormatProbeInput& input);
+Format probeFormat_LAS(const System::FormatProbeInput& input);
 void addPredefinedFormatProbes(System* system);
 
 } // namespace IO
@@ -5,9 +5,23 @@
 ****************************************************************************/
 
 #include "io_writer.h"
+#include "task_progress.h"
 
 namespace Mayo {
 namespace IO {
 
+bool Writer::writeStreamed(Span<const ApplicationItem> appItems, const FilePath& fp, TaskProgress* progress)
+{
+    progress = progress ? progress : &TaskProgress::null();
+    {
+        TaskProgress transferProgress(progress, 40);
+        if (!this->transfer(appItems, &transferProgress))
+            return false;
+    }
+
+    TaskProgress writeProgress(progress, 60);
+    return this->writeFile(fp, &writeProgress);
+}
+
 } // namespace IO
 } // namespace Mayo
@@ -24,6 +24,8 @@ namespace IO {
 // Provides services for writing files in two steps:
 //     - transfer a list of items to be written
 //     - write transferred items into target file
+// Alternatively a writer can support streaming, where items are traversed and serialized
+// incrementally into the target file, so the whole output isn't staged in memory
 class Writer : public MessengerClient {
 public:
     virtual ~Writer() = default;
@@ -38,6 +40,15 @@ public:
 
     // Apply properties contain in 'group' to the writer's parameter values(known in writer sub-class)
     virtual void applyProperties(const PropertyGroup* group) = 0;
+
+    // Whether writeStreamed() is supported, ie items can be written in a single pass with bounded
+    // memory buffers. When supported, transfer() and writeFile() steps are not needed
+    virtual bool supportsStreaming() const { return false; }
+
+    // Writes items(documents and document nodes) directly to the file at path 'fp'
+    // Default implementation just runs transfer() and writeFile() steps
+    // Returns 'true' on success
+    virtual bool writeStreamed(Span<const ApplicationItem> appItems, const FilePath& fp, TaskProgress* progress);
 };
 
 // Abstract base class for all writer factories
@@ -2,10 +2,13 @@
 
 #include "caf_utils.h"
 #include "brep_utils.h"
+#include "document.h"
 #include "triangulation_annex_data.h"
 #include "point_cloud_data.h"
 #include "xcaf.h"
 
+#include <TDocStd_Owner.hxx>
+
 namespace Mayo {
 
 LabelDataFlags findLabelDataFlags(const TDF_Label& label)
@@ -31,4 +34,16 @@ LabelDataFlags findLabelDataFlags(const TDF_Label& label)
     return flags;
 }
 
+void invalidateLabelDataFlags(const TDF_Label& label)
+{
+    // Document::findFrom() throws if 'label' isn't owned by a document
+    OccHandle<TDocStd_Owner> owner;
+    if (label.IsNull() || !label.Root().FindAttribute(TDocStd_Owner::GetID(), owner))
+        return;
+
+    DocumentPtr doc = DocumentPtr::DownCast(owner->GetDocument());
+    if (doc)
+        doc->invalidateLabelDataFlags(label);
+}
+
 } // namespace Mayo
@@ -27,4 +27,7 @@ using LabelDataFlags = unsigned;
 
 LabelDataFlags findLabelDataFlags(const TDF_Label& label);
 
+// Drops the data flags of 'label' cached by its document(see Document::labelDataFlags())
+void invalidateLabelDataFlags(const TDF_Label& label);
+
 } // namespace Mayo
@@ -0,0 +1,260 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "mass_properties.h"
+
+#include "brep_utils.h"
+#include "math_utils.h"
+#include "occ_handle.h"
+#include "task_progress.h"
+
+#include <BRep_Builder.hxx>
+#include <BRep_Tool.hxx>
+#include <BRepGProp.hxx>
+#include <GProp_GProps.hxx>
+#include <OSD_Parallel.hxx>
+#include <Poly_Triangulation.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS.hxx>
+#include <TopoDS_Compound.hxx>
+
+#include <atomic>
+#include <cmath>
+#include <vector>
+
+namespace Mayo {
+
+namespace {
+
+gp_Mat outerProduct(const gp_XYZ& u, const gp_XYZ& v)
+{
+    return gp_Mat(u * v.X(), u * v.Y(), u * v.Z());
+}
+
+gp_Mat scaledIdentity(double value)
+{
+    return gp_Mat(value, 0., 0., 0., value, 0., 0., 0., value);
+}
+
+// Inertia of a point mass 'mass' at 'offset' from the reference point(parallel axis theorem)
+gp_Mat pointMassInertia(double mass, const gp_XYZ& offset)
+{
+    return (scaledIdentity(offset.SquareModulus()) - outerProduct(offset, offset)) * mass;
+}
+
+bool hasOnlyGeometricFaces(const TopoDS_Shape& shape)
+{
+    for (TopExp_Explorer expl(shape, TopAbs_FACE); expl.More(); expl.Next()) {
+        if (!BRepUtils::isGeometric(TopoDS::Face(expl.Current())))
+            return false;
+    }
+
+    return true;
+}
+
+// Sum over the signed tetrahedra formed by a reference point and each triangle of closed surfaces
+// Reference point is the first node found, this limits precision loss with far away bodies
+class TriangulationIntegrals {
+public:
+    void add(const OccHandle<Poly_Triangulation>& triangulation, const TopLoc_Location& loc, bool isReversed)
+    {
+        if (triangulation.IsNull() || triangulation->NbNodes() == 0)
+            return;
+
+        const gp_Trsf& trsf = loc.Transformation();
+        auto fnNode = [&](int i) {
+            gp_Pnt pnt = triangulation->Node(i);
+            if (!loc.IsIdentity())
+                pnt.Transform(trsf);
+
+            return pnt.XYZ();
+        };
+
+        if (!m_hasRefPoint) {
+            m_refPoint = fnNode(1);
+            m_hasRefPoint = true;
+        }
+
+        for (int i = 1; i <= triangulation->NbTriangles(); ++i) {
+            int n1, n2, n3;
+            triangulation->Triangle(i).Get(n1, n2, n3);
+            if (isReversed)
+                std::swap(n2, n3);
+
+            const gp_XYZ a = fnNode(n1) - m_refPoint;
+            const gp_XYZ b = fnNode(n2) - m_refPoint;
+            const gp_XYZ c = fnNode(n3) - m_refPoint;
+            const double det = a.Dot(b.Crossed(c));
+            const gp_XYZ sum = a + b + c;
+            m_sixVolume += det;
+            m_firstMoment += sum * det;
+            m_secondMoment += (outerProduct(a, a) + outerProduct(b, b) + outerProduct(c, c) + outerProduct(sum, sum)) * det;
+        }
+    }
+
+    MassProperties result() const
+    {
+        MassProperties props;
+        if (MathUtils::fuzzyIsNull(m_sixVolume))
+            return props;
+
+        props.mass = m_sixVolume / 6.;
+        const gp_XYZ center = m_firstMoment / (4. * m_sixVolume);
+        props.centerOfMass = m_refPoint + center;
+        const gp_Mat covariance = m_secondMoment / 120.;
+        const double trace = covariance.Value(1, 1) + covariance.Value(2, 2) + covariance.Value(3, 3);
+        const gp_Mat inertiaAtRef = scaledIdentity(trace) - covariance;
+        props.inertia = inertiaAtRef - pointMassInertia(props.mass, center);
+        return props;
+    }
+
+private:
+    bool m_hasRefPoint = false;
+    gp_XYZ m_refPoint;
+    double m_sixVolume = 0.;
+    gp_XYZ m_firstMoment; // Scaled by 24
+    gp_Mat m_secondMoment{ 0., 0., 0., 0., 0., 0., 0., 0., 0. }; // Scaled by 120
+};
+
+MassProperties computeBody(const TopoDS_Shape& body)
+{
+    MassProperties props;
+    if (hasOnlyGeometricFaces(body)) {
+        GProp_GProps gprops;
+        BRepGProp::VolumeProperties(body, gprops);
+        props.mass = gprops.Mass();
+        props.centerOfMass = gprops.CentreOfMass();
+        props.inertia = gprops.MatrixOfInertia();
+    }
+    else {
+        props = MassProperties::computeFromTriangulations(body);
+    }
+
+    // Reversed shells(or inconsistently oriented faces) give a negative volume, it has to be
+    // fixed per body before accumulation
+    if (props.mass < 0.)
+        props = props.scaled(-1.);
+
+    return props;
+}
+
+} // namespace
+
+bool MassProperties::isNull() const
+{
+    return MathUtils::fuzzyIsNull(this->mass);
+}
+
+void MassProperties::add(const MassProperties& other)
+{
+    if (other.isNull())
+        return;
+
+    if (this->isNull()) {
+        *this = other;
+        return;
+    }
+
+    const double totalMass = this->mass + other.mass;
+    const gp_XYZ center = (this->centerOfMass.XYZ() * this->mass + other.centerOfMass.XYZ() * other.mass) / totalMass;
+    this->inertia =
+        this->inertia + pointMassInertia(this->mass, this->centerOfMass.XYZ() - center)
+        + other.inertia + pointMassInertia(other.mass, other.centerOfMass.XYZ() - center);
+    this->mass = totalMass;
+    this->centerOfMass = center;
+}
+
+MassProperties MassProperties::transformed(const gp_Trsf& trsf) const
+{
+    // Vectorial part without scale factor, so it's a rotation(possibly with symmetry)
+    const gp_Mat rotation = trsf.HVectorialPart();
+    const double scale = std::abs(trsf.ScaleFactor());
+    MassProperties props;
+    props.mass = this->mass * scale * scale * scale;
+    props.centerOfMass = this->centerOfMass.Transformed(trsf);
+    props.inertia = rotation * this->inertia * rotation.Transposed() * std::pow(scale, 5);
+    return props;
+}
+
+MassProperties MassProperties::scaled(double density) const
+{
+    MassProperties props = *this;
+    props.mass *= density;
+    props.inertia *= density;
+    return props;
+}
+
+MassProperties MassProperties::compute(const TopoDS_Shape& shape, TaskProgress* progress)
+{
+    progress = progress ? progress : &TaskProgress::null();
+    if (shape.IsNull())
+        return {};
+
+    // Bodies are the solids and the shells not bound to solids
+    // Faces not bound to shells(eg triangulation face of mesh parts) are gathered in a single body
+    std::vector<TopoDS_Shape> vecBody;
+    for (TopExp_Explorer expl(shape, TopAbs_SOLID); expl.More(); expl.Next())
+        vecBody.push_back(expl.Current());
+
+    for (TopExp_Explorer expl(shape, TopAbs_SHELL, TopAbs_SOLID); expl.More(); expl.Next())
+        vecBody.push_back(expl.Current());
+
+    {
+        BRep_Builder builder;
+        TopoDS_Compound compFreeFaces;
+        builder.MakeCompound(compFreeFaces);
+        bool hasFreeFaces = false;
+        for (TopExp_Explorer expl(shape, TopAbs_FACE, TopAbs_SHELL); expl.More(); expl.Next()) {
+            builder.Add(compFreeFaces, expl.Current());
+            hasFreeFaces = true;
+        }
+
+        if (hasFreeFaces)
+            vecBody.push_back(compFreeFaces);
+    }
+
+    std::vector<MassProperties> vecBodyProps(vecBody.size());
+    std::atomic<int> doneCount = 0;
+    OSD_Parallel::For(0, int(vecBody.size()), [&](int i) {
+        if (progress->isAbortRequested())
+            return;
+
+        vecBodyProps.at(i) = computeBody(vecBody.at(i));
+        progress->setValue(MathUtils::toPercent(++doneCount, 0, int(vecBody.size())));
+    }, vecBody.size() <= 1);
+
+    if (progress->isAbortRequested())
+        return {};
+
+    // Accumulation in body order, so result doesn't depend on thread scheduling
+    MassProperties props;
+    for (const MassProperties& bodyProps : vecBodyProps)
+        props.add(bodyProps);
+
+    return props;
+}
+
+MassProperties MassProperties::computeFromTriangulations(const TopoDS_Shape& shape)
+{
+    TriangulationIntegrals integrals;
+    for (TopExp_Explorer expl(shape, TopAbs_FACE); expl.More(); expl.Next()) {
+        const TopoDS_Face& face = TopoDS::Face(expl.Current());
+        TopLoc_Location loc;
+        const OccHandle<Poly_Triangulation>& triangulation = BRep_Tool::Triangulation(face, loc);
+        integrals.add(triangulation, loc, face.Orientation() == TopAbs_REVERSED);
+    }
+
+    return integrals.result();
+}
+
+MassProperties MassProperties::computeFromTriangulation(const OccHandle<Poly_Triangulation>& triangulation)
+{
+    TriangulationIntegrals integrals;
+    integrals.add(triangulation, TopLoc_Location(), false);
+    return integrals.result();
+}
+
+} // namespace Mayo
@@ -0,0 +1,56 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "occ_handle.h"
+
+#include <gp_Mat.hxx>
+#include <gp_Pnt.hxx>
+#include <gp_Trsf.hxx>
+
+class Poly_Triangulation;
+class TopoDS_Shape;
+
+namespace Mayo {
+
+class TaskProgress;
+
+// Mass, center of mass and inertia tensor of a body
+// Properties computed from geometry are at unit density: 'mass' is then the volume of the body and
+// 'inertia' its second moment of volume
+struct MassProperties {
+    double mass = 0.;
+    gp_Pnt centerOfMass;
+    // Inertia tensor at the center of mass, axes parallel to the reference frame
+    gp_Mat inertia{ 0., 0., 0., 0., 0., 0., 0., 0., 0. };
+
+    bool isNull() const;
+
+    // Combines the properties of 'other' body, bodies are assumed to be disjoint
+    void add(const MassProperties& other);
+
+    // Properties of the body moved by 'trsf'(rigid transformation, possibly scaled)
+    MassProperties transformed(const gp_Trsf& trsf) const;
+
+    // Properties of the body made of a material of uniform 'density'
+    MassProperties scaled(double density) const;
+
+    // Volume properties of the solids contained in 'shape', computed in parallel per solid
+    // Bodies having some non-geometric faces(eg mesh parts) are integrated over their triangulations
+    // Volume of each body is made positive whatever its orientation
+    // Returns null properties if the computation was aborted through 'progress'
+    static MassProperties compute(const TopoDS_Shape& shape, TaskProgress* progress = nullptr);
+
+    // Volume properties of the closed surface formed by the face triangulations of 'shape'
+    // Runs in linear time, exact for the polyhedron defined by the triangles
+    static MassProperties computeFromTriangulations(const TopoDS_Shape& shape);
+
+    // Volume properties of the closed surface formed by 'triangulation'
+    static MassProperties computeFromTriangulation(const OccHandle<Poly_Triangulation>& triangulation);
+};
+
+} // namespace Mayo
@@ -0,0 +1,128 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "memory_mapped_file.h"
+
+#ifdef _WIN32
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace Mayo {
+
+MemoryMappedFile::MemoryMappedFile(const FilePath& fp)
+{
+    this->open(fp);
+}
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+    this->close();
+}
+
+bool MemoryMappedFile::open(const FilePath& fp)
+{
+    this->close();
+#ifdef _WIN32
+    HANDLE hFile = CreateFileW(
+        fp.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr
+    );
+    if (hFile == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize = {};
+    if (!GetFileSizeEx(hFile, &fileSize)) {
+        CloseHandle(hFile);
+        return false;
+    }
+
+    m_hFile = hFile;
+    m_isOpen = true;
+    if (fileSize.QuadPart == 0)
+        return true;
+
+    HANDLE hFileMapping = CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!hFileMapping) {
+        this->close();
+        return false;
+    }
+
+    m_hFileMapping = hFileMapping;
+    const void* ptr = MapViewOfFile(hFileMapping, FILE_MAP_READ, 0, 0, 0);
+    if (!ptr) {
+        this->close();
+        return false;
+    }
+
+    m_data = static_cast<const char*>(ptr);
+    m_size = static_cast<std::size_t>(fileSize.QuadPart);
+    return true;
+#else
+    const int fd = ::open(fp.c_str(), O_RDONLY);
+    if (fd == -1)
+        return false;
+
+    struct stat fileStat = {};
+    if (::fstat(fd, &fileStat) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    m_isOpen = true;
+    if (fileStat.st_size == 0) {
+        ::close(fd);
+        return true;
+    }
+
+    const auto fileSize = static_cast<std::size_t>(fileStat.st_size);
+    void* ptr = ::mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // Mapping keeps a reference on the file
+    if (ptr == MAP_FAILED) {
+        m_isOpen = false;
+        return false;
+    }
+
+#  ifdef POSIX_MADV_SEQUENTIAL
+    ::posix_madvise(ptr, fileSize, POSIX_MADV_SEQUENTIAL);
+#  endif
+    m_data = static_cast<const char*>(ptr);
+    m_size = fileSize;
+    return true;
+#endif
+}
+
+void MemoryMappedFile::close()
+{
+#ifdef _WIN32
+    if (m_data)
+        UnmapViewOfFile(m_data);
+
+    if (m_hFileMapping)
+        CloseHandle(static_cast<HANDLE>(m_hFileMapping));
+
+    if (m_hFile)
+        CloseHandle(static_cast<HANDLE>(m_hFile));
+
+    m_hFile = nullptr;
+    m_hFileMapping = nullptr;
+#else
+    if (m_data)
+        ::munmap(const_cast<char*>(m_data), m_size);
+#endif
+
+    m_data = nullptr;
+    m_size = 0;
+    m_isOpen = false;
+}
+
+} // namespace Mayo
@@ -0,0 +1,53 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "filepath.h"
+
+#include <cstddef>
+#include <string_view>
+
+namespace Mayo {
+
+// Provides read-only access to the contents of a file mapped into memory
+// The file contents are paged in lazily by the operating system, so this is well suited to parse
+// big files without having to copy them in intermediate buffers
+class MemoryMappedFile {
+public:
+    MemoryMappedFile() = default;
+    MemoryMappedFile(const FilePath& fp);
+    ~MemoryMappedFile();
+
+    // Not copyable
+    MemoryMappedFile(const MemoryMappedFile&) = delete;
+    MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+    // Maps file at path 'fp' into memory, any previously mapped file is first unmapped
+    // Returns 'true' on success. Note that an empty file is reported as success with null data()
+    bool open(const FilePath& fp);
+    void close();
+
+    bool isOpen() const { return m_isOpen; }
+
+    const char* data() const { return m_data; }
+    std::size_t size() const { return m_size; }
+    std::string_view contents() const { return { m_data, m_size }; }
+
+    const char* begin() const { return m_data; }
+    const char* end() const { return m_data + m_size; }
+
+private:
+    const char* m_data = nullptr;
+    std::size_t m_size = 0;
+    bool m_isOpen = false;
+#ifdef _WIN32
+    void* m_hFile = nullptr;
+    void* m_hFileMapping = nullptr;
+#endif
+};
+
+} // namespace Mayo
@@ -0,0 +1,81 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "memory_utils.h"
+
+#if defined(_WIN32)
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <windows.h>
+#  include <psapi.h>
+#elif defined(__APPLE__)
+#  include <mach/mach.h>
+#  include <sys/resource.h>
+#else
+#  include <sys/resource.h>
+#  include <unistd.h>
+#  include <cstdio>
+#endif
+
+namespace Mayo {
+namespace MemoryUtils {
+
+std::uint64_t residentSetSize()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters = {};
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return counters.WorkingSetSize;
+
+    return 0;
+#elif defined(__APPLE__)
+    mach_task_basic_info info = {};
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    const kern_return_t err = task_info(
+        mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count
+    );
+    return err == KERN_SUCCESS ? info.resident_size : 0;
+#else
+    // Second field of /proc/self/statm is the resident set size, counted in pages
+    std::FILE* file = std::fopen("/proc/self/statm", "r");
+    if (!file)
+        return 0;
+
+    unsigned long long pageCountTotal = 0;
+    unsigned long long pageCountResident = 0;
+    const int fieldCount = std::fscanf(file, "%llu %llu", &pageCountTotal, &pageCountResident);
+    std::fclose(file);
+    if (fieldCount != 2)
+        return 0;
+
+    return static_cast<std::uint64_t>(pageCountResident) * sysconf(_SC_PAGESIZE);
+#endif
+}
+
+std::uint64_t peakResidentSetSize()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters = {};
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return counters.PeakWorkingSetSize;
+
+    return 0;
+#else
+    struct rusage usage = {};
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+
+#  if defined(__APPLE__)
+    return static_cast<std::uint64_t>(usage.ru_maxrss); // Bytes on macOS
+#  else
+    return static_cast<std::uint64_t>(usage.ru_maxrss) * 1024; // Kilobytes on Linux/BSD
+#  endif
+#endif
+}
+
+} // namespace MemoryUtils
+} // namespace Mayo
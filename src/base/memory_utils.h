@@ -0,0 +1,24 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+
+namespace Mayo {
+
+// Provides helper functions to query memory usage of the current process
+namespace MemoryUtils {
+
+// Returns current resident set size(physical memory in use) in bytes, 0 if not available
+std::uint64_t residentSetSize();
+
+// Returns peak resident set size reached so far in bytes, 0 if not available
+std::uint64_t peakResidentSetSize();
+
+} // namespace MemoryUtils
+
+} // namespace Mayo
@@ -0,0 +1,505 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "mesh_bvh.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace Mayo {
+
+namespace {
+
+constexpr uint32_t MaxLeafTriangleCount = 4;
+
+struct BuildItem {
+    int triangle;
+    gp_XYZ pnts[3];
+    gp_XYZ centroid;
+};
+
+gp_XYZ minXYZ(const gp_XYZ& u, const gp_XYZ& v)
+{
+    return { std::min(u.X(), v.X()), std::min(u.Y(), v.Y()), std::min(u.Z(), v.Z()) };
+}
+
+gp_XYZ maxXYZ(const gp_XYZ& u, const gp_XYZ& v)
+{
+    return { std::max(u.X(), v.X()), std::max(u.Y(), v.Y()), std::max(u.Z(), v.Z()) };
+}
+
+// Builds the subtree of items [begin, end[ and returns the index of its root node
+int32_t buildNode(std::vector<MeshBvh::Node>& vecNode, std::vector<BuildItem>& vecItem, uint32_t begin, uint32_t end)
+{
+    const auto inode = int32_t(vecNode.size());
+    vecNode.emplace_back();
+    const double inf = std::numeric_limits<double>::max();
+    gp_XYZ cornerMin(inf, inf, inf);
+    gp_XYZ cornerMax(-inf, -inf, -inf);
+    gp_XYZ centroidMin = cornerMin;
+    gp_XYZ centroidMax = cornerMax;
+    for (uint32_t i = begin; i < end; ++i) {
+        for (const gp_XYZ& pnt : vecItem[i].pnts) {
+            cornerMin = minXYZ(cornerMin, pnt);
+            cornerMax = maxXYZ(cornerMax, pnt);
+        }
+
+        centroidMin = minXYZ(centroidMin, vecItem[i].centroid);
+        centroidMax = maxXYZ(centroidMax, vecItem[i].centroid);
+    }
+
+    vecNode[inode].cornerMin = cornerMin;
+    vecNode[inode].cornerMax = cornerMax;
+
+    // Split along the longest axis of centroids, unless they are all confused
+    const gp_XYZ extent = centroidMax - centroidMin;
+    int axis = 1;
+    if (extent.Y() > extent.Coord(axis))
+        axis = 2;
+    if (extent.Z() > extent.Coord(axis))
+        axis = 3;
+
+    if (end - begin <= MaxLeafTriangleCount || extent.Coord(axis) <= 0.) {
+        vecNode[inode].first = begin;
+        vecNode[inode].count = end - begin;
+        return inode;
+    }
+
+    const uint32_t mid = begin + (end - begin) / 2;
+    std::nth_element(
+        vecItem.begin() + begin, vecItem.begin() + mid, vecItem.begin() + end,
+        [=](const BuildItem& lhs, const BuildItem& rhs) {
+            return lhs.centroid.Coord(axis) < rhs.centroid.Coord(axis);
+        }
+    );
+    buildNode(vecNode, vecItem, begin, mid); // Left child is next to 'inode'
+    const int32_t rightChild = buildNode(vecNode, vecItem, mid, end);
+    vecNode[inode].rightChild = rightChild;
+    return inode;
+}
+
+double squareDistance(const gp_XYZ& pnt, const MeshBvh::Node& node)
+{
+    double sqDist = 0.;
+    for (int i = 1; i <= 3; ++i) {
+        const double d = std::max({ 0., node.cornerMin.Coord(i) - pnt.Coord(i), pnt.Coord(i) - node.cornerMax.Coord(i) });
+        sqDist += d * d;
+    }
+
+    return sqDist;
+}
+
+double squareDistance(const gp_XYZ& min1, const gp_XYZ& max1, const gp_XYZ& min2, const gp_XYZ& max2)
+{
+    double sqDist = 0.;
+    for (int i = 1; i <= 3; ++i) {
+        const double d = std::max({ 0., min1.Coord(i) - max2.Coord(i), min2.Coord(i) - max1.Coord(i) });
+        sqDist += d * d;
+    }
+
+    return sqDist;
+}
+
+double clamp01(double t)
+{
+    return std::clamp(t, 0., 1.);
+}
+
+// Nearest points between segments [p1, q1] and [p2, q2], returns their square distance
+// See "Real-Time Collision Detection", C. Ericson, section 5.1.9
+double nearestPointsSegmentSegment(
+        const gp_XYZ& p1, const gp_XYZ& q1, const gp_XYZ& p2, const gp_XYZ& q2, gp_XYZ* c1, gp_XYZ* c2
+    )
+{
+    const gp_XYZ d1 = q1 - p1;
+    const gp_XYZ d2 = q2 - p2;
+    const gp_XYZ r = p1 - p2;
+    const double a = d1.SquareModulus();
+    const double e = d2.SquareModulus();
+    const double f = d2.Dot(r);
+    constexpr double eps = std::numeric_limits<double>::min();
+    double s = 0.;
+    double t = 0.;
+    if (a <= eps && e <= eps) {
+        // Both segments degenerate into points
+    }
+    else if (a <= eps) {
+        t = clamp01(f / e);
+    }
+    else {
+        const double c = d1.Dot(r);
+        if (e <= eps) {
+            s = clamp01(-c / a);
+        }
+        else {
+            const double b = d1.Dot(d2);
+            const double denom = a * e - b * b;
+            s = denom > 0. ? clamp01((b * f - c * e) / denom) : 0.;
+            t = (b * s + f) / e;
+            if (t < 0.) {
+                t = 0.;
+                s = clamp01(-c / a);
+            }
+            else if (t > 1.) {
+                t = 1.;
+                s = clamp01((b - c) / a);
+            }
+        }
+    }
+
+    *c1 = p1 + d1 * s;
+    *c2 = p2 + d2 * t;
+    return (*c1 - *c2).SquareModulus();
+}
+
+// Point of triangle(a, b, c) nearest to 'p'
+// See "Real-Time Collision Detection", C. Ericson, section 5.1.5
+gp_XYZ nearestPointOnTriangle(const gp_XYZ& p, const gp_XYZ& a, const gp_XYZ& b, const gp_XYZ& c)
+{
+    const gp_XYZ ab = b - a;
+    const gp_XYZ ac = c - a;
+    const gp_XYZ ap = p - a;
+    const double d1 = ab.Dot(ap);
+    const double d2 = ac.Dot(ap);
+    if (d1 <= 0. && d2 <= 0.)
+        return a;
+
+    const gp_XYZ bp = p - b;
+    const double d3 = ab.Dot(bp);
+    const double d4 = ac.Dot(bp);
+    if (d3 >= 0. && d4 <= d3)
+        return b;
+
+    const double vc = d1 * d4 - d3 * d2;
+    if (vc <= 0. && d1 >= 0. && d3 <= 0.)
+        return a + ab * (d1 / (d1 - d3));
+
+    const gp_XYZ cp = p - c;
+    const double d5 = ab.Dot(cp);
+    const double d6 = ac.Dot(cp);
+    if (d6 >= 0. && d5 <= d6)
+        return c;
+
+    const double vb = d5 * d2 - d1 * d6;
+    if (vb <= 0. && d2 >= 0. && d6 <= 0.)
+        return a + ac * (d2 / (d2 - d6));
+
+    const double va = d3 * d6 - d5 * d4;
+    if (va <= 0. && (d4 - d3) >= 0. && (d5 - d6) >= 0.)
+        return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+    const double sum = va + vb + vc;
+    if (sum <= std::numeric_limits<double>::min()) {
+        // Degenerated triangle, falls back to its edges
+        gp_XYZ pnt;
+        gp_XYZ pntEdge;
+        gp_XYZ pntNearest = a;
+        double sqDistMin = std::numeric_limits<double>::max();
+        const gp_XYZ* vertices[] = { &a, &b, &c };
+        for (int i = 0; i < 3; ++i) {
+            const double sqDist = nearestPointsSegmentSegment(p, p, *vertices[i], *vertices[(i + 1) % 3], &pnt, &pntEdge);
+            if (sqDist < sqDistMin) {
+                sqDistMin = sqDist;
+                pntNearest = pntEdge;
+            }
+        }
+
+        return pntNearest;
+    }
+
+    return a + ab * (vb / sum) + ac * (vc / sum);
+}
+
+// Intersection of segment [p, q] with triangle(a, b, c), Möller-Trumbore algorithm
+// Segments parallel to the triangle are reported as not intersecting
+bool intersectSegmentTriangle(
+        const gp_XYZ& p, const gp_XYZ& q, const gp_XYZ& a, const gp_XYZ& b, const gp_XYZ& c, gp_XYZ* pnt
+    )
+{
+    const gp_XYZ dir = q - p;
+    const gp_XYZ e1 = b - a;
+    const gp_XYZ e2 = c - a;
+    const gp_XYZ h = dir.Crossed(e2);
+    const double det = e1.Dot(h);
+    if (std::abs(det) <= std::numeric_limits<double>::min())
+        return false;
+
+    const double invDet = 1. / det;
+    const gp_XYZ s = p - a;
+    const double u = invDet * s.Dot(h);
+    if (u < 0. || u > 1.)
+        return false;
+
+    const gp_XYZ sxe1 = s.Crossed(e1);
+    const double v = invDet * dir.Dot(sxe1);
+    if (v < 0. || u + v > 1.)
+        return false;
+
+    const double t = invDet * e2.Dot(sxe1);
+    if (t < 0. || t > 1.)
+        return false;
+
+    *pnt = p + dir * t;
+    return true;
+}
+
+// Nearest points between triangles 'tri1' and 'tri2', returns their square distance
+double nearestPointsTriangleTriangle(const gp_XYZ* tri1, const gp_XYZ* tri2, gp_XYZ* c1, gp_XYZ* c2)
+{
+    // Triangles intersect if and only if an edge of one of them crosses the other one(coplanar
+    // overlaps are found below by edge/edge and vertex/triangle tests)
+    gp_XYZ pnt;
+    for (int i = 0; i < 3; ++i) {
+        if (intersectSegmentTriangle(tri1[i], tri1[(i + 1) % 3], tri2[0], tri2[1], tri2[2], &pnt)
+            || intersectSegmentTriangle(tri2[i], tri2[(i + 1) % 3], tri1[0], tri1[1], tri1[2], &pnt))
+        {
+            *c1 = pnt;
+            *c2 = pnt;
+            return 0.;
+        }
+    }
+
+    // Otherwise nearest points are a vertex and its projection on the other triangle, or are on
+    // two edges
+    double sqDistMin = std::numeric_limits<double>::max();
+    auto fnUpdate = [&](const gp_XYZ& pnt1, const gp_XYZ& pnt2) {
+        const double sqDist = (pnt1 - pnt2).SquareModulus();
+        if (sqDist < sqDistMin) {
+            sqDistMin = sqDist;
+            *c1 = pnt1;
+            *c2 = pnt2;
+        }
+    };
+
+    for (int i = 0; i < 3; ++i) {
+        fnUpdate(tri1[i], nearestPointOnTriangle(tri1[i], tri2[0], tri2[1], tri2[2]));
+        fnUpdate(nearestPointOnTriangle(tri2[i], tri1[0], tri1[1], tri1[2]), tri2[i]);
+    }
+
+    gp_XYZ pnt1;
+    gp_XYZ pnt2;
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            nearestPointsSegmentSegment(tri1[i], tri1[(i + 1) % 3], tri2[j], tri2[(j + 1) % 3], &pnt1, &pnt2);
+            fnUpdate(pnt1, pnt2);
+        }
+    }
+
+    return sqDistMin;
+}
+
+} // namespace
+
+MeshBvh::MeshBvh(const OccHandle<Poly_Triangulation>& triangulation)
+{
+    if (triangulation) {
+        std::vector<int> vecTriangle(triangulation->NbTriangles());
+        std::iota(vecTriangle.begin(), vecTriangle.end(), 1);
+        this->build(triangulation, std::move(vecTriangle));
+    }
+}
+
+MeshBvh::MeshBvh(const OccHandle<Poly_Triangulation>& triangulation, Span<const int> triangles)
+{
+    if (triangulation)
+        this->build(triangulation, std::vector<int>(triangles.begin(), triangles.end()));
+}
+
+void MeshBvh::build(const OccHandle<Poly_Triangulation>& triangulation, std::vector<int>&& vecTriangle)
+{
+    if (vecTriangle.empty())
+        return;
+
+    std::vector<BuildItem> vecItem(vecTriangle.size());
+    for (size_t i = 0; i < vecTriangle.size(); ++i) {
+        BuildItem& item = vecItem[i];
+        int n1, n2, n3;
+        triangulation->Triangle(vecTriangle[i]).Get(n1, n2, n3);
+        item.triangle = vecTriangle[i];
+        item.pnts[0] = triangulation->Node(n1).XYZ();
+        item.pnts[1] = triangulation->Node(n2).XYZ();
+        item.pnts[2] = triangulation->Node(n3).XYZ();
+        item.centroid = (item.pnts[0] + item.pnts[1] + item.pnts[2]) / 3.;
+    }
+
+    m_vecNode.reserve(2 * (vecItem.size() / MaxLeafTriangleCount) + 1);
+    buildNode(m_vecNode, vecItem, 0, uint32_t(vecItem.size()));
+
+    m_vecTriangle.resize(vecItem.size());
+    m_vecTrianglePoint.resize(3 * vecItem.size());
+    for (size_t i = 0; i < vecItem.size(); ++i) {
+        m_vecTriangle[i] = vecItem[i].triangle;
+        std::copy(std::cbegin(vecItem[i].pnts), std::cend(vecItem[i].pnts), m_vecTrianglePoint.begin() + 3 * i);
+    }
+}
+
+MeshBvh::Nearest MeshBvh::nearestTo(const gp_Pnt& pnt) const
+{
+    Nearest nearest;
+    if (this->isEmpty())
+        return nearest;
+
+    struct StackItem {
+        int32_t node;
+        double sqDist;
+    };
+
+    const gp_XYZ p = pnt.XYZ();
+    double sqDistMin = std::numeric_limits<double>::max();
+    std::vector<StackItem> stack;
+    stack.push_back({ 0, squareDistance(p, m_vecNode.front()) });
+    while (!stack.empty()) {
+        const StackItem item = stack.back();
+        stack.pop_back();
+        if (item.sqDist >= sqDistMin)
+            continue;
+
+        const Node& node = m_vecNode[item.node];
+        if (node.isLeaf()) {
+            for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+                const gp_XYZ* tri = this->trianglePoints(i);
+                const gp_XYZ q = nearestPointOnTriangle(p, tri[0], tri[1], tri[2]);
+                const double sqDist = (q - p).SquareModulus();
+                if (sqDist < sqDistMin) {
+                    sqDistMin = sqDist;
+                    nearest.pnt1 = q;
+                    nearest.triangle1 = m_vecTriangle[i];
+                }
+            }
+        }
+        else {
+            // Nearest child is pushed last, so it's visited first
+            StackItem left{ item.node + 1, squareDistance(p, m_vecNode[item.node + 1]) };
+            StackItem right{ node.rightChild, squareDistance(p, m_vecNode[node.rightChild]) };
+            if (left.sqDist < right.sqDist)
+                std::swap(left, right);
+
+            stack.push_back(left);
+            stack.push_back(right);
+        }
+    }
+
+    nearest.pnt2 = pnt;
+    nearest.distance = std::sqrt(sqDistMin);
+    return nearest;
+}
+
+MeshBvh::Nearest MeshBvh::nearestTo(const gp_Trsf& trsf, const MeshBvh& other, const gp_Trsf& otherTrsf) const
+{
+    Nearest nearest;
+    if (this->isEmpty() || other.isEmpty())
+        return nearest;
+
+    // Queries are done in the frame of this hierarchy, 'other' is moved into it
+    const gp_Trsf relTrsf = trsf.Inverted().Multiplied(otherTrsf);
+    const gp_Mat relRotation = relTrsf.HVectorialPart();
+    const double relScale = std::abs(relTrsf.ScaleFactor());
+
+    // Axis-aligned box enclosing the box of 'otherNode' moved by 'relTrsf'
+    struct Box {
+        gp_XYZ cornerMin;
+        gp_XYZ cornerMax;
+        double diagonal() const { return (cornerMax - cornerMin).SquareModulus(); }
+    };
+    auto fnOtherBox = [&](const Node& otherNode) {
+        gp_XYZ center = (otherNode.cornerMin + otherNode.cornerMax) / 2.;
+        relTrsf.Transforms(center);
+        const gp_XYZ halfSize = (otherNode.cornerMax - otherNode.cornerMin) / 2.;
+        gp_XYZ halfSizeMoved;
+        for (int i = 1; i <= 3; ++i) {
+            double coord = 0.;
+            for (int j = 1; j <= 3; ++j)
+                coord += std::abs(relRotation.Value(i, j)) * halfSize.Coord(j);
+
+            halfSizeMoved.SetCoord(i, relScale * coord);
+        }
+
+        return Box{ center - halfSizeMoved, center + halfSizeMoved };
+    };
+
+    struct StackItem {
+        int32_t node1;
+        int32_t node2;
+        Box box2;
+        double sqDist;
+    };
+    auto fnStackItem = [&](int32_t inode1, int32_t inode2, const Box& box2) {
+        const Node& node1 = m_vecNode[inode1];
+        const double sqDist = squareDistance(node1.cornerMin, node1.cornerMax, box2.cornerMin, box2.cornerMax);
+        return StackItem{ inode1, inode2, box2, sqDist };
+    };
+
+    double sqDistMin = std::numeric_limits<double>::max();
+    gp_XYZ pnt1;
+    gp_XYZ pnt2;
+    std::vector<StackItem> stack;
+    stack.push_back(fnStackItem(0, 0, fnOtherBox(other.m_vecNode.front())));
+    while (!stack.empty()) {
+        const StackItem item = stack.back();
+        stack.pop_back();
+        if (item.sqDist >= sqDistMin)
+            continue;
+
+        const Node& node1 = m_vecNode[item.node1];
+        const Node& node2 = other.m_vecNode[item.node2];
+        if (node1.isLeaf() && node2.isLeaf()) {
+            for (uint32_t j = node2.first; j < node2.first + node2.count; ++j) {
+                gp_XYZ tri2[3];
+                std::copy(other.trianglePoints(j), other.trianglePoints(j) + 3, tri2);
+                for (gp_XYZ& pnt : tri2)
+                    relTrsf.Transforms(pnt);
+
+                for (uint32_t i = node1.first; i < node1.first + node1.count; ++i) {
+                    gp_XYZ c1;
+                    gp_XYZ c2;
+                    const double sqDist = nearestPointsTriangleTriangle(this->trianglePoints(i), tri2, &c1, &c2);
+                    if (sqDist < sqDistMin) {
+                        sqDistMin = sqDist;
+                        pnt1 = c1;
+                        pnt2 = c2;
+                        nearest.triangle1 = m_vecTriangle[i];
+                        nearest.triangle2 = other.m_vecTriangle[j];
+                    }
+                }
+            }
+
+            continue;
+        }
+
+        // Descend into the largest node
+        const Box box1{ node1.cornerMin, node1.cornerMax };
+        const bool descendNode1 = !node1.isLeaf() && (node2.isLeaf() || box1.diagonal() >= item.box2.diagonal());
+        StackItem childItem1;
+        StackItem childItem2;
+        if (descendNode1) {
+            childItem1 = fnStackItem(item.node1 + 1, item.node2, item.box2);
+            childItem2 = fnStackItem(node1.rightChild, item.node2, item.box2);
+        }
+        else {
+            const int32_t ichild1 = item.node2 + 1;
+            const int32_t ichild2 = node2.rightChild;
+            childItem1 = fnStackItem(item.node1, ichild1, fnOtherBox(other.m_vecNode[ichild1]));
+            childItem2 = fnStackItem(item.node1, ichild2, fnOtherBox(other.m_vecNode[ichild2]));
+        }
+
+        // Nearest pair is pushed last, so it's visited first
+        if (childItem1.sqDist < childItem2.sqDist)
+            std::swap(childItem1, childItem2);
+
+        stack.push_back(childItem1);
+        stack.push_back(childItem2);
+    }
+
+    trsf.Transforms(pnt1);
+    trsf.Transforms(pnt2);
+    nearest.pnt1 = pnt1;
+    nearest.pnt2 = pnt2;
+    nearest.distance = nearest.pnt1.Distance(nearest.pnt2);
+    return nearest;
+}
+
+} // namespace Mayo
@@ -0,0 +1,82 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "occ_handle.h"
+#include "span.h"
+
+#include <gp_Pnt.hxx>
+#include <gp_Trsf.hxx>
+#include <gp_XYZ.hxx>
+#include <Poly_Triangulation.hxx>
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace Mayo {
+
+// Bounding volume hierarchy over the triangles of a Poly_Triangulation, used for exact nearest
+// point queries
+//
+// Nodes are axis-aligned boxes built by median split along the longest axis, stored depth-first so
+// the left child of a node is the next one. Triangle coordinates are copied in leaf order, so the
+// triangles of a leaf are contiguous in memory
+// Queries visit the nearest nodes first and skip those farther than the best distance found so far
+// Coordinates are the ones of the triangulation, ie without any location applied
+class MeshBvh {
+public:
+    struct Node {
+        gp_XYZ cornerMin;
+        gp_XYZ cornerMax;
+        int32_t rightChild = -1; // Left child is the next node
+        uint32_t first = 0; // Range of triangles for leaf nodes
+        uint32_t count = 0;
+
+        bool isLeaf() const { return count > 0; }
+    };
+
+    // Nearest points between two entities
+    struct Nearest {
+        gp_Pnt pnt1;
+        gp_Pnt pnt2;
+        double distance = std::numeric_limits<double>::max();
+        int triangle1 = 0; // Index(1-based) in the triangulation, 0 if the entity isn't a mesh
+        int triangle2 = 0;
+
+        bool isValid() const { return distance < std::numeric_limits<double>::max(); }
+    };
+
+    MeshBvh() = default;
+    // Hierarchy over all the triangles of 'triangulation'
+    explicit MeshBvh(const OccHandle<Poly_Triangulation>& triangulation);
+    // Hierarchy over a subset of triangles(1-based indices) of 'triangulation'
+    MeshBvh(const OccHandle<Poly_Triangulation>& triangulation, Span<const int> triangles);
+
+    bool isEmpty() const { return m_vecNode.empty(); }
+    size_t triangleCount() const { return m_vecTriangle.size(); }
+    Span<const Node> nodes() const { return m_vecNode; }
+
+    // Nearest point to 'pnt', which is returned as Nearest::pnt1(along with Nearest::triangle1)
+    // Nearest::pnt2 is 'pnt' itself
+    Nearest nearestTo(const gp_Pnt& pnt) const;
+
+    // Nearest points between the triangles of this hierarchy located by 'trsf' and the triangles of
+    // 'other' located by 'otherTrsf'. Points are returned in the global frame
+    // Transformations must be similarities(rotation, translation, uniform scale)
+    Nearest nearestTo(const gp_Trsf& trsf, const MeshBvh& other, const gp_Trsf& otherTrsf) const;
+
+private:
+    void build(const OccHandle<Poly_Triangulation>& triangulation, std::vector<int>&& vecTriangle);
+    const gp_XYZ* trianglePoints(uint32_t i) const { return &m_vecTrianglePoint.at(3 * i); }
+
+    std::vector<Node> m_vecNode;
+    std::vector<int> m_vecTriangle; // Triangle indices in leaf order
+    std::vector<gp_XYZ> m_vecTrianglePoint; // Three points per triangle, in leaf order
+};
+
+} // namespace Mayo
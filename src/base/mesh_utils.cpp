@@ -6,10 +6,12 @@
 
 #include "mesh_utils.h"
 #include "math_utils.h"
+#include "spatial_hash_grid.h"
 
 #include <cassert>
 #include <cmath>
 #include <stdexcept>
+#include <unordered_map>
 
 namespace Mayo {
 namespace MeshUtils {
@@ -25,6 +27,15 @@ namespace {
         return TColStd_Array1OfReal();
 }
 
+gp_XYZ toXYZ(const Poly_Triangulation_NormalType& n)
+{
+#if OCC_VERSION_HEX >= 0x070600
+    return gp_XYZ(n.x(), n.y(), n.z());
+#else
+    return n.XYZ();
+#endif
+}
+
 } // namespace
 
 double triangleSignedVolume(const gp_XYZ& p1, const gp_XYZ& p2, const gp_XYZ& p3)
@@ -86,6 +97,82 @@ double triangulationArea(const OccHandle<Poly_Triangulation>& triangulation)
     return area;
 }
 
+OccHandle<Poly_Triangulation> decimateVertexClustering(
+        const OccHandle<Poly_Triangulation>& triangulation,
+        double cellSize,
+        std::vector<int>* ptrNodeMap
+    )
+{
+    if (!triangulation || cellSize <= 0.)
+        return triangulation;
+
+    // Cluster of each node, clusters being numbered in order of appearance
+    const int nodeCount = triangulation->NbNodes();
+    const double invCellSize = 1. / cellSize;
+    std::unordered_map<VoxelKey, int, VoxelKeyHash> mapCluster;
+    mapCluster.reserve(nodeCount);
+    std::vector<int> vecNodeCluster(nodeCount);
+    std::vector<gp_XYZ> vecClusterSum;
+    std::vector<int> vecClusterNodeCount;
+    for (int i = 1; i <= nodeCount; ++i) {
+        const gp_XYZ coords = triangulation->Node(i).XYZ();
+        auto [it, inserted] = mapCluster.insert({ VoxelKey::of(coords, invCellSize), int(vecClusterSum.size()) });
+        if (inserted) {
+            vecClusterSum.push_back({});
+            vecClusterNodeCount.push_back(0);
+        }
+
+        vecNodeCluster[i - 1] = it->second;
+        vecClusterSum[it->second] += coords;
+        ++vecClusterNodeCount[it->second];
+    }
+
+    // Triangles whose nodes aren't in three distinct clusters collapse
+    std::vector<Poly_Triangle> vecTriangle;
+    vecTriangle.reserve(triangulation->NbTriangles());
+    for (const Poly_Triangle& tri : MeshUtils::triangles(triangulation)) {
+        int n1, n2, n3;
+        tri.Get(n1, n2, n3);
+        const int c1 = vecNodeCluster[n1 - 1] + 1;
+        const int c2 = vecNodeCluster[n2 - 1] + 1;
+        const int c3 = vecNodeCluster[n3 - 1] + 1;
+        if (c1 != c2 && c2 != c3 && c1 != c3)
+            vecTriangle.emplace_back(c1, c2, c3);
+    }
+
+    const int clusterCount = int(vecClusterSum.size());
+    auto mesh = makeOccHandle<Poly_Triangulation>(clusterCount, int(vecTriangle.size()), false/*!hasUvNodes*/);
+    for (int i = 0; i < clusterCount; ++i)
+        MeshUtils::setNode(mesh, i + 1, gp_Pnt(vecClusterSum[i] / double(vecClusterNodeCount[i])));
+
+    for (size_t i = 0; i < vecTriangle.size(); ++i)
+        MeshUtils::setTriangle(mesh, int(i + 1), vecTriangle[i]);
+
+    if (triangulation->HasNormals()) {
+        std::vector<gp_XYZ> vecClusterNormal(clusterCount);
+        for (int i = 1; i <= nodeCount; ++i)
+            vecClusterNormal[vecNodeCluster[i - 1]] += toXYZ(MeshUtils::normal(triangulation, i));
+
+        MeshUtils::allocateNormals(mesh);
+        for (int i = 0; i < clusterCount; ++i) {
+            gp_XYZ n = vecClusterNormal[i];
+            const double norm = n.Modulus();
+            if (norm > 0.)
+                n /= norm;
+
+            MeshUtils::setNormal(mesh, i + 1, Poly_Triangulation_NormalType(n.X(), n.Y(), n.Z()));
+        }
+    }
+
+    if (ptrNodeMap) {
+        ptrNodeMap->resize(nodeCount);
+        for (int i = 0; i < nodeCount; ++i)
+            (*ptrNodeMap)[i] = vecNodeCluster[i] + 1;
+    }
+
+    return mesh;
+}
+
 void setNode(const OccHandle<Poly_Triangulation>& triangulation, int index, const gp_Pnt& pnt)
 {
 #if OCC_VERSION_HEX >= 0x070600
@@ -11,6 +11,7 @@
 #include <Poly_Polygon3D.hxx>
 #include <Poly_Triangulation.hxx>
 #include <Standard_Version.hxx>
+#include <vector>
 class gp_XYZ;
 
 namespace Mayo {
@@ -40,6 +41,16 @@ void allocateNormals(const OccHandle<Poly_Triangulation>& triangulation);
 Poly_Triangulation_NormalType normal(const OccHandle<Poly_Triangulation>& triangulation, int index);
 const Poly_Array1OfTriangle& triangles(const OccHandle<Poly_Triangulation>& triangulation);
 
+// Simplifies 'triangulation' by vertex clustering: nodes falling into the same cubic cell of size
+// 'cellSize' are merged at their average position and triangles becoming degenerated are removed
+// Optional 'ptrNodeMap' receives for each input node(0-based) the index(1-based) of its output node
+// Normals are averaged, UV nodes are dropped
+OccHandle<Poly_Triangulation> decimateVertexClustering(
+        const OccHandle<Poly_Triangulation>& triangulation,
+        double cellSize,
+        std::vector<int>* ptrNodeMap = nullptr
+);
+
 enum class Orientation {
     Unknown,
     Clockwise,
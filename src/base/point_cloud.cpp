@@ -0,0 +1,138 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "point_cloud.h"
+
+#include <OSD_Parallel.hxx>
+
+#include <algorithm>
+
+namespace Mayo {
+
+void PointCloud::resize(size_t count)
+{
+    m_vecPosition.resize(count);
+    if (this->hasColors())
+        m_vecColor.resize(count);
+
+    if (this->hasNormals())
+        m_vecNormal.resize(count);
+
+    if (this->hasIntensities())
+        m_vecIntensity.resize(count);
+
+    for (ScalarField& field : m_vecScalarField)
+        field.values.resize(count);
+}
+
+void PointCloud::reserve(size_t count)
+{
+    m_vecPosition.reserve(count);
+}
+
+void PointCloud::clear()
+{
+    m_origin = gp_XYZ();
+    m_vecPosition.clear();
+    m_vecColor.clear();
+    m_vecNormal.clear();
+    m_vecIntensity.clear();
+    m_vecScalarField.clear();
+}
+
+gp_Pnt PointCloud::point(size_t i) const
+{
+    const Vec3f& pos = m_vecPosition.at(i);
+    return gp_Pnt(m_origin + gp_XYZ(pos.x(), pos.y(), pos.z()));
+}
+
+void PointCloud::addPoint(const gp_Pnt& pnt)
+{
+    const gp_XYZ pos = pnt.XYZ() - m_origin;
+    m_vecPosition.emplace_back(float(pos.X()), float(pos.Y()), float(pos.Z()));
+}
+
+void PointCloud::allocateColors()
+{
+    m_vecColor.resize(this->pointCount(), Color{ 0, 0, 0 });
+}
+
+void PointCloud::allocateNormals()
+{
+    m_vecNormal.resize(this->pointCount());
+}
+
+void PointCloud::allocateIntensities()
+{
+    m_vecIntensity.resize(this->pointCount(), 0.f);
+}
+
+PointCloud::ScalarField& PointCloud::addScalarField(std::string_view name)
+{
+    ScalarField* field = this->findScalarField(name);
+    if (!field) {
+        m_vecScalarField.push_back({ std::string(name), {} });
+        field = &m_vecScalarField.back();
+    }
+
+    field->values.resize(this->pointCount(), 0.f);
+    return *field;
+}
+
+PointCloud::ScalarField* PointCloud::findScalarField(std::string_view name)
+{
+    auto it = std::find_if(m_vecScalarField.begin(), m_vecScalarField.end(), [=](const ScalarField& field) {
+        return field.name == name;
+    });
+    return it != m_vecScalarField.end() ? &(*it) : nullptr;
+}
+
+const PointCloud::ScalarField* PointCloud::findScalarField(std::string_view name) const
+{
+    return const_cast<PointCloud*>(this)->findScalarField(name);
+}
+
+Bnd_Box PointCloud::computeBoundingBox() const
+{
+    constexpr size_t ChunkSize = 256 * 1024;
+    const int chunkCount = int((this->pointCount() + ChunkSize - 1) / ChunkSize);
+    std::vector<Bnd_Box> vecChunkBndBox(chunkCount);
+    OSD_Parallel::For(0, chunkCount, [&](int ichunk) {
+        const size_t begin = ichunk * ChunkSize;
+        const size_t end = std::min(this->pointCount(), begin + ChunkSize);
+        Vec3f posMin = m_vecPosition.at(begin);
+        Vec3f posMax = posMin;
+        for (size_t i = begin + 1; i < end; ++i) {
+            posMin = posMin.cwiseMin(m_vecPosition[i]);
+            posMax = posMax.cwiseMax(m_vecPosition[i]);
+        }
+
+        vecChunkBndBox.at(ichunk).Update(
+            m_origin.X() + posMin.x(), m_origin.Y() + posMin.y(), m_origin.Z() + posMin.z(),
+            m_origin.X() + posMax.x(), m_origin.Y() + posMax.y(), m_origin.Z() + posMax.z()
+        );
+    }, chunkCount == 1);
+
+    Bnd_Box bndBox;
+    for (const Bnd_Box& chunkBndBox : vecChunkBndBox)
+        bndBox.Add(chunkBndBox);
+
+    return bndBox;
+}
+
+size_t PointCloud::memorySize() const
+{
+    size_t bytes = m_vecPosition.size() * sizeof(Vec3f);
+    bytes += m_vecColor.size() * sizeof(Color);
+    bytes += m_vecNormal.size() * sizeof(Vec3f);
+    bytes += m_vecIntensity.size() * sizeof(float);
+    for (const ScalarField& field : m_vecScalarField)
+        bytes += field.values.size() * sizeof(float);
+
+    return bytes;
+}
+
+} // namespace Mayo
@@ -0,0 +1,104 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "span.h"
+
+#include <Bnd_Box.hxx>
+#include <gp_Pnt.hxx>
+#include <gp_XYZ.hxx>
+#include <NCollection_Vec3.hxx>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Mayo {
+
+// Compact CPU-side storage of a point cloud
+//
+// Each attribute is stored in its own array(structure of arrays), so positions can be read by
+// writers, measurement or render array builders without touching the other attributes
+// Only positions are mandatory, other attributes are either empty or sized to pointCount()
+// Positions are relative to origin(), so points far from the world origin(eg georeferenced scans)
+// keep the precision of floats
+class PointCloud {
+public:
+    using Vec3f = NCollection_Vec3<float>;
+
+    struct Color {
+        uint8_t red;
+        uint8_t green;
+        uint8_t blue;
+    };
+
+    struct ScalarField {
+        std::string name;
+        std::vector<float> values;
+    };
+
+    size_t pointCount() const { return m_vecPosition.size(); }
+    bool isEmpty() const { return m_vecPosition.empty(); }
+
+    // Resizes positions and all attributes allocated so far
+    void resize(size_t count);
+    void reserve(size_t count);
+    void clear();
+
+    // Position of the local frame of the points, translation only
+    const gp_XYZ& origin() const { return m_origin; }
+    void setOrigin(const gp_XYZ& origin) { m_origin = origin; }
+
+    // Positions relative to origin()
+    std::vector<Vec3f>& positions() { return m_vecPosition; }
+    const std::vector<Vec3f>& positions() const { return m_vecPosition; }
+
+    // Absolute position of the i-th point
+    gp_Pnt point(size_t i) const;
+    void addPoint(const gp_Pnt& pnt);
+
+    // RGB colors, 8 bits per component(sRGB)
+    bool hasColors() const { return !m_vecColor.empty(); }
+    void allocateColors();
+    std::vector<Color>& colors() { return m_vecColor; }
+    const std::vector<Color>& colors() const { return m_vecColor; }
+
+    bool hasNormals() const { return !m_vecNormal.empty(); }
+    void allocateNormals();
+    std::vector<Vec3f>& normals() { return m_vecNormal; }
+    const std::vector<Vec3f>& normals() const { return m_vecNormal; }
+
+    bool hasIntensities() const { return !m_vecIntensity.empty(); }
+    void allocateIntensities();
+    std::vector<float>& intensities() { return m_vecIntensity; }
+    const std::vector<float>& intensities() const { return m_vecIntensity; }
+
+    // Arbitrary per-point values(eg classification, GPS time, ...)
+    Span<const ScalarField> scalarFields() const { return m_vecScalarField; }
+    ScalarField& addScalarField(std::string_view name);
+    ScalarField* findScalarField(std::string_view name);
+    const ScalarField* findScalarField(std::string_view name) const;
+
+    // Bounding box of absolute positions, computed in parallel
+    Bnd_Box computeBoundingBox() const;
+
+    // Count of bytes used by point data
+    size_t memorySize() const;
+
+private:
+    static_assert(sizeof(Vec3f) == 3 * sizeof(float), "Positions must be tightly packed");
+    static_assert(sizeof(Color) == 3, "Colors must be tightly packed");
+
+    gp_XYZ m_origin;
+    std::vector<Vec3f> m_vecPosition;
+    std::vector<Color> m_vecColor;
+    std::vector<Vec3f> m_vecNormal;
+    std::vector<float> m_vecIntensity;
+    std::vector<ScalarField> m_vecScalarField;
+};
+
+} // namespace Mayo
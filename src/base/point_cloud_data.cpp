@@ -5,9 +5,12 @@
 ****************************************************************************/
 
 #include "point_cloud_data.h"
+#include "label_data.h"
+#include "point_cloud_octree.h"
 
 #include <Standard_GUID.hxx>
 #include <TDF_Label.hxx>
+#include <limits>
 
 namespace Mayo {
 
@@ -28,13 +31,39 @@ PointCloudDataPtr PointCloudData::Set(const TDF_Label& label)
     return data;
 }
 
-PointCloudDataPtr PointCloudData::Set(const TDF_Label& label, const OccHandle<Graphic3d_ArrayOfPoints>& points)
+PointCloudDataPtr PointCloudData::Set(const TDF_Label& label, const std::shared_ptr<const PointCloud>& pointCloud)
 {
     PointCloudDataPtr data = PointCloudData::Set(label);
-    data->m_points = points;
+    data->setPointCloud(pointCloud);
     return data;
 }
 
+std::shared_ptr<const PointCloudOctree> PointCloudData::octree(TaskProgress* progress) const
+{
+    std::lock_guard<std::mutex> lock(m_mutexOctree);
+    if (!m_octree && m_pointCloud && !m_pointCloud->isEmpty()) {
+        const std::vector<PointCloud::Vec3f>& positions = m_pointCloud->positions();
+        if (positions.size() > std::numeric_limits<uint32_t>::max())
+            return {}; // Octree indexes points with 32 bits integers
+
+        PointCloudOctree::PointsView pointsView;
+        pointsView.data = reinterpret_cast<const char*>(positions.data());
+        pointsView.stride = sizeof(PointCloud::Vec3f);
+        pointsView.count = uint32_t(positions.size());
+        auto octree = std::make_shared<PointCloudOctree>();
+        if (octree->build(pointsView, {}, progress))
+            m_octree = octree;
+    }
+
+    return m_octree;
+}
+
+std::shared_ptr<const PointCloudOctree> PointCloudData::builtOctree() const
+{
+    std::unique_lock<std::mutex> lock(m_mutexOctree, std::try_to_lock);
+    return lock.owns_lock() ? m_octree : nullptr;
+}
+
 const Standard_GUID& PointCloudData::ID() const
 {
     return PointCloudData::GetID();
@@ -44,7 +73,7 @@ void PointCloudData::Restore(const OccHandle<TDF_Attribute>& attribute)
 {
     auto data = PointCloudDataPtr::DownCast(attribute);
     if (data)
-        m_points = data->m_points;
+        this->setPointCloud(data->m_pointCloud);
 }
 
 OccHandle<TDF_Attribute> PointCloudData::NewEmpty() const
@@ -56,7 +85,16 @@ void PointCloudData::Paste(const OccHandle<TDF_Attribute>& into, const OccHandle
 {
     auto data = PointCloudDataPtr::DownCast(into);
     if (data)
-        data->m_points = m_points;
+        data->setPointCloud(m_pointCloud);
+}
+
+void PointCloudData::setPointCloud(const std::shared_ptr<const PointCloud>& pointCloud)
+{
+    std::lock_guard<std::mutex> lock(m_mutexOctree);
+    if (pointCloud != m_pointCloud)
+        m_octree.reset();
+
+    m_pointCloud = pointCloud;
 }
 
 Standard_OStream& PointCloudData::Dump(Standard_OStream& ostr) const
@@ -66,4 +104,15 @@ Standard_OStream& PointCloudData::Dump(Standard_OStream& ostr) const
     return ostr;
 }
 
+// Presence of the attribute is part of the label data flags
+void PointCloudData::AfterAddition()
+{
+    invalidateLabelDataFlags(this->Label());
+}
+
+void PointCloudData::BeforeForget()
+{
+    invalidateLabelDataFlags(this->Label());
+}
+
 } // namespace Mayo
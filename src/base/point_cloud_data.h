@@ -7,25 +7,39 @@
 #pragma once
 
 #include "occ_handle.h"
+#include "point_cloud.h"
 
-#include <Graphic3d_ArrayOfPoints.hxx>
 #include <TDF_Attribute.hxx>
+#include <memory>
+#include <mutex>
 
 namespace Mayo {
 
 // Pre-declarations
+class PointCloudOctree;
 class PointCloudData;
+class TaskProgress;
 DEFINE_STANDARD_HANDLE(PointCloudData, TDF_Attribute)
 using PointCloudDataPtr = OccHandle<PointCloudData>;
 
 // Provides a label attribute to store point cloud data
+// Points are held in a PointCloud container shared(read-only) between the document, readers,
+// writers and graphics drivers. Render arrays are built from it on demand by graphics drivers
 class PointCloudData : public TDF_Attribute {
 public:
     static const Standard_GUID& GetID();
     static PointCloudDataPtr Set(const TDF_Label& label);
-    static PointCloudDataPtr Set(const TDF_Label& label, const OccHandle<Graphic3d_ArrayOfPoints>& points);
+    static PointCloudDataPtr Set(const TDF_Label& label, const std::shared_ptr<const PointCloud>& pointCloud);
 
-    const OccHandle<Graphic3d_ArrayOfPoints>& points() const { return m_points; }
+    const std::shared_ptr<const PointCloud>& pointCloud() const { return m_pointCloud; }
+    size_t pointCount() const { return m_pointCloud ? m_pointCloud->pointCount() : 0; }
+
+    // Spatial index of pointCloud(), built on first call(thread-safe)
+    // The octree refers to the positions of pointCloud(), so that one must be kept alive along with it
+    // Returns null if building was aborted with 'progress' or if point count exceeds 32 bits indices
+    std::shared_ptr<const PointCloudOctree> octree(TaskProgress* progress = nullptr) const;
+    // Spatial index of pointCloud() if already built, null otherwise. Doesn't block
+    std::shared_ptr<const PointCloudOctree> builtOctree() const;
 
     // -- from TDF_Attribute
     const Standard_GUID& ID() const override;
@@ -33,11 +47,17 @@ public:
     OccHandle<TDF_Attribute> NewEmpty() const override;
     void Paste(const OccHandle<TDF_Attribute>& into, const OccHandle<TDF_RelocationTable>& table) const override;
     Standard_OStream& Dump(Standard_OStream& ostr) const override;
+    void AfterAddition() override;
+    void BeforeForget() override;
 
     DEFINE_STANDARD_RTTI_INLINE(PointCloudData, TDF_Attribute)
 
 private:
-    OccHandle<Graphic3d_ArrayOfPoints> m_points;
+    void setPointCloud(const std::shared_ptr<const PointCloud>& pointCloud);
+
+    std::shared_ptr<const PointCloud> m_pointCloud;
+    mutable std::mutex m_mutexOctree;
+    mutable std::shared_ptr<const PointCloudOctree> m_octree;
 };
 
 } // namespace Mayo
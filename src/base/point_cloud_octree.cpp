@@ -0,0 +1,318 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "point_cloud_octree.h"
+
+#include "task_progress.h"
+
+#include <Graphic3d_Camera.hxx>
+#include <OSD_Parallel.hxx>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <numeric>
+#include <queue>
+#include <thread>
+
+namespace Mayo {
+
+namespace {
+
+constexpr int MortonBitsPerAxis = 21;
+
+// Inserts two zero bits between each of the 21 lower bits of 'x'
+uint64_t spreadMortonBits(uint64_t x)
+{
+    x &= 0x1fffff;
+    x = (x | (x << 32)) & 0x1f00000000ffff;
+    x = (x | (x << 16)) & 0x1f0000ff0000ff;
+    x = (x | (x << 8)) & 0x100f00f00f00f00f;
+    x = (x | (x << 4)) & 0x10c30c30c30c30c3;
+    x = (x | (x << 2)) & 0x1249249249249249;
+    return x;
+}
+
+// Sorts chunks of 'vec' concurrently and then merges them pairwise
+template<typename T, typename LessFunction> void parallelSort(std::vector<T>& vec, LessFunction fnLess)
+{
+    const size_t threadCount = std::max(1u, std::thread::hardware_concurrency());
+    const size_t chunkSize = std::max<size_t>(64 * 1024, (vec.size() + threadCount - 1) / threadCount);
+    const int chunkCount = int((vec.size() + chunkSize - 1) / chunkSize);
+    OSD_Parallel::For(0, chunkCount, [&](int i) {
+        const size_t begin = i * chunkSize;
+        std::sort(vec.begin() + begin, vec.begin() + std::min(vec.size(), begin + chunkSize), fnLess);
+    }, chunkCount == 1);
+
+    for (size_t width = chunkSize; width < vec.size(); width *= 2) {
+        const int pairCount = int((vec.size() + 2 * width - 1) / (2 * width));
+        OSD_Parallel::For(0, pairCount, [&](int i) {
+            const size_t begin = i * 2 * width;
+            const size_t mid = std::min(vec.size(), begin + width);
+            const size_t end = std::min(vec.size(), begin + 2 * width);
+            std::inplace_merge(vec.begin() + begin, vec.begin() + mid, vec.begin() + end, fnLess);
+        }, pairCount == 1);
+    }
+}
+
+} // namespace
+
+gp_Pnt PointCloudOctree::PointsView::point(uint32_t i) const
+{
+    float coords[3];
+    std::memcpy(coords, this->data + size_t(i) * this->stride, sizeof(coords));
+    return { coords[0], coords[1], coords[2] };
+}
+
+bool PointCloudOctree::build(const PointsView& points, const Parameters& params, TaskProgress* progress)
+{
+    progress = progress ? progress : &TaskProgress::null();
+    this->clear();
+    m_points = points;
+    if (!points.data || points.count == 0)
+        return true;
+
+    const int maxDepth = std::clamp(params.maxDepth, 0, MortonBitsPerAxis);
+    const uint32_t maxLeafPointCount = std::max(1u, params.maxLeafPointCount);
+    constexpr uint32_t ChunkSize = 256 * 1024;
+    const int chunkCount = int((points.count + ChunkSize - 1) / ChunkSize);
+    auto fnParallelForEachChunk = [&](const std::function<void(uint32_t, uint32_t)>& fn) {
+        OSD_Parallel::For(0, chunkCount, [&](int ichunk) {
+            const uint32_t begin = ichunk * ChunkSize;
+            fn(begin, std::min(points.count, begin + ChunkSize));
+        }, chunkCount == 1);
+    };
+
+    // Bounding box
+    {
+        std::vector<Bnd_Box> vecChunkBndBox(chunkCount);
+        fnParallelForEachChunk([&](uint32_t begin, uint32_t end) {
+            Bnd_Box& bndBox = vecChunkBndBox.at(begin / ChunkSize);
+            for (uint32_t i = begin; i < end; ++i)
+                bndBox.Add(points.point(i));
+        });
+        for (const Bnd_Box& bndBox : vecChunkBndBox)
+            m_bndBox.Add(bndBox);
+
+        progress->setValue(10);
+    }
+
+    // Root cell is the cube enclosing the bounding box
+    double xMin, yMin, zMin, xMax, yMax, zMax;
+    m_bndBox.Get(xMin, yMin, zMin, xMax, yMax, zMax);
+    const double cubeSize = std::max({ xMax - xMin, yMax - yMin, zMax - zMin, 1e-9 });
+    const double cellCount = double(1u << MortonBitsPerAxis);
+    const double scale = cellCount / cubeSize;
+
+    // Morton codes, indexed by point
+    std::vector<uint64_t> vecMortonCode(points.count);
+    {
+        auto fnCellCoord = [=](double v, double vMin) {
+            return uint64_t(std::clamp((v - vMin) * scale, 0., cellCount - 1));
+        };
+        fnParallelForEachChunk([&](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i) {
+                const gp_Pnt pnt = points.point(i);
+                vecMortonCode[i] =
+                    spreadMortonBits(fnCellCoord(pnt.X(), xMin))
+                    | (spreadMortonBits(fnCellCoord(pnt.Y(), yMin)) << 1)
+                    | (spreadMortonBits(fnCellCoord(pnt.Z(), zMin)) << 2);
+            }
+        });
+        if (progress->isAbortRequested())
+            return false;
+
+        progress->setValue(30);
+    }
+
+    // Point indices are sorted in place, codes being looked up by index
+    m_vecPointIndex.resize(points.count);
+    std::iota(m_vecPointIndex.begin(), m_vecPointIndex.end(), 0u);
+    parallelSort(m_vecPointIndex, [&](uint32_t lhs, uint32_t rhs) {
+        return vecMortonCode[lhs] < vecMortonCode[rhs];
+    });
+    if (progress->isAbortRequested()) {
+        m_vecPointIndex.clear();
+        return false;
+    }
+
+    progress->setValue(80);
+
+    // Nodes, created breadth-first so children of a node are consecutive
+    Node root;
+    root.box.Update(xMin, yMin, zMin, xMin + cubeSize, yMin + cubeSize, zMin + cubeSize);
+    root.end = points.count;
+    m_vecNode.push_back(root);
+    for (size_t inode = 0; inode < m_vecNode.size(); ++inode) {
+        const Node node = m_vecNode.at(inode); // Copy as 'm_vecNode' gets reallocated
+        if (node.pointCount() <= maxLeafPointCount || node.depth >= maxDepth)
+            continue;
+
+        const int shift = 3 * (MortonBitsPerAxis - node.depth - 1);
+        double nodeXMin, nodeYMin, nodeZMin, nodeXMax, nodeYMax, nodeZMax;
+        node.box.Get(nodeXMin, nodeYMin, nodeZMin, nodeXMax, nodeYMax, nodeZMax);
+        const double halfSize = (nodeXMax - nodeXMin) / 2.;
+        const auto firstChild = int32_t(m_vecNode.size());
+        uint8_t childCount = 0;
+        auto itBegin = m_vecPointIndex.cbegin() + node.begin;
+        const auto itNodeEnd = m_vecPointIndex.cbegin() + node.end;
+        for (uint64_t octant = 0; octant < 8; ++octant) {
+            auto itEnd = std::partition_point(itBegin, itNodeEnd, [&](uint32_t index) {
+                return ((vecMortonCode[index] >> shift) & 7) <= octant;
+            });
+            if (itEnd != itBegin) {
+                Node child;
+                const double childXMin = nodeXMin + ((octant & 1) ? halfSize : 0.);
+                const double childYMin = nodeYMin + ((octant & 2) ? halfSize : 0.);
+                const double childZMin = nodeZMin + ((octant & 4) ? halfSize : 0.);
+                child.box.Update(
+                    childXMin, childYMin, childZMin,
+                    childXMin + halfSize, childYMin + halfSize, childZMin + halfSize
+                );
+                child.begin = uint32_t(itBegin - m_vecPointIndex.cbegin());
+                child.end = uint32_t(itEnd - m_vecPointIndex.cbegin());
+                child.depth = node.depth + 1;
+                m_vecNode.push_back(child);
+                ++childCount;
+            }
+
+            itBegin = itEnd;
+        }
+
+        m_vecNode.at(inode).firstChild = firstChild;
+        m_vecNode.at(inode).childCount = childCount;
+    }
+
+    progress->setValue(100);
+    return true;
+}
+
+void PointCloudOctree::clear()
+{
+    m_points = {};
+    m_bndBox.SetVoid();
+    m_vecNode.clear();
+    m_vecPointIndex.clear();
+}
+
+uint32_t PointCloudOctree::samplePointIndex(const Node& node, uint32_t sampleCount, uint32_t i) const
+{
+    const uint32_t count = node.pointCount();
+    if (sampleCount >= count)
+        return m_vecPointIndex.at(node.begin + i);
+
+    const uint64_t offset = (uint64_t(i) * count) / sampleCount;
+    return m_vecPointIndex.at(node.begin + offset);
+}
+
+void PointCloudOctree::traversePoints(
+        const std::function<bool(const Node&)>& fnAcceptNode,
+        const std::function<bool(uint32_t)>& fnVisitPoint
+    ) const
+{
+    if (this->isEmpty())
+        return;
+
+    std::vector<int32_t> stackNode = { 0 };
+    while (!stackNode.empty()) {
+        const Node& node = m_vecNode.at(stackNode.back());
+        stackNode.pop_back();
+        if (!fnAcceptNode(node))
+            continue;
+
+        if (!node.isLeaf()) {
+            // Push in reverse order so children are visited in Morton order
+            for (int32_t ichild = node.firstChild + node.childCount - 1; ichild >= node.firstChild; --ichild)
+                stackNode.push_back(ichild);
+
+            continue;
+        }
+
+        for (uint32_t i = node.begin; i < node.end; ++i) {
+            if (!fnVisitPoint(m_vecPointIndex.at(i)))
+                return;
+        }
+    }
+}
+
+std::vector<PointCloudOctree::NodeSample> PointCloudOctree::selectLod(
+        const Graphic3d_Camera& camera, int viewHeightPixels, const LodParameters& params
+    ) const
+{
+    std::vector<NodeSample> vecSample;
+    if (this->isEmpty() || viewHeightPixels <= 0)
+        return vecSample;
+
+    const gp_Pnt eye = camera.Eye();
+    const gp_Vec direction = camera.Direction();
+    auto fnIsOutOfView = [&](const Node& node) {
+        if (!node.box.IsOut(eye))
+            return false;
+
+        double xMin, yMin, zMin, xMax, yMax, zMax;
+        node.box.Get(xMin, yMin, zMin, xMax, yMax, zMax);
+        unsigned outMask = 0xF;
+        for (int i = 0; i < 8; ++i) {
+            const gp_Pnt corner((i & 1) ? xMax : xMin, (i & 2) ? yMax : yMin, (i & 4) ? zMax : zMin);
+            if (gp_Vec(eye, corner).Dot(direction) <= 0.)
+                return false; // Corner behind the eye, can't conclude from projection
+
+            const gp_Pnt ndc = camera.Project(corner);
+            const unsigned cornerMask =
+                (ndc.X() < -1. ? 1 : 0) | (ndc.X() > 1. ? 2 : 0)
+                | (ndc.Y() < -1. ? 4 : 0) | (ndc.Y() > 1. ? 8 : 0);
+            outMask &= cornerMask;
+        }
+
+        return outMask != 0;
+    };
+
+    // Size in pixels of the node cell, whatever the camera projection is
+    auto fnPixelSize = [&](const Node& node) {
+        const double diagonal = std::sqrt(node.box.SquareExtent());
+        double xMin, yMin, zMin, xMax, yMax, zMax;
+        node.box.Get(xMin, yMin, zMin, xMax, yMax, zMax);
+        const gp_Pnt center((xMin + xMax) / 2., (yMin + yMax) / 2., (zMin + zMax) / 2.);
+        const double distance = std::max(eye.Distance(center) - diagonal / 2., camera.ZNear());
+        const double viewUnitHeight = camera.ViewDimensions(distance).Y();
+        return viewUnitHeight > 0. ? diagonal * viewHeightPixels / viewUnitHeight : 0.;
+    };
+
+    if (fnIsOutOfView(this->rootNode()))
+        return vecSample;
+
+    const uint32_t nodeSampleCount = std::max(1u, params.nodeSampleCount);
+    std::priority_queue<std::pair<double, int32_t>> queueNode;
+    queueNode.push({ fnPixelSize(this->rootNode()), 0 });
+    size_t pointCount = 0;
+    while (!queueNode.empty()) {
+        const auto [pixelSize, inode] = queueNode.top();
+        queueNode.pop();
+        const Node& node = m_vecNode.at(inode);
+        const uint32_t sampleCount = std::min(node.pointCount(), nodeSampleCount);
+        if (pointCount + sampleCount > params.pointBudget)
+            break;
+
+        vecSample.push_back({ inode, sampleCount });
+        pointCount += sampleCount;
+
+        // Refine while representatives are too sparse on screen. Children representatives partly
+        // overlap the ones of their parent, which only costs some point budget
+        const bool isPartialSample = sampleCount < node.pointCount();
+        if (!node.isLeaf() && isPartialSample && pixelSize / std::sqrt(double(sampleCount)) > params.pointSpacingPixels) {
+            for (int32_t ichild = node.firstChild; ichild < node.firstChild + node.childCount; ++ichild) {
+                const Node& child = m_vecNode.at(ichild);
+                if (!fnIsOutOfView(child))
+                    queueNode.push({ fnPixelSize(child), ichild });
+            }
+        }
+    }
+
+    return vecSample;
+}
+
+} // namespace Mayo
@@ -0,0 +1,116 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "span.h"
+
+#include <Bnd_Box.hxx>
+#include <gp_Pnt.hxx>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+class Graphic3d_Camera;
+
+namespace Mayo {
+
+class TaskProgress;
+
+// Spatial index of a point cloud, used to display huge point clouds
+//
+// Points are sorted along a Morton(Z-order) curve, so each octree node refers to a contiguous range
+// of the sorted point indices. Representatives of a node are obtained by striding over its range,
+// which gives a spatially uniform subsample without storing any extra point
+// The octree only stores point indices(4 bytes per point), coordinates stay in the source buffer
+// Building needs a temporary Morton code per point(8 bytes), point indices are sorted in place
+class PointCloudOctree {
+public:
+    // Read access to point coordinates stored as 3 consecutive floats, 'stride' being the count of
+    // bytes between two consecutive points
+    struct PointsView {
+        const char* data = nullptr;
+        size_t stride = 3 * sizeof(float);
+        uint32_t count = 0;
+
+        gp_Pnt point(uint32_t i) const;
+    };
+
+    struct Parameters {
+        uint32_t maxLeafPointCount = 16 * 1024;
+        int maxDepth = 21; // Can't exceed 21(bits per axis of Morton codes)
+    };
+
+    struct Node {
+        Bnd_Box box; // Octree cell
+        uint32_t begin = 0; // Range in pointIndices()
+        uint32_t end = 0;
+        int32_t firstChild = -1; // Children are consecutive in nodes()
+        uint8_t childCount = 0;
+        uint8_t depth = 0;
+
+        uint32_t pointCount() const { return end - begin; }
+        bool isLeaf() const { return childCount == 0; }
+    };
+
+    // Node selected for display, along with the count of its representatives
+    struct NodeSample {
+        int32_t node = 0;
+        uint32_t pointCount = 0;
+        bool operator==(const NodeSample& other) const {
+            return node == other.node && pointCount == other.pointCount;
+        }
+    };
+
+    struct LodParameters {
+        size_t pointBudget = 5'000'000;
+        uint32_t nodeSampleCount = 16 * 1024; // Maximum count of representatives per node
+        double pointSpacingPixels = 2.; // Nodes are refined while representatives are more apart
+    };
+
+    // Builds the octree over 'points', which must stay valid as long as the octree is used
+    // Returns 'false' if aborted
+    bool build(const PointsView& points, const Parameters& params, TaskProgress* progress = nullptr);
+    void clear();
+
+    bool isEmpty() const { return m_vecNode.empty(); }
+    const PointsView& points() const { return m_points; }
+    const Bnd_Box& boundingBox() const { return m_bndBox; }
+
+    Span<const Node> nodes() const { return m_vecNode; }
+    const Node& node(int32_t i) const { return m_vecNode.at(i); }
+    const Node& rootNode() const { return m_vecNode.front(); }
+
+    // Point indices(in points()) sorted along the Morton curve
+    Span<const uint32_t> pointIndices() const { return m_vecPointIndex; }
+
+    // Index(in points()) of the 'i'th representative out of 'sampleCount' ones of 'node'
+    uint32_t samplePointIndex(const Node& node, uint32_t sampleCount, uint32_t i) const;
+
+    // Depth-first traversal of the nodes accepted by 'fnAcceptNode', children of a node being visited
+    // only if their parent is accepted. 'fnVisitPoint' is called with the index(in points()) of each
+    // point of the accepted leaf nodes, the traversal stops as soon as it returns false
+    void traversePoints(
+            const std::function<bool(const Node&)>& fnAcceptNode,
+            const std::function<bool(uint32_t)>& fnVisitPoint
+    ) const;
+
+    // Selects the nodes to display from 'camera' so that nearest/biggest nodes are the most refined
+    // Nodes are visited from the largest on screen and each one contributes its representatives
+    // until the point budget is exhausted. Nodes out of the view frustum are skipped
+    std::vector<NodeSample> selectLod(
+            const Graphic3d_Camera& camera, int viewHeightPixels, const LodParameters& params
+    ) const;
+
+private:
+    PointsView m_points;
+    Bnd_Box m_bndBox;
+    std::vector<Node> m_vecNode;
+    std::vector<uint32_t> m_vecPointIndex;
+};
+
+} // namespace Mayo
@@ -0,0 +1,407 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "point_cloud_utils.h"
+
+#include "cpp_utils.h"
+
+#include <OSD_Parallel.hxx>
+#include <gp_XYZ.hxx>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Mayo {
+
+namespace {
+
+using Vec3f = PointCloud::Vec3f;
+
+// Calls 'fn' for each cell located at Chebyshev distance 'ring' from cell 'key'
+template<typename Function>
+void foreachCellOfRing(const VoxelKey& key, int ring, Function fn)
+{
+    for (int dx = -ring; dx <= ring; ++dx) {
+        for (int dy = -ring; dy <= ring; ++dy) {
+            // Inner columns of the ring only have their two end cells on the ring
+            const bool onRingSide = std::abs(dx) == ring || std::abs(dy) == ring;
+            const int dzStep = onRingSide ? 1 : std::max(1, 2 * ring);
+            for (int dz = -ring; dz <= ring; dz += dzStep)
+                fn(VoxelKey{ key.x + dx, key.y + dy, key.z + dz });
+        }
+    }
+}
+
+// Point indices are 32 bits(as in PointCloudData), throws std::overflow_error for larger point clouds
+uint32_t indexablePointCount(size_t pointCount)
+{
+    return CppUtils::safeStaticCast<uint32_t>(pointCount);
+}
+
+std::vector<uint32_t> keptIndices(const std::vector<uint8_t>& vecKeep)
+{
+    std::vector<uint32_t> vecIndex;
+    const uint32_t pointCount = indexablePointCount(vecKeep.size());
+    for (uint32_t i = 0; i < pointCount; ++i) {
+        if (vecKeep[i])
+            vecIndex.push_back(i);
+    }
+
+    return vecIndex;
+}
+
+} // namespace
+
+VoxelGridSampler::VoxelGridSampler(double voxelSize)
+    : m_invVoxelSize(voxelSize > 0. ? 1. / voxelSize : 1.)
+{
+}
+
+bool VoxelGridSampler::tryAdd(const PointCloud::Vec3f& pos)
+{
+    return m_setVoxel.insert(VoxelKey::of(pos, m_invVoxelSize)).second;
+}
+
+PointCloud PointCloudUtils::concatenate(Span<const PointCloud> parts)
+{
+    PointCloud result;
+    if (parts.empty())
+        return result;
+
+    std::vector<size_t> vecPartOffset;
+    size_t pointCount = 0;
+    for (const PointCloud& part : parts) {
+        vecPartOffset.push_back(pointCount);
+        pointCount += part.pointCount();
+    }
+
+    // Empty parts(eg all points filtered out) don't provide the attributes
+    auto itFirstPart = std::find_if(parts.begin(), parts.end(), [](const PointCloud& part) {
+        return !part.isEmpty();
+    });
+    if (itFirstPart == parts.end())
+        return result;
+
+    const PointCloud& firstPart = *itFirstPart;
+    result.setOrigin(firstPart.origin());
+    result.resize(pointCount);
+    if (firstPart.hasColors())
+        result.allocateColors();
+
+    if (firstPart.hasNormals())
+        result.allocateNormals();
+
+    if (firstPart.hasIntensities())
+        result.allocateIntensities();
+
+    for (const PointCloud::ScalarField& field : firstPart.scalarFields())
+        result.addScalarField(field.name);
+
+    auto fnCopy = [](const auto& vecSource, auto& vecTarget, size_t offset) {
+        if (!vecSource.empty() && !vecTarget.empty())
+            std::copy(vecSource.cbegin(), vecSource.cend(), vecTarget.begin() + offset);
+    };
+    OSD_Parallel::For(0, int(parts.size()), [&](int ipart) {
+        const PointCloud& part = parts[ipart];
+        const size_t offset = vecPartOffset.at(ipart);
+        const gp_XYZ shift = part.origin() - result.origin();
+        if (shift.IsEqual(gp_XYZ(), 0.)) {
+            fnCopy(part.positions(), result.positions(), offset);
+        }
+        else {
+            const Vec3f vecShift(float(shift.X()), float(shift.Y()), float(shift.Z()));
+            std::transform(
+                part.positions().cbegin(), part.positions().cend(), result.positions().begin() + offset,
+                [=](const Vec3f& pos) { return pos + vecShift; }
+            );
+        }
+
+        fnCopy(part.colors(), result.colors(), offset);
+        fnCopy(part.normals(), result.normals(), offset);
+        fnCopy(part.intensities(), result.intensities(), offset);
+        for (const PointCloud::ScalarField& field : part.scalarFields()) {
+            PointCloud::ScalarField* targetField = result.findScalarField(field.name);
+            if (targetField)
+                fnCopy(field.values, targetField->values, offset);
+        }
+    }, parts.size() == 1);
+
+    return result;
+}
+
+PointCloud PointCloudUtils::select(const PointCloud& pointCloud, Span<const uint32_t> indices)
+{
+    PointCloud result;
+    result.setOrigin(pointCloud.origin());
+    result.resize(indices.size());
+    if (pointCloud.hasColors())
+        result.allocateColors();
+
+    if (pointCloud.hasNormals())
+        result.allocateNormals();
+
+    if (pointCloud.hasIntensities())
+        result.allocateIntensities();
+
+    auto fnSelect = [=](const auto& vecSource, auto& vecTarget) {
+        if (vecSource.empty())
+            return;
+
+        for (size_t i = 0; i < indices.size(); ++i)
+            vecTarget[i] = vecSource[indices[i]];
+    };
+    fnSelect(pointCloud.positions(), result.positions());
+    fnSelect(pointCloud.colors(), result.colors());
+    fnSelect(pointCloud.normals(), result.normals());
+    fnSelect(pointCloud.intensities(), result.intensities());
+    for (const PointCloud::ScalarField& field : pointCloud.scalarFields())
+        fnSelect(field.values, result.addScalarField(field.name).values);
+
+    return result;
+}
+
+std::vector<uint32_t> PointCloudUtils::voxelGridSampleIndices(const PointCloud& pointCloud, double voxelSize)
+{
+    std::vector<uint32_t> vecIndex;
+    VoxelGridSampler sampler(voxelSize);
+    const std::vector<PointCloud::Vec3f>& positions = pointCloud.positions();
+    const uint32_t pointCount = indexablePointCount(positions.size());
+    for (uint32_t i = 0; i < pointCount; ++i) {
+        if (sampler.tryAdd(positions[i]))
+            vecIndex.push_back(i);
+    }
+
+    return vecIndex;
+}
+
+void PointCloudUtils::decimate(PointCloud* pointCloud, const PointCloudDecimation& decimation)
+{
+    if (!pointCloud || decimation.mode == PointCloudDecimation::Mode::None)
+        return;
+
+    std::vector<uint32_t> vecIndex;
+    if (decimation.mode == PointCloudDecimation::Mode::EveryNth) {
+        const uint64_t step = uint64_t(std::max(1, decimation.step));
+        if (step == 1)
+            return;
+
+        // 64 bits counter so 'i + step' can't wrap around
+        const uint32_t pointCount = indexablePointCount(pointCloud->pointCount());
+        for (uint64_t i = 0; i < pointCount; i += step)
+            vecIndex.push_back(static_cast<uint32_t>(i));
+    }
+    else if (decimation.mode == PointCloudDecimation::Mode::VoxelGrid) {
+        vecIndex = PointCloudUtils::voxelGridSampleIndices(*pointCloud, decimation.voxelSize);
+    }
+
+    if (vecIndex.size() != pointCloud->pointCount())
+        *pointCloud = PointCloudUtils::select(*pointCloud, vecIndex);
+}
+
+PointCloud PointCloudUtils::voxelGridDownsample(const PointCloud& pointCloud, double voxelSize)
+{
+    const std::vector<Vec3f>& positions = pointCloud.positions();
+    const SpatialHashGrid grid(positions, voxelSize);
+    // Flags of kept points, each one written by a single thread
+    std::vector<uint8_t> vecKeep(positions.size(), 0);
+
+    struct Voxel {
+        VoxelKey key;
+        gp_XYZ sum;
+        size_t count;
+        double minSquareDistance;
+        uint32_t nearestIndex;
+    };
+
+    constexpr size_t ChunkSize = 64 * 1024;
+    const int chunkCount = int((grid.bucketCount() + ChunkSize - 1) / ChunkSize);
+    OSD_Parallel::For(0, chunkCount, [&](int ichunk) {
+        std::vector<Voxel> vecVoxel; // Voxels of the current bucket, usually a single one
+        auto fnVoxel = [&](const VoxelKey& key) -> Voxel& {
+            for (Voxel& voxel : vecVoxel) {
+                if (voxel.key == key)
+                    return voxel;
+            }
+
+            vecVoxel.push_back({ key, {}, 0, std::numeric_limits<double>::max(), 0 });
+            return vecVoxel.back();
+        };
+
+        const size_t begin = ichunk * ChunkSize;
+        const size_t end = std::min(grid.bucketCount(), begin + ChunkSize);
+        for (size_t ibucket = begin; ibucket < end; ++ibucket) {
+            const SpatialHashGrid::SlotRange bucket = grid.bucketAt(ibucket);
+            vecVoxel.clear();
+            for (uint32_t slot = bucket.begin; slot < bucket.end; ++slot) {
+                Voxel& voxel = fnVoxel(grid.slotKey(slot));
+                const Vec3f& pos = positions[grid.slotPointIndex(slot)];
+                voxel.sum += gp_XYZ(pos.x(), pos.y(), pos.z());
+                ++voxel.count;
+            }
+
+            for (uint32_t slot = bucket.begin; slot < bucket.end; ++slot) {
+                Voxel& voxel = fnVoxel(grid.slotKey(slot));
+                const gp_XYZ centroid = voxel.sum / double(voxel.count);
+                const uint32_t index = grid.slotPointIndex(slot);
+                const Vec3f& pos = positions[index];
+                const double sqrDist = (gp_XYZ(pos.x(), pos.y(), pos.z()) - centroid).SquareModulus();
+                // Ties are resolved by point index, so result doesn't depend on the thread count
+                if (sqrDist < voxel.minSquareDistance
+                    || (sqrDist == voxel.minSquareDistance && index < voxel.nearestIndex))
+                {
+                    voxel.minSquareDistance = sqrDist;
+                    voxel.nearestIndex = index;
+                }
+            }
+
+            for (const Voxel& voxel : vecVoxel)
+                vecKeep[voxel.nearestIndex] = 1;
+        }
+    }, chunkCount <= 1);
+
+    return PointCloudUtils::select(pointCloud, keptIndices(vecKeep));
+}
+
+std::vector<uint32_t> PointCloudUtils::statisticalInlierIndices(
+        const PointCloud& pointCloud, int neighborCount, double stdDevRatio
+    )
+{
+    const std::vector<Vec3f>& positions = pointCloud.positions();
+    const size_t pointCount = indexablePointCount(positions.size());
+    const size_t k = size_t(std::max(1, neighborCount));
+    std::vector<uint8_t> vecKeep(pointCount, 1);
+    if (pointCount <= k)
+        return keptIndices(vecKeep);
+
+    // Cell size such that a cell holds 'k' points on average, flat dimensions of the bounding
+    // box(eg scan of a planar area) being ignored
+    double xmin, ymin, zmin, xmax, ymax, zmax;
+    pointCloud.computeBoundingBox().Get(xmin, ymin, zmin, xmax, ymax, zmax);
+    const double extents[] = { xmax - xmin, ymax - ymin, zmax - zmin };
+    const double maxExtent = *std::max_element(std::cbegin(extents), std::cend(extents));
+    double measure = 1.;
+    int dimCount = 0;
+    for (double extent : extents) {
+        if (extent > 1e-6 * maxExtent) {
+            measure *= extent;
+            ++dimCount;
+        }
+    }
+
+    if (dimCount == 0)
+        return keptIndices(vecKeep); // All points are coincident
+
+    const double cellSize = std::pow(measure * k / double(pointCount), 1. / dimCount);
+    const SpatialHashGrid grid(positions, cellSize);
+    // Copy of positions in slot order, neighbor candidates are then read sequentially
+    std::vector<Vec3f> vecSlotPos(pointCount);
+    for (uint32_t slot = 0; slot < pointCount; ++slot)
+        vecSlotPos[slot] = positions[grid.slotPointIndex(slot)];
+
+    // Mean distance of each point to its k nearest neighbors, found by visiting the rings of cells
+    // around the cell of the point until remaining cells can't provide nearer neighbors
+    constexpr int MaxRing = 4;
+    std::vector<float> vecMeanDist(pointCount);
+    constexpr size_t ChunkSize = 16 * 1024;
+    const int chunkCount = int((pointCount + ChunkSize - 1) / ChunkSize);
+    OSD_Parallel::For(0, chunkCount, [&](int ichunk) {
+        std::vector<float> heap; // Max-heap of the square distances to nearest neighbors
+        heap.reserve(k);
+        const uint32_t begin = uint32_t(ichunk * ChunkSize);
+        const uint32_t end = uint32_t(std::min(pointCount, begin + ChunkSize));
+        for (uint32_t slot = begin; slot < end; ++slot) {
+            const Vec3f& pos = vecSlotPos[slot];
+            auto fnVisitCell = [&](const VoxelKey& key) {
+                const SpatialHashGrid::SlotRange bucket = grid.bucket(key);
+                for (uint32_t other = bucket.begin; other < bucket.end; ++other) {
+                    if (other == slot || grid.slotKey(other) != key)
+                        continue;
+
+                    const float sqrDist = (vecSlotPos[other] - pos).SquareModulus();
+                    if (heap.size() < k) {
+                        heap.push_back(sqrDist);
+                        std::push_heap(heap.begin(), heap.end());
+                    }
+                    else if (sqrDist < heap.front()) {
+                        std::pop_heap(heap.begin(), heap.end());
+                        heap.back() = sqrDist;
+                        std::push_heap(heap.begin(), heap.end());
+                    }
+                }
+            };
+
+            heap.clear();
+            for (int ring = 0; ring <= MaxRing; ++ring) {
+                foreachCellOfRing(grid.slotKey(slot), ring, fnVisitCell);
+                // Points in cells beyond current ring are at least 'ring * cellSize' away
+                const double reach = ring * cellSize;
+                if (heap.size() == k && heap.front() <= reach * reach)
+                    break;
+            }
+
+            double sumDist = 0.;
+            for (float sqrDist : heap)
+                sumDist += std::sqrt(sqrDist);
+
+            // Neighbors not found are beyond the visited rings
+            sumDist += (k - heap.size()) * MaxRing * cellSize;
+            vecMeanDist[grid.slotPointIndex(slot)] = float(sumDist / k);
+        }
+    }, chunkCount <= 1);
+
+    double sum = 0.;
+    double sqrSum = 0.;
+    for (float dist : vecMeanDist) {
+        sum += dist;
+        sqrSum += double(dist) * dist;
+    }
+
+    const double mean = sum / pointCount;
+    const double stdDev = std::sqrt(std::max(0., sqrSum / pointCount - mean * mean));
+    const double maxMeanDist = mean + stdDevRatio * stdDev;
+    for (size_t i = 0; i < pointCount; ++i)
+        vecKeep[i] = vecMeanDist[i] <= maxMeanDist ? 1 : 0;
+
+    return keptIndices(vecKeep);
+}
+
+PointCloud PointCloudUtils::removeStatisticalOutliers(
+        const PointCloud& pointCloud, int neighborCount, double stdDevRatio
+    )
+{
+    const std::vector<uint32_t> vecIndex = PointCloudUtils::statisticalInlierIndices(pointCloud, neighborCount, stdDevRatio);
+    return PointCloudUtils::select(pointCloud, vecIndex);
+}
+
+PointCloud PointCloudUtils::cropBox(const PointCloud& pointCloud, const Bnd_Box& box)
+{
+    if (box.IsVoid())
+        return {};
+
+    // Box is expressed in absolute coordinates, unlike positions
+    const gp_XYZ& origin = pointCloud.origin();
+    double xmin, ymin, zmin, xmax, ymax, zmax;
+    box.Get(xmin, ymin, zmin, xmax, ymax, zmax);
+    xmin -= origin.X(); ymin -= origin.Y(); zmin -= origin.Z();
+    xmax -= origin.X(); ymax -= origin.Y(); zmax -= origin.Z();
+    std::vector<uint32_t> vecIndex;
+    const std::vector<Vec3f>& positions = pointCloud.positions();
+    const uint32_t pointCount = indexablePointCount(positions.size());
+    for (uint32_t i = 0; i < pointCount; ++i) {
+        const Vec3f& pos = positions[i];
+        if (xmin <= pos.x() && pos.x() <= xmax
+            && ymin <= pos.y() && pos.y() <= ymax
+            && zmin <= pos.z() && pos.z() <= zmax)
+        {
+            vecIndex.push_back(i);
+        }
+    }
+
+    return PointCloudUtils::select(pointCloud, vecIndex);
+}
+
+} // namespace Mayo
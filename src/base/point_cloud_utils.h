@@ -0,0 +1,80 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "point_cloud.h"
+#include "spatial_hash_grid.h"
+#include "span.h"
+
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+namespace Mayo {
+
+// Decimation to be applied while reading point clouds
+struct PointCloudDecimation {
+    enum class Mode {
+        None,
+        EveryNth, // Keep one point every 'step' points
+        VoxelGrid // Keep the first point found in each cubic cell of size 'voxelSize'
+    };
+
+    Mode mode = Mode::None;
+    int step = 10;
+    double voxelSize = 1.;
+};
+
+// Incrementally tells if a point falls into a voxel(cubic cell) not yet occupied
+class VoxelGridSampler {
+public:
+    VoxelGridSampler(double voxelSize);
+
+    // Returns true if 'pos' is the first point found in its voxel
+    bool tryAdd(const PointCloud::Vec3f& pos);
+
+private:
+    double m_invVoxelSize = 1.;
+    std::unordered_set<VoxelKey, VoxelKeyHash> m_setVoxel;
+};
+
+struct PointCloudUtils {
+    // Returns the concatenation of 'parts', attributes are copied in parallel
+    // Attributes(colors, normals, ...) are taken from the first non-empty part, other parts are
+    // expected to provide the same attributes. Result has the origin of the first non-empty part
+    static PointCloud concatenate(Span<const PointCloud> parts);
+
+    // Returns the subset of 'pointCloud' made of points at 'indices'(all attributes are copied)
+    static PointCloud select(const PointCloud& pointCloud, Span<const uint32_t> indices);
+
+    // Returns indices of the points kept by a voxel grid of size 'voxelSize'
+    static std::vector<uint32_t> voxelGridSampleIndices(const PointCloud& pointCloud, double voxelSize);
+
+    // Applies 'decimation' on 'pointCloud'
+    // EveryNth mode considers indices of points in 'pointCloud', so it should be applied before any
+    // concatenation of point clouds decimated separately
+    static void decimate(PointCloud* pointCloud, const PointCloudDecimation& decimation);
+
+    // Returns one point per voxel of size 'voxelSize': the point closest to the centroid of the
+    // points in the voxel. Unlike voxelGridSampleIndices(), result doesn't depend on points order
+    // Voxels are processed in parallel, cost is linear with point count(see SpatialHashGrid)
+    static PointCloud voxelGridDownsample(const PointCloud& pointCloud, double voxelSize);
+
+    // Returns indices of the points whose mean distance to their 'neighborCount' nearest neighbors
+    // doesn't exceed 'stdDevRatio' standard deviations above the mean of these distances
+    static std::vector<uint32_t> statisticalInlierIndices(
+            const PointCloud& pointCloud, int neighborCount, double stdDevRatio
+    );
+    static PointCloud removeStatisticalOutliers(
+            const PointCloud& pointCloud, int neighborCount, double stdDevRatio
+    );
+
+    // Returns the points of 'pointCloud' located inside 'box'
+    static PointCloud cropBox(const PointCloud& pointCloud, const Bnd_Box& box);
+};
+
+} // namespace Mayo
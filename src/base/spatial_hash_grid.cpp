@@ -0,0 +1,109 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "spatial_hash_grid.h"
+
+#include "cpp_utils.h"
+
+#include <OSD_Parallel.hxx>
+
+#include <algorithm>
+#include <cmath>
+
+namespace Mayo {
+
+VoxelKey VoxelKey::of(const NCollection_Vec3<float>& pos, double invCellSize)
+{
+    return {
+        int64_t(std::floor(pos.x() * invCellSize)),
+        int64_t(std::floor(pos.y() * invCellSize)),
+        int64_t(std::floor(pos.z() * invCellSize))
+    };
+}
+
+VoxelKey VoxelKey::of(const gp_XYZ& coords, double invCellSize)
+{
+    return {
+        int64_t(std::floor(coords.X() * invCellSize)),
+        int64_t(std::floor(coords.Y() * invCellSize)),
+        int64_t(std::floor(coords.Z() * invCellSize))
+    };
+}
+
+size_t VoxelKeyHash::operator()(const VoxelKey& key) const
+{
+    // Large primes from "Optimized Spatial Hashing for Collision Detection of Deformable Objects"
+    const auto x = uint64_t(key.x) * 73856093u;
+    const auto y = uint64_t(key.y) * 19349663u;
+    const auto z = uint64_t(key.z) * 83492791u;
+    // Final mix(from MurmurHash3) so low bits, used to index buckets, depend on all coordinates
+    uint64_t h = x ^ y ^ z;
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    return size_t(h);
+}
+
+SpatialHashGrid::SpatialHashGrid(Span<const Vec3f> positions, double cellSize)
+    : m_cellSize(cellSize > 0. ? cellSize : 1.),
+      m_invCellSize(1. / m_cellSize)
+{
+    // Power of two bucket count, so bucket index is just a mask of the hash value
+    size_t bucketCount = 1;
+    while (bucketCount < positions.size())
+        bucketCount <<= 1;
+
+    // Point indices are stored on 32 bits
+    const uint32_t pointCount = CppUtils::safeStaticCast<uint32_t>(positions.size());
+    std::vector<VoxelKey> vecPointKey(pointCount);
+    std::vector<uint32_t> vecPointBucket(pointCount);
+    m_vecBucketOffset.assign(bucketCount + 1, 0);
+
+    // Keys and buckets of points are computed in parallel
+    constexpr size_t ChunkSize = 256 * 1024;
+    const int chunkCount = int((pointCount + ChunkSize - 1) / ChunkSize);
+    OSD_Parallel::For(0, chunkCount, [&](int ichunk) {
+        const size_t begin = ichunk * ChunkSize;
+        const size_t end = std::min<size_t>(pointCount, begin + ChunkSize);
+        for (size_t i = begin; i < end; ++i) {
+            vecPointKey[i] = this->keyOf(positions[i]);
+            vecPointBucket[i] = uint32_t(this->bucketIndex(vecPointKey[i]));
+        }
+    }, chunkCount <= 1);
+
+    // Counting scatter of points into slots
+    for (uint32_t ibucket : vecPointBucket)
+        ++m_vecBucketOffset[ibucket + 1];
+
+    for (size_t i = 1; i < m_vecBucketOffset.size(); ++i)
+        m_vecBucketOffset[i] += m_vecBucketOffset[i - 1];
+
+    std::vector<uint32_t> vecBucketCursor(m_vecBucketOffset.cbegin(), m_vecBucketOffset.cend() - 1);
+    m_vecSlotPointIndex.resize(pointCount);
+    m_vecSlotKey.resize(pointCount);
+    for (uint32_t i = 0; i < pointCount; ++i) {
+        const uint32_t slot = vecBucketCursor[vecPointBucket[i]]++;
+        m_vecSlotPointIndex[slot] = i;
+        m_vecSlotKey[slot] = vecPointKey[i];
+    }
+}
+
+SpatialHashGrid::SlotRange SpatialHashGrid::bucket(const VoxelKey& key) const
+{
+    return this->bucketAt(this->bucketIndex(key));
+}
+
+SpatialHashGrid::SlotRange SpatialHashGrid::bucketAt(size_t ibucket) const
+{
+    return { m_vecBucketOffset[ibucket], m_vecBucketOffset[ibucket + 1] };
+}
+
+size_t SpatialHashGrid::bucketIndex(const VoxelKey& key) const
+{
+    return VoxelKeyHash{}(key) & (this->bucketCount() - 1);
+}
+
+} // namespace Mayo
@@ -0,0 +1,79 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "span.h"
+
+#include <NCollection_Vec3.hxx>
+#include <gp_XYZ.hxx>
+#include <cstdint>
+#include <vector>
+
+namespace Mayo {
+
+// Integer coordinates of a cubic cell in a uniform grid
+struct VoxelKey {
+    int64_t x;
+    int64_t y;
+    int64_t z;
+
+    // Cell containing 'pos' for a grid whose cell size is 1/invCellSize
+    static VoxelKey of(const NCollection_Vec3<float>& pos, double invCellSize);
+    static VoxelKey of(const gp_XYZ& coords, double invCellSize);
+
+    bool operator==(const VoxelKey& other) const {
+        return x == other.x && y == other.y && z == other.z;
+    }
+    bool operator!=(const VoxelKey& other) const { return !(*this == other); }
+};
+
+struct VoxelKeyHash {
+    size_t operator()(const VoxelKey& key) const;
+};
+
+// Buckets points into the cells of a uniform grid, without any tree nor sorting
+//
+// Cells are addressed through a hash table having as many buckets as points, which is filled by a
+// counting scatter: construction and cell lookups are linear with point count whatever the extent
+// of the data
+// Points are stored by bucket into "slots", so points of a cell are contiguous in memory. A bucket
+// can hold points of several cells(hash collisions), so callers have to filter with slotKey()
+class SpatialHashGrid {
+public:
+    using Vec3f = NCollection_Vec3<float>;
+
+    struct SlotRange {
+        uint32_t begin;
+        uint32_t end;
+    };
+
+    SpatialHashGrid(Span<const Vec3f> positions, double cellSize);
+
+    double cellSize() const { return m_cellSize; }
+    VoxelKey keyOf(const Vec3f& pos) const { return VoxelKey::of(pos, m_invCellSize); }
+
+    size_t slotCount() const { return m_vecSlotPointIndex.size(); }
+    uint32_t slotPointIndex(uint32_t slot) const { return m_vecSlotPointIndex[slot]; }
+    const VoxelKey& slotKey(uint32_t slot) const { return m_vecSlotKey[slot]; }
+
+    // Slots of the bucket where cell 'key' is stored
+    SlotRange bucket(const VoxelKey& key) const;
+
+    size_t bucketCount() const { return m_vecBucketOffset.size() - 1; }
+    SlotRange bucketAt(size_t ibucket) const;
+
+private:
+    size_t bucketIndex(const VoxelKey& key) const;
+
+    double m_cellSize = 1.;
+    double m_invCellSize = 1.;
+    std::vector<uint32_t> m_vecBucketOffset;
+    std::vector<uint32_t> m_vecSlotPointIndex;
+    std::vector<VoxelKey> m_vecSlotKey;
+};
+
+} // namespace Mayo
@@ -256,4 +256,33 @@ DoubleToStringOperation to_stdString(double value)
     return op;
 }
 
+std::string to_jsonString(std::string_view str)
+{
+    static const char hexDigits[] = "0123456789abcdef";
+    std::string out;
+    out.reserve(str.size() + 2);
+    out += '"';
+    for (char c : str) {
+        switch (c) {
+        case '"':  out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                out += "\\u00";
+                out += hexDigits[static_cast<unsigned char>(c) >> 4];
+                out += hexDigits[static_cast<unsigned char>(c) & 0xF];
+            }
+            else {
+                out += c;
+            }
+        }
+    }
+
+    out += '"';
+    return out;
+}
+
 } // namespace Mayo
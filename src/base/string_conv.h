@@ -93,6 +93,9 @@ private:
 std::string to_stdString(double value, const DoubleToStringOptions& opts);
 DoubleToStringOperation to_stdString(double value);
 
+// Returns 'str' as a JSON string literal(ie double-quoted with special characters escaped)
+std::string to_jsonString(std::string_view str);
+
 // --
 // -- Converters(misc)
 // --
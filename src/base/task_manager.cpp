@@ -9,12 +9,18 @@
 #include "cpp_utils.h"
 #include "math_utils.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
+#include <chrono>
 #include <cmath>
+#include <condition_variable>
 #include <future>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 namespace Mayo {
 
@@ -44,9 +50,25 @@ struct TaskManager::Private {
     // Destroy finished task entities whose policy was set to TaskAutoDestroy::On
     void cleanGarbage();
 
+    // Deferred notifications of throttled progress values, sent by a dedicated thread
+    // A task cancels its deferred notification before ending, so progress objects stay valid
+    struct DeferredNotification {
+        TaskProgress* progress = nullptr;
+        std::chrono::steady_clock::time_point time;
+    };
+    void cancelDeferredNotification(TaskProgress* progress);
+    void runDeferredNotifications();
+
     TaskManager* taskMgr = nullptr;
     std::atomic<TaskId> taskIdSeq = {};
+    std::atomic<int> progressSignalInterval = 50;
     std::unordered_map<TaskId, std::unique_ptr<TaskManager::Entity>> mapEntity;
+
+    std::mutex deferredMutex;
+    std::condition_variable deferredCondition;
+    std::vector<DeferredNotification> vecDeferred;
+    std::thread deferredThread; // Started on first deferred notification
+    bool isDeferredThreadStopRequested = false;
 };
 
 TaskManager::TaskManager()
@@ -68,6 +90,16 @@ TaskManager::~TaskManager()
     for (auto it = d->mapEntity.begin(); it != d->mapEntity.end(); )
         it = d->mapEntity.erase(it);
 
+    if (d->deferredThread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(d->deferredMutex);
+            d->isDeferredThreadStopRequested = true;
+        }
+
+        d->deferredCondition.notify_one();
+        d->deferredThread.join();
+    }
+
     delete d;
 }
 
@@ -158,6 +190,36 @@ int TaskManager::globalProgress() const
     return std::lround(pct);
 }
 
+int TaskManager::progressSignalInterval() const
+{
+    return d->progressSignalInterval.load(std::memory_order_relaxed);
+}
+
+void TaskManager::setProgressSignalInterval(int msecs)
+{
+    d->progressSignalInterval = std::max(msecs, 0);
+}
+
+void TaskManager::deferProgressNotification(TaskProgress* progress, int64_t timeNs)
+{
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point time(std::chrono::duration_cast<Clock::duration>(std::chrono::nanoseconds(timeNs)));
+    {
+        std::lock_guard<std::mutex> lock(d->deferredMutex);
+        auto itDeferred = std::find_if(d->vecDeferred.begin(), d->vecDeferred.end(), [=](const auto& deferred) {
+            return deferred.progress == progress;
+        });
+        if (itDeferred != d->vecDeferred.end())
+            return; // Pending notification will send the latest value
+
+        d->vecDeferred.push_back({ progress, time });
+        if (!d->deferredThread.joinable())
+            d->deferredThread = std::thread([=]{ d->runDeferredNotifications(); });
+    }
+
+    d->deferredCondition.notify_one();
+}
+
 const std::string& TaskManager::title(TaskId id) const
 {
     const Entity* entity = d->findEntity(id);
@@ -194,10 +256,47 @@ void TaskManager::Private::execEntity(Entity* entity)
     if (!entity->taskProgress.isAbortRequested())
         entity->taskProgress.setValue(100);
 
+    // Last value may have been throttled
+    this->cancelDeferredNotification(&entity->taskProgress);
+    entity->taskProgress.flushValueChanged();
     this->taskMgr->signalEnded.send(entity->taskId);
     entity->isFinished = true;
 }
 
+void TaskManager::Private::cancelDeferredNotification(TaskProgress* progress)
+{
+    // Locking also waits for a notification being sent by the deferred thread
+    std::lock_guard<std::mutex> lock(this->deferredMutex);
+    auto itEnd = std::remove_if(this->vecDeferred.begin(), this->vecDeferred.end(), [=](const auto& deferred) {
+        return deferred.progress == progress;
+    });
+    this->vecDeferred.erase(itEnd, this->vecDeferred.end());
+}
+
+void TaskManager::Private::runDeferredNotifications()
+{
+    std::unique_lock<std::mutex> lock(this->deferredMutex);
+    while (!this->isDeferredThreadStopRequested) {
+        if (this->vecDeferred.empty()) {
+            this->deferredCondition.wait(lock);
+            continue;
+        }
+
+        auto itNext = std::min_element(this->vecDeferred.begin(), this->vecDeferred.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.time < rhs.time;
+        });
+        if (std::chrono::steady_clock::now() < itNext->time) {
+            this->deferredCondition.wait_until(lock, itNext->time);
+            continue;
+        }
+
+        // Sent with the mutex locked, so the task can't end meanwhile
+        TaskProgress* progress = itNext->progress;
+        this->vecDeferred.erase(itNext);
+        progress->flushValueChanged();
+    }
+}
+
 void TaskManager::Private::cleanGarbage()
 {
     auto it = this->mapEntity.begin();
@@ -52,6 +52,12 @@ public:
     // Current progress of all tasks
     int globalProgress() const;
 
+    // Minimum time interval(milliseconds) between two emissions of signalProgressChanged for a
+    // task, progress changes happening in between are coalesced. Values 0 and 100 are always sent
+    // Default is 50ms(ie 20Hz), zero disables throttling
+    int progressSignalInterval() const;
+    void setProgressSignalInterval(int msecs);
+
     // Title(description) of a task identified by 'id'
     const std::string& title(TaskId id) const;
     void setTitle(TaskId id, std::string_view title);
@@ -84,6 +90,11 @@ public:
     Signal<TaskId> signalEnded;
 
 private:
+    // Schedules notification of the current value of root 'progress' at time 'timeNs'(nanoseconds
+    // since epoch of std::chrono::steady_clock), so the last throttled value isn't lost
+    void deferProgressNotification(TaskProgress* progress, int64_t timeNs);
+    friend class TaskProgress;
+
     struct Entity;
     struct Private;
     Private* const d = nullptr;
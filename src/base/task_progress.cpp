@@ -8,16 +8,17 @@
 #include "task_manager.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
-#include <limits>
 
 namespace Mayo {
 
 TaskProgress::TaskProgress(TaskProgress* parent, double portionSize, std::string_view step)
     : m_parent(parent),
+      m_root(parent ? parent->m_root : this),
       m_taskMgr(parent ? parent->m_taskMgr : nullptr),
       m_taskId(parent ? parent->m_taskId : TaskId_null),
-      m_portionSize(std::clamp(portionSize, 0., 100.))
+      m_scale(parent ? std::llround(parent->m_scale * (std::clamp(portionSize, 0., 100.) / 100.)) : RootScale)
 {
     if (!step.empty())
         this->setStep(step);
@@ -40,31 +41,35 @@ bool TaskProgress::isNull() const
     return m_taskId == TaskId_null;
 }
 
+int TaskProgress::value() const
+{
+    if (m_scale <= 0)
+        return 0;
+
+    const double pct = (100. * m_value.load(std::memory_order_relaxed)) / m_scale;
+    return std::clamp(static_cast<int>(std::lround(pct)), 0, 100);
+}
+
 void TaskProgress::setValue(int pct)
+{
+    this->setValue(static_cast<double>(pct));
+}
+
+void TaskProgress::setValue(double pct)
 {
     if (m_taskId == TaskId_null)
         return;
 
-    if (m_isAbortRequested)
+    if (this->isAbortRequested())
         return;
 
-    const int valueOnEntry = m_value;
-    m_value = std::clamp(pct, 0, 100);
-    if (m_value != 0 && m_value == valueOnEntry)
+    const int64_t value = std::llround(m_scale * (std::clamp(pct, 0., 100.) / 100.));
+    const int64_t valueOnEntry = m_ownValue.exchange(value);
+    if (value == valueOnEntry && value != 0)
         return;
 
-    if (m_parent) {
-        const auto valueDeltaInParent = std::round((m_value - valueOnEntry) * (m_portionSize / 100.));
-        m_parent->setValue(m_parent->value() + valueDeltaInParent);
-    }
-    else {
-        m_taskMgr->signalProgressChanged.send(m_taskId, m_value);
-    }
-}
-
-void TaskProgress::setValue(double pct)
-{
-    this->setValue(static_cast<int>(std::lround(pct)));
+    this->updateValue();
+    m_root->notifyValueChanged();
 }
 
 void TaskProgress::setStep(std::string_view title)
@@ -75,6 +80,16 @@ void TaskProgress::setStep(std::string_view title)
     }
 }
 
+bool TaskProgress::isAbortRequested() const
+{
+    for (const TaskProgress* progress = this; progress; progress = progress->m_parent) {
+        if (progress->m_isAbortRequested.load(std::memory_order_relaxed))
+            return true;
+    }
+
+    return false;
+}
+
 bool TaskProgress::isAbortRequested(const TaskProgress* progress)
 {
     return progress ? progress->isAbortRequested() : false;
@@ -86,4 +101,76 @@ void TaskProgress::requestAbort()
         m_isAbortRequested = true;
 }
 
+void TaskProgress::updateValue()
+{
+    // Values share the same unit across the progress tree, so the delta of the effective value is
+    // added as is to the parent
+    for (TaskProgress* progress = this; progress; progress = progress->m_parent) {
+        int64_t valueOnEntry = progress->m_value.load();
+        int64_t value = 0;
+        do {
+            value = std::min(progress->m_ownValue.load() + progress->m_childrenValue.load(), progress->m_scale);
+        } while (!progress->m_value.compare_exchange_weak(valueOnEntry, value));
+
+        const int64_t valueDelta = value - valueOnEntry;
+        if (valueDelta == 0)
+            break;
+
+        if (progress->m_parent)
+            progress->m_parent->m_childrenValue.fetch_add(valueDelta);
+    }
+}
+
+void TaskProgress::notifyValueChanged()
+{
+    if (!m_taskMgr)
+        return;
+
+    const int pct = this->value();
+    int notifiedPct = m_notifiedValue.load(std::memory_order_relaxed);
+    if (pct == notifiedPct)
+        return;
+
+    // Bound values are always notified, others at most once per time interval
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    const int64_t nowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+    int64_t notifiedTimeNs = m_notifiedTime.load(std::memory_order_relaxed);
+    if (pct != 0 && pct != 100) {
+        // Throttled value is notified at the end of the interval, unless superseded meanwhile
+        const int64_t intervalNs = int64_t(m_taskMgr->progressSignalInterval()) * 1000000;
+        if (nowNs - notifiedTimeNs < intervalNs) {
+            m_taskMgr->deferProgressNotification(this, notifiedTimeNs + intervalNs);
+            return;
+        }
+
+        // Another thread may be notifying concurrently, only one wins
+        if (!m_notifiedTime.compare_exchange_strong(notifiedTimeNs, nowNs)) {
+            m_taskMgr->deferProgressNotification(this, nowNs + intervalNs);
+            return;
+        }
+    }
+    else {
+        m_notifiedTime.store(nowNs, std::memory_order_relaxed);
+    }
+
+    // Bound values must not be lost against a concurrent notification of an intermediate value
+    const bool isBoundValue = pct == 0 || pct == 100;
+    while (!m_notifiedValue.compare_exchange_strong(notifiedPct, pct)) {
+        if (!isBoundValue || notifiedPct == pct)
+            return;
+    }
+
+    m_taskMgr->signalProgressChanged.send(m_taskId, pct);
+}
+
+void TaskProgress::flushValueChanged()
+{
+    if (!m_taskMgr)
+        return;
+
+    const int pct = this->value();
+    if (m_notifiedValue.exchange(pct) != pct)
+        m_taskMgr->signalProgressChanged.send(m_taskId, pct);
+}
+
 } // namespace Mayo
@@ -8,6 +8,7 @@
 
 #include "task_common.h"
 #include <atomic>
+#include <cstdint>
 #include <string>
 #include <string_view>
 
@@ -16,6 +17,13 @@ namespace Mayo {
 class TaskManager;
 
 // Provides feedback on the progress of a running/executing task
+//
+// Progress objects form a tree: a child progress covers a portion of its parent. Values are
+// accumulated as fixed-point integers expressed in units of the root progress, so nesting doesn't
+// lose precision and child progress objects can be updated concurrently from many threads.
+// The value of a progress is its own value(see setValue()) plus the values of its children.
+// Notification of the root value(TaskManager::signalProgressChanged) is throttled, see
+// TaskManager::setProgressSignalInterval(), but the final value of a task is always notified
 class TaskProgress {
 public:
     TaskProgress() = default;
@@ -28,8 +36,9 @@ public:
     TaskId taskId() const { return m_taskId; }
     TaskManager* taskManager() const { return m_taskMgr; }
 
-    // Value in [0,100]
-    int value() const { return m_value; }
+    // Value in [0,100], children values included
+    int value() const;
+    // Own value of this progress in [0,100], children values are added to it
     void setValue(int pct);
     void setValue(double pct);
 
@@ -40,7 +49,8 @@ public:
     const TaskProgress* parent() const { return m_parent; }
     TaskProgress* parent() { return m_parent; }
 
-    bool isAbortRequested() const { return m_isAbortRequested; }
+    // Abort requested on this progress or any of its ancestors
+    bool isAbortRequested() const;
     static bool isAbortRequested(const TaskProgress* progress);
 
     // Disable copy
@@ -53,16 +63,29 @@ private:
     void setTaskId(TaskId id) { m_taskId = id; }
     void setTaskManager(TaskManager* mgr) { m_taskMgr = mgr; }
     void requestAbort();
+    void updateValue();
+    void notifyValueChanged();
+    void flushValueChanged();
 
     friend class TaskManager;
 
+    // Fixed-point value of 100% for a root progress
+    static constexpr int64_t RootScale = int64_t(1) << 40;
+
     TaskProgress* m_parent = nullptr;
+    TaskProgress* m_root = this;
     TaskManager* m_taskMgr = nullptr;
     TaskId m_taskId = TaskId_null;
-    double m_portionSize = -1;
-    std::atomic<int> m_value = 0;
+    int64_t m_scale = RootScale; // Fixed-point value of 100% for this progress, in root units
+    std::atomic<int64_t> m_ownValue = 0; // Fixed-point value in root units, as set by setValue()
+    std::atomic<int64_t> m_childrenValue = 0; // Sum of the children values
+    std::atomic<int64_t> m_value = 0; // Own and children values, capped to m_scale
     std::string m_step;
-    bool m_isAbortRequested = false;
+    std::atomic<bool> m_isAbortRequested = false;
+
+    // Used by root progress only, to throttle notifications
+    std::atomic<int> m_notifiedValue = -1;
+    std::atomic<int64_t> m_notifiedTime = 0; // Nanoseconds since epoch of std::chrono::steady_clock
 };
 
 } // namespace Mayo
@@ -5,6 +5,7 @@
 ****************************************************************************/
 
 #include "triangulation_annex_data.h"
+#include "label_data.h"
 
 #include <Standard_GUID.hxx>
 #include <TDF_Label.hxx>
@@ -83,4 +84,14 @@ void Mayo::TriangulationAnnexData::copyNodeColors(Span<const Quantity_Color> spa
     std::copy(spanNodeColor.begin(), spanNodeColor.end(), std::back_inserter(m_vecNodeColor));
 }
 
+void TriangulationAnnexData::AfterAddition()
+{
+    invalidateLabelDataFlags(this->Label());
+}
+
+void TriangulationAnnexData::BeforeForget()
+{
+    invalidateLabelDataFlags(this->Label());
+}
+
 } // namespace Mayo
@@ -34,6 +34,8 @@ public:
     OccHandle<TDF_Attribute> NewEmpty() const override;
     void Paste(const OccHandle<TDF_Attribute>& into, const OccHandle<TDF_RelocationTable>& table) const override;
     Standard_OStream& Dump(Standard_OStream& ostr) const override;
+    void AfterAddition() override;
+    void BeforeForget() override;
 
     DEFINE_STANDARD_RTTI_INLINE(TriangulationAnnexData, TDF_Attribute)
 
@@ -6,6 +6,7 @@
 
 #include "xcaf.h"
 #include "caf_utils.h"
+#include "label_data.h"
 #include "math_utils.h"
 
 #include <TDataStd_TreeNode.hxx>
@@ -17,6 +18,8 @@
 #include <XCAFDoc_DocumentTool.hxx>
 #include <XCAFDoc_Volume.hxx>
 #include <set>
+#include <utility>
+#include <vector>
 
 namespace Mayo {
 
@@ -100,6 +103,7 @@ TopoDS_Shape XCaf::shape(const TDF_Label& lbl)
 void XCaf::setShape(const TDF_Label& label, const TopoDS_Shape& shape)
 {
     this->shapeTool()->SetShape(label, shape);
+    invalidateLabelDataFlags(label);
 }
 
 //QString XCaf::findLabelName(const TDF_Label& lbl)
@@ -341,23 +345,40 @@ TreeNodeId XCaf::deepBuildAssemblyTree(TreeNodeId parentNode, const TDF_Label& l
 {
     Expects(m_modelTree != nullptr);
 
-    const TreeNodeId node = m_modelTree->appendChild(parentNode, label);
-    if (XCaf::isShapeAssembly(label)) {
-        for (const TDF_Label& child : XCaf::shapeComponents(label))
-            this->deepBuildAssemblyTree(node, child);
-    }
-    else if (XCaf::isShapeReference(label)) {
-        const TDF_Label referred = XCaf::shapeReferred(label);
-        this->deepBuildAssemblyTree(node, referred);
-    }
+    // Iterative depth-first expansion, children are pushed in reverse order so they are appended
+    // to their parent node in the same order as XCAF components
+    struct PendingNode {
+        TreeNodeId parentNode;
+        TDF_Label label;
+    };
+    std::vector<PendingNode> stack;
+    stack.push_back({ parentNode, label });
+    TreeNodeId firstNode = 0;
+    while (!stack.empty()) {
+        const PendingNode pending = std::move(stack.back());
+        stack.pop_back();
+        const TreeNodeId node = m_modelTree->appendChild(pending.parentNode, pending.label);
+        if (firstNode == 0)
+            firstNode = node;
+
+        if (XCaf::isShapeAssembly(pending.label)) {
+            const TDF_LabelSequence seqComponent = XCaf::shapeComponents(pending.label);
+            for (int i = seqComponent.Upper(); i >= seqComponent.Lower(); --i)
+                stack.push_back({ node, seqComponent.Value(i) });
+        }
+        else if (XCaf::isShapeReference(pending.label)) {
+            stack.push_back({ node, XCaf::shapeReferred(pending.label) });
+        }
 #if 0
-    else if (XCaf::isShapeSimple(label)) {
-        for (const TDF_Label& child : XCaf::shapeSubs(label))
-            this->deepBuildAssemblyTree(node, child);
-    }
+        else if (XCaf::isShapeSimple(pending.label)) {
+            const TDF_LabelSequence seqSub = XCaf::shapeSubs(pending.label);
+            for (int i = seqSub.Upper(); i >= seqSub.Lower(); --i)
+                stack.push_back({ node, seqSub.Value(i) });
+        }
 #endif
+    }
 
-    return node;
+    return firstNode;
 }
 
 } // namespace Mayo
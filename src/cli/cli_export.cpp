@@ -9,9 +9,11 @@
 #include "console.h"
 #include "../app/app_module.h"
 #include "../base/application.h"
+#include "../base/data_reduction.h"
 #include "../base/io_system.h"
 #include "../base/messenger.h"
 #include "../base/task_manager.h"
+#include "../base/task_progress.h"
 #include "../qtcommon/qstring_conv.h"
 
 #include <Message.hxx>
@@ -119,16 +121,30 @@ bool importInDocument(DocumentPtr doc, const CliExportArgs& args, Helper* helper
             break; // Interrupt
     }
 
+    const DataReduction::Parameters dataReduction = args.dataReduction;
     ErrorMessageCollect errorCollect;
     const bool okImport = appModule->ioSystem()->importInDocument()
         .targetDocument(doc)
         .withFilepaths(args.filesToOpen)
         .withParametersProvider(appModule)
         .withEntityPostProcess([=](TDF_Label labelEntity, TaskProgress* progress) {
-            appModule->computeBRepMesh(labelEntity, progress);
+            if (brepMeshRequired) {
+                TaskProgress meshProgress(progress, dataReduction.isEnabled() ? 50 : 100);
+                appModule->computeBRepMesh(labelEntity, &meshProgress);
+            }
+
+            if (dataReduction.isEnabled()) {
+                TaskProgress reductionProgress(progress, brepMeshRequired ? 50 : 100);
+                DataReduction::applyToEntity(labelEntity, dataReduction, &reductionProgress);
+            }
         })
-        .withEntityPostProcessRequiredIf([=](IO::Format){ return brepMeshRequired; })
-        .withEntityPostProcessInfoProgress(20, CliExport::textIdTr("Mesh BRep shapes"))
+        .withEntityPostProcessRequiredIf([=](IO::Format){ return brepMeshRequired || dataReduction.isEnabled(); })
+        .withEntityPostProcessInfoProgress(
+            20,
+            dataReduction.isEnabled() ?
+                CliExport::textIdTr("Post-process entities") :
+                CliExport::textIdTr("Mesh BRep shapes")
+        )
         .withMessenger(&errorCollect)
         .withTaskProgress(progress)
         .execute();
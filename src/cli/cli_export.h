@@ -7,6 +7,7 @@
 #pragma once
 
 #include "../base/application_ptr.h"
+#include "../base/data_reduction.h"
 #include "../base/filepath.h"
 #include "../base/span.h"
 
@@ -19,6 +20,7 @@ struct CliExportArgs {
     bool progressReport = true;
     Span<const FilePath> filesToOpen;
     Span<const FilePath> filesToExport;
+    DataReduction::Parameters dataReduction;
 };
 
 // Asynchronously exports input file(s) listed in 'args'
@@ -7,6 +7,8 @@
 #include "../app/app_module.h"
 #include "../app/library_info.h"
 #include "../base/application.h"
+#include "../base/data_reduction.h"
+#include "../base/instrumentation.h"
 #include "../base/io_system.h"
 #include "../base/settings.h"
 #include "../graphics/graphics_mesh_object_driver.h"
@@ -23,6 +25,8 @@
 #include "../io_off/io_off_writer.h"
 #include "../io_ply/io_ply_reader.h"
 #include "../io_ply/io_ply_writer.h"
+#include "../io_pointcloud/io_las_reader.h"
+#include "../io_pointcloud/io_xyz_reader.h"
 #include "../qtbackend/qsettings_storage.h"
 #include "../qtbackend/qt_app_translator.h"
 #include "../qtbackend/qt_signal_thread_helper.h"
@@ -68,8 +72,11 @@ struct CommandLineArguments {
     FilePath filepathUseSettings;
     FilePath filepathWriteSettings;
     FilePath filepathLog;
+    FilePath filepathMetrics;
     std::vector<FilePath> listFilepathToExport;
     std::vector<FilePath> listFilepathToOpen;
+    DataReduction::Parameters dataReduction;
+    QStringList listErrorMessage;
     bool cacheUseSettings = false;
     bool includeDebugLogs = true;
     bool progressReport = true;
@@ -222,6 +229,46 @@ static CommandLineArguments processCommandLine()
     );
     cmdParser.addOption(cmdFileToExport);
 
+    const QCommandLineOption cmdCropBox(
+                QStringList{ "crop-box" },
+                Main::tr("Keep only the points of imported point clouds located inside box "
+                         "'xmin,ymin,zmin,xmax,ymax,zmax'"),
+                Main::tr("box")
+    );
+    cmdParser.addOption(cmdCropBox);
+
+    const QCommandLineOption cmdOutlierNeighbors(
+                QStringList{ "outlier-neighbors" },
+                Main::tr("Remove statistical outliers from imported point clouds, considering the "
+                         "mean distance of each point to its 'count' nearest neighbors"),
+                Main::tr("count")
+    );
+    cmdParser.addOption(cmdOutlierNeighbors);
+
+    const QCommandLineOption cmdOutlierStdDev(
+                QStringList{ "outlier-stddev" },
+                Main::tr("Points whose mean neighbor distance exceeds the global mean by more than "
+                         "'ratio' standard deviations are outliers(default: 1)"),
+                Main::tr("ratio")
+    );
+    cmdParser.addOption(cmdOutlierStdDev);
+
+    const QCommandLineOption cmdVoxelSize(
+                QStringList{ "voxel-size" },
+                Main::tr("Downsample imported point clouds by keeping a single point per voxel(cubic "
+                         "cell) of this size"),
+                Main::tr("size")
+    );
+    cmdParser.addOption(cmdVoxelSize);
+
+    const QCommandLineOption cmdMeshCellSize(
+                QStringList{ "mesh-cell-size" },
+                Main::tr("Decimate imported meshes by merging the vertices located in the same "
+                         "cubic cell of this size"),
+                Main::tr("size")
+    );
+    cmdParser.addOption(cmdMeshCellSize);
+
     const QCommandLineOption cmdLogFile(
                 QStringList{ "log-file" },
                 Main::tr("Writes log messages into output file"),
@@ -229,6 +276,14 @@ static CommandLineArguments processCommandLine()
     );
     cmdParser.addOption(cmdLogFile);
 
+    const QCommandLineOption cmdLogMetrics(
+                QStringList{ "log-metrics" },
+                Main::tr("Writes timing and memory metrics of each import/export stage as JSON lines "
+                         "into output file"),
+                Main::tr("filepath")
+    );
+    cmdParser.addOption(cmdLogMetrics);
+
     const QCommandLineOption cmdDebugLogs(
                 QStringList{ "debug-logs" },
                 Main::tr("Don't filter out debug log messages in release build")
@@ -273,11 +328,55 @@ static CommandLineArguments processCommandLine()
     if (cmdParser.isSet(cmdLogFile))
         args.filepathLog = filepathFrom(cmdParser.value(cmdLogFile));
 
+    if (cmdParser.isSet(cmdLogMetrics))
+        args.filepathMetrics = filepathFrom(cmdParser.value(cmdLogMetrics));
+
     if (cmdParser.isSet(cmdFileToExport)) {
         for (const QString& strFilepath : cmdParser.values(cmdFileToExport))
             args.listFilepathToExport.push_back(filepathFrom(strFilepath));
     }
 
+    // Data reduction options, invalid values are errors as the output would differ from expected
+    auto fnInvalidValue = [&](const QCommandLineOption& option) {
+        args.listErrorMessage.push_back(Main::tr("Invalid value for option '%1'").arg(option.names().front()));
+    };
+    auto fnOptionValue = [&](const QCommandLineOption& option, double defaultValue) {
+        bool ok = false;
+        const double value = cmdParser.value(option).toDouble(&ok);
+        if (!ok || value < 0) {
+            fnInvalidValue(option);
+            return defaultValue;
+        }
+
+        return value;
+    };
+
+    if (cmdParser.isSet(cmdCropBox)) {
+        const QStringList listCoord = cmdParser.value(cmdCropBox).split(',');
+        double coords[6] = {};
+        bool ok = listCoord.size() == 6;
+        for (int i = 0; ok && i < 6; ++i)
+            coords[i] = listCoord.at(i).trimmed().toDouble(&ok);
+
+        if (ok)
+            args.dataReduction.cropBox.Update(coords[0], coords[1], coords[2], coords[3], coords[4], coords[5]);
+        else
+            fnInvalidValue(cmdCropBox);
+    }
+
+    DataReduction::Parameters& dataReduction = args.dataReduction;
+    if (cmdParser.isSet(cmdOutlierNeighbors))
+        dataReduction.outlierNeighborCount = int(fnOptionValue(cmdOutlierNeighbors, dataReduction.outlierNeighborCount));
+
+    if (cmdParser.isSet(cmdOutlierStdDev))
+        dataReduction.outlierStdDevRatio = fnOptionValue(cmdOutlierStdDev, dataReduction.outlierStdDevRatio);
+
+    if (cmdParser.isSet(cmdVoxelSize))
+        dataReduction.voxelSize = fnOptionValue(cmdVoxelSize, dataReduction.voxelSize);
+
+    if (cmdParser.isSet(cmdMeshCellSize))
+        dataReduction.meshClusterCellSize = fnOptionValue(cmdMeshCellSize, dataReduction.meshClusterCellSize);
+
     for (const QString& posArg : cmdParser.positionalArguments())
         args.listFilepathToOpen.push_back(filepathFrom(posArg));
 
@@ -421,6 +520,8 @@ static int runApp(QCoreApplication* qtApp)
     ioSystem->addFactoryReader(std::make_unique<IO::OccFactoryReader>());
     ioSystem->addFactoryReader(std::make_unique<IO::OffFactoryReader>());
     ioSystem->addFactoryReader(std::make_unique<IO::PlyFactoryReader>());
+    ioSystem->addFactoryReader(std::make_unique<IO::XyzFactoryReader>());
+    ioSystem->addFactoryReader(std::make_unique<IO::LasFactoryReader>());
     ioSystem->addFactoryReader(IO::AssimpFactoryReader::create());
     ioSystem->addFactoryWriter(std::make_unique<IO::OccFactoryWriter>());
     ioSystem->addFactoryWriter(std::make_unique<IO::OffFactoryWriter>());
@@ -428,6 +529,18 @@ static int runApp(QCoreApplication* qtApp)
     ioSystem->addFactoryWriter(IO::GmioFactoryWriter::create());
     ioSystem->addFactoryWriter(std::make_unique<IO::ImageFactoryWriter>(guiApp));
     IO::addPredefinedFormatProbes(ioSystem);
+    // Metrics are written in their own file, so JSON lines aren't mixed with log messages
+    std::ofstream metricsStream;
+    std::unique_ptr<InstrumentationJsonLinesSink> metricsSink;
+    if (!args.filepathMetrics.empty()) {
+        metricsStream.open(args.filepathMetrics);
+        if (!metricsStream.is_open())
+            fnCriticalExit(Main::tr("Failed to open metrics file '%1'").arg(filepathTo<QString>(args.filepathMetrics)));
+
+        metricsSink = std::make_unique<InstrumentationJsonLinesSink>(metricsStream);
+        ioSystem->setInstrumentationSink(metricsSink.get());
+    }
+
     appModule->properties()->IO_bindParameters(ioSystem);
     appModule->properties()->retranslate();
 
@@ -463,7 +576,13 @@ static int runApp(QCoreApplication* qtApp)
     }
 
     int exitCode = EXIT_SUCCESS;
-    if (args.listFilepathToOpen.empty()) {
+    if (!args.listErrorMessage.isEmpty()) {
+        for (const QString& msg : args.listErrorMessage)
+            qCritical().noquote() << msg;
+
+        exitCode = EXIT_FAILURE;
+    }
+    else if (args.listFilepathToOpen.empty()) {
         if (!args.listFilepathToExport.empty()) {
             qCritical() << Main::tr("No input files -> nothing to export");
             exitCode = EXIT_FAILURE;
@@ -475,11 +594,13 @@ static int runApp(QCoreApplication* qtApp)
             cliArgs.progressReport = args.progressReport;
             cliArgs.filesToOpen = args.listFilepathToOpen;
             cliArgs.filesToExport = args.listFilepathToExport;
+            cliArgs.dataReduction = args.dataReduction;
             cli_asyncExportDocuments(app, cliArgs, [=](int retcode) { qtApp->exit(retcode); });
         });
         exitCode = qtApp->exec();
     }
 
+    ioSystem->setInstrumentationSink(nullptr);
     if (args.cacheUseSettings) {
         if (!args.filepathUseSettings.empty()) {
             appModule->settings()->save();
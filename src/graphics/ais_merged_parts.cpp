@@ -0,0 +1,302 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "ais_merged_parts.h"
+
+#include <AIS_InteractiveContext.hxx>
+#include <BRep_Tool.hxx>
+#include <Graphic3d_AspectFillArea3d.hxx>
+#include <Graphic3d_Group.hxx>
+#include <NCollection_BaseAllocator.hxx>
+#include <Poly_Triangulation.hxx>
+#include <Prs3d_Root.hxx>
+#include <Prs3d_ShadingAspect.hxx>
+#include <Select3D_SensitivePrimitiveArray.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS.hxx>
+
+#include <utility>
+
+namespace Mayo {
+
+AIS_MergedParts::AIS_MergedParts(const Quantity_Color& color, const Graphic3d_MaterialAspect& material)
+{
+    myDrawer->SetShadingAspect(new Prs3d_ShadingAspect);
+    myDrawer->ShadingAspect()->SetMaterial(material);
+    myDrawer->ShadingAspect()->SetColor(color);
+    this->SetDisplayMode(0);
+    // Highlighting is done per part by HilightSelected() and HilightOwnerWithColor()
+    this->SetAutoHilight(false);
+}
+
+int AIS_MergedParts::addPart(PartId id, const TopoDS_Shape& shape)
+{
+    if (AIS_MergedParts::shapeTriangleCount(shape) < 0)
+        return -1;
+
+    Part part;
+    part.id = id;
+    part.firstIndex = m_builtIndexCount + int(m_vecNodeIndex.size());
+    for (TopExp_Explorer expl(shape, TopAbs_FACE); expl.More(); expl.Next()) {
+        const TopoDS_Face& face = TopoDS::Face(expl.Current());
+        TopLoc_Location loc;
+        const OccHandle<Poly_Triangulation>& triangulation = BRep_Tool::Triangulation(face, loc);
+        const gp_Trsf& trsf = loc.Transformation();
+        const int nodeOffset = int(m_vecNodePosition.size());
+        for (int i = 1; i <= triangulation->NbNodes(); ++i) {
+            const gp_Pnt pnt = triangulation->Node(i).Transformed(trsf);
+            m_vecNodePosition.emplace_back(float(pnt.X()), float(pnt.Y()), float(pnt.Z()));
+            m_vecNodeNormal.emplace_back(0.f, 0.f, 0.f);
+            part.bndBox.Add(pnt);
+        }
+
+        // Nodes aren't shared between faces, so normals are smoothed only inside a face
+        const bool isReversed = face.Orientation() == TopAbs_REVERSED;
+        for (int i = 1; i <= triangulation->NbTriangles(); ++i) {
+            int n1, n2, n3;
+            triangulation->Triangle(i).Get(n1, n2, n3);
+            if (isReversed)
+                std::swap(n2, n3);
+
+            const int indices[] = { nodeOffset + n1 - 1, nodeOffset + n2 - 1, nodeOffset + n3 - 1 };
+            const Graphic3d_Vec3& pnt1 = m_vecNodePosition.at(indices[0]);
+            const Graphic3d_Vec3 normal = Graphic3d_Vec3::Cross(
+                m_vecNodePosition.at(indices[1]) - pnt1, m_vecNodePosition.at(indices[2]) - pnt1
+            );
+            for (int index : indices) {
+                m_vecNodeNormal.at(index) += normal; // Weighted by triangle area
+                m_vecNodeIndex.push_back(m_builtNodeCount + index);
+            }
+        }
+
+        for (size_t i = nodeOffset; i < m_vecNodeNormal.size(); ++i) {
+            Graphic3d_Vec3& normal = m_vecNodeNormal.at(i);
+            if (normal.Modulus() > 0.f)
+                normal.Normalize();
+        }
+    }
+
+    part.indexCount = m_builtIndexCount + int(m_vecNodeIndex.size()) - part.firstIndex;
+    m_vecPart.push_back(std::move(part));
+    ++m_visiblePartCount;
+    return int(m_vecPart.size()) - 1;
+}
+
+const OccHandle<AIS_MergedParts::PartOwner>& AIS_MergedParts::partOwner(int index)
+{
+    Part& part = m_vecPart.at(index);
+    if (!part.owner)
+        part.owner = new PartOwner(this, index);
+
+    return part.owner;
+}
+
+void AIS_MergedParts::setPartVisible(int index, bool on)
+{
+    Part& part = m_vecPart.at(index);
+    if (part.isVisible != on) {
+        part.isVisible = on;
+        m_visiblePartCount += on ? 1 : -1;
+    }
+}
+
+int AIS_MergedParts::shapeTriangleCount(const TopoDS_Shape& shape)
+{
+    int count = 0;
+    for (TopExp_Explorer expl(shape, TopAbs_FACE); expl.More(); expl.Next()) {
+        TopLoc_Location loc;
+        const OccHandle<Poly_Triangulation>& triangulation = BRep_Tool::Triangulation(TopoDS::Face(expl.Current()), loc);
+        if (!triangulation)
+            return -1;
+
+        count += triangulation->NbTriangles();
+    }
+
+    return count;
+}
+
+void AIS_MergedParts::ComputeSelection(const OccHandle<SelectMgr_Selection>& sel, const int mode)
+{
+    if (mode != 0 || !this->triangles())
+        return;
+
+    // Sensitive entities of the parts refer to ranges of the same index buffer
+    for (int i = 0; i < this->partCount(); ++i) {
+        const Part& part = m_vecPart.at(i);
+        if (!part.isVisible || part.indexCount == 0)
+            continue;
+
+        auto sensitive = makeOccHandle<Select3D_SensitivePrimitiveArray>(this->partOwner(i));
+        const bool ok = sensitive->InitTriangulation(
+            m_triangles->Attributes(),
+            m_triangles->Indices(),
+            TopLoc_Location(),
+            part.firstIndex,
+            part.firstIndex + part.indexCount - 1
+        );
+        if (ok)
+            sel->Add(sensitive);
+    }
+}
+
+void AIS_MergedParts::HilightSelected(
+        const OccHandle<PrsMgr_PresentationManager>& pm, const SelectMgr_SequenceOfOwner& seqOwner
+    )
+{
+    OccHandle<Prs3d_Presentation> prs = this->GetSelectPresentation(pm);
+    if (!prs)
+        return;
+
+    prs->Clear();
+    std::vector<int> vecPartIndex;
+    for (const OccHandle<SelectMgr_EntityOwner>& owner : seqOwner) {
+        auto partOwner = OccHandle<PartOwner>::DownCast(owner);
+        if (partOwner && this->isPartVisible(partOwner->partIndex()))
+            vecPartIndex.push_back(partOwner->partIndex());
+    }
+
+    if (vecPartIndex.empty())
+        return;
+
+    const OccHandle<Prs3d_Drawer>& style =
+        myHilightDrawer ? myHilightDrawer : this->GetContext()->HighlightStyle(Prs3d_TypeOfHighlight_Selected);
+    this->addPartsGroup(prs, vecPartIndex, style);
+    prs->Display();
+}
+
+void AIS_MergedParts::HilightOwnerWithColor(
+        const OccHandle<PrsMgr_PresentationManager>& pm,
+        const OccHandle<Prs3d_Drawer>& style,
+        const OccHandle<SelectMgr_EntityOwner>& owner
+    )
+{
+    auto partOwner = OccHandle<PartOwner>::DownCast(owner);
+    OccHandle<Prs3d_Presentation> prs = this->GetHilightPresentation(pm);
+    if (!partOwner || !prs)
+        return;
+
+    prs->Clear();
+    const int partIndex = partOwner->partIndex();
+    this->addPartsGroup(prs, Span<const int>(&partIndex, 1), style);
+    if (pm->IsImmediateModeOn())
+        pm->AddToImmediateList(prs);
+    else
+        prs->Display();
+}
+
+void AIS_MergedParts::Compute(
+        const OccHandle<PrsMgr_PresentationManager>&,
+        const OccHandle<Prs3d_Presentation>& prs,
+        const int mode)
+{
+    if (mode != 0 || m_visiblePartCount == 0 || !this->triangles())
+        return;
+
+    // Index buffer of all the parts is reused as long as none is hidden
+    OccHandle<Graphic3d_IndexBuffer> indices = m_triangles->Indices();
+    if (m_visiblePartCount != this->partCount()) {
+        std::vector<int> vecPartIndex;
+        for (int i = 0; i < this->partCount(); ++i) {
+            if (m_vecPart.at(i).isVisible)
+                vecPartIndex.push_back(i);
+        }
+
+        indices = this->createIndexBuffer(vecPartIndex);
+    }
+
+#if OCC_VERSION_HEX >= 0x070400
+    OccHandle<Graphic3d_Group> group = prs->CurrentGroup();
+#else
+    OccHandle<Graphic3d_Group> group = Prs3d_Root::CurrentGroup(prs);
+#endif
+    group->SetGroupPrimitivesAspect(myDrawer->ShadingAspect()->Aspect());
+    group->AddPrimitiveArray(Graphic3d_TOPA_TRIANGLES, indices, m_triangles->Attributes(), OccHandle<Graphic3d_BoundBuffer>());
+}
+
+const OccHandle<Graphic3d_ArrayOfTriangles>& AIS_MergedParts::triangles()
+{
+    if (m_vecNodeIndex.empty())
+        return m_triangles;
+
+    // Vertices and indices of the previous array are copied, then pending data is released
+    const int nodeCount = m_builtNodeCount + int(m_vecNodePosition.size());
+    const int indexCount = m_builtIndexCount + int(m_vecNodeIndex.size());
+    auto triangles = makeOccHandle<Graphic3d_ArrayOfTriangles>(nodeCount, indexCount, Graphic3d_ArrayFlags_VertexNormal);
+    for (int i = 1; i <= m_builtNodeCount; ++i) {
+        double x, y, z, nx, ny, nz;
+        m_triangles->Vertice(i, x, y, z);
+        m_triangles->VertexNormal(i, nx, ny, nz);
+        triangles->AddVertex(x, y, z, nx, ny, nz);
+    }
+
+    for (size_t i = 0; i < m_vecNodePosition.size(); ++i) {
+        const Graphic3d_Vec3& pos = m_vecNodePosition.at(i);
+        const Graphic3d_Vec3& normal = m_vecNodeNormal.at(i);
+        triangles->AddVertex(pos.x(), pos.y(), pos.z(), normal.x(), normal.y(), normal.z());
+    }
+
+    for (int i = 0; i < m_builtIndexCount; ++i)
+        triangles->AddEdge(m_triangles->Indices()->Index(i) + 1);
+
+    for (int index : m_vecNodeIndex)
+        triangles->AddEdge(index + 1);
+
+    m_triangles = triangles;
+    m_builtNodeCount = nodeCount;
+    m_builtIndexCount = indexCount;
+    std::vector<Graphic3d_Vec3>().swap(m_vecNodePosition);
+    std::vector<Graphic3d_Vec3>().swap(m_vecNodeNormal);
+    std::vector<int>().swap(m_vecNodeIndex);
+    return m_triangles;
+}
+
+OccHandle<Graphic3d_IndexBuffer> AIS_MergedParts::createIndexBuffer(Span<const int> spanPartIndex) const
+{
+    int indexCount = 0;
+    for (int partIndex : spanPartIndex)
+        indexCount += m_vecPart.at(partIndex).indexCount;
+
+    auto indices = makeOccHandle<Graphic3d_IndexBuffer>(NCollection_BaseAllocator::CommonBaseAllocator());
+    if (indexCount == 0 || !m_triangles || !indices->Init<int>(indexCount))
+        return {};
+
+    const OccHandle<Graphic3d_IndexBuffer>& allIndices = m_triangles->Indices();
+    int pos = 0;
+    for (int partIndex : spanPartIndex) {
+        const Part& part = m_vecPart.at(partIndex);
+        for (int i = 0; i < part.indexCount; ++i)
+            indices->SetIndex(pos++, allIndices->Index(part.firstIndex + i));
+    }
+
+    return indices;
+}
+
+void AIS_MergedParts::addPartsGroup(
+        const OccHandle<Prs3d_Presentation>& prs, Span<const int> spanPartIndex, const OccHandle<Prs3d_Drawer>& style
+    )
+{
+    if (!this->triangles())
+        return;
+
+    OccHandle<Graphic3d_IndexBuffer> indices = this->createIndexBuffer(spanPartIndex);
+    if (!indices)
+        return;
+
+    // Same aspect as the parts, with the highlight color and drawn slightly in front of them
+    auto aspect = makeOccHandle<Graphic3d_AspectFillArea3d>(*myDrawer->ShadingAspect()->Aspect());
+    Graphic3d_MaterialAspect material = aspect->FrontMaterial();
+    material.SetColor(style->Color());
+    aspect->SetFrontMaterial(material);
+    aspect->SetBackMaterial(material);
+    aspect->SetInteriorColor(style->Color());
+    aspect->SetPolygonOffsets(Aspect_POM_Fill, 1.f, -1.f);
+
+    OccHandle<Graphic3d_Group> group = prs->NewGroup();
+    group->SetGroupPrimitivesAspect(aspect);
+    group->AddPrimitiveArray(Graphic3d_TOPA_TRIANGLES, indices, m_triangles->Attributes(), OccHandle<Graphic3d_BoundBuffer>());
+}
+
+} // namespace Mayo
@@ -0,0 +1,138 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "../base/occ_handle.h"
+#include "../base/span.h"
+#include "../base/tkernel_utils.h"
+
+#include <AIS_InteractiveObject.hxx>
+#include <Bnd_Box.hxx>
+#include <Graphic3d_ArrayOfTriangles.hxx>
+#include <Graphic3d_IndexBuffer.hxx>
+#include <Graphic3d_MaterialAspect.hxx>
+#include <Prs3d_Presentation.hxx>
+#include <PrsMgr_PresentationManager.hxx>
+#include <SelectMgr_EntityOwner.hxx>
+#include <SelectMgr_Selection.hxx>
+#include <SelectMgr_SequenceOfOwner.hxx>
+#include <TopoDS_Shape.hxx>
+
+#include <cstdint>
+#include <vector>
+
+#if OCC_VERSION_HEX < OCC_VERSION_CHECK(7, 5, 0)
+#  include <Prs3d_Projector.hxx>
+#endif
+
+namespace Mayo {
+
+// Displays many static parts sharing the same color and material as a single primitive array, so
+// they're drawn with one draw call instead of one per part
+//
+// Triangles of the parts are copied in the global frame when added. Parts are identified by an id
+// provided by the caller(eg tree node) and each one gets its own selection owner, so parts are still
+// picked and highlighted individually
+// Hiding some parts only rebuilds the index buffer, the vertex buffer is kept as is
+class AIS_MergedParts : public AIS_InteractiveObject {
+public:
+    using PartId = uint32_t;
+
+    // Selection owner of a single part
+    class PartOwner : public SelectMgr_EntityOwner {
+    public:
+        PartOwner(const OccHandle<SelectMgr_SelectableObject>& object, int partIndex)
+            : SelectMgr_EntityOwner(object), m_partIndex(partIndex)
+        {}
+
+        int partIndex() const { return m_partIndex; }
+
+        DEFINE_STANDARD_RTTI_INLINE(PartOwner, SelectMgr_EntityOwner)
+
+    private:
+        int m_partIndex = -1;
+    };
+
+    AIS_MergedParts(const Quantity_Color& color, const Graphic3d_MaterialAspect& material);
+
+    // Adds the triangles of the faces of 'shape', its location is applied
+    // Returns the index of the new part, or -1 if some face of 'shape' has no triangulation
+    // Presentation has to be recomputed once parts are added
+    int addPart(PartId id, const TopoDS_Shape& shape);
+
+    int partCount() const { return int(m_vecPart.size()); }
+    PartId partId(int index) const { return m_vecPart.at(index).id; }
+    int partTriangleCount(int index) const { return m_vecPart.at(index).indexCount / 3; }
+    const Bnd_Box& partBoundingBox(int index) const { return m_vecPart.at(index).bndBox; }
+    // Owner is created on first call, object must already be managed by a handle
+    const OccHandle<PartOwner>& partOwner(int index);
+
+    // Presentation has to be recomputed(eg with AIS_InteractiveContext::Redisplay()) once
+    // visibility of parts changed
+    bool isPartVisible(int index) const { return m_vecPart.at(index).isVisible; }
+    void setPartVisible(int index, bool on);
+    int visiblePartCount() const { return m_visiblePartCount; }
+
+    int triangleCount() const { return (m_builtIndexCount + int(m_vecNodeIndex.size())) / 3; }
+
+    // Count of triangles of the faces of 'shape', -1 if some face has no triangulation
+    static int shapeTriangleCount(const TopoDS_Shape& shape);
+
+    bool AcceptDisplayMode(const int mode) const override { return mode == 0; }
+    void ComputeSelection(const OccHandle<SelectMgr_Selection>& sel, const int mode) override;
+    void HilightSelected(
+            const OccHandle<PrsMgr_PresentationManager>& pm, const SelectMgr_SequenceOfOwner& seqOwner
+    ) override;
+    void HilightOwnerWithColor(
+            const OccHandle<PrsMgr_PresentationManager>& pm,
+            const OccHandle<Prs3d_Drawer>& style,
+            const OccHandle<SelectMgr_EntityOwner>& owner
+    ) override;
+
+    DEFINE_STANDARD_RTTI_INLINE(AIS_MergedParts, AIS_InteractiveObject)
+
+protected:
+    void Compute(
+            const OccHandle<PrsMgr_PresentationManager>& pm,
+            const OccHandle<Prs3d_Presentation>& prs,
+            const int mode
+    ) override;
+
+#if OCC_VERSION_HEX < OCC_VERSION_CHECK(7, 5, 0)
+    void Compute(const OccHandle<Prs3d_Projector>&, const OccHandle<Prs3d_Presentation>&) override {}
+#endif
+
+private:
+    struct Part {
+        PartId id = 0;
+        bool isVisible = true;
+        int firstIndex = 0; // Range in the index buffer of all the parts, three indices per triangle
+        int indexCount = 0;
+        Bnd_Box bndBox;
+        OccHandle<PartOwner> owner;
+    };
+
+    // Primitive array of all the parts, rebuilt on demand once parts were added
+    const OccHandle<Graphic3d_ArrayOfTriangles>& triangles();
+    // Indices are read from triangles(), which must be up to date
+    OccHandle<Graphic3d_IndexBuffer> createIndexBuffer(Span<const int> spanPartIndex) const;
+    void addPartsGroup(
+            const OccHandle<Prs3d_Presentation>& prs, Span<const int> spanPartIndex, const OccHandle<Prs3d_Drawer>& style
+    );
+
+    std::vector<Part> m_vecPart;
+    // Data of the parts added since 'm_triangles' was built, released once it's rebuilt
+    std::vector<Graphic3d_Vec3> m_vecNodePosition; // Global frame
+    std::vector<Graphic3d_Vec3> m_vecNodeNormal;
+    std::vector<int> m_vecNodeIndex; // 0-based, in the whole vertex buffer
+    int m_visiblePartCount = 0;
+    OccHandle<Graphic3d_ArrayOfTriangles> m_triangles;
+    int m_builtNodeCount = 0; // Count of vertices in 'm_triangles'
+    int m_builtIndexCount = 0;
+};
+
+} // namespace Mayo
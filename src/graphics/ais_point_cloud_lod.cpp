@@ -0,0 +1,293 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "ais_point_cloud_lod.h"
+#include "graphics_point_cloud_object_driver.h"
+
+#include "../base/cpp_utils.h"
+
+#include <Graphic3d_Group.hxx>
+#include <Prs3d_PointAspect.hxx>
+#include <Prs3d_Root.hxx>
+#include <SelectBasics_PickResult.hxx>
+#include <SelectBasics_SelectingVolumeManager.hxx>
+#include <SelectMgr_EntityOwner.hxx>
+
+#include <algorithm>
+
+namespace Mayo {
+
+namespace {
+
+NCollection_Vec3<double> toVec3(const gp_Pnt& pnt)
+{
+    return { pnt.X(), pnt.Y(), pnt.Z() };
+}
+
+bool overlapsBox(SelectBasics_SelectingVolumeManager& mgr, const Bnd_Box& box, SelectBasics_PickResult& pickResult)
+{
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+    return mgr.OverlapsBox(toVec3(box.CornerMin()), toVec3(box.CornerMax()), pickResult);
+#else
+    return mgr.Overlaps(toVec3(box.CornerMin()), toVec3(box.CornerMax()), pickResult);
+#endif
+}
+
+bool overlapsBox(SelectBasics_SelectingVolumeManager& mgr, const Bnd_Box& box, bool* ptrInside)
+{
+    Standard_Boolean inside = false;
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+    const bool overlaps = mgr.OverlapsBox(toVec3(box.CornerMin()), toVec3(box.CornerMax()), &inside);
+#else
+    const bool overlaps = mgr.Overlaps(toVec3(box.CornerMin()), toVec3(box.CornerMax()), &inside);
+#endif
+    *ptrInside = inside;
+    return overlaps;
+}
+
+bool overlapsPoint(SelectBasics_SelectingVolumeManager& mgr, const gp_Pnt& pnt, SelectBasics_PickResult& pickResult)
+{
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+    return mgr.OverlapsPoint(pnt, pickResult);
+#else
+    return mgr.Overlaps(pnt, pickResult);
+#endif
+}
+
+bool overlapsPoint(SelectBasics_SelectingVolumeManager& mgr, const gp_Pnt& pnt)
+{
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+    return mgr.OverlapsPoint(pnt);
+#else
+    return mgr.Overlaps(pnt);
+#endif
+}
+
+bool isPointSelection(const SelectBasics_SelectingVolumeManager& mgr)
+{
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+    return mgr.GetActiveSelectionType() == SelectMgr_SelectionType_Point;
+#else
+    return mgr.GetActiveSelectionType() == SelectBasics_SelectingVolumeManager::Point;
+#endif
+}
+
+} // namespace
+
+Select3D_SensitivePointCloudOctree::Select3D_SensitivePointCloudOctree(
+        const OccHandle<SelectMgr_EntityOwner>& owner,
+        const std::shared_ptr<const PointCloudOctree>& octree
+    )
+    : Select3D_SensitiveEntity(owner),
+      m_octree(octree)
+{
+}
+
+bool Select3D_SensitivePointCloudOctree::Matches(
+        SelectBasics_SelectingVolumeManager& mgr, SelectBasics_PickResult& pickResult
+    )
+{
+    if (!m_octree || m_octree->isEmpty())
+        return false;
+
+    if (!isPointSelection(mgr)) {
+        // Box/polyline selection: all points have to be inside the selecting volume, or any of them
+        // when overlap is allowed. Nodes entirely inside(or outside) decide without their points
+        const bool allRequired = !mgr.IsOverlapAllowed();
+        bool matched = allRequired;
+        bool done = false;
+        m_octree->traversePoints(
+            [&](const PointCloudOctree::Node& node) {
+                bool inside = false;
+                const bool overlaps = !done && overlapsBox(mgr, node.box, &inside);
+                if (!done && (allRequired ? !overlaps : inside)) {
+                    matched = !allRequired;
+                    done = true;
+                }
+
+                return overlaps && !inside && !done;
+            },
+            [&](uint32_t ipnt) {
+                const bool inside = overlapsPoint(mgr, m_octree->points().point(ipnt));
+                if (inside != allRequired) {
+                    matched = inside;
+                    done = true;
+                }
+
+                return !done;
+            }
+        );
+        if (matched)
+            pickResult = SelectBasics_PickResult(0., 0., this->CenterOfGeometry());
+
+        return matched;
+    }
+
+    // Point selection: nearest point along the picking ray, nodes farther than the current nearest
+    // point are skipped
+    bool matched = false;
+    m_octree->traversePoints(
+        [&](const PointCloudOctree::Node& node) {
+            SelectBasics_PickResult boxResult;
+            if (!overlapsBox(mgr, node.box, boxResult))
+                return false;
+
+            return !matched || boxResult.Depth() <= pickResult.Depth();
+        },
+        [&](uint32_t ipnt) {
+            const gp_Pnt pnt = m_octree->points().point(ipnt);
+            SelectBasics_PickResult pntResult;
+            if (overlapsPoint(mgr, pnt, pntResult) && (!matched || pntResult.Depth() < pickResult.Depth())) {
+                pickResult = pntResult;
+                pickResult.SetPickedPoint(pnt);
+                matched = true;
+            }
+
+            return true;
+        }
+    );
+    return matched;
+}
+
+int Select3D_SensitivePointCloudOctree::NbSubElements() const
+{
+    return m_octree ? int(m_octree->points().count) : 0;
+}
+
+OccHandle<Select3D_SensitiveEntity> Select3D_SensitivePointCloudOctree::GetConnected()
+{
+    return new Select3D_SensitivePointCloudOctree(this->OwnerId(), m_octree);
+}
+
+Select3D_BndBox3d Select3D_SensitivePointCloudOctree::BoundingBox()
+{
+    if (!m_octree || m_octree->isEmpty())
+        return {};
+
+    const Bnd_Box& box = m_octree->boundingBox();
+    return Select3D_BndBox3d(toVec3(box.CornerMin()), toVec3(box.CornerMax()));
+}
+
+gp_Pnt Select3D_SensitivePointCloudOctree::CenterOfGeometry() const
+{
+    if (!m_octree || m_octree->isEmpty())
+        return {};
+
+    const Bnd_Box& box = m_octree->boundingBox();
+    return (box.CornerMin().XYZ() + box.CornerMax().XYZ()) * 0.5;
+}
+
+AIS_PointCloudLod::AIS_PointCloudLod(
+        const std::shared_ptr<const PointCloud>& pointCloud,
+        const std::shared_ptr<const PointCloudOctree>& octree
+    )
+    : m_pointCloud(pointCloud)
+{
+    myDrawer->SetPointAspect(new Prs3d_PointAspect(Aspect_TOM_POINT, Quantity_NOC_YELLOW, 1.));
+    this->setOctree(octree);
+}
+
+void AIS_PointCloudLod::setOctree(const std::shared_ptr<const PointCloudOctree>& octree)
+{
+    m_octree = octree;
+    m_vecNodeSample.clear();
+    // Coarse representation of the whole point cloud until the first call to updateLod()
+    if (m_octree && !m_octree->isEmpty()) {
+        const uint32_t rootPointCount = m_octree->rootNode().pointCount();
+        const auto pointCount = uint32_t(std::min<size_t>(rootPointCount, m_lodParams.nodeSampleCount));
+        m_vecNodeSample.push_back({ 0, pointCount });
+    }
+}
+
+void AIS_PointCloudLod::setLodParameters(const PointCloudOctree::LodParameters& params)
+{
+    m_lodParams = params;
+}
+
+size_t AIS_PointCloudLod::displayedPointCount() const
+{
+    if (!m_octree)
+        return m_pointCloud ? std::min<size_t>(m_pointCloud->pointCount(), m_lodParams.nodeSampleCount) : 0;
+
+    size_t count = 0;
+    for (const PointCloudOctree::NodeSample& sample : m_vecNodeSample)
+        count += sample.pointCount;
+
+    return count;
+}
+
+bool AIS_PointCloudLod::updateLod(const Graphic3d_Camera& camera, int viewHeightPixels)
+{
+    if (!m_octree)
+        return false;
+
+    std::vector<PointCloudOctree::NodeSample> vecNodeSample = m_octree->selectLod(camera, viewHeightPixels, m_lodParams);
+    if (vecNodeSample == m_vecNodeSample)
+        return false;
+
+    m_vecNodeSample = std::move(vecNodeSample);
+    return true;
+}
+
+void AIS_PointCloudLod::Compute(
+        const OccHandle<PrsMgr_PresentationManager>&,
+        const OccHandle<Prs3d_Presentation>& prs,
+        const int mode)
+{
+    const int pointCount = CppUtils::safeStaticCast<int>(this->displayedPointCount());
+    if (mode != 0 || !m_pointCloud || pointCount == 0)
+        return;
+
+    const bool hasColors = m_pointCloud->hasColors();
+    const bool hasNormals = m_pointCloud->hasNormals();
+    auto gfxPoints = makeOccHandle<Graphic3d_ArrayOfPoints>(pointCount, hasColors, hasNormals);
+    auto fnAddPoint = [&](size_t index) {
+        const int vertexIndex = gfxPoints->AddVertex(m_pointCloud->positions()[index]);
+        if (hasColors) {
+            const PointCloud::Color& color = m_pointCloud->colors()[index];
+            gfxPoints->SetVertexColor(vertexIndex, GraphicsPointCloudObjectDriver::toVertexColor(color));
+        }
+
+        if (hasNormals) {
+            const PointCloud::Vec3f& normal = m_pointCloud->normals()[index];
+            gfxPoints->SetVertexNormal(vertexIndex, normal.x(), normal.y(), normal.z());
+        }
+    };
+
+    if (m_octree) {
+        for (const PointCloudOctree::NodeSample& sample : m_vecNodeSample) {
+            const PointCloudOctree::Node& node = m_octree->node(sample.node);
+            for (uint32_t i = 0; i < sample.pointCount; ++i)
+                fnAddPoint(m_octree->samplePointIndex(node, sample.pointCount, i));
+        }
+    }
+    else {
+        // Octree not available yet, points are picked at regular stride in the point cloud
+        const size_t cloudPointCount = m_pointCloud->pointCount();
+        for (int i = 0; i < pointCount; ++i)
+            fnAddPoint((uint64_t(i) * cloudPointCount) / pointCount);
+    }
+
+#if OCC_VERSION_HEX >= 0x070400
+    OccHandle<Graphic3d_Group> group = prs->CurrentGroup();
+#else
+    OccHandle<Graphic3d_Group> group = Prs3d_Root::CurrentGroup(prs);
+#endif
+    group->SetGroupPrimitivesAspect(myDrawer->PointAspect()->Aspect());
+    group->AddPrimitiveArray(gfxPoints);
+}
+
+void AIS_PointCloudLod::ComputeSelection(const OccHandle<SelectMgr_Selection>& sel, const int mode)
+{
+    // Whole point cloud is selected by picking any of its points
+    if (mode != 0 || !m_octree || m_octree->isEmpty())
+        return;
+
+    auto owner = makeOccHandle<SelectMgr_EntityOwner>(this);
+    sel->Add(new Select3D_SensitivePointCloudOctree(owner, m_octree));
+}
+
+} // namespace Mayo
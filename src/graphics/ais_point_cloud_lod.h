@@ -0,0 +1,104 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "../base/occ_handle.h"
+#include "../base/point_cloud.h"
+#include "../base/point_cloud_octree.h"
+#include "../base/tkernel_utils.h"
+
+#include <AIS_InteractiveObject.hxx>
+#include <Graphic3d_ArrayOfPoints.hxx>
+#include <Graphic3d_Camera.hxx>
+#include <Prs3d_Presentation.hxx>
+#include <PrsMgr_PresentationManager.hxx>
+#include <Select3D_SensitiveEntity.hxx>
+#include <SelectMgr_Selection.hxx>
+
+#include <memory>
+#include <vector>
+
+#if OCC_VERSION_HEX < OCC_VERSION_CHECK(7, 5, 0)
+#  include <Prs3d_Projector.hxx>
+#endif
+
+namespace Mayo {
+
+// Sensitive entity picking the points of a PointCloudOctree
+// Matching walks the octree: node boxes are tested against the selecting volume first, then the
+// points of the overlapped leaf nodes. For point selection the nearest point gives the pick depth
+class Select3D_SensitivePointCloudOctree : public Select3D_SensitiveEntity {
+public:
+    Select3D_SensitivePointCloudOctree(
+            const OccHandle<SelectMgr_EntityOwner>& owner,
+            const std::shared_ptr<const PointCloudOctree>& octree
+    );
+
+    bool Matches(SelectBasics_SelectingVolumeManager& mgr, SelectBasics_PickResult& pickResult) override;
+    int NbSubElements() const override;
+    OccHandle<Select3D_SensitiveEntity> GetConnected() override;
+    Select3D_BndBox3d BoundingBox() override;
+    gp_Pnt CenterOfGeometry() const override;
+
+    DEFINE_STANDARD_RTTI_INLINE(Select3D_SensitivePointCloudOctree, Select3D_SensitiveEntity)
+
+private:
+    std::shared_ptr<const PointCloudOctree> m_octree;
+};
+
+// Displays a point cloud indexed by a PointCloudOctree
+// Only the octree nodes needed for the current camera are uploaded, within a point budget. The
+// presentation gets stale when the camera changes: call updateLod() and recompute the presentation
+// if it returns true
+// The octree can be provided later(eg built by a worker thread), a coarse subsample of the points
+// is displayed until then
+class AIS_PointCloudLod : public AIS_InteractiveObject {
+public:
+    // 'pointCloud' is the source of 'octree', it also provides the colors(if any)
+    AIS_PointCloudLod(
+            const std::shared_ptr<const PointCloud>& pointCloud,
+            const std::shared_ptr<const PointCloudOctree>& octree = {}
+    );
+
+    const std::shared_ptr<const PointCloud>& pointCloud() const { return m_pointCloud; }
+
+    // Presentation and selection have to be recomputed after call to setOctree()
+    const std::shared_ptr<const PointCloudOctree>& octree() const { return m_octree; }
+    void setOctree(const std::shared_ptr<const PointCloudOctree>& octree);
+
+    const PointCloudOctree::LodParameters& lodParameters() const { return m_lodParams; }
+    void setLodParameters(const PointCloudOctree::LodParameters& params);
+
+    // Count of points currently displayed
+    size_t displayedPointCount() const;
+
+    // Selects the octree nodes to display for 'camera'
+    // Returns true if the selection changed, ie the presentation has to be recomputed
+    bool updateLod(const Graphic3d_Camera& camera, int viewHeightPixels);
+
+    void ComputeSelection(const OccHandle<SelectMgr_Selection>& sel, const int mode) override;
+
+    DEFINE_STANDARD_RTTI_INLINE(AIS_PointCloudLod, AIS_InteractiveObject)
+
+protected:
+    void Compute(
+            const OccHandle<PrsMgr_PresentationManager>& pm,
+            const OccHandle<Prs3d_Presentation>& prs,
+            const int mode) override;
+
+#if OCC_VERSION_HEX < OCC_VERSION_CHECK(7, 5, 0)
+    void Compute(const OccHandle<Prs3d_Projector>&, const OccHandle<Prs3d_Presentation>&) override {}
+#endif
+
+private:
+    std::shared_ptr<const PointCloud> m_pointCloud;
+    std::shared_ptr<const PointCloudOctree> m_octree;
+    PointCloudOctree::LodParameters m_lodParams;
+    std::vector<PointCloudOctree::NodeSample> m_vecNodeSample;
+};
+
+} // namespace Mayo
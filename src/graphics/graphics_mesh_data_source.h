@@ -25,6 +25,9 @@ class GraphicsMeshDataSource : public MeshVS_DataSource {
 public:
     GraphicsMeshDataSource(const OccHandle<Poly_Triangulation>& mesh);
 
+    // Source triangulation, node and element IDs are the indices of its nodes and triangles
+    const OccHandle<Poly_Triangulation>& triangulation() const { return m_mesh; }
+
     bool GetGeom(const int ID, const bool IsElement, TColStd_Array1OfReal& Coords, int& NbNodes, MeshVS_EntityType& Type) const override;
     bool GetGeomType(const int ID, const bool IsElement, MeshVS_EntityType& Type) const override;
     Standard_Address GetAddr(const int /*ID*/, const bool /*IsElement*/) const override { return nullptr; }
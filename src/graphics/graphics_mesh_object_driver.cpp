@@ -39,11 +39,12 @@ GraphicsMeshObjectDriver::GraphicsMeshObjectDriver()
         { MeshVS_DMF_Shrink, GraphicsMeshObjectDriverI18N::textId("Mesh_Shrink") } // MeshVS_DA_ShrinkCoeff
     });
     this->setDefaultDisplayMode(MeshVS_DMF_Shading);
+    this->setSupportStatusFromFlags(true);
 }
 
-GraphicsMeshObjectDriver::Support GraphicsMeshObjectDriver::supportStatus(const TDF_Label& label) const
+GraphicsMeshObjectDriver::Support GraphicsMeshObjectDriver::supportStatus(LabelDataFlags flags) const
 {
-    return meshSupportStatus(label);
+    return meshSupportStatus(flags);
 }
 
 GraphicsObjectPtr GraphicsMeshObjectDriver::createObject(const TDF_Label& label) const
@@ -213,7 +214,11 @@ GraphicsMeshObjectDriver::properties(Span<const GraphicsObjectPtr> spanObject) c
 
 GraphicsMeshObjectDriver::Support GraphicsMeshObjectDriver::meshSupportStatus(const TDF_Label& label)
 {
-    const LabelDataFlags flags = findLabelDataFlags(label);
+    return meshSupportStatus(findLabelDataFlags(label));
+}
+
+GraphicsMeshObjectDriver::Support GraphicsMeshObjectDriver::meshSupportStatus(LabelDataFlags flags)
+{
     if (flags & LabelData_ShapeIsFace) {
         if (flags & LabelData_HasTriangulationAnnexData)
             return GraphicsMeshObjectDriver::Support::Complete;
@@ -19,13 +19,15 @@ class GraphicsMeshObjectDriver : public GraphicsObjectDriver {
 public:
     GraphicsMeshObjectDriver();
 
-    Support supportStatus(const TDF_Label& label) const override;
+    using GraphicsObjectDriver::supportStatus;
+    Support supportStatus(LabelDataFlags flags) const override;
     GraphicsObjectPtr createObject(const TDF_Label& label) const override;
     void applyDisplayMode(GraphicsObjectPtr object, Enumeration::Value mode) const override;
     Enumeration::Value currentDisplayMode(const GraphicsObjectPtr& object) const override;
     std::unique_ptr<PropertyGroupSignals> properties(Span<const GraphicsObjectPtr> spanObject) const override;
 
     static Support meshSupportStatus(const TDF_Label& label);
+    static Support meshSupportStatus(LabelDataFlags flags);
 
     struct DefaultValues {
         bool showEdges = false;
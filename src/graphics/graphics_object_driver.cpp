@@ -10,6 +10,16 @@ namespace Mayo {
 
 namespace { struct GraphicsObjectDriverI18N { MAYO_DECLARE_TEXT_ID_FUNCTIONS(Mayo::GraphicsObjectDriver) }; }
 
+GraphicsObjectDriver::Support GraphicsObjectDriver::supportStatus(const TDF_Label& label) const
+{
+    return this->supportStatus(findLabelDataFlags(label));
+}
+
+GraphicsObjectDriver::Support GraphicsObjectDriver::supportStatus(LabelDataFlags) const
+{
+    return Support::None;
+}
+
 GraphicsObjectDriverPtr GraphicsObjectDriver::get(const GraphicsObjectPtr& object)
 {
     if (object)
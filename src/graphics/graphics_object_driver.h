@@ -28,8 +28,19 @@ class GraphicsObjectDriver : public Standard_Transient {
 public:
     enum class Support { None, Partial, Complete };
 
-    virtual Support supportStatus(const TDF_Label& label) const = 0;
+    // Default implementation evaluates the data flags of 'label'(see findLabelDataFlags())
+    virtual Support supportStatus(const TDF_Label& label) const;
+    // Default implementation returns Support::None
+    // Drivers overriding it should call setSupportStatusFromFlags(true), then the driver is
+    // selected once per combination of flags instead of once per label
+    virtual Support supportStatus(LabelDataFlags flags) const;
+    // Whether support status depends only on the data flags of the label
+    bool isSupportStatusFromFlags() const { return m_isSupportStatusFromFlags; }
+
     virtual GraphicsObjectPtr createObject(const TDF_Label& label) const = 0;
+    // Whether createObject() can be called concurrently for different labels
+    // False by default: creation of most AIS objects isn't thread-safe
+    bool isConcurrentCreationSupported() const { return m_isConcurrentCreationSupported; }
 
     Enumeration::Value defaultDisplayMode() const { return m_defaultDisplayMode; }
     const Enumeration& displayModes() const { return m_enumDisplayModes; }
@@ -46,6 +57,8 @@ public:
 protected:
     void setDisplayModes(Enumeration enumeration) { m_enumDisplayModes = std::move(enumeration); }
     void setDefaultDisplayMode(Enumeration::Value mode) { m_defaultDisplayMode = mode; }
+    void setSupportStatusFromFlags(bool on) { m_isSupportStatusFromFlags = on; }
+    void setConcurrentCreationSupported(bool on) { m_isConcurrentCreationSupported = on; }
     void throwIf_invalidDisplayMode(Enumeration::Value mode) const;
     void throwIf_differentDriver(const GraphicsObjectPtr& object) const;
     void throwIf_differentDriver(Span<const GraphicsObjectPtr> objects) const;
@@ -53,6 +66,8 @@ protected:
 private:
     Enumeration m_enumDisplayModes;
     Enumeration::Value m_defaultDisplayMode = -1;
+    bool m_isSupportStatusFromFlags = false;
+    bool m_isConcurrentCreationSupported = false;
 };
 
 } // namespace Mayo
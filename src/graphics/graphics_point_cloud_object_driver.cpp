@@ -5,30 +5,53 @@
 ****************************************************************************/
 
 #include "graphics_point_cloud_object_driver.h"
+#include "ais_point_cloud_lod.h"
 
 #include "../base/caf_utils.h"
+#include "../base/cpp_utils.h"
 #include "../base/label_data.h"
 #include "../base/point_cloud_data.h"
+#include "../base/tkernel_utils.h"
 
 #include <AIS_PointCloud.hxx>
+#include <gp_Trsf.hxx>
+#include <gp_Vec.hxx>
+#include <array>
 
 namespace Mayo {
 
 GraphicsPointCloudObjectDriver::GraphicsPointCloudObjectDriver()
 {
+    this->setSupportStatusFromFlags(true);
 }
 
-GraphicsPointCloudObjectDriver::Support GraphicsPointCloudObjectDriver::supportStatus(const TDF_Label& label) const
+GraphicsPointCloudObjectDriver::Support GraphicsPointCloudObjectDriver::supportStatus(LabelDataFlags flags) const
 {
-    return pointCloudSupportStatus(label);
+    return pointCloudSupportStatus(flags);
 }
 
 GraphicsObjectPtr GraphicsPointCloudObjectDriver::createObject(const TDF_Label& label) const
 {
     if (findLabelDataFlags(label) & LabelData_HasPointCloudData) {
         auto attrPointCloudData = CafUtils::findAttribute<PointCloudData>(label);
+        const std::shared_ptr<const PointCloud>& pointCloud = attrPointCloudData->pointCloud();
+        if (!pointCloud)
+            return {};
+
+        // Render arrays hold positions relative to the origin of the point cloud
+        gp_Trsf trsfOrigin;
+        trsfOrigin.SetTranslation(gp_Vec(pointCloud->origin()));
+        if (pointCloud->pointCount() >= size_t(GraphicsPointCloudObjectDriver::lodPointCountThreshold())) {
+            // Octree isn't built here if not available yet, it's a long operation(see GuiDocument)
+            auto object = new AIS_PointCloudLod(pointCloud, attrPointCloudData->builtOctree());
+            object->SetLocalTransformation(trsfOrigin);
+            object->SetOwner(this);
+            return object;
+        }
+
         auto object = new AIS_PointCloud;
-        object->SetPoints(attrPointCloudData->points());
+        object->SetPoints(GraphicsPointCloudObjectDriver::createPointArray(*pointCloud));
+        object->SetLocalTransformation(trsfOrigin);
         object->SetOwner(this);
         return object;
     }
@@ -36,6 +59,46 @@ GraphicsObjectPtr GraphicsPointCloudObjectDriver::createObject(const TDF_Label&
     return {};
 }
 
+OccHandle<Graphic3d_ArrayOfPoints> GraphicsPointCloudObjectDriver::createPointArray(const PointCloud& pointCloud)
+{
+    const int pointCount = CppUtils::safeStaticCast<int>(pointCloud.pointCount());
+    const bool hasColors = pointCloud.hasColors();
+    const bool hasNormals = pointCloud.hasNormals();
+    auto gfxPoints = makeOccHandle<Graphic3d_ArrayOfPoints>(pointCount, hasColors, hasNormals);
+    const std::vector<PointCloud::Vec3f>& positions = pointCloud.positions();
+    for (int i = 0; i < pointCount; ++i) {
+        const int vertexIndex = gfxPoints->AddVertex(positions[i]);
+        if (hasColors)
+            gfxPoints->SetVertexColor(vertexIndex, GraphicsPointCloudObjectDriver::toVertexColor(pointCloud.colors()[i]));
+
+        if (hasNormals) {
+            const PointCloud::Vec3f& normal = pointCloud.normals()[i];
+            gfxPoints->SetVertexNormal(vertexIndex, normal.x(), normal.y(), normal.z());
+        }
+    }
+
+    return gfxPoints;
+}
+
+Graphic3d_Vec4ub GraphicsPointCloudObjectDriver::toVertexColor(const PointCloud::Color& color)
+{
+    // Same conversion as Graphic3d_ArrayOfPrimitives::SetVertexColor(Quantity_Color), done once
+    // per component value
+    static const std::array<uint8_t, 256> arrayComponent = []{
+        std::array<uint8_t, 256> array;
+        for (int i = 0; i < 256; ++i) {
+            const Quantity_Color c(i / 255., 0., 0., TKernelUtils::preferredRgbColorType());
+            array[i] = uint8_t(c.Red() * 255.);
+        }
+
+        return array;
+    }();
+
+    return {
+        arrayComponent[color.red], arrayComponent[color.green], arrayComponent[color.blue], uint8_t(255)
+    };
+}
+
 void GraphicsPointCloudObjectDriver::applyDisplayMode(GraphicsObjectPtr object, Enumeration::Value /*mode*/) const
 {
     this->throwIf_differentDriver(object);
@@ -58,7 +121,11 @@ GraphicsPointCloudObjectDriver::properties(Span<const GraphicsObjectPtr> spanObj
 
 GraphicsPointCloudObjectDriver::Support GraphicsPointCloudObjectDriver::pointCloudSupportStatus(const TDF_Label& label)
 {
-    const LabelDataFlags flags = findLabelDataFlags(label);
+    return pointCloudSupportStatus(findLabelDataFlags(label));
+}
+
+GraphicsPointCloudObjectDriver::Support GraphicsPointCloudObjectDriver::pointCloudSupportStatus(LabelDataFlags flags)
+{
     if (flags & LabelData_HasPointCloudData)
         return GraphicsObjectDriver::Support::Complete;
     else
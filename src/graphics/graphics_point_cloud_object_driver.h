@@ -8,6 +8,10 @@
 
 #include "graphics_object_driver.h"
 
+#include "../base/point_cloud.h"
+
+#include <Graphic3d_ArrayOfPoints.hxx>
+
 namespace Mayo {
 
 // Pre-declarations
@@ -20,13 +24,24 @@ class GraphicsPointCloudObjectDriver : public GraphicsObjectDriver {
 public:
     GraphicsPointCloudObjectDriver();
 
-    Support supportStatus(const TDF_Label& label) const override;
+    using GraphicsObjectDriver::supportStatus;
+    Support supportStatus(LabelDataFlags flags) const override;
     GraphicsObjectPtr createObject(const TDF_Label& label) const override;
     void applyDisplayMode(GraphicsObjectPtr object, Enumeration::Value mode) const override;
     Enumeration::Value currentDisplayMode(const GraphicsObjectPtr& object) const override;
     std::unique_ptr<PropertyGroupSignals> properties(Span<const GraphicsObjectPtr> spanObject) const override;
 
     static Support pointCloudSupportStatus(const TDF_Label& label);
+    static Support pointCloudSupportStatus(LabelDataFlags flags);
+
+    // Point clouds having at least this count of points are displayed with AIS_PointCloudLod
+    static int lodPointCountThreshold() { return 2'000'000; }
+
+    // Creates the render array(positions, colors and normals) of 'pointCloud'
+    static OccHandle<Graphic3d_ArrayOfPoints> createPointArray(const PointCloud& pointCloud);
+
+    // Converts a color stored in PointCloud(sRGB bytes) to a vertex color of render arrays
+    static Graphic3d_Vec4ub toVertexColor(const PointCloud::Color& color);
 
     DEFINE_STANDARD_RTTI_INLINE(GraphicsPointCloudObjectDriver, GraphicsObjectDriver)
 };
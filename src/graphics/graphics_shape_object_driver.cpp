@@ -20,6 +20,7 @@
 #include <V3d_View.hxx>
 #include <V3d_Viewer.hxx>
 #include <XCAFPrs_AISObject.hxx>
+#include <XCAFPrs_Style.hxx>
 
 namespace Mayo {
 
@@ -36,11 +37,12 @@ GraphicsShapeObjectDriver::GraphicsShapeObjectDriver()
         { DisplayMode_ShadedWithFaceBoundary, GraphicsShapeObjectDriverI18N::textId("Shape_ShadedWithFaceBoundary") }
     });
     this->setDefaultDisplayMode(DisplayMode_ShadedWithFaceBoundary);
+    this->setSupportStatusFromFlags(true);
 }
 
-GraphicsObjectDriver::Support GraphicsShapeObjectDriver::supportStatus(const TDF_Label& label) const
+GraphicsObjectDriver::Support GraphicsShapeObjectDriver::supportStatus(LabelDataFlags flags) const
 {
-    return shapeSupportStatus(label);
+    return shapeSupportStatus(flags);
 }
 
 GraphicsObjectPtr GraphicsShapeObjectDriver::createObject(const TDF_Label& label) const
@@ -48,7 +50,7 @@ GraphicsObjectPtr GraphicsShapeObjectDriver::createObject(const TDF_Label& label
     if (XCaf::isShape(label)) {
         auto object = new XCAFPrs_AISObject(label);
         object->SetDisplayMode(AIS_Shaded);
-        object->SetMaterial(Graphic3d_NOM_PLASTER);
+        object->SetMaterial(GraphicsShapeObjectDriver::defaultMaterial());
         object->Attributes()->SetFaceBoundaryDraw(true);
         object->Attributes()->SetFaceBoundaryAspect(
             new Prs3d_LineAspect(Quantity_NOC_BLACK, Aspect_TOL_SOLID, 1.)
@@ -134,9 +136,29 @@ GraphicsShapeObjectDriver::properties(Span<const GraphicsObjectPtr> spanObject)
     return {};
 }
 
+const Quantity_Color& GraphicsShapeObjectDriver::defaultColor()
+{
+    // XCAFPrs_AISObject::DefaultStyle() is protected
+    struct ShapeObject : public XCAFPrs_AISObject {
+        ShapeObject() : XCAFPrs_AISObject(TDF_Label()) {}
+        Quantity_Color defaultSurfaceColor() const {
+            XCAFPrs_Style style;
+            this->DefaultStyle(style);
+            return style.GetColorSurf();
+        }
+    };
+
+    static const Quantity_Color color = makeOccHandle<ShapeObject>()->defaultSurfaceColor();
+    return color;
+}
+
 GraphicsObjectDriver::Support GraphicsShapeObjectDriver::shapeSupportStatus(const TDF_Label& label)
 {
-    const LabelDataFlags flags = findLabelDataFlags(label);
+    return shapeSupportStatus(findLabelDataFlags(label));
+}
+
+GraphicsObjectDriver::Support GraphicsShapeObjectDriver::shapeSupportStatus(LabelDataFlags flags)
+{
     if (flags & LabelData_ShapeIsFace) {
         if (flags & LabelData_ShapeIsGeometricFace)
             return GraphicsObjectDriver::Support::Complete;
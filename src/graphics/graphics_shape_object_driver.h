@@ -8,6 +8,9 @@
 
 #include "graphics_object_driver.h"
 
+#include <Graphic3d_NameOfMaterial.hxx>
+#include <Quantity_Color.hxx>
+
 namespace Mayo {
 
 class GraphicsShapeObjectDriver;
@@ -19,13 +22,19 @@ class GraphicsShapeObjectDriver : public GraphicsObjectDriver {
 public:
     GraphicsShapeObjectDriver();
 
-    Support supportStatus(const TDF_Label& label) const override;
+    using GraphicsObjectDriver::supportStatus;
+    Support supportStatus(LabelDataFlags flags) const override;
     GraphicsObjectPtr createObject(const TDF_Label& label) const override;
     void applyDisplayMode(GraphicsObjectPtr object, Enumeration::Value mode) const override;
     Enumeration::Value currentDisplayMode(const GraphicsObjectPtr& object) const override;
     std::unique_ptr<PropertyGroupSignals> properties(Span<const GraphicsObjectPtr> spanObject) const override;
 
     static Support shapeSupportStatus(const TDF_Label& label);
+    static Support shapeSupportStatus(LabelDataFlags flags);
+
+    // Material and surface color of the graphics objects created for shapes without color
+    static Graphic3d_NameOfMaterial defaultMaterial() { return Graphic3d_NOM_PLASTER; }
+    static const Quantity_Color& defaultColor();
 
     enum DisplayMode {
         DisplayMode_Wireframe,
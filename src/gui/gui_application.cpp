@@ -11,6 +11,8 @@
 #include "../base/document.h"
 #include "gui_document.h"
 
+#include <mutex>
+#include <unordered_map>
 #include <unordered_set>
 
 namespace Mayo {
@@ -42,6 +44,11 @@ struct GuiApplication::Private {
     ApplicationPtr m_app;
     std::vector<GuiDocument*> m_vecGuiDocument;
     std::vector<GraphicsObjectDriverPtr> m_vecGfxObjectDriver;
+    // Driver dispatch table, used when the support status of all drivers depends only on label
+    // data flags. Drivers are then selected once per combination of flags
+    bool m_isGfxObjectDriverFromFlags = true;
+    std::unordered_map<LabelDataFlags, GraphicsObjectDriverPtr> m_mapFlagsGfxObjectDriver;
+    std::mutex m_mutexMapFlagsGfxObjectDriver;
     SignalConnectionHandle m_connApplicationItemSelectionChanged;
     ApplicationItemSelectionModel m_selectionModel;
     bool m_automaticDocumentMapping = true;
@@ -99,11 +106,14 @@ ApplicationItemSelectionModel* GuiApplication::selectionModel() const
 void GuiApplication::addGraphicsObjectDriver(GraphicsObjectDriverPtr ptr)
 {
     d->m_vecGfxObjectDriver.push_back(ptr);
+    d->m_isGfxObjectDriverFromFlags = d->m_isGfxObjectDriverFromFlags && ptr->isSupportStatusFromFlags();
+    std::lock_guard<std::mutex> lock(d->m_mutexMapFlagsGfxObjectDriver);
+    d->m_mapFlagsGfxObjectDriver.clear();
 }
 
 void GuiApplication::addGraphicsObjectDriver(std::unique_ptr<GraphicsObjectDriver> ptr)
 {
-    d->m_vecGfxObjectDriver.push_back(ptr.release()); // Will be converted to opencascade::handle<>
+    this->addGraphicsObjectDriver(GraphicsObjectDriverPtr(ptr.release()));
 }
 
 Span<const GraphicsObjectDriverPtr> GuiApplication::graphicsObjectDrivers() const
@@ -111,22 +121,51 @@ Span<const GraphicsObjectDriverPtr> GuiApplication::graphicsObjectDrivers() cons
     return d->m_vecGfxObjectDriver;
 }
 
-GraphicsObjectPtr GuiApplication::createGraphicsObject(const TDF_Label& label) const
+GraphicsObjectDriverPtr GuiApplication::findGraphicsObjectDriver(const TDF_Label& label, LabelDataFlags flags) const
 {
-    GraphicsObjectDriver* driverPartialSupport = nullptr;
-    for (const GraphicsObjectDriverPtr& driver : d->m_vecGfxObjectDriver) {
-        const GraphicsObjectDriver::Support support = driver->supportStatus(label);
-        if (support == GraphicsObjectDriver::Support::Complete)
-            return driver->createObject(label);
+    // First driver with complete support, otherwise last one with partial support
+    auto fnFindDriver = [=](auto fnSupportStatus) {
+        GraphicsObjectDriverPtr driverPartialSupport;
+        for (const GraphicsObjectDriverPtr& driver : d->m_vecGfxObjectDriver) {
+            const GraphicsObjectDriver::Support support = fnSupportStatus(driver);
+            if (support == GraphicsObjectDriver::Support::Complete)
+                return driver;
+
+            if (support == GraphicsObjectDriver::Support::Partial)
+                driverPartialSupport = driver;
+        }
+
+        return driverPartialSupport;
+    };
 
-        if (support == GraphicsObjectDriver::Support::Partial)
-            driverPartialSupport = driver.get();
+    if (!d->m_isGfxObjectDriverFromFlags) {
+        return fnFindDriver([&](const GraphicsObjectDriverPtr& driver) {
+            return driver->isSupportStatusFromFlags() ? driver->supportStatus(flags) : driver->supportStatus(label);
+        });
     }
 
-    if (driverPartialSupport)
-        return driverPartialSupport->createObject(label);
-    else
-        return {};
+    std::lock_guard<std::mutex> lock(d->m_mutexMapFlagsGfxObjectDriver);
+    auto it = d->m_mapFlagsGfxObjectDriver.find(flags);
+    if (it != d->m_mapFlagsGfxObjectDriver.cend())
+        return it->second;
+
+    GraphicsObjectDriverPtr driverFound = fnFindDriver([=](const GraphicsObjectDriverPtr& driver) {
+        return driver->supportStatus(flags);
+    });
+    d->m_mapFlagsGfxObjectDriver.insert({ flags, driverFound });
+    return driverFound;
+}
+
+GraphicsObjectPtr GuiApplication::createGraphicsObject(const TDF_Label& label) const
+{
+    DocumentPtr doc = Document::findFrom(label);
+    return this->createGraphicsObject(label, doc ? doc->labelDataFlags(label) : findLabelDataFlags(label));
+}
+
+GraphicsObjectPtr GuiApplication::createGraphicsObject(const TDF_Label& label, LabelDataFlags flags) const
+{
+    GraphicsObjectDriverPtr driver = this->findGraphicsObjectDriver(label, flags);
+    return driver ? driver->createObject(label) : GraphicsObjectPtr();
 }
 
 bool GuiApplication::automaticDocumentMapping() const
@@ -51,7 +51,13 @@ public:
     void addGraphicsObjectDriver(GraphicsObjectDriverPtr ptr);
     void addGraphicsObjectDriver(std::unique_ptr<GraphicsObjectDriver> ptr);
     Span<const GraphicsObjectDriverPtr> graphicsObjectDrivers() const;
+    // Driver with complete support of 'label' having data 'flags', otherwise the last one with
+    // partial support. Selection is cached per flags when possible(see GraphicsObjectDriver::isSupportStatusFromFlags())
+    // Safe to call concurrently
+    GraphicsObjectDriverPtr findGraphicsObjectDriver(const TDF_Label& label, LabelDataFlags flags) const;
+    // Safe to call concurrently only if the driver found supports it(see GraphicsObjectDriver::isConcurrentCreationSupported())
     GraphicsObjectPtr createGraphicsObject(const TDF_Label& label) const;
+    GraphicsObjectPtr createGraphicsObject(const TDF_Label& label, LabelDataFlags flags) const;
 
     // Whether a GuiDocument object is automatically created once a Document is added in Application
     bool automaticDocumentMapping() const;
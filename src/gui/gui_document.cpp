@@ -9,11 +9,19 @@
 #include "../base/application.h"
 #include "../base/application_item.h"
 #include "../base/bnd_utils.h"
+#include "../base/brep_deferred_mesh.h"
+#include "../base/brep_mesh_lod.h"
 #include "../base/caf_utils.h"
 #include "../base/cpp_utils.h"
 #include "../base/document.h"
 #include "../base/math_utils.h"
+#include "../base/point_cloud_data.h"
+#include "../base/task_manager.h"
+#include "../base/task_progress.h"
+#include "../base/text_id.h"
 #include "../base/tkernel_utils.h"
+#include "../graphics/ais_point_cloud_lod.h"
+#include "../graphics/graphics_shape_object_driver.h"
 #include "../graphics/graphics_utils.h"
 #include "../gui/gui_application.h"
 
@@ -22,16 +30,79 @@
 #endif
 #include <AIS_ConnectedInteractive.hxx>
 #include <AIS_Trihedron.hxx>
+#include <BRep_Tool.hxx>
 #include <Geom_Axis2Placement.hxx>
 #include <Graphic3d_GraphicDriver.hxx>
+#include <OSD_Parallel.hxx>
+#include <TColStd_HArray1OfReal.hxx>
+#include <TDataStd_NamedData.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS.hxx>
 #include <V3d_TypeOfOrientation.hxx>
 
+#include <fmt/format.h>
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <limits>
+#include <mutex>
 
 namespace Mayo {
 
+struct GuiDocumentI18N { MAYO_DECLARE_TEXT_ID_FUNCTIONS(Mayo::GuiDocumentI18N) };
+
 namespace Internal {
 
+// Returns the distance between point 'pnt' and box 'bndBox'(zero if point is inside)
+static double distance(const Bnd_Box& bndBox, const gp_Pnt& pnt)
+{
+    const BndBoxCoords coords = BndBoxCoords::get(bndBox);
+    const double dx = std::max({ coords.xmin - pnt.X(), 0., pnt.X() - coords.xmax });
+    const double dy = std::max({ coords.ymin - pnt.Y(), 0., pnt.Y() - coords.ymax });
+    const double dz = std::max({ coords.zmin - pnt.Z(), 0., pnt.Z() - coords.zmax });
+    return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+// Whether 'shape' has at least one face without triangulation(ie meshing is required to display it)
+static bool hasFaceWithoutTriangulation(const TopoDS_Shape& shape)
+{
+    for (TopExp_Explorer expl(shape, TopAbs_FACE); expl.More(); expl.Next()) {
+        TopLoc_Location loc;
+        if (!BRep_Tool::Triangulation(TopoDS::Face(expl.Current()), loc))
+            return true;
+    }
+
+    return false;
+}
+
+// Whether some sub-shape of shape 'label' has its own color(eg colored faces)
+static bool hasSubShapeColor(const XCaf& xcaf, const TDF_Label& label)
+{
+    for (const TDF_Label& subLabel : XCaf::shapeSubs(label)) {
+        if (xcaf.hasShapeColor(subLabel))
+            return true;
+    }
+
+    return false;
+}
+
+// Count of leaf nodes mapped between two checks of the time budget, products of a batch are
+// created concurrently
+static constexpr size_t leafNodeMappingBatchSize = 64;
+
+// Vertex buffer of a merged batch is rebuilt at each display, so a batch still accepting parts is
+// displayed at most once per interval while the mapping is in progress
+static constexpr std::chrono::milliseconds openMergedBatchUpdateInterval(1000);
+
+// Keys of the view state items stored in the TDataStd_NamedData attribute of document root label
+static const char viewStateKeyCamera[] = "Mayo.ViewState.Camera";
+static const char viewStateKeyCameraProjection[] = "Mayo.ViewState.CameraProjection";
+
+static TCollection_ExtendedString viewStateKeyDisplayMode(const GraphicsObjectDriverPtr& driver)
+{
+    return TCollection_ExtendedString("Mayo.ViewState.DisplayMode.") + driver->DynamicType()->Name();
+}
+
 static OccHandle<AIS_Trihedron> createOriginTrihedron()
 {
     auto axis = makeOccHandle<Geom_Axis2Placement>(gp::XOY());
@@ -67,12 +138,36 @@ static GuiDocument::GradientBackground& defaultGradientBackground()
 
 } // namespace Internal
 
+// Shared between GuiDocument and its background meshing tasks, so tasks never access a GuiDocument
+// object that could have been destroyed meanwhile
+struct GuiDocument::MeshTaskQueue {
+    struct Result {
+        TDF_Label product;
+        bool meshed = false; // False if meshing was cancelled
+        std::shared_ptr<BRepMeshLod::Level> ptrFineLevel; // Non-null for a finer level of detail
+        // Non-null for the octree of a point cloud displayed with level of detail
+        OccHandle<AIS_PointCloudLod> pntCloudLod;
+        std::shared_ptr<const PointCloudOctree> pntCloudOctree;
+    };
+
+    std::mutex mutex;
+    std::vector<Result> vecResult;
+    std::atomic<bool> isCancelRequested = false;
+    std::atomic<int> runningTaskCount = 0;
+
+    void push(Result&& result) {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->vecResult.push_back(std::move(result));
+    }
+};
+
 GuiDocument::GuiDocument(const DocumentPtr& doc, GuiApplication* guiApp)
     : m_guiApp(guiApp),
       m_document(doc),
       m_v3dView(m_gfxScene.createV3dView()),
       m_aisOriginTrihedron(Internal::createOriginTrihedron()),
-      m_cameraAnimation(new V3dViewCameraAnimation)
+      m_cameraAnimation(new V3dViewCameraAnimation),
+      m_meshTaskQueue(std::make_shared<MeshTaskQueue>())
 {
     Expects(!doc.IsNull());
 
@@ -136,14 +231,26 @@ Bnd_Box GuiDocument::graphicsBoundingBox(GraphicsBoundingBoxFlags flags) const
     }
 
     // If no application items selected(and visible), then take the whole document
-    if (appItems.empty())
+    const bool isWholeDocument = appItems.empty();
+    if (isWholeDocument) {
+        if ((flags & OnlyVisibleGraphics) && m_isGfxVisibleBoundingBoxValid)
+            return m_gfxVisibleBoundingBox;
+
         appItems = { ApplicationItem{this->document()} };
+    }
 
     // Helper function to extend main bounding box with each visible graphics object inside tree node
     auto fnAddTreeNodeBndBox = [&](TreeNodeId nodeId) {
         if (fnIsVisibleTreeNode(nodeId)) {
             this->foreachGraphicsObject(nodeId, [&](GraphicsObjectPtr gfxObject) {
-                BndUtils::add(&bndBox, GraphicsUtils::AisObject_boundingBox(gfxObject));
+                auto itBndBox = m_mapGfxObjectBndBox.find(gfxObject);
+                if (itBndBox != m_mapGfxObjectBndBox.cend())
+                    BndUtils::add(&bndBox, itBndBox->second);
+                else
+                    BndUtils::add(&bndBox, GraphicsUtils::AisObject_boundingBox(gfxObject));
+            });
+            this->foreachMergedPart(nodeId, [&](const OccHandle<AIS_MergedParts>& batch, int partIndex) {
+                BndUtils::add(&bndBox, batch->partBoundingBox(partIndex));
             });
         }
     };
@@ -157,6 +264,11 @@ Bnd_Box GuiDocument::graphicsBoundingBox(GraphicsBoundingBoxFlags flags) const
             traverseTree(item.documentTreeNode().id(), modelTree, fnAddTreeNodeBndBox);
     }
 
+    if (isWholeDocument && (flags & OnlyVisibleGraphics)) {
+        m_gfxVisibleBoundingBox = bndBox;
+        m_isGfxVisibleBoundingBoxValid = true;
+    }
+
     return bndBox;
 }
 
@@ -199,6 +311,10 @@ void GuiDocument::setDevicePixelRatio(double ratio)
 
 GuiDocument::~GuiDocument()
 {
+    m_meshTaskQueue->isCancelRequested = true;
+    for (const GraphicsEntity& gfxEntity : m_vecGraphicsEntity)
+        this->unpinDeferredMeshData(gfxEntity);
+
     delete m_cameraAnimation;
 }
 
@@ -225,13 +341,22 @@ TreeNodeId GuiDocument::nodeFromGraphicsObject(const GraphicsObjectPtr& gfxObjec
     if (!gfxObject)
         return 0;
 
-    for (const GraphicsEntity& gfxEntity: m_vecGraphicsEntity) {
-        auto it = gfxEntity.mapGfxObjectTreeNode.find(gfxObject);
-        if (it != gfxEntity.mapGfxObjectTreeNode.cend())
-            return it->second;
+    auto it = m_mapGfxObjectTreeNode.find(gfxObject);
+    return it != m_mapGfxObjectTreeNode.cend() ? it->second : 0;
+}
+
+TreeNodeId GuiDocument::nodeFromGraphicsOwner(const GraphicsOwnerPtr& gfxOwner) const
+{
+    auto partOwner = OccHandle<AIS_MergedParts::PartOwner>::DownCast(gfxOwner);
+    if (partOwner) {
+        auto batch = OccHandle<AIS_MergedParts>::DownCast(partOwner->Selectable());
+        return batch ? batch->partId(partOwner->partIndex()) : 0;
     }
 
-    return 0;
+    auto gfxObject = GraphicsObjectPtr::DownCast(
+        gfxOwner ? gfxOwner->Selectable() : OccHandle<SelectMgr_SelectableObject>()
+    );
+    return this->nodeFromGraphicsObject(gfxObject);
 }
 
 void GuiDocument::toggleItemSelected(const ApplicationItem& appItem)
@@ -252,6 +377,10 @@ void GuiDocument::toggleItemSelected(const ApplicationItem& appItem)
             if (gfxObject)
                 m_gfxScene.toggleOwnerSelection(gfxObject->GlobalSelOwner());
         });
+        this->foreachMergedPart(docTreeNode.id(), [=](const OccHandle<AIS_MergedParts>& batch, int partIndex) {
+            if (batch->isPartVisible(partIndex))
+                m_gfxScene.toggleOwnerSelection(batch->partOwner(partIndex));
+        });
     }
 }
 
@@ -284,6 +413,69 @@ void GuiDocument::setActiveDisplayMode(const GraphicsObjectDriverPtr& driver, in
     }
 }
 
+void GuiDocument::storeViewState()
+{
+    OccHandle<TDataStd_NamedData> namedData = TDataStd_NamedData::Set(m_document->rootLabel());
+    for (const auto& [driver, mode] : m_mapGfxDriverDisplayMode)
+        namedData->SetInteger(Internal::viewStateKeyDisplayMode(driver), mode);
+
+    // Camera is stored as [eye(xyz), center(xyz), up(xyz), scale]
+    const OccHandle<Graphic3d_Camera>& camera = m_v3dView->Camera();
+    auto arrayCamera = makeOccHandle<TColStd_HArray1OfReal>(1, 10);
+    int index = 1;
+    for (const gp_XYZ& coords : { camera->Eye().XYZ(), camera->Center().XYZ(), camera->Up().XYZ() }) {
+        arrayCamera->SetValue(index++, coords.X());
+        arrayCamera->SetValue(index++, coords.Y());
+        arrayCamera->SetValue(index++, coords.Z());
+    }
+
+    arrayCamera->SetValue(index, camera->Scale());
+    namedData->SetArrayOfReals(Internal::viewStateKeyCamera, arrayCamera);
+    namedData->SetInteger(Internal::viewStateKeyCameraProjection, int(camera->ProjectionType()));
+}
+
+bool GuiDocument::restoreViewState()
+{
+    auto namedData = CafUtils::findAttribute<TDataStd_NamedData>(m_document->rootLabel());
+    if (!namedData)
+        return false;
+
+    for (const GraphicsObjectDriverPtr& driver : m_guiApp->graphicsObjectDrivers()) {
+        const TCollection_ExtendedString key = Internal::viewStateKeyDisplayMode(driver);
+        if (namedData->HasInteger(key)) {
+            const int mode = namedData->GetInteger(key);
+            if (driver->displayModes().findIndexByValue(mode) != -1)
+                this->setActiveDisplayMode(driver, mode);
+        }
+    }
+
+    if (namedData->HasArrayOfReals(Internal::viewStateKeyCamera)) {
+        const OccHandle<TColStd_HArray1OfReal>& arrayCamera = namedData->GetArrayOfReals(Internal::viewStateKeyCamera);
+        if (arrayCamera && arrayCamera->Length() == 10) {
+            auto fnPoint = [&](int index) {
+                return gp_XYZ(arrayCamera->Value(index), arrayCamera->Value(index + 1), arrayCamera->Value(index + 2));
+            };
+            const OccHandle<Graphic3d_Camera>& camera = m_v3dView->Camera();
+            camera->SetEye(gp_Pnt(fnPoint(1)));
+            camera->SetCenter(gp_Pnt(fnPoint(4)));
+            camera->SetUp(gp_Dir(fnPoint(7)));
+            camera->SetScale(arrayCamera->Value(10));
+            if (namedData->HasInteger(Internal::viewStateKeyCameraProjection)) {
+                const int projection = namedData->GetInteger(Internal::viewStateKeyCameraProjection);
+                camera->SetProjectionType(static_cast<Graphic3d_Camera::Projection>(projection));
+            }
+
+            // Stored camera takes precedence over fitting the view once entities are mapped
+            for (PendingMapping& mapping : m_vecPendingMapping)
+                mapping.fitView = false;
+
+            m_v3dView->Update();
+        }
+    }
+
+    return true;
+}
+
 CheckState GuiDocument::nodeVisibleState(TreeNodeId nodeId) const
 {
     auto itFound = m_mapTreeNodeCheckState.find(nodeId);
@@ -319,9 +511,39 @@ void GuiDocument::setNodeVisible(TreeNodeId nodeId, bool on)
     traverseTree(nodeId, docModelTree , [=](TreeNodeId id) {
         fnSetNodeVisibleState(id, nodeVisibleState);
     });
+    const GraphicsEntity* gfxEntity = this->findGraphicsEntity(docModelTree.nodeRoot(nodeId));
     this->foreachGraphicsObject(nodeId, [=](GraphicsObjectPtr gfxObject) {
+        // Deferred mesh data is resident only while the graphics object is visible
+        const TopoDS_Shape deferredMeshShape =
+            gfxEntity ? CppUtils::findValue(gfxObject, gfxEntity->mapGfxObjectDeferredMeshShape) : TopoDS_Shape();
+        const bool wasVisible = GraphicsUtils::AisObject_isVisible(gfxObject);
+        if (on && !wasVisible && !deferredMeshShape.IsNull())
+            BRepDeferredMesh::pin(deferredMeshShape);
+
         GraphicsUtils::AisObject_setVisible(gfxObject, on);
+        if (!on && wasVisible && !deferredMeshShape.IsNull())
+            BRepDeferredMesh::unpin(deferredMeshShape);
+
+        // Showing graphics can only extend the visible bounding box, so it's updated in place
+        if (on && !wasVisible && m_isGfxVisibleBoundingBoxValid)
+            BndUtils::add(&m_gfxVisibleBoundingBox, CppUtils::findValue(gfxObject, m_mapGfxObjectBndBox));
     });
+    // Merged parts are hidden within their batch, which is then recomputed once
+    std::unordered_set<OccHandle<AIS_MergedParts>> setChangedBatch;
+    this->foreachMergedPart(nodeId, [&](const OccHandle<AIS_MergedParts>& batch, int partIndex) {
+        if (batch->isPartVisible(partIndex) == on)
+            return;
+
+        batch->setPartVisible(partIndex, on);
+        setChangedBatch.insert(batch);
+        if (on && m_isGfxVisibleBoundingBoxValid)
+            BndUtils::add(&m_gfxVisibleBoundingBox, batch->partBoundingBox(partIndex));
+    });
+    for (const OccHandle<AIS_MergedParts>& batch : setChangedBatch)
+        this->updateMergedBatch(batch);
+
+    if (!on)
+        m_isGfxVisibleBoundingBoxValid = false;
 
     // Keep selection state of the input node: in case the node graphics are "shown" back again then
     // AIS object selection status is lost
@@ -387,12 +609,190 @@ void GuiDocument::setExplodingFactor(double t)
             gp_Trsf trsfMove;
             trsfMove.SetTranslation(2 * t * vecDirection);
             m_gfxScene.setObjectTransformation(object.ptr, trsfMove * object.trsfOriginal);
+            m_mapGfxObjectBndBox.insert_or_assign(object.ptr, object.bndBox.Transformed(trsfMove));
         }
     }
 
+    m_isGfxVisibleBoundingBoxValid = false;
+
     m_gfxScene.redraw();
 }
 
+void GuiDocument::enableProgressiveMapping(const ProgressiveMapping& params)
+{
+    Expects(params.taskMgr != nullptr);
+    Expects(params.fnMeshShape != nullptr);
+    m_progressiveMapping = params;
+}
+
+void GuiDocument::setMergedDisplay(const MergedDisplay& params)
+{
+    Expects(params.maxPartTriangleCount > 0);
+    Expects(params.maxBatchTriangleCount >= params.maxPartTriangleCount);
+    m_mergedDisplay = params;
+}
+
+bool GuiDocument::hasPendingGraphicsMapping() const
+{
+    if (!m_vecPendingMapping.empty() || m_meshTaskQueue->runningTaskCount > 0)
+        return true;
+
+    std::lock_guard<std::mutex> lock(m_meshTaskQueue->mutex);
+    return !m_meshTaskQueue->vecResult.empty();
+}
+
+bool GuiDocument::hasPendingMeshing(TreeNodeId nodeId) const
+{
+    if (m_setProductMeshing.empty())
+        return false;
+
+    // Product nodes follow reference nodes in the model tree, so products are all visited
+    bool isPending = false;
+    const Tree<TDF_Label>& docModelTree = m_document->modelTree();
+    traverseTree(nodeId, docModelTree, [&](TreeNodeId id) {
+        isPending = isPending || m_setProductMeshing.find(docModelTree.nodeData(id)) != m_setProductMeshing.cend();
+    });
+    return isPending;
+}
+
+void GuiDocument::processPendingGraphicsMapping(std::chrono::milliseconds budget)
+{
+    const auto deadline = std::chrono::steady_clock::now() + budget;
+    this->processMeshTaskResults();
+    this->mapPendingLeafNodes(deadline);
+}
+
+void GuiDocument::cancelPendingGraphicsMapping()
+{
+    // Running tasks keep the old queue alive until they're finished
+    m_meshTaskQueue->isCancelRequested = true;
+    m_meshTaskQueue = std::make_shared<MeshTaskQueue>();
+    // Parts already merged are kept
+    for (PendingMapping& mapping : m_vecPendingMapping) {
+        GraphicsEntity* gfxEntity = this->findGraphicsEntity(mapping.entityTreeNodeId);
+        if (gfxEntity)
+            this->updateMergedBatches(&mapping, gfxEntity, true/*includeOpenBatches*/);
+    }
+
+    m_vecPendingMapping.clear();
+    if (!m_setProductMeshing.empty()) {
+        m_setProductMeshing.clear();
+        this->signalProductsMeshed.send();
+    }
+}
+
+void GuiDocument::updateLevelOfDetail()
+{
+    if (m_v3dView->Window().IsNull())
+        return;
+
+    int viewWidth = 0;
+    int viewHeight = 0;
+    m_v3dView->Window()->Size(viewWidth, viewHeight);
+    if (viewHeight <= 0)
+        return;
+
+    const OccHandle<Graphic3d_Camera>& camera = m_v3dView->Camera();
+    bool isLodChanged = false;
+    // Faces pinned for a worker thread(eg export) were skipped by setActiveLevel(), levels are
+    // applied again once they are released
+    const uint64_t unpinCount = BRepMeshLod::unpinCount();
+    const bool isAnyUnpinned = unpinCount != m_lodUnpinCount;
+    m_lodUnpinCount = unpinCount;
+    {
+        std::lock_guard<std::mutex> lockLod(BRepMeshLod::mutex());
+        for (GraphicsEntity& gfxEntity : m_vecGraphicsEntity) {
+            for (GraphicsEntity::ProductLod& product : gfxEntity.vecProductLod) {
+                const int levelCount = BRepMeshLod::levelCount(product.shape);
+                if (levelCount < 2)
+                    continue; // Nothing to select
+
+                if (int(product.vecLevelDeflection.size()) != levelCount) {
+                    // Some level of detail was added since last update
+                    product.vecLevelDeflection.clear();
+                    for (int level = 0; level < levelCount; ++level)
+                        product.vecLevelDeflection.push_back(BRepMeshLod::levelDeflection(product.shape, level));
+
+                    product.activeLevel = BRepMeshLod::activeLevel(product.shape);
+                }
+                else if (isAnyUnpinned) {
+                    product.activeLevel = -1;
+                }
+
+                // Distance between camera eye and the nearest instance of the product
+                double distance = std::numeric_limits<double>::max();
+                for (size_t index : product.vecObjectIndex) {
+                    const Bnd_Box& bndBox = gfxEntity.vecObject.at(index).bndBox;
+                    if (!bndBox.IsVoid())
+                        distance = std::min(distance, Internal::distance(bndBox, camera->Eye()));
+                }
+
+                if (distance == std::numeric_limits<double>::max())
+                    continue;
+
+                // Pixel count per world unit at 'distance', whatever the camera projection is
+                const double viewUnitHeight = camera->ViewDimensions(std::max(distance, camera->ZNear())).Y();
+                const double pixelsPerUnit = viewUnitHeight > 0. ? viewHeight / viewUnitHeight : 0.;
+                int level = levelCount - 1;
+                for (int i = 0; i < levelCount - 1; ++i) {
+                    if (product.vecLevelDeflection.at(i) * pixelsPerUnit <= m_lodScreenSpaceError) {
+                        level = i;
+                        break;
+                    }
+                }
+
+                if (level == product.activeLevel)
+                    continue;
+
+                product.activeLevel = level;
+                if (BRepMeshLod::setActiveLevel(product.shape, level)) {
+                    // Instances(AIS_ConnectedInteractive) are recomputed as well to update selection
+                    m_gfxScene.recomputeObjectPresentation(product.gfxProduct);
+                    for (size_t index : product.vecObjectIndex) {
+                        const GraphicsObjectPtr& gfxObject = gfxEntity.vecObject.at(index).ptr;
+                        if (gfxObject != product.gfxProduct)
+                            m_gfxScene.recomputeObjectPresentation(gfxObject);
+                    }
+
+                    isLodChanged = true;
+                }
+            }
+        }
+    }
+
+    // Point clouds displayed with octree-based level of detail
+    for (const GraphicsEntity& gfxEntity : m_vecGraphicsEntity) {
+        for (const GraphicsEntity::Object& object : gfxEntity.vecObject) {
+            auto pntCloudLod = OccHandle<AIS_PointCloudLod>::DownCast(object.ptr);
+            if (!pntCloudLod || !m_gfxScene.isObjectVisible(pntCloudLod))
+                continue;
+
+            // Octree is expressed in object space, eg when exploding assemblies
+            Graphic3d_Camera objectCamera(*camera);
+            const gp_Trsf& objectTrsf = pntCloudLod->Transformation();
+            if (objectTrsf.Form() != gp_Identity)
+                objectCamera.Transform(objectTrsf.Inverted());
+
+            if (pntCloudLod->updateLod(objectCamera, viewHeight)) {
+                m_gfxScene.recomputeObjectPresentation(pntCloudLod);
+                isLodChanged = true;
+            }
+        }
+    }
+
+    if (isLodChanged)
+        m_gfxScene.redraw();
+}
+
+void GuiDocument::setLodScreenSpaceError(double pixels)
+{
+    if (MathUtils::fuzzyEqual(m_lodScreenSpaceError, pixels))
+        return;
+
+    m_lodScreenSpaceError = pixels;
+    this->updateLevelOfDetail();
+}
+
 bool GuiDocument::isOriginTrihedronVisible() const
 {
     return m_gfxScene.isObjectVisible(m_aisOriginTrihedron);
@@ -564,10 +964,7 @@ void GuiDocument::setDefaultGradientBackground(const GradientBackground& gradien
 
 void GuiDocument::onDocumentEntityAdded(TreeNodeId entityTreeNodeId)
 {
-    this->mapEntity(entityTreeNodeId);
-    BndUtils::add(&m_gfxBoundingBox, m_vecGraphicsEntity.back().bndBox);
-    m_v3dView->FitAll(this->graphicsBoundingBox(OnlySelectedGraphics | OnlyVisibleGraphics));
-    this->signalGraphicsBoundingBoxChanged.send(m_gfxBoundingBox);
+    this->mapEntity(entityTreeNodeId, true/*fitViewOnceMapped*/);
 }
 
 void GuiDocument::onDocumentEntityAboutToBeDestroyed(TreeNodeId entityTreeNodeId)
@@ -593,27 +990,24 @@ void GuiDocument::onGraphicsSelectionChanged()
     }
 
     std::vector<ApplicationItem> vecSelected;
+    std::unordered_set<ApplicationItem> setSelected;
     m_gfxScene.foreachSelectedOwner([&](const GraphicsOwnerPtr& gfxOwner) {
-        auto gfxObject = GraphicsObjectPtr::DownCast(
-            gfxOwner ? gfxOwner->Selectable() : OccHandle<SelectMgr_SelectableObject>()
-        );
-        const TreeNodeId nodeId = this->nodeFromGraphicsObject(gfxObject);
+        const TreeNodeId nodeId = this->nodeFromGraphicsOwner(gfxOwner);
         if (nodeId != 0) {
             const ApplicationItem appItem({ m_document, nodeId });
-            vecSelected.push_back(std::move(appItem));
+            if (setSelected.insert(appItem).second)
+                vecSelected.push_back(std::move(appItem));
         }
     });
 
     std::vector<ApplicationItem> vecRemoved;
     for (const ApplicationItem& appItem : appSelectionModel->selectedItems()) {
-        if (appItem.document() != m_document)
-            continue;
-
-        auto it = std::find(vecSelected.cbegin(), vecSelected.cend(), appItem);
-        if (it == vecSelected.cend())
+        if (appItem.document() == m_document && setSelected.find(appItem) == setSelected.cend())
             vecRemoved.push_back(appItem);
     }
 
+    // Single notification of the selection changes
+    ApplicationItemSelectionModel::BatchScope batchScope(appSelectionModel);
     if (!vecSelected.empty())
         appSelectionModel->add(vecSelected);
 
@@ -621,90 +1015,611 @@ void GuiDocument::onGraphicsSelectionChanged()
         appSelectionModel->remove(vecRemoved);
 }
 
-void GuiDocument::mapEntity(TreeNodeId entityTreeNodeId)
+void GuiDocument::mapEntity(TreeNodeId entityTreeNodeId, bool fitViewOnceMapped)
 {
     const Tree<TDF_Label>& docModelTree = m_document->modelTree();
     GraphicsEntity gfxEntity;
     gfxEntity.treeNodeId = entityTreeNodeId;
-    std::unordered_map<TDF_Label, GraphicsObjectPtr> mapLabelGfxProduct;
-
-    traverseTree(entityTreeNodeId, docModelTree, [&](TreeNodeId id) {
-        const TDF_Label nodeLabel = docModelTree.nodeData(id);
-        if (docModelTree.nodeIsLeaf(id)) {
-            GraphicsObjectPtr gfxProduct = CppUtils::findValue(nodeLabel, mapLabelGfxProduct);
-            if (!gfxProduct) {
-                gfxProduct = m_guiApp->createGraphicsObject(nodeLabel);
-                if (!gfxProduct)
-                    return;
-
-                mapLabelGfxProduct.insert({ nodeLabel, gfxProduct });
+    m_vecGraphicsEntity.push_back(std::move(gfxEntity));
+
+    PendingMapping mapping;
+    mapping.entityTreeNodeId = entityTreeNodeId;
+    mapping.fitView = fitViewOnceMapped;
+    const AssemblyGraph& graph = m_document->assemblyGraph();
+    const AssemblyGraph::OccurrenceId graphRootId = m_document->assemblyGraphRoot(entityTreeNodeId);
+    if (graphRootId != 0) {
+        // Leaves are the occurrences of products without components
+        m_document->traverseAssemblyGraphPaths(entityTreeNodeId, [&](AssemblyGraph::OccurrencePath path, TreeNodeId id) {
+            m_mapTreeNodeCheckState.insert({ id, CheckState::On });
+            if (path.size() > 1)
+                m_mapTreeNodeCheckState.insert({ docModelTree.nodeParent(id), CheckState::On });
+
+            if (graph.product(graph.occurrence(path.back()).product).vecChildOccurrence.empty())
+                mapping.vecLeafNodeId.push_back(id);
+        });
+    }
+    else {
+        traverseTree(entityTreeNodeId, docModelTree, [&](TreeNodeId id) {
+            m_mapTreeNodeCheckState.insert({ id, CheckState::On });
+            if (docModelTree.nodeIsLeaf(id))
+                mapping.vecLeafNodeId.push_back(id);
+        });
+    }
+
+    if (!this->isProgressiveMappingEnabled()) {
+        m_vecPendingMapping.push_back(std::move(mapping));
+        this->mapPendingLeafNodes(std::chrono::steady_clock::time_point::max());
+        return;
+    }
+
+    // Find BRep products to be meshed before their graphics objects can be created, each product
+    // being visited once whatever the count of its instances
+    std::vector<MeshTaskProduct> vecProductToMesh;
+    auto fnAddProductToMesh = [&](const TDF_Label& label, bool isRoot) {
+        if (!XCaf::isShape(label) || m_setProductMeshing.find(label) != m_setProductMeshing.cend())
+            return;
+
+        const TopoDS_Shape shape = XCaf::shape(label);
+        if (Internal::hasFaceWithoutTriangulation(shape)) {
+            m_setProductMeshing.insert(label);
+            vecProductToMesh.push_back({ label, shape, !isRoot && this->isMergedPartCandidate(label) });
+        }
+    };
+    if (graphRootId != 0) {
+        const AssemblyGraph::ProductId rootProductId = graph.occurrence(graphRootId).product;
+        graph.traverseProducts(graphRootId, [&](AssemblyGraph::ProductId productId) {
+            const AssemblyGraph::Product& product = graph.product(productId);
+            if (product.vecChildOccurrence.empty())
+                fnAddProductToMesh(product.label, productId == rootProductId);
+        });
+    }
+    else {
+        for (TreeNodeId leafNodeId : mapping.vecLeafNodeId)
+            fnAddProductToMesh(docModelTree.nodeData(leafNodeId), docModelTree.nodeIsRoot(leafNodeId));
+    }
+
+    m_vecPendingMapping.push_back(std::move(mapping));
+    if (!vecProductToMesh.empty())
+        this->runMeshTask(std::move(vecProductToMesh));
+
+    this->signalGraphicsMappingPending.send();
+}
+
+void GuiDocument::mapLeafNode(PendingMapping* mapping, GraphicsEntity* gfxEntity, TreeNodeId leafNodeId)
+{
+    const Tree<TDF_Label>& docModelTree = m_document->modelTree();
+    TreeNodeId id = leafNodeId;
+    const TDF_Label nodeLabel = docModelTree.nodeData(id);
+    GraphicsObjectPtr gfxProduct = CppUtils::findValue(nodeLabel, mapping->mapLabelGfxProduct);
+    if (!gfxProduct) {
+        gfxProduct = m_guiApp->createGraphicsObject(nodeLabel, m_document->labelDataFlags(nodeLabel));
+        if (!gfxProduct)
+            return;
+
+        this->addGraphicsProduct(mapping, gfxEntity, nodeLabel, gfxProduct);
+    }
+
+    if (!docModelTree.nodeIsRoot(id)) {
+        const TreeNodeId parentNodeId = docModelTree.nodeParent(id);
+        const TDF_Label parentNodeLabel = docModelTree.nodeData(parentNodeId);
+        if (XCaf::isShapeReference(parentNodeLabel) && m_document->xcaf().hasShapeColor(parentNodeLabel)) {
+            // Parent node is a reference and it redefines color attribute, so the graphics
+            // can't be shared with the product
+            auto gfxObject = m_guiApp->createGraphicsObject(parentNodeLabel, m_document->labelDataFlags(parentNodeId));
+            const TreeNodeId grandParentNodeId = docModelTree.nodeParent(parentNodeId);
+            const TopLoc_Location locGrandParentShape = XCaf::shapeAbsoluteLocation(docModelTree, grandParentNodeId);
+            gfxObject->SetLocalTransformation(locGrandParentShape);
+            gfxEntity->vecObject.push_back(gfxObject);
+        }
+        else {
+            auto gfxInstance = new AIS_ConnectedInteractive;
+            gfxInstance->Connect(gfxProduct, XCaf::shapeAbsoluteLocation(docModelTree, id));
+            gfxInstance->SetDisplayMode(gfxProduct->DisplayMode());
+            gfxInstance->Attributes()->SetFaceBoundaryDraw(gfxProduct->Attributes()->FaceBoundaryDraw());
+            gfxInstance->SetOwner(gfxProduct->GetOwner());
+            gfxEntity->vecObject.push_back(GraphicsObjectPtr(gfxInstance));
+        }
+
+        if (XCaf::isShapeReference(parentNodeLabel))
+            id = docModelTree.nodeParent(id);
+    }
+    else {
+        gfxEntity->vecObject.push_back(gfxProduct);
+    }
+
+    auto itProductLod = mapping->mapLabelProductLodIndex.find(nodeLabel);
+    if (itProductLod != mapping->mapLabelProductLodIndex.cend()) {
+        GraphicsEntity::ProductLod& productLod = gfxEntity->vecProductLod.at(itProductLod->second);
+        productLod.vecObjectIndex.push_back(gfxEntity->vecObject.size() - 1);
+    }
+
+    const GraphicsEntity::Object& lastGfxObject = gfxEntity->vecObject.back();
+    gfxEntity->mapTreeNodeGfxObject.insert({ id, lastGfxObject.ptr });
+    m_mapGfxObjectTreeNode.insert({ lastGfxObject.ptr, id });
+    if (mapping->setLabelDeferredMesh.find(nodeLabel) != mapping->setLabelDeferredMesh.cend()) {
+        // Mesh data must be resident before the graphics object gets displayed
+        const TopoDS_Shape& productShape = gfxEntity->vecProductLod.at(itProductLod->second).shape;
+        BRepDeferredMesh::pin(productShape);
+        gfxEntity->mapGfxObjectDeferredMeshShape.insert({ lastGfxObject.ptr, productShape });
+    }
+}
+
+void GuiDocument::addGraphicsProduct(
+        PendingMapping* mapping, GraphicsEntity* gfxEntity, const TDF_Label& label, const GraphicsObjectPtr& gfxProduct
+    )
+{
+    mapping->mapLabelGfxProduct.insert({ label, gfxProduct });
+    if (XCaf::isShape(label)) {
+        mapping->mapLabelProductLodIndex.insert({ label, gfxEntity->vecProductLod.size() });
+        GraphicsEntity::ProductLod productLod;
+        productLod.shape = XCaf::shape(label);
+        productLod.gfxProduct = gfxProduct;
+        if (BRepDeferredMesh::hasDeferredData(productLod.shape))
+            mapping->setLabelDeferredMesh.insert(label);
+
+        gfxEntity->vecProductLod.push_back(std::move(productLod));
+    }
+
+    auto pntCloudLod = OccHandle<AIS_PointCloudLod>::DownCast(gfxProduct);
+    if (pntCloudLod && !pntCloudLod->octree())
+        this->runPointCloudOctreeTask(label, pntCloudLod);
+}
+
+void GuiDocument::createGraphicsProducts(
+        PendingMapping* mapping, GraphicsEntity* gfxEntity, Span<const TreeNodeId> spanLeafNodeId
+    )
+{
+    const Tree<TDF_Label>& docModelTree = m_document->modelTree();
+    std::vector<TDF_Label> vecProductLabel;
+    std::unordered_set<TDF_Label> setProductLabel;
+    for (TreeNodeId leafNodeId : spanLeafNodeId) {
+        const TDF_Label& label = docModelTree.nodeData(leafNodeId);
+        if (mapping->mapLabelGfxProduct.find(label) == mapping->mapLabelGfxProduct.cend()
+                && setProductLabel.insert(label).second)
+        {
+            vecProductLabel.push_back(label);
+        }
+    }
+
+    // Drivers are resolved here, only those opting in create their objects concurrently. Others
+    // create them on the calling(GUI) thread
+    std::vector<GraphicsObjectDriverPtr> vecDriver(vecProductLabel.size());
+    std::vector<int> vecConcurrentIndex;
+    for (size_t i = 0; i < vecProductLabel.size(); ++i) {
+        const TDF_Label& label = vecProductLabel.at(i);
+        vecDriver.at(i) = m_guiApp->findGraphicsObjectDriver(label, m_document->labelDataFlags(label));
+        if (vecDriver.at(i) && vecDriver.at(i)->isConcurrentCreationSupported())
+            vecConcurrentIndex.push_back(int(i));
+    }
+
+    std::vector<GraphicsObjectPtr> vecGfxProduct(vecProductLabel.size());
+    OSD_Parallel::For(0, int(vecConcurrentIndex.size()), [&](int j) {
+        const int i = vecConcurrentIndex.at(j);
+        vecGfxProduct.at(i) = vecDriver.at(i)->createObject(vecProductLabel.at(i));
+    }, vecConcurrentIndex.size() <= 1);
+
+    for (size_t i = 0; i < vecProductLabel.size(); ++i) {
+        if (vecDriver.at(i) && !vecDriver.at(i)->isConcurrentCreationSupported())
+            vecGfxProduct.at(i) = vecDriver.at(i)->createObject(vecProductLabel.at(i));
+    }
+
+    // Insertion in leaf order, so the mapping doesn't depend on thread scheduling
+    for (size_t i = 0; i < vecProductLabel.size(); ++i) {
+        if (vecGfxProduct.at(i))
+            this->addGraphicsProduct(mapping, gfxEntity, vecProductLabel.at(i), vecGfxProduct.at(i));
+    }
+}
+
+bool GuiDocument::isMergedPartCandidate(const TDF_Label& productLabel) const
+{
+    if (!m_mergedDisplay.enabled)
+        return false;
+
+    const LabelDataFlags flags = m_document->labelDataFlags(productLabel);
+    if ((flags & LabelData_HasShape) == 0 || (flags & LabelData_HasTriangulationAnnexData) != 0)
+        return false;
+
+    // Parts whose mesh can change afterwards or with colored faces get their own graphics object
+    return !BRepDeferredMesh::hasDeferredData(XCaf::shape(productLabel))
+           && !Internal::hasSubShapeColor(m_document->xcaf(), productLabel);
+}
+
+bool GuiDocument::mapMergedLeafNode(PendingMapping* mapping, GraphicsEntity* gfxEntity, TreeNodeId leafNodeId)
+{
+    const Tree<TDF_Label>& docModelTree = m_document->modelTree();
+    const TDF_Label nodeLabel = docModelTree.nodeData(leafNodeId);
+    if (docModelTree.nodeIsRoot(leafNodeId) || !this->isMergedPartCandidate(nodeLabel))
+        return false;
+
+    // Parts with finer levels of detail get their own graphics object
+    const TopoDS_Shape shape = XCaf::shape(nodeLabel);
+    if (BRepMeshLod::levelCount(shape) > 1)
+        return false;
+
+    const int triangleCount = AIS_MergedParts::shapeTriangleCount(shape);
+    if (triangleCount <= 0 || triangleCount > m_mergedDisplay.maxPartTriangleCount)
+        return false;
+
+    // Same node and color resolution as mapLeafNode()
+    TreeNodeId partNodeId = leafNodeId;
+    const TreeNodeId parentNodeId = docModelTree.nodeParent(leafNodeId);
+    const TDF_Label parentNodeLabel = docModelTree.nodeData(parentNodeId);
+    Quantity_Color color = GraphicsShapeObjectDriver::defaultColor();
+    if (XCaf::isShapeReference(parentNodeLabel) && m_document->xcaf().hasShapeColor(parentNodeLabel))
+        color = m_document->xcaf().shapeColor(parentNodeLabel);
+    else if (m_document->xcaf().hasShapeColor(nodeLabel))
+        color = m_document->xcaf().shapeColor(nodeLabel);
+
+    if (XCaf::isShapeReference(parentNodeLabel))
+        partNodeId = parentNodeId;
+
+    // Find the open batch of the color, a new one is started once it's full
+    auto& vecOpenBatch = mapping->vecOpenMergedBatch;
+    auto itOpenBatch = std::find_if(vecOpenBatch.begin(), vecOpenBatch.end(), [&](const auto& colorBatch) {
+        return colorBatch.first.IsEqual(color);
+    });
+    if (itOpenBatch != vecOpenBatch.end()) {
+        const OccHandle<AIS_MergedParts>& batch = gfxEntity->vecMergedBatch.at(itOpenBatch->second);
+        if (batch->triangleCount() + triangleCount > m_mergedDisplay.maxBatchTriangleCount) {
+            vecOpenBatch.erase(itOpenBatch);
+            itOpenBatch = vecOpenBatch.end();
+        }
+    }
+
+    if (itOpenBatch == vecOpenBatch.end()) {
+        const Graphic3d_MaterialAspect material(GraphicsShapeObjectDriver::defaultMaterial());
+        gfxEntity->vecMergedBatch.push_back(makeOccHandle<AIS_MergedParts>(color, material));
+        vecOpenBatch.push_back({ color, gfxEntity->vecMergedBatch.size() - 1 });
+        itOpenBatch = vecOpenBatch.end() - 1;
+    }
+
+    const size_t batchIndex = itOpenBatch->second;
+    const OccHandle<AIS_MergedParts>& batch = gfxEntity->vecMergedBatch.at(batchIndex);
+    const TopoDS_Shape partShape = shape.Moved(XCaf::shapeAbsoluteLocation(docModelTree, leafNodeId));
+    const int partIndex = batch->addPart(partNodeId, partShape);
+    if (partIndex < 0)
+        return false;
+
+    gfxEntity->mapTreeNodeMergedPart.insert({ partNodeId, { batchIndex, partIndex } });
+    mapping->setDirtyMergedBatch.insert(batchIndex);
+    BndUtils::add(&gfxEntity->bndBox, batch->partBoundingBox(partIndex));
+    // Node might have been unchecked in the model tree before the part got merged
+    if (this->nodeVisibleState(partNodeId) == CheckState::Off)
+        batch->setPartVisible(partIndex, false);
+    else if (m_isGfxVisibleBoundingBoxValid)
+        BndUtils::add(&m_gfxVisibleBoundingBox, batch->partBoundingBox(partIndex));
+
+    return true;
+}
+
+bool GuiDocument::updateMergedBatches(PendingMapping* mapping, GraphicsEntity* gfxEntity, bool includeOpenBatches)
+{
+    auto fnIsOpenBatch = [=](size_t batchIndex) {
+        return std::any_of(
+            mapping->vecOpenMergedBatch.cbegin(), mapping->vecOpenMergedBatch.cend(),
+            [=](const auto& colorBatch) { return colorBatch.second == batchIndex; }
+        );
+    };
+
+    const auto timeNow = std::chrono::steady_clock::now();
+    if (timeNow - mapping->timeOpenMergedBatchUpdate >= Internal::openMergedBatchUpdateInterval)
+        includeOpenBatches = true;
+
+    bool isUpdated = false;
+    for (auto it = mapping->setDirtyMergedBatch.begin(); it != mapping->setDirtyMergedBatch.end();) {
+        if (includeOpenBatches || !fnIsOpenBatch(*it)) {
+            this->updateMergedBatch(gfxEntity->vecMergedBatch.at(*it));
+            it = mapping->setDirtyMergedBatch.erase(it);
+            isUpdated = true;
+        }
+        else {
+            ++it;
+        }
+    }
+
+    if (includeOpenBatches)
+        mapping->timeOpenMergedBatchUpdate = timeNow;
+
+    return isUpdated;
+}
+
+void GuiDocument::updateMergedBatch(const OccHandle<AIS_MergedParts>& batch)
+{
+    if (!batch->GetContext()) {
+        m_gfxScene.addObject(batch);
+        return;
+    }
+
+    if (batch->visiblePartCount() == 0) {
+        GraphicsUtils::AisObject_setVisible(batch, false);
+        return;
+    }
+
+    m_gfxScene.recomputeObjectPresentation(batch);
+    // Sensitive entities are computed for the visible parts only
+    batch->GetContext()->RecomputeSelectionOnly(batch);
+    GraphicsUtils::AisObject_setVisible(batch, true);
+}
+
+void GuiDocument::mapPendingLeafNodes(std::chrono::steady_clock::time_point deadline)
+{
+    const Tree<TDF_Label>& docModelTree = m_document->modelTree();
+    bool isBndBoxChanged = false;
+    bool isMergedBatchUpdated = false;
+    for (PendingMapping& mapping : m_vecPendingMapping) {
+        GraphicsEntity* gfxEntity = this->findGraphicsEntity(mapping.entityTreeNodeId);
+        if (!gfxEntity)
+            continue;
+
+        // Create graphics objects of ready leaf nodes while budget isn't exhausted
+        const size_t firstNewObjectIndex = gfxEntity->vecObject.size();
+        const size_t mergedPartCount = gfxEntity->mapTreeNodeMergedPart.size();
+        std::vector<TreeNodeId> vecLeafNodeIdReady;
+        std::vector<TreeNodeId> vecLeafNodeIdRemaining;
+        for (TreeNodeId leafNodeId : mapping.vecLeafNodeId) {
+            const bool isReady = m_setProductMeshing.empty()
+                                 || m_setProductMeshing.find(docModelTree.nodeData(leafNodeId)) == m_setProductMeshing.cend();
+            if (isReady)
+                vecLeafNodeIdReady.push_back(leafNodeId);
+            else
+                vecLeafNodeIdRemaining.push_back(leafNodeId);
+        }
+
+        size_t readyIndex = 0;
+        while (readyIndex < vecLeafNodeIdReady.size() && std::chrono::steady_clock::now() < deadline) {
+            const size_t batchSize = std::min(Internal::leafNodeMappingBatchSize, vecLeafNodeIdReady.size() - readyIndex);
+            const Span<const TreeNodeId> spanBatch(vecLeafNodeIdReady.data() + readyIndex, batchSize);
+            std::vector<TreeNodeId> vecLeafNodeIdUnmerged;
+            for (TreeNodeId leafNodeId : spanBatch) {
+                if (!this->mapMergedLeafNode(&mapping, gfxEntity, leafNodeId))
+                    vecLeafNodeIdUnmerged.push_back(leafNodeId);
             }
 
-            if (!docModelTree.nodeIsRoot(id)) {
-                const TreeNodeId parentNodeId = docModelTree.nodeParent(id);
-                const TDF_Label parentNodeLabel = docModelTree.nodeData(parentNodeId);
-                if (XCaf::isShapeReference(parentNodeLabel) && m_document->xcaf().hasShapeColor(parentNodeLabel)) {
-                    // Parent node is a reference and it redefines color attribute, so the graphics
-                    // can't be shared with the product
-                    auto gfxObject = m_guiApp->createGraphicsObject(parentNodeLabel);
-                    const TreeNodeId grandParentNodeId = docModelTree.nodeParent(parentNodeId);
-                    const TopLoc_Location locGrandParentShape = XCaf::shapeAbsoluteLocation(docModelTree, grandParentNodeId);
-                    gfxObject->SetLocalTransformation(locGrandParentShape);
-                    gfxEntity.vecObject.push_back(gfxObject);
-                }
-                else {
-                    auto gfxInstance = new AIS_ConnectedInteractive;
-                    gfxInstance->Connect(gfxProduct, XCaf::shapeAbsoluteLocation(docModelTree, id));
-                    gfxInstance->SetDisplayMode(gfxProduct->DisplayMode());
-                    gfxInstance->Attributes()->SetFaceBoundaryDraw(gfxProduct->Attributes()->FaceBoundaryDraw());
-                    gfxInstance->SetOwner(gfxProduct->GetOwner());
-                    gfxEntity.vecObject.push_back(GraphicsObjectPtr(gfxInstance));
-                }
+            this->createGraphicsProducts(&mapping, gfxEntity, vecLeafNodeIdUnmerged);
+            for (TreeNodeId leafNodeId : vecLeafNodeIdUnmerged)
+                this->mapLeafNode(&mapping, gfxEntity, leafNodeId);
+
+            readyIndex += batchSize;
+        }
+
+        vecLeafNodeIdRemaining.insert(
+            vecLeafNodeIdRemaining.end(), vecLeafNodeIdReady.begin() + readyIndex, vecLeafNodeIdReady.end()
+        );
+        mapping.vecLeafNodeId = std::move(vecLeafNodeIdRemaining);
+        const bool isMappingComplete = mapping.vecLeafNodeId.empty();
+        if (this->updateMergedBatches(&mapping, gfxEntity, isMappingComplete/*includeOpenBatches*/))
+            isMergedBatchUpdated = true;
+
+        const bool hasNewMergedParts = gfxEntity->mapTreeNodeMergedPart.size() != mergedPartCount;
+        if (firstNewObjectIndex == gfxEntity->vecObject.size() && !hasNewMergedParts)
+            continue;
+
+        for (size_t i = firstNewObjectIndex; i < gfxEntity->vecObject.size(); ++i) {
+            GraphicsEntity::Object& object = gfxEntity->vecObject.at(i);
+            m_gfxScene.addObject(object.ptr);
+            auto driver = GraphicsObjectDriver::get(object.ptr);
+            if (driver)
+                driver->applyDisplayMode(object.ptr, this->activeDisplayMode(driver));
+
+            object.bndBox = GraphicsUtils::AisObject_boundingBox(object.ptr);
+            object.trsfOriginal = m_gfxScene.objectTransformation(object.ptr);
+            BndUtils::add(&gfxEntity->bndBox, object.bndBox);
+            m_mapGfxObjectBndBox.insert_or_assign(object.ptr, object.bndBox);
+            // Node might have been unchecked in the model tree before its graphics got created
+            // Deferred mesh data was pinned for the display, and is released along with hiding
+            const TreeNodeId nodeId = CppUtils::findValue(object.ptr, m_mapGfxObjectTreeNode);
+            if (this->nodeVisibleState(nodeId) == CheckState::Off) {
+                GraphicsUtils::AisObject_setVisible(object.ptr, false);
+                const TopoDS_Shape deferredMeshShape =
+                    CppUtils::findValue(object.ptr, gfxEntity->mapGfxObjectDeferredMeshShape);
+                if (!deferredMeshShape.IsNull())
+                    BRepDeferredMesh::unpin(deferredMeshShape);
+            }
+            else if (m_isGfxVisibleBoundingBoxValid) {
+                BndUtils::add(&m_gfxVisibleBoundingBox, object.bndBox);
+            }
+        }
+
+        BndUtils::add(&m_gfxBoundingBox, gfxEntity->bndBox);
+        isBndBoxChanged = true;
+        if (mapping.fitView) {
+            // View is fitted only once to not disturb user navigation while mapping is in progress
+            m_v3dView->FitAll(this->graphicsBoundingBox(OnlySelectedGraphics | OnlyVisibleGraphics));
+            mapping.fitView = false;
+        }
+    }
+
+    // Erase entities whose mapping is complete
+    auto itMappingEnd = std::remove_if(
+        m_vecPendingMapping.begin(), m_vecPendingMapping.end(),
+        [](const PendingMapping& mapping) { return mapping.vecLeafNodeId.empty(); }
+    );
+    m_vecPendingMapping.erase(itMappingEnd, m_vecPendingMapping.end());
+
+    if (isBndBoxChanged || isMergedBatchUpdated)
+        m_gfxScene.redraw();
+
+    if (isBndBoxChanged)
+        this->signalGraphicsBoundingBoxChanged.send(m_gfxBoundingBox);
+}
 
-                if (XCaf::isShapeReference(parentNodeLabel))
-                    id = docModelTree.nodeParent(id);
+void GuiDocument::runMeshTask(std::vector<MeshTaskProduct> vecProduct)
+{
+    TaskManager* taskMgr = m_progressiveMapping.taskMgr;
+    std::shared_ptr<MeshTaskQueue> queue = m_meshTaskQueue;
+    auto fnMeshShape = m_progressiveMapping.fnMeshShape;
+    auto fnMeshShapeFineLevel = m_progressiveMapping.fnMeshShapeFineLevel;
+    const int maxMergedPartTriangleCount = m_mergedDisplay.maxPartTriangleCount;
+    ++queue->runningTaskCount;
+    const TaskId taskId = taskMgr->newTask([=](TaskProgress* progress) {
+        auto _ = gsl::finally([=]{ --queue->runningTaskCount; });
+        auto fnIsCancelled = [=]{
+            return queue->isCancelRequested || TaskProgress::isAbortRequested(progress);
+        };
+
+        // Coarse meshing first so all products can be displayed as soon as possible
+        const double portionSize = (fnMeshShapeFineLevel ? 50. : 100.) / vecProduct.size();
+        for (const MeshTaskProduct& product : vecProduct) {
+            if (!fnIsCancelled()) {
+                TaskProgress subProgress(progress, portionSize);
+                fnMeshShape(product.shape, &subProgress);
             }
-            else {
-                gfxEntity.vecObject.push_back(gfxProduct);
+
+            queue->push({ product.label, !fnIsCancelled(), {} });
+        }
+
+        if (!fnMeshShapeFineLevel)
+            return;
+
+        for (const MeshTaskProduct& product : vecProduct) {
+            if (fnIsCancelled())
+                return;
+
+            // Same criterion as mapMergedLeafNode(), merged parts keep the coarse mesh
+            if (product.isMergedPartCandidate) {
+                const int triangleCount = AIS_MergedParts::shapeTriangleCount(product.shape);
+                if (triangleCount > 0 && triangleCount <= maxMergedPartTriangleCount)
+                    continue;
             }
 
-            const GraphicsEntity::Object& lastGfxObject = gfxEntity.vecObject.back();
-            gfxEntity.mapTreeNodeGfxObject.insert({ id, lastGfxObject.ptr });
-            gfxEntity.mapGfxObjectTreeNode.insert({ lastGfxObject.ptr, id });
+            TaskProgress subProgress(progress, portionSize, GuiDocumentI18N::textIdTr("Refine BRep meshes"));
+            auto ptrFineLevel = std::make_shared<BRepMeshLod::Level>(fnMeshShapeFineLevel(product.shape, &subProgress));
+            if (!ptrFineLevel->empty() && !fnIsCancelled())
+                queue->push({ product.label, true, std::move(ptrFineLevel) });
         }
     });
+    taskMgr->setTitle(taskId, fmt::format(GuiDocumentI18N::textIdTr("Mesh {}"), m_document->name()));
+    taskMgr->run(taskId);
+}
 
-    for (const GraphicsEntity::Object& object : gfxEntity.vecObject) {
-        m_gfxScene.addObject(object.ptr);
-        auto driver = GraphicsObjectDriver::get(object.ptr);
-        if (driver)
-            driver->applyDisplayMode(object.ptr, this->activeDisplayMode(driver));
+void GuiDocument::runPointCloudOctreeTask(const TDF_Label& label, const OccHandle<AIS_PointCloudLod>& pntCloudLod)
+{
+    auto attrPointCloudData = CafUtils::findAttribute<PointCloudData>(label);
+    if (!attrPointCloudData)
+        return;
+
+    if (!this->isProgressiveMappingEnabled()) {
+        pntCloudLod->setOctree(attrPointCloudData->octree());
+        return;
     }
 
-    for (GraphicsEntity::Object& object : gfxEntity.vecObject) {
-        object.bndBox = GraphicsUtils::AisObject_boundingBox(object.ptr);
-        object.trsfOriginal = m_gfxScene.objectTransformation(object.ptr);
-        BndUtils::add(&gfxEntity.bndBox, object.bndBox);
+    // Coarse subsample is displayed until the octree is available
+    TaskManager* taskMgr = m_progressiveMapping.taskMgr;
+    std::shared_ptr<MeshTaskQueue> queue = m_meshTaskQueue;
+    ++queue->runningTaskCount;
+    const TaskId taskId = taskMgr->newTask([=](TaskProgress* progress) {
+        auto _ = gsl::finally([=]{ --queue->runningTaskCount; });
+        MeshTaskQueue::Result result;
+        result.product = label;
+        result.pntCloudLod = pntCloudLod;
+        result.pntCloudOctree = attrPointCloudData->octree(progress);
+        if (result.pntCloudOctree && !queue->isCancelRequested)
+            queue->push(std::move(result));
+    });
+    taskMgr->setTitle(taskId, fmt::format(GuiDocumentI18N::textIdTr("Index points of {}"), m_document->name()));
+    taskMgr->run(taskId);
+}
+
+void GuiDocument::processMeshTaskResults()
+{
+    std::vector<MeshTaskQueue::Result> vecResult;
+    {
+        std::lock_guard<std::mutex> lock(m_meshTaskQueue->mutex);
+        vecResult.swap(m_meshTaskQueue->vecResult);
     }
 
-    m_gfxScene.redraw();
+    bool isLodChanged = false;
+    bool isProductMeshed = false;
+    std::vector<MeshTaskQueue::Result> vecResultDelayed;
+    std::unique_lock<std::mutex> lockLod(BRepMeshLod::mutex(), std::defer_lock);
+    const Tree<TDF_Label>& docModelTree = m_document->modelTree();
+    for (const MeshTaskQueue::Result& result : vecResult) {
+        if (result.pntCloudLod) {
+            result.pntCloudLod->setOctree(result.pntCloudOctree);
+            m_gfxScene.recomputeObjectPresentation(result.pntCloudLod);
+            if (result.pntCloudLod->HasInteractiveContext())
+                result.pntCloudLod->GetContext()->RecomputeSelectionOnly(result.pntCloudLod);
+
+            isLodChanged = true;
+            continue;
+        }
 
-    traverseTree(entityTreeNodeId, docModelTree, [=](TreeNodeId id) {
-        m_mapTreeNodeCheckState.insert({ id, CheckState::On });
-    });
+        if (result.ptrFineLevel) {
+            if (!lockLod.owns_lock())
+                lockLod.lock();
 
-    m_vecGraphicsEntity.push_back(std::move(gfxEntity));
+            // Faces are pinned for a worker thread(eg export), level will be added at next call
+            if (!BRepMeshLod::addLevel(*result.ptrFineLevel)) {
+                vecResultDelayed.push_back(result);
+                continue;
+            }
+
+            isLodChanged = true;
+            continue;
+        }
+
+        isProductMeshed = m_setProductMeshing.erase(result.product) > 0 || isProductMeshed;
+        if (!result.meshed) {
+            // Meshing cancelled, the product can't be displayed
+            for (PendingMapping& mapping : m_vecPendingMapping) {
+                auto itLeafEnd = std::remove_if(
+                    mapping.vecLeafNodeId.begin(), mapping.vecLeafNodeId.end(),
+                    [&](TreeNodeId id) { return docModelTree.nodeData(id) == result.product; }
+                );
+                mapping.vecLeafNodeId.erase(itLeafEnd, mapping.vecLeafNodeId.end());
+            }
+        }
+    }
+
+    if (!vecResultDelayed.empty()) {
+        std::lock_guard<std::mutex> lock(m_meshTaskQueue->mutex);
+        for (MeshTaskQueue::Result& result : vecResultDelayed)
+            m_meshTaskQueue->vecResult.push_back(std::move(result));
+    }
+
+    if (lockLod.owns_lock())
+        lockLod.unlock();
+
+    if (isLodChanged)
+        this->updateLevelOfDetail();
+
+    if (isProductMeshed)
+        this->signalProductsMeshed.send();
+}
+
+void GuiDocument::unpinDeferredMeshData(const GraphicsEntity& gfxEntity)
+{
+    for (const auto& [gfxObject, shape] : gfxEntity.mapGfxObjectDeferredMeshShape) {
+        if (GraphicsUtils::AisObject_isVisible(gfxObject))
+            BRepDeferredMesh::unpin(shape);
+    }
 }
 
 void GuiDocument::unmapEntity(TreeNodeId entityTreeNodeId)
 {
+    auto itMappingEnd = std::remove_if(
+        m_vecPendingMapping.begin(), m_vecPendingMapping.end(),
+        [=](const PendingMapping& mapping) { return mapping.entityTreeNodeId == entityTreeNodeId; }
+    );
+    m_vecPendingMapping.erase(itMappingEnd, m_vecPendingMapping.end());
+
     {   // Delete entity graphics
         const GraphicsEntity* ptrItem = this->findGraphicsEntity(entityTreeNodeId);
         if (!ptrItem)
             return;
 
-        for (const GraphicsEntity::Object& object : ptrItem->vecObject)
+        this->unpinDeferredMeshData(*ptrItem);
+
+        for (const GraphicsEntity::Object& object : ptrItem->vecObject) {
             m_gfxScene.eraseObject(object.ptr);
+            m_mapGfxObjectTreeNode.erase(object.ptr);
+            m_mapGfxObjectBndBox.erase(object.ptr);
+        }
+
+        for (const OccHandle<AIS_MergedParts>& batch : ptrItem->vecMergedBatch)
+            m_gfxScene.eraseObject(batch);
+
+        m_isGfxVisibleBoundingBoxValid = false;
 
         const auto indexItem = ptrItem - &m_vecGraphicsEntity.front();
         m_vecGraphicsEntity.erase(m_vecGraphicsEntity.begin() + indexItem);
@@ -716,6 +1631,22 @@ void GuiDocument::unmapEntity(TreeNodeId entityTreeNodeId)
     });
 }
 
+void GuiDocument::foreachMergedPart(
+        TreeNodeId nodeId, const std::function<void(const OccHandle<AIS_MergedParts>&, int)>& fn
+    ) const
+{
+    const Tree<TDF_Label>& docModelTree = m_document->modelTree();
+    const GraphicsEntity* gfxEntity = this->findGraphicsEntity(docModelTree.nodeRoot(nodeId));
+    if (!gfxEntity || gfxEntity->mapTreeNodeMergedPart.empty())
+        return;
+
+    traverseTree(nodeId, docModelTree, [&](TreeNodeId id) {
+        auto itPart = gfxEntity->mapTreeNodeMergedPart.find(id);
+        if (itPart != gfxEntity->mapTreeNodeMergedPart.cend())
+            fn(gfxEntity->vecMergedBatch.at(itPart->second.batchIndex), itPart->second.partIndex);
+    });
+}
+
 const GuiDocument::GraphicsEntity* GuiDocument::findGraphicsEntity(TreeNodeId entityTreeNodeId) const
 {
     auto itFound = std::find_if(
@@ -726,6 +1657,12 @@ const GuiDocument::GraphicsEntity* GuiDocument::findGraphicsEntity(TreeNodeId en
     return itFound != m_vecGraphicsEntity.cend() ? &(*itFound) : nullptr;
 }
 
+GuiDocument::GraphicsEntity* GuiDocument::findGraphicsEntity(TreeNodeId entityTreeNodeId)
+{
+    const GuiDocument* constThis = this;
+    return const_cast<GraphicsEntity*>(constThis->findGraphicsEntity(entityTreeNodeId));
+}
+
 void GuiDocument::v3dViewTrihedronDisplay(Aspect_TypeOfTriedronPosition corner)
 {
     const double scale = 0.075 * m_devicePixelRatio;
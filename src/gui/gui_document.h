@@ -6,25 +6,36 @@
 
 #pragma once
 
+#include "../base/brep_mesh_lod.h"
+#include "../base/caf_utils.h"
 #include "../base/document.h"
 #include "../base/global.h"
 #include "../base/signal.h"
+#include "../graphics/ais_merged_parts.h"
 #include "../graphics/graphics_object_driver.h"
+#include "../graphics/graphics_owner_ptr.h"
 #include "../graphics/graphics_scene.h"
 #include "../graphics/graphics_view_ptr.h"
 #include "v3d_view_camera_animation.h"
 
 #include <Aspect_TypeOfTriedronPosition.hxx>
 #include <Bnd_Box.hxx>
+#include <TopoDS_Shape.hxx>
 #include <V3d_View.hxx>
+#include <chrono>
 #include <functional>
+#include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace Mayo {
 
+class AIS_PointCloudLod;
 class ApplicationItem;
 class GuiApplication;
+class TaskManager;
+class TaskProgress;
 class V3dViewCameraAnimation;
 
 // Provides the link between Base::Document and graphical representations(called "graphics objects")
@@ -75,6 +86,8 @@ public:
 
     // Finds the tree node id associated to graphics object
     TreeNodeId nodeFromGraphicsObject(const GraphicsObjectPtr& gfxObject) const;
+    // Finds the tree node id associated to graphics owner, this includes parts of merged display
+    TreeNodeId nodeFromGraphicsOwner(const GraphicsOwnerPtr& gfxOwner) const;
 
     // Toggles selected status of an application item(doesn't affect Application's selection model)
     void toggleItemSelected(const ApplicationItem& appItem);
@@ -86,6 +99,13 @@ public:
     int activeDisplayMode(const GraphicsObjectDriverPtr& driver) const;
     void setActiveDisplayMode(const GraphicsObjectDriverPtr& driver, int mode);
 
+    // -- View state(camera and display modes)
+    // Stores view state into the base document, so it's saved along with the document contents
+    void storeViewState();
+    // Restores view state previously stored in the base document, typically once the document
+    // has been reopened. Returns false if the document holds no view state
+    bool restoreViewState();
+
     // -- Visible state of document's tree nodes
     CheckState nodeVisibleState(TreeNodeId nodeId) const;
     void setNodeVisible(TreeNodeId nodeId, bool on);
@@ -94,6 +114,54 @@ public:
     double explodingFactor() const { return m_explodingFactor; }
     void setExplodingFactor(double t); // Must be in [0,1]
 
+    // -- Progressive graphics mapping
+    // By default all the graphics objects of an entity are created as soon as the entity is added
+    // to the document. With progressive mapping they're created by processPendingGraphicsMapping()
+    // which has to be called periodically(eg each frame) with some time budget, so the 3D view
+    // stays interactive while a big model is loaded
+    // BRep products without triangulation are meshed in background tasks, their graphics objects
+    // are created as soon as meshing is done
+    struct ProgressiveMapping {
+        // Runs the background meshing tasks(can't be null)
+        TaskManager* taskMgr = nullptr;
+        // Computes the triangulation of a BRep product, called from worker thread
+        std::function<void(const TopoDS_Shape&, TaskProgress*)> fnMeshShape;
+        // Optional, computes a finer level of detail once all products of an entity got meshed
+        // Called from worker thread
+        std::function<BRepMeshLod::Level(const TopoDS_Shape&, TaskProgress*)> fnMeshShapeFineLevel;
+    };
+    bool isProgressiveMappingEnabled() const { return m_progressiveMapping.taskMgr != nullptr; }
+    void enableProgressiveMapping(const ProgressiveMapping& params);
+    bool hasPendingGraphicsMapping() const;
+    // Whether BRep products below tree node 'nodeId'(included) are still meshed by background tasks
+    bool hasPendingMeshing(TreeNodeId nodeId) const;
+    void processPendingGraphicsMapping(std::chrono::milliseconds budget);
+    // Stops background meshing and drops graphics objects not created yet
+    void cancelPendingGraphicsMapping();
+
+    // -- Merged display
+    // Small BRep parts sharing the same color are batched in AIS_MergedParts objects, so assemblies
+    // made of many parts are drawn with a few draw calls instead of one per part
+    // Merged parts are still picked, highlighted and hidden individually. But they can't be measured,
+    // they aren't exploded, their face boundaries aren't drawn and they keep the mesh available when mapped
+    // Applies to the entities mapped afterwards
+    struct MergedDisplay {
+        bool enabled = false;
+        int maxPartTriangleCount = 5000; // Bigger parts get their own graphics object
+        int maxBatchTriangleCount = 1000000;
+    };
+    const MergedDisplay& mergedDisplay() const { return m_mergedDisplay; }
+    void setMergedDisplay(const MergedDisplay& params);
+
+    // -- Level of detail of BRep meshes(see BRepMeshLod) and huge point clouds(see AIS_PointCloudLod)
+    // Selects for each product the coarsest level of detail whose screen-space error(ie chordal
+    // deflection projected in the 3D view) doesn't exceed lodScreenSpaceError() pixels
+    // Octree nodes of point clouds to be displayed are selected as well
+    // Should be called once the view camera has changed(eg at the end of some navigation)
+    void updateLevelOfDetail();
+    double lodScreenSpaceError() const { return m_lodScreenSpaceError; }
+    void setLodScreenSpaceError(double pixels);
+
     // -- Visibility of trihedron at world origin
     bool isOriginTrihedronVisible() const;
     void toggleOriginTrihedronVisibility();
@@ -134,6 +202,8 @@ public:
     mutable Signal<const Bnd_Box&> signalGraphicsBoundingBoxChanged;
     mutable Signal<ViewTrihedronMode> signalViewTrihedronModeChanged;
     mutable Signal<Aspect_TypeOfTriedronPosition> signalViewTrihedronCornerChanged;
+    mutable Signal<> signalGraphicsMappingPending; // Progressive mapping has some work queued
+    mutable Signal<> signalProductsMeshed; // Some products got out of hasPendingMeshing()
 
     // -- Implementation
 private:
@@ -141,7 +211,7 @@ private:
     void onDocumentEntityAboutToBeDestroyed(TreeNodeId entityTreeNodeId);
     void onGraphicsSelectionChanged();
 
-    void mapEntity(TreeNodeId entityTreeNodeId);
+    void mapEntity(TreeNodeId entityTreeNodeId, bool fitViewOnceMapped = false);
     void unmapEntity(TreeNodeId entityTreeNodeId);
 
     struct GraphicsEntity {
@@ -152,14 +222,79 @@ private:
             Bnd_Box bndBox;
         };
 
+        struct ProductLod {
+            TopoDS_Shape shape;
+            GraphicsObjectPtr gfxProduct;
+            std::vector<size_t> vecObjectIndex; // Objects(in 'vecObject') showing the product
+            std::vector<double> vecLevelDeflection;
+            int activeLevel = 0;
+        };
+
         TreeNodeId treeNodeId;
         std::vector<Object> vecObject;
+        std::vector<ProductLod> vecProductLod;
         std::unordered_map<TreeNodeId, GraphicsObjectPtr> mapTreeNodeGfxObject;
-        std::unordered_map<GraphicsObjectPtr, TreeNodeId> mapGfxObjectTreeNode;
+        // Product shapes with deferred mesh data, pinned while the graphics object is visible
+        std::unordered_map<GraphicsObjectPtr, TopoDS_Shape> mapGfxObjectDeferredMeshShape;
+        // Parts of merged display, see MergedDisplay
+        struct MergedPart {
+            size_t batchIndex = 0; // In 'vecMergedBatch'
+            int partIndex = -1;
+        };
+        std::vector<OccHandle<AIS_MergedParts>> vecMergedBatch;
+        std::unordered_map<TreeNodeId, MergedPart> mapTreeNodeMergedPart;
         Bnd_Box bndBox;
     };
 
+    // Graphics mapping of an entity still in progress
+    struct PendingMapping {
+        TreeNodeId entityTreeNodeId = 0;
+        std::vector<TreeNodeId> vecLeafNodeId; // Leaf nodes whose graphics are still to be created
+        std::unordered_map<TDF_Label, GraphicsObjectPtr> mapLabelGfxProduct;
+        std::unordered_map<TDF_Label, size_t> mapLabelProductLodIndex;
+        std::unordered_set<TDF_Label> setLabelDeferredMesh;
+        std::vector<std::pair<Quantity_Color, size_t>> vecOpenMergedBatch; // Batches accepting parts, by color
+        std::unordered_set<size_t> setDirtyMergedBatch; // Batches where parts were added
+        std::chrono::steady_clock::time_point timeOpenMergedBatchUpdate; // Last display of the open batches
+        bool fitView = false;
+    };
+
+    // Results of background meshing tasks, shared with them
+    struct MeshTaskQueue;
+
+    void mapLeafNode(PendingMapping* mapping, GraphicsEntity* gfxEntity, TreeNodeId leafNodeId);
+    void addGraphicsProduct(
+            PendingMapping* mapping, GraphicsEntity* gfxEntity, const TDF_Label& label, const GraphicsObjectPtr& gfxProduct
+    );
+    // Creates the graphics objects of the products not yet mapped in 'spanLeafNodeId', concurrently for
+    // drivers supporting it(see GraphicsObjectDriver::isConcurrentCreationSupported())
+    void createGraphicsProducts(PendingMapping* mapping, GraphicsEntity* gfxEntity, Span<const TreeNodeId> spanLeafNodeId);
+    // Whether a non-root part product can be merged, regardless of its mesh
+    bool isMergedPartCandidate(const TDF_Label& productLabel) const;
+    // Adds the part of a leaf node to a batch of merged display, returns false if not eligible
+    bool mapMergedLeafNode(PendingMapping* mapping, GraphicsEntity* gfxEntity, TreeNodeId leafNodeId);
+    // Displays or recomputes the batches where parts were added. Open batches are kept as is unless
+    // 'includeOpenBatches' is true or they weren't updated for a while. Returns true if some batch was updated
+    bool updateMergedBatches(PendingMapping* mapping, GraphicsEntity* gfxEntity, bool includeOpenBatches);
+    void updateMergedBatch(const OccHandle<AIS_MergedParts>& batch);
+    void mapPendingLeafNodes(std::chrono::steady_clock::time_point deadline);
+    struct MeshTaskProduct {
+        TDF_Label label;
+        TopoDS_Shape shape;
+        bool isMergedPartCandidate = false; // Fine level of detail is then skipped
+    };
+    void runMeshTask(std::vector<MeshTaskProduct> vecProduct);
+    void runPointCloudOctreeTask(const TDF_Label& label, const OccHandle<AIS_PointCloudLod>& pntCloudLod);
+    void processMeshTaskResults();
+    void unpinDeferredMeshData(const GraphicsEntity& gfxEntity);
+
+    // Executes callback 'fn' on all merged parts associated to tree node 'nodeId'(deep node traversal)
+    void foreachMergedPart(
+            TreeNodeId nodeId, const std::function<void(const OccHandle<AIS_MergedParts>&, int)>& fn
+    ) const;
+
     const GraphicsEntity* findGraphicsEntity(TreeNodeId entityTreeNodeId) const;
+    GraphicsEntity* findGraphicsEntity(TreeNodeId entityTreeNodeId);
 
     void v3dViewTrihedronDisplay(Aspect_TypeOfTriedronPosition corner);
 
@@ -176,12 +311,26 @@ private:
     OccHandle<AIS_InteractiveObject> m_aisViewCube;
 
     std::vector<GraphicsEntity> m_vecGraphicsEntity;
+    std::unordered_map<GraphicsObjectPtr, TreeNodeId> m_mapGfxObjectTreeNode; // All entities
+    // Bounding box of each graphics object(all entities) with exploding transformation applied
+    std::unordered_map<GraphicsObjectPtr, Bnd_Box> m_mapGfxObjectBndBox;
     Bnd_Box m_gfxBoundingBox;
+    // Bounding box of the visible graphics objects, computed on demand
+    mutable Bnd_Box m_gfxVisibleBoundingBox;
+    mutable bool m_isGfxVisibleBoundingBoxValid = false;
 
     std::unordered_map<GraphicsObjectDriverPtr, int> m_mapGfxDriverDisplayMode;
     std::unordered_map<TreeNodeId, CheckState> m_mapTreeNodeCheckState;
 
     double m_explodingFactor = 0.;
+    double m_lodScreenSpaceError = 1.;
+    uint64_t m_lodUnpinCount = 0; // Last value of BRepMeshLod::unpinCount() seen
+
+    ProgressiveMapping m_progressiveMapping;
+    MergedDisplay m_mergedDisplay;
+    std::vector<PendingMapping> m_vecPendingMapping;
+    std::unordered_set<TDF_Label> m_setProductMeshing;
+    std::shared_ptr<MeshTaskQueue> m_meshTaskQueue;
 };
 
 } // namespace Mayo
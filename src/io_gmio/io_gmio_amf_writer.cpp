@@ -22,6 +22,7 @@
 #include "../base/xcaf.h"
 
 #include <BRep_Tool.hxx>
+#include <OSD_Parallel.hxx>
 #include <Poly_Triangulation.hxx>
 #include <gp_Quaternion.hxx>
 
@@ -31,7 +32,10 @@
 #include <gmio_stl/stl_error.h>
 
 #include <fmt/format.h>
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <functional>
 #include <unordered_map>
 
 namespace Mayo {
@@ -155,6 +159,26 @@ public:
                     fmt::format(textIdTr("Use the ZIP64 format extensions.\n"
                                          "Only applicable if option `{}` is on"),
                                 this->createZipArchive.label()));
+
+        this->zipCompressionLevel.setConstraintsEnabled(true);
+        this->zipCompressionLevel.setRange(0, 9);
+        this->zipCompressionLevel.setDescription(
+                    fmt::format(textIdTr("zlib compression level, from 0(no compression) to 9(best compression).\n"
+                                         "Only applicable if option `{}` is on"),
+                                this->createZipArchive.label()));
+
+        this->zipCompressionStrategy.mutableEnumeration().changeTrContext(this->textIdContext());
+        this->zipCompressionStrategy.setDescription(
+                    fmt::format(textIdTr("zlib compression strategy.\n"
+                                         "Only applicable if option `{}` is on"),
+                                this->createZipArchive.label()));
+        this->zipCompressionStrategy.setDescriptions({
+                    { ZipCompressionStrategy::Default, textIdTr("Default strategy, suited to XML text") },
+                    { ZipCompressionStrategy::Filtered, textIdTr("Favor Huffman coding over string matching") },
+                    { ZipCompressionStrategy::HuffmanOnly, textIdTr("Huffman coding only, fastest") },
+                    { ZipCompressionStrategy::Rle, textIdTr("Limit string matching to one distance(run-length encoding)") },
+                    { ZipCompressionStrategy::Fixed, textIdTr("Use fixed Huffman codes") }
+        });
     }
 
     void restoreDefaults() override
@@ -165,9 +189,13 @@ public:
         this->createZipArchive.setValue(params.createZipArchive);
         this->zipEntryFilename.setValue(params.zipEntryFilename);
         this->useZip64.setValue(params.useZip64);
+        this->zipCompressionLevel.setValue(params.zipCompressionLevel);
+        this->zipCompressionStrategy.setValue(params.zipCompressionStrategy);
 
         this->zipEntryFilename.setEnabled(this->createZipArchive);
         this->useZip64.setEnabled(this->createZipArchive);
+        this->zipCompressionLevel.setEnabled(this->createZipArchive);
+        this->zipCompressionStrategy.setEnabled(this->createZipArchive);
     }
 
     void onPropertyChanged(Property* prop) override
@@ -175,6 +203,8 @@ public:
         if (prop == &this->createZipArchive) {
             this->zipEntryFilename.setEnabled(this->createZipArchive);
             this->useZip64.setEnabled(this->createZipArchive);
+            this->zipCompressionLevel.setEnabled(this->createZipArchive);
+            this->zipCompressionStrategy.setEnabled(this->createZipArchive);
         }
 
         PropertyGroup::onPropertyChanged(prop);
@@ -185,11 +215,14 @@ public:
     PropertyBool createZipArchive{ this, textId("createZipArchive") };
     PropertyString zipEntryFilename{ this, textId("zipEntryFilename") };
     PropertyBool useZip64{ this, textId("useZip64") };
+    PropertyInt zipCompressionLevel{ this, textId("zipCompressionLevel") };
+    PropertyEnum<GmioAmfWriter::ZipCompressionStrategy> zipCompressionStrategy{ this, textId("zipCompressionStrategy") };
 };
 
 bool GmioAmfWriter::transfer(Span<const ApplicationItem> spanAppItem, TaskProgress* progress)
 {
     m_vecMaterial.clear();
+    m_mapColorMaterialId.clear();
     m_vecMesh.clear();
     m_vecObject.clear();
     m_vecInstance.clear();
@@ -205,46 +238,56 @@ bool GmioAmfWriter::transfer(Span<const ApplicationItem> spanAppItem, TaskProgre
         auto it = mapLabelObjectId.find(label);
         return it != mapLabelObjectId.cend() ? it->second : -1;
     };
+
+    // Paths of the assembly nodes, built from the path of the parent node so each node name is
+    // read once. Parents of the tree node items are resolved on first use
+    std::unordered_map<TreeNodeId, std::string> mapNodePath;
+    std::function<const std::string&(const Tree<TDF_Label>&, TreeNodeId)> fnNodePath;
+    fnNodePath = [&](const Tree<TDF_Label>& modelTree, TreeNodeId id) -> const std::string& {
+        auto it = mapNodePath.find(id);
+        if (it != mapNodePath.cend())
+            return it->second;
+
+        std::string path;
+        const TreeNodeId parentId = modelTree.nodeParent(id);
+        if (parentId != 0)
+            path = fnNodePath(modelTree, parentId) + '/';
+
+        const std::string name = to_stdString(CafUtils::labelAttrStdName(modelTree.nodeData(id)));
+        path += !name.empty() ? name : std::string("anonymous");
+        return mapNodePath.insert({ id, std::move(path) }).first->second;
+    };
+
     auto fnCreateObject = [&](const Tree<TDF_Label>& modelTree, TreeNodeId id) {
+        if (!modelTree.nodeIsLeaf(id))
+            return;
+
         const TDF_Label nodeLabel = modelTree.nodeData(id);
-        if (modelTree.nodeIsLeaf(id)) {
-            int objectId = fnFindObjectId(nodeLabel);
-            if (objectId == -1) {
-                objectId = this->createObject(nodeLabel);
-                if (objectId == -1)
-                    return;
-
-                mapLabelObjectId.insert({ nodeLabel, objectId });
-            }
+        int objectId = fnFindObjectId(nodeLabel);
+        if (objectId == -1) {
+            objectId = this->createObject(nodeLabel);
+            if (objectId == -1)
+                return;
 
-            std::string absoluteName;
-            TreeNodeId itParent = id;
-            do {
-                itParent = modelTree.nodeParent(itParent);
-                if (itParent != 0) {
-                    const std::string name = to_stdString(CafUtils::labelAttrStdName(modelTree.nodeData(itParent)));
-                    if (!name.empty())
-                        absoluteName += '/' + name;
-                    else
-                        absoluteName += "/anonymous";
-                }
-            } while (itParent != 0);
-
-            if (!absoluteName.empty()) {
-                absoluteName.erase(0, 1); // Remove starting '/'
-                Instance instance;
-                instance.objectId = objectId;
-                instance.trsf = XCaf::shapeAbsoluteLocation(modelTree, id);
-                instance.name = absoluteName;
-                m_vecInstance.push_back(std::move(instance));
-            }
+            mapLabelObjectId.insert({ nodeLabel, objectId });
+        }
+
+        const TreeNodeId parentId = modelTree.nodeParent(id);
+        if (parentId != 0) {
+            Instance instance;
+            instance.objectId = objectId;
+            instance.trsf = XCaf::shapeAbsoluteLocation(modelTree, id);
+            instance.name = fnNodePath(modelTree, parentId);
+            m_vecInstance.push_back(std::move(instance));
         }
     };
 
+    TaskProgress traverseProgress(progress, 40);
     for (const ApplicationItem& appItem : spanAppItem) {
         const auto appItemIndex = &appItem - &spanAppItem.front();
-        progress->setValue(MathUtils::toPercent(appItemIndex, 0, spanAppItem.size() - 1));
+        traverseProgress.setValue(MathUtils::toPercent(appItemIndex, 0, spanAppItem.size() - 1));
         const Tree<TDF_Label>& modelTree = appItem.document()->modelTree();
+        mapNodePath.clear(); // Node ids are specific to a model tree
         if (appItem.isDocument()) {
             traverseTree(modelTree, [&](TreeNodeId id) { fnCreateObject(modelTree, id); });
         }
@@ -255,7 +298,39 @@ bool GmioAmfWriter::transfer(Span<const ApplicationItem> spanAppItem, TaskProgre
         }
     }
 
-    return true;
+    TaskProgress prepareProgress(progress, 60);
+    this->prepareMeshes(&prepareProgress);
+    return !TaskProgress::isAbortRequested(progress);
+}
+
+void GmioAmfWriter::prepareMeshes(TaskProgress* progress)
+{
+    // Objects are independent, their meshes are prepared concurrently
+    std::atomic<int> preparedObjectCount = 0;
+    OSD_Parallel::For(0, int(m_vecObject.size()), [&](int objectIndex) {
+        if (progress->isAbortRequested())
+            return;
+
+        const Object& object = m_vecObject.at(objectIndex);
+        for (int meshId = object.firstMeshId; meshId <= object.lastMeshId; ++meshId) {
+            Mesh& mesh = m_vecMesh.at(meshId);
+            const gp_Trsf& trsf = mesh.location.Transformation();
+            const bool isIdentity = mesh.location.IsIdentity();
+            mesh.vecNode.resize(mesh.triangulation->NbNodes());
+            for (int i = 1; i <= mesh.triangulation->NbNodes(); ++i) {
+                gp_XYZ coords = mesh.triangulation->Node(i).XYZ();
+                if (!isIdentity)
+                    trsf.Transforms(coords);
+
+                mesh.vecNode.at(i - 1) = coords;
+            }
+        }
+
+        // Only the thread completing the count reports, TaskProgress isn't thread-safe
+        const int count = ++preparedObjectCount;
+        if (count == int(m_vecObject.size()))
+            progress->setValue(100);
+    });
 }
 
 bool GmioAmfWriter::writeFile(const FilePath& filepath, TaskProgress* progress)
@@ -281,6 +356,20 @@ bool GmioAmfWriter::writeFile(const FilePath& filepath, TaskProgress* progress)
         }
         return GMIO_FLOAT_TEXT_FORMAT_DECIMAL_UPPERCASE;
     };
+    auto fnZlibCompressLevel = [](int level) {
+        // gmio maps level 0 to zlib default compression
+        return level <= 0 ? GMIO_ZLIB_COMPRESS_LEVEL_NONE : static_cast<gmio_zlib_compress_level>(std::min(level, 9));
+    };
+    auto fnZlibCompressStrategy = [](ZipCompressionStrategy strategy) {
+        switch (strategy) {
+        case ZipCompressionStrategy::Default:     return GMIO_ZLIB_COMPRESSION_STRATEGY_DEFAULT;
+        case ZipCompressionStrategy::Filtered:    return GMIO_ZLIB_COMPRESSION_STRATEGY_FILTERED;
+        case ZipCompressionStrategy::HuffmanOnly: return GMIO_ZLIB_COMPRESSION_STRATEGY_HUFFMAN_ONLY;
+        case ZipCompressionStrategy::Rle:         return GMIO_ZLIB_COMPRESSION_STRATEGY_RLE;
+        case ZipCompressionStrategy::Fixed:       return GMIO_ZLIB_COMPRESSION_STRATEGY_FIXED;
+        }
+        return GMIO_ZLIB_COMPRESSION_STRATEGY_DEFAULT;
+    };
 
     gmio_amf_write_options amfOptions = {};
     amfOptions.task_iface.cookie = progress;
@@ -292,7 +381,8 @@ bool GmioAmfWriter::writeFile(const FilePath& filepath, TaskProgress* progress)
     amfOptions.dont_use_zip64_extensions = !m_params.useZip64;
     amfOptions.zip_entry_filename = m_params.zipEntryFilename.c_str();
     amfOptions.zip_entry_filename_len = CppUtils::safeStaticCast<uint16_t>(m_params.zipEntryFilename.size());
-    // TODO Handle gmio_amf_write_options::z_compress_options
+    amfOptions.z_compress_options.level = fnZlibCompressLevel(m_params.zipCompressionLevel);
+    amfOptions.z_compress_options.strategy = fnZlibCompressStrategy(m_params.zipCompressionStrategy);
     const int error = gmio_amf_write_file(filepath.u8string().c_str(), &amfDoc, &amfOptions);
     return gmio_no_error(error);
 }
@@ -311,6 +401,8 @@ void GmioAmfWriter::applyProperties(const PropertyGroup* group)
         m_params.createZipArchive = ptr->createZipArchive;
         m_params.zipEntryFilename = ptr->zipEntryFilename;
         m_params.useZip64 = ptr->useZip64;
+        m_params.zipCompressionLevel = ptr->zipCompressionLevel;
+        m_params.zipCompressionStrategy = ptr->zipCompressionStrategy;
     }
 }
 
@@ -346,23 +438,8 @@ int GmioAmfWriter::createObject(const TDF_Label& labelShape)
     // Object material
     int materialId = -1;
     DocumentPtr doc = Document::findFrom(labelShape);
-    if (doc && doc->xcaf().hasShapeColor(labelShape)) {
-        const Quantity_Color color = doc->xcaf().shapeColor(labelShape);
-        auto itColor = std::find_if(m_vecMaterial.cbegin(), m_vecMaterial.cend(), [=](const Material& mat) {
-            return mat.color == color;
-        });
-        if (itColor != m_vecMaterial.cend()) {
-            materialId = CppUtils::safeStaticCast<int>(itColor - m_vecMaterial.cbegin());
-        }
-        else {
-            materialId = CppUtils::safeStaticCast<int>(m_vecMaterial.size());
-            Material material;
-            material.id = materialId;
-            material.color = color;
-            material.isColor = true;
-            m_vecMaterial.push_back(std::move(material));
-        }
-    }
+    if (doc && doc->xcaf().hasShapeColor(labelShape))
+        materialId = this->findOrCreateMaterial(doc->xcaf().shapeColor(labelShape));
 
     // Add object
     Object object;
@@ -375,6 +452,31 @@ int GmioAmfWriter::createObject(const TDF_Label& labelShape)
     return m_vecObject.back().id;
 }
 
+int GmioAmfWriter::findOrCreateMaterial(const Quantity_Color& color)
+{
+    const ColorKey key = { color.Red(), color.Green(), color.Blue() };
+    auto it = m_mapColorMaterialId.find(key);
+    if (it != m_mapColorMaterialId.cend())
+        return it->second;
+
+    Material material;
+    material.id = CppUtils::safeStaticCast<int>(m_vecMaterial.size());
+    material.color = color;
+    material.isColor = true;
+    m_vecMaterial.push_back(std::move(material));
+    m_mapColorMaterialId.insert({ key, m_vecMaterial.back().id });
+    return m_vecMaterial.back().id;
+}
+
+size_t GmioAmfWriter::ColorKeyHash::operator()(const ColorKey& key) const
+{
+    size_t h = 0;
+    for (double value : key)
+        h = h * 31 + std::hash<double>{}(value);
+
+    return h;
+}
+
 const GmioAmfWriter* GmioAmfWriter::from(const void* cookie) {
     return static_cast<const GmioAmfWriter*>(cookie);
 }
@@ -446,12 +548,12 @@ void GmioAmfWriter::amf_getObjectMeshElement(
     const Object& object = writer->m_vecObject.at(elementIndex->object_index);
     const Mesh& mesh = writer->m_vecMesh.at(object.firstMeshId + elementIndex->mesh_index);
     if (elementIndex->element_type == GMIO_AMF_MESH_ELEMENT_VERTEX) {
-        const gp_Pnt& pnt = mesh.triangulation->Node(elementIndex->value + 1);
+        const gp_XYZ& coords = mesh.vecNode.at(elementIndex->value);
         auto amfVertex = static_cast<gmio_amf_vertex*>(ptrElement);
         *amfVertex = {};
-        amfVertex->coords.x = pnt.X();
-        amfVertex->coords.y = pnt.Y();
-        amfVertex->coords.z = pnt.Z();
+        amfVertex->coords.x = coords.X();
+        amfVertex->coords.y = coords.Y();
+        amfVertex->coords.z = coords.Z();
     }
     else if (elementIndex->element_type == GMIO_AMF_MESH_ELEMENT_VOLUME) {
         auto amfVolume = static_cast<gmio_amf_volume*>(ptrElement);
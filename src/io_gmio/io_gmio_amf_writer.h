@@ -14,7 +14,10 @@
 #include <TopLoc_Location.hxx>
 
 #include <gmio_amf/amf_document.h>
+#include <array>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace Mayo {
@@ -22,6 +25,8 @@ namespace IO {
 
 // gmio-based writer for AMF format
 // Requires gmio >= v0.4.0
+// Meshes of the objects are prepared concurrently by transfer(), gmio then only reads them while
+// generating the XML contents
 class GmioAmfWriter : public Writer {
 public:
     bool transfer(Span<const ApplicationItem> spanAppItem, TaskProgress* progress) override;
@@ -38,6 +43,14 @@ public:
         Shortest // -> GMIO_FLOAT_TEXT_FORMAT_SHORTEST_UPPERCASE
     };
 
+    enum class ZipCompressionStrategy {
+        Default, // -> GMIO_ZLIB_COMPRESSION_STRATEGY_DEFAULT
+        Filtered, // -> GMIO_ZLIB_COMPRESSION_STRATEGY_FILTERED
+        HuffmanOnly, // -> GMIO_ZLIB_COMPRESSION_STRATEGY_HUFFMAN_ONLY
+        Rle, // -> GMIO_ZLIB_COMPRESSION_STRATEGY_RLE
+        Fixed // -> GMIO_ZLIB_COMPRESSION_STRATEGY_FIXED
+    };
+
     struct Parameters {
         // TODO gmio_amf_unit
         FloatTextFormat float64Format = FloatTextFormat::Decimal;
@@ -45,12 +58,25 @@ public:
         bool createZipArchive = false;
         bool useZip64 = true;
         std::string zipEntryFilename; // UTF8
+        int zipCompressionLevel = 6; // 0(no compression) to 9(best compression)
+        ZipCompressionStrategy zipCompressionStrategy = ZipCompressionStrategy::Default;
     };
     Parameters& parameters() { return m_params; }
     const Parameters& constParameters() const { return m_params; }
 
+    // Results of transfer()
+    // Material 0 is the default one, others are created once per distinct shape color
+    int materialCount() const { return int(m_vecMaterial.size()); }
+    int objectCount() const { return int(m_vecObject.size()); }
+    int instanceCount() const { return int(m_vecInstance.size()); }
+    // Path of the assembly nodes from the root, separated with '/'
+    std::string_view instanceName(int index) const { return m_vecInstance.at(index).name; }
+    int instanceObjectId(int index) const { return m_vecInstance.at(index).objectId; }
+
 private:
     int createObject(const TDF_Label& labelShape);
+    int findOrCreateMaterial(const Quantity_Color& color);
+    void prepareMeshes(TaskProgress* progress);
 
     static const GmioAmfWriter* from(const void* cookie);
 
@@ -115,11 +141,19 @@ private:
         OccHandle<Poly_Triangulation> triangulation;
         TopLoc_Location location;
         int materialId = -1;
+        std::vector<gp_XYZ> vecNode; // Location applied, filled by prepareMeshes()
+    };
+
+    // Exact RGB values of a color, used as key of the material map
+    using ColorKey = std::array<double, 3>;
+    struct ColorKeyHash {
+        size_t operator()(const ColorKey& key) const;
     };
 
     class Properties;
     Parameters m_params;
     std::vector<Material> m_vecMaterial;
+    std::unordered_map<ColorKey, int, ColorKeyHash> m_mapColorMaterialId;
     std::vector<Mesh> m_vecMesh;
     std::vector<Object> m_vecObject;
     std::vector<Instance> m_vecInstance;
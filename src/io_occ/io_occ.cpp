@@ -82,6 +82,8 @@ PtrPropertyGroup OccFactoryReader::createProperties(Format format, PropertyGroup
         return OccStepReader::createProperties(parentGroup);
     if (format == Format_IGES)
         return OccIgesReader::createProperties(parentGroup);
+    if (format == Format_STL)
+        return OccStlReader::createProperties(parentGroup);
 
 #if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 4, 0)
     if (format == Format_GLTF)
@@ -144,6 +146,8 @@ PtrPropertyGroup OccFactoryWriter::createProperties(Format format, PropertyGroup
         return OccStepWriter::createProperties(parentGroup);
     if (format == Format_IGES)
         return OccIgesWriter::createProperties(parentGroup);
+    if (format == Format_OCCBREP)
+        return OccBRepWriter::createProperties(parentGroup);
     if (format == Format_STL)
         return OccStlWriter::createProperties(parentGroup);
     if (format == Format_VRML)
@@ -13,6 +13,11 @@
 #include "../base/tkernel_utils.h"
 
 #include <RWMesh_CafReader.hxx>
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+#  include <XCAFDoc_DocumentTool.hxx>
+#  include <XCAFDoc_Editor.hxx>
+#  include <XCAFDoc_ShapeTool.hxx>
+#endif
 
 namespace Mayo {
 namespace IO {
@@ -66,19 +71,66 @@ OccBaseMeshReaderProperties::LengthUnit OccBaseMeshReaderProperties::lengthUnit(
     return LengthUnit::Undefined;
 }
 
-bool OccBaseMeshReader::readFile(const FilePath& filepath, TaskProgress* /*progress*/)
+namespace {
+
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+// Returns the top-level free shapes of XCAF document 'doc'
+TDF_LabelSequence freeShapes(const OccHandle<TDocStd_Document>& doc)
+{
+    TDF_LabelSequence seq;
+    XCAFDoc_DocumentTool::ShapeTool(doc->Main())->GetFreeShapes(seq);
+    return seq;
+}
+#endif
+
+} // namespace
+
+bool OccBaseMeshReader::readFile(const FilePath& filepath, [[maybe_unused]] TaskProgress* progress)
 {
     m_filepath = filepath;
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+    // Staging document isn't bound to any application, so it can be filled from any thread
+    m_stagingDoc = makeOccHandle<TDocStd_Document>("BinXCAF");
+    XCAFDoc_DocumentTool::Set(m_stagingDoc->Main(), false);
+    this->applyParameters();
+    m_reader.SetDocument(m_stagingDoc);
+    auto indicator = makeOccHandle<OccProgressIndicator>(progress);
+    m_reader.Perform(m_filepath.u8string().c_str(), TKernelUtils::start(indicator));
+    // Perform() may report failure although some shapes were read(eg missing external buffer)
+    return !freeShapes(m_stagingDoc).IsEmpty();
+#else
     return true;
+#endif
 }
 
 TDF_LabelSequence OccBaseMeshReader::transfer(DocumentPtr doc, TaskProgress* progress)
 {
+    const TDF_LabelSequence seqMark = doc->xcaf().topLevelFreeShapes();
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+    if (!m_stagingDoc)
+        return {};
+
+    // Shapes and their triangulations are shared, only the labels and attributes are copied
+    // Extracted shapes become free shapes of the target document
+    XCAFDoc_Editor::Extract(freeShapes(m_stagingDoc), XCAFDoc_DocumentTool::ShapesLabel(doc->Main()));
+
+    // Length unit is set by the reader on the staging document, target one keeps its unit if any
+    double lengthUnit = 1.;
+    double targetLengthUnit = 1.;
+    if (XCAFDoc_DocumentTool::GetLengthUnit(m_stagingDoc, lengthUnit)
+            && !XCAFDoc_DocumentTool::GetLengthUnit(doc, targetLengthUnit))
+    {
+        XCAFDoc_DocumentTool::SetLengthUnit(doc, lengthUnit);
+    }
+
+    m_stagingDoc.Nullify();
+    progress->setValue(100);
+#else
     this->applyParameters();
     m_reader.SetDocument(doc);
-    const TDF_LabelSequence seqMark = doc->xcaf().topLevelFreeShapes();
     auto indicator = makeOccHandle<OccProgressIndicator>(progress);
     m_reader.Perform(m_filepath.u8string().c_str(), TKernelUtils::start(indicator));
+#endif
     return doc->xcaf().diffTopLevelFreeShapes(seqMark);
 }
 
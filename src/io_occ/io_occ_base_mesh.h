@@ -12,12 +12,16 @@
 #include "../base/property_enumeration.h"
 
 #include <RWMesh_CoordinateSystem.hxx>
+#include <TDocStd_Document.hxx>
 class RWMesh_CafReader;
 
 namespace Mayo {
 namespace IO {
 
 // Base class around OpenCascade RWMesh_CafReader
+// With OpenCascade >= v7.6.0 the file is parsed by readFile() into a private staging document, so
+// parsing of many files can run concurrently. transfer() then just copies the staged labels into
+// the target document
 class OccBaseMeshReader : public Reader {
 public:
     bool readFile(const FilePath& filepath, TaskProgress* progress) override;
@@ -41,6 +45,7 @@ protected:
 private:
     FilePath m_filepath;
     RWMesh_CafReader& m_reader;
+    OccHandle<TDocStd_Document> m_stagingDoc;
 };
 
 // Common properties for OccBaseMeshReader
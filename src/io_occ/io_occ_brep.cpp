@@ -13,28 +13,125 @@
 #include "../base/filepath_conv.h"
 #include "../base/occ_progress_indicator.h"
 #include "../base/io_system.h"
+#include "../base/property_builtins.h"
+#include "../base/property_enumeration.h"
 #include "../base/task_progress.h"
 #include "../base/tkernel_utils.h"
 
+#include <BinTools.hxx>
 #include <BRep_Builder.hxx>
 #include <BRepTools.hxx>
 #include <TDataStd_Name.hxx>
 
+#include <fmt/format.h>
+#include <algorithm>
+#include <fstream>
+#include <string_view>
+#include <vector>
+
 namespace Mayo {
 namespace IO {
 
+namespace {
+
+// Size of the buffer used by file streams, BRep readers/writers do many small I/O operations
+constexpr size_t FileStreamBufferSize = 1024 * 1024;
+
+// Whether 'istr' contains binary BRep data(BinTools), stream position is left unchanged
+bool isBinaryBRep(std::istream& istr)
+{
+    // Header of binary shape set, written by BinTools_ShapeSet
+    constexpr std::string_view binaryHeader = "Open CASCADE Topology V";
+    char buff[256] = {};
+    const auto pos = istr.tellg();
+    istr.read(buff, std::size(buff));
+    const std::string_view strBuff(buff, istr.gcount());
+    istr.clear();
+    istr.seekg(pos);
+    return strBuff.find(binaryHeader) != std::string_view::npos;
+}
+
+} // namespace
+
+class OccBRepWriter::Properties : public PropertyGroup {
+    MAYO_DECLARE_TEXT_ID_FUNCTIONS(Mayo::IO::OccBRepWriter::Properties)
+public:
+    Properties(PropertyGroup* parentGroup)
+        : PropertyGroup(parentGroup)
+    {
+        this->format.mutableEnumeration().changeTrContext(OccBRepWriter::Properties::textIdContext());
+        this->format.setDescription(
+                    textIdTr("Binary variant(BinTools) is faster to read/write and smaller on disk")
+        );
+        this->withTriangles.setDescription(textIdTr("Write triangulations of BRep faces"));
+        this->withNormals.setDescription(
+                    fmt::format(textIdTr("Write normals of triangulations.\n\n"
+                                         "Applicable only if option `{}` is on"),
+                                this->withTriangles.label()
+                    )
+        );
+    }
+
+    void restoreDefaults() override
+    {
+        const Parameters defaults;
+        this->format.setValue(defaults.format);
+        this->withTriangles.setValue(defaults.withTriangles);
+        this->withNormals.setValue(defaults.withNormals);
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+        this->withNormals.setEnabled(this->withTriangles);
+#else
+        this->withTriangles.setEnabled(false);
+        this->withNormals.setEnabled(false);
+#endif
+    }
+
+    void onPropertyChanged(Property* prop) override
+    {
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+        if (prop == &this->withTriangles)
+            this->withNormals.setEnabled(this->withTriangles);
+#endif
+
+        PropertyGroup::onPropertyChanged(prop);
+    }
+
+    PropertyEnum<OccBRepWriter::Format> format{ this, textId("format") };
+    PropertyBool withTriangles{ this, textId("withTriangles") };
+    PropertyBool withNormals{ this, textId("withNormals") };
+};
+
 bool OccBRepReader::readFile(const FilePath& filepath, TaskProgress* progress)
 {
     m_shape.Nullify();
     m_baseFilename = filepath.stem();
-    BRep_Builder brepBuilder;
+    std::vector<char> buffer(FileStreamBufferSize);
+    std::ifstream ifs;
+    ifs.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+    ifs.open(filepath, std::ios::in | std::ios::binary);
+    if (!ifs.is_open())
+        return false;
+
+    return this->readStream(ifs, progress);
+}
+
+bool OccBRepReader::readStream(std::istream& istr, TaskProgress* progress)
+{
+    m_shape.Nullify();
     auto indicator = makeOccHandle<OccProgressIndicator>(progress);
-    return BRepTools::Read(
-        m_shape,
-        filepath.u8string().c_str(),
-        brepBuilder,
-        TKernelUtils::start(indicator)
-    );
+    if (isBinaryBRep(istr)) {
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 5, 0)
+        BinTools::Read(m_shape, istr, TKernelUtils::start(indicator));
+#else
+        BinTools::Read(m_shape, istr);
+#endif
+    }
+    else {
+        BRep_Builder brepBuilder;
+        BRepTools::Read(m_shape, istr, brepBuilder, TKernelUtils::start(indicator));
+    }
+
+    return !m_shape.IsNull();
 }
 
 TDF_LabelSequence OccBRepReader::transfer(DocumentPtr doc, TaskProgress* /*progress*/)
@@ -79,9 +176,72 @@ bool OccBRepWriter::transfer(Span<const ApplicationItem> appItems, TaskProgress*
 }
 
 bool OccBRepWriter::writeFile(const FilePath& filepath, TaskProgress* progress)
+{
+    std::vector<char> buffer(FileStreamBufferSize);
+    std::ofstream ofs;
+    ofs.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+    ofs.open(filepath, std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!ofs.is_open())
+        return false;
+
+    const bool ok = this->writeStream(ofs, progress);
+    ofs.close();
+    return ok && !ofs.fail();
+}
+
+bool OccBRepWriter::writeStream(std::ostream& ostr, TaskProgress* progress)
 {
     auto indicator = makeOccHandle<OccProgressIndicator>(progress);
-    return BRepTools::Write(m_shape, filepath.u8string().c_str(), TKernelUtils::start(indicator));
+    if (m_params.format == Format::Binary) {
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+        const bool withNormals = m_params.withTriangles && m_params.withNormals;
+        BinTools::Write(
+            m_shape,
+            ostr,
+            m_params.withTriangles,
+            withNormals,
+            withNormals ? BinTools_FormatVersion_VERSION_3 : BinTools_FormatVersion_CURRENT,
+            TKernelUtils::start(indicator)
+        );
+#elif OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 5, 0)
+        BinTools::Write(m_shape, ostr, TKernelUtils::start(indicator));
+#else
+        BinTools::Write(m_shape, ostr);
+#endif
+    }
+    else {
+        ostr << "DBRep_DrawableShape\n"; // Same header as BRepTools::Write(filepath), for Draw
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+        const bool withNormals = m_params.withTriangles && m_params.withNormals;
+        BRepTools::Write(
+            m_shape,
+            ostr,
+            m_params.withTriangles,
+            withNormals,
+            withNormals ? TopTools_FormatVersion_VERSION_3 : TopTools_FormatVersion_CURRENT,
+            TKernelUtils::start(indicator)
+        );
+#else
+        BRepTools::Write(m_shape, ostr, TKernelUtils::start(indicator));
+#endif
+    }
+
+    return !ostr.fail();
+}
+
+std::unique_ptr<PropertyGroup> OccBRepWriter::createProperties(PropertyGroup* parentGroup)
+{
+    return std::make_unique<Properties>(parentGroup);
+}
+
+void OccBRepWriter::applyProperties(const PropertyGroup* params)
+{
+    auto ptr = dynamic_cast<const Properties*>(params);
+    if (ptr) {
+        m_params.format = ptr->format;
+        m_params.withTriangles = ptr->withTriangles;
+        m_params.withNormals = ptr->withNormals;
+    }
 }
 
 } // namespace IO
@@ -9,17 +9,22 @@
 #include "../base/io_reader.h"
 #include "../base/io_writer.h"
 #include <TopoDS_Shape.hxx>
+#include <iosfwd>
 
 namespace Mayo {
 namespace IO {
 
-// Reader for OpenCascade BRep file format
+// Reader for OpenCascade BRep file format, text and binary(BinTools) variants are supported
 class OccBRepReader : public Reader {
 public:
     bool readFile(const FilePath& filepath, TaskProgress* progress) override;
     TDF_LabelSequence transfer(DocumentPtr doc, TaskProgress* progress) override;
     void applyProperties(const PropertyGroup*) override {}
 
+    // Reads BRep shape from 'istr', variant(text or binary) is detected from the header
+    // Stream must be opened in binary mode
+    bool readStream(std::istream& istr, TaskProgress* progress);
+
 private:
     TopoDS_Shape m_shape;
     FilePath m_baseFilename;
@@ -30,9 +35,27 @@ class OccBRepWriter : public Writer {
 public:
     bool transfer(Span<const ApplicationItem> appItems, TaskProgress* progress) override;
     bool writeFile(const FilePath& filepath, TaskProgress* progress) override;
-    void applyProperties(const PropertyGroup*) override {}
+
+    // Writes the shape transferred to 'ostr', stream must be opened in binary mode
+    bool writeStream(std::ostream& ostr, TaskProgress* progress);
+
+    static std::unique_ptr<PropertyGroup> createProperties(PropertyGroup* parentGroup);
+    void applyProperties(const PropertyGroup* params) override;
+
+    // Parameters
+    enum class Format { Text, Binary };
+
+    struct Parameters {
+        Format format = Format::Text;
+        bool withTriangles = true; // Requires OpenCascade >= v7.6.0, always on otherwise
+        bool withNormals = false; // Requires OpenCascade >= v7.6.0
+    };
+    Parameters& parameters() { return m_params; }
+    const Parameters& constParameters() const { return m_params; }
 
 private:
+    class Properties;
+    Parameters m_params;
     TopoDS_Shape m_shape;
 };
 
@@ -6,6 +6,7 @@
 
 #include "io_occ_gltf_reader.h"
 #include "../base/property_builtins.h"
+#include "../base/tkernel_utils.h"
 
 namespace Mayo {
 namespace IO {
@@ -22,6 +23,14 @@ public:
         this->useMeshNameAsFallback.setDescription(
             textIdTr("Use mesh name in case if node name is empty(`Yes` by default)")
         );
+        this->deferredMeshDataLoading.setDescription(
+            textIdTr("Read only the scene structure, mesh data being loaded when a part is displayed "
+                     "or exported(`No` by default)\n\n"
+                     "This option is applicable when OpenCascade ≥ 7.6 version")
+        );
+#if OCC_VERSION_HEX < OCC_VERSION_CHECK(7, 6, 0)
+        this->deferredMeshDataLoading.setEnabled(false);
+#endif
     }
 
     void restoreDefaults() override
@@ -29,10 +38,12 @@ public:
         OccBaseMeshReaderProperties::restoreDefaults();
         this->skipEmptyNodes.setValue(true);
         this->useMeshNameAsFallback.setValue(true);
+        this->deferredMeshDataLoading.setValue(false);
     }
 
     PropertyBool skipEmptyNodes{ this, textId("skipEmptyNodes") };
     PropertyBool useMeshNameAsFallback{ this, textId("useMeshNameAsFallback") };
+    PropertyBool deferredMeshDataLoading{ this, textId("deferredMeshDataLoading") };
 };
 
 OccGltfReader::OccGltfReader()
@@ -52,6 +63,7 @@ void OccGltfReader::applyProperties(const PropertyGroup* params)
     if (ptr) {
         m_params.useMeshNameAsFallback = ptr->useMeshNameAsFallback;
         m_params.skipEmptyNodes = ptr->skipEmptyNodes;
+        m_params.deferredMeshDataLoading = ptr->deferredMeshDataLoading;
     }
 }
 
@@ -60,6 +72,13 @@ void OccGltfReader::applyParameters()
     OccBaseMeshReader::applyParameters();
     m_reader.SetSkipEmptyNodes(m_params.skipEmptyNodes);
     m_reader.SetMeshNameAsFallback(m_params.useMeshNameAsFallback);
+    // Decode buffers with worker threads
+    m_reader.SetParallel(true);
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+    // With deferred loading, late data is kept so triangulations can be loaded/unloaded later
+    m_reader.SetToSkipLateDataLoading(m_params.deferredMeshDataLoading);
+    m_reader.SetToKeepLateData(m_params.deferredMeshDataLoading);
+#endif
 }
 
 } // namespace IO
@@ -26,6 +26,9 @@ public:
     struct Parameters : public OccBaseMeshReader::Parameters {
         bool skipEmptyNodes = true;
         bool useMeshNameAsFallback = true;
+        // Read only the scene structure, triangulation buffers are loaded on demand(see BRepDeferredMesh)
+        // Requires OpenCascade >= v7.6.0
+        bool deferredMeshDataLoading = false;
     };
     OccGltfReader::Parameters& parameters() override { return m_params; }
     const OccGltfReader::Parameters& constParameters() const override { return m_params; }
@@ -9,45 +9,131 @@
 #include "../base/application_item.h"
 #include "../base/brep_utils.h"
 #include "../base/caf_utils.h"
+#include "../base/cpp_utils.h"
 #include "../base/triangulation_annex_data.h"
 #include "../base/document.h"
 #include "../base/filepath_conv.h"
 #include "../base/global.h"
 #include "../base/io_system.h"
+#include "../base/math_utils.h"
+#include "../base/memory_mapped_file.h"
+#include "../base/mesh_utils.h"
 #include "../base/messenger.h"
 #include "../base/occ_progress_indicator.h"
+#include "../base/property_builtins.h"
 #include "../base/property_enumeration.h"
 #include "../base/task_progress.h"
 #include "../base/tkernel_utils.h"
 
 #include <BRep_Builder.hxx>
+#include <BRep_Tool.hxx>
 #include <BRepTools.hxx>
+#include <OSD_Parallel.hxx>
 #include <RWStl.hxx>
-#include <StlAPI_Writer.hxx>
 #include <TDataStd_Name.hxx>
-#include <TopoDS_Compound.hxx>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
 
 namespace Mayo {
 namespace IO {
 
 namespace {
 
-static TopoDS_Shape asShape(const DocumentPtr& doc)
+// Shapes of the items, each item being visited once
+std::vector<TopoDS_Shape> itemShapes(Span<const ApplicationItem> appItems)
 {
-    TopoDS_Shape shape;
+    std::vector<TopoDS_Shape> vecShape;
+    System::visitUniqueItems(appItems, [&](const ApplicationItem& appItem) {
+        if (appItem.isDocument()) {
+            for (int i = 0; i < appItem.document()->entityCount(); ++i) {
+                const TDF_Label entityLabel = appItem.document()->entityLabel(i);
+                if (XCaf::isShape(entityLabel))
+                    vecShape.push_back(XCaf::shape(entityLabel));
+            }
+        }
+        else if (appItem.isDocumentTreeNode()) {
+            const TDF_Label label = appItem.documentTreeNode().label();
+            if (XCaf::isShape(label))
+                vecShape.push_back(XCaf::shape(label));
+        }
+    });
 
-    if (doc->entityCount() == 1) {
-        shape = XCaf::shape(doc->entityLabel(0));
-    }
-    else if (doc->entityCount() > 1) {
-        TopoDS_Compound cmpd = BRepUtils::makeEmptyCompound();
-        for (int i = 0; i < doc->entityCount(); ++i)
-            BRepUtils::addShape(&cmpd, XCaf::shape(doc->entityLabel(i)));
+    return vecShape;
+}
+
+// Binary STL: 80 bytes header, triangle count(uint32) and then 50 bytes per triangle record
+// Record: normal(3 x float32), vertices(3 x 3 x float32) and attribute byte count(uint16)
+// All values are little-endian, host is assumed to be little-endian too
+constexpr size_t StlBinaryHeaderSize = 80 + 4;
+constexpr size_t StlBinaryRecordSize = 50;
+
+// Count of triangles decoded by a parallel task
+constexpr int ChunkTriangleCount = 64 * 1024;
 
-        shape = cmpd;
+struct StlVertex {
+    float coords[3];
+};
+
+uint32_t readUInt32(const char* bytes)
+{
+    const auto ubytes = reinterpret_cast<const unsigned char*>(bytes);
+    return uint32_t(ubytes[0]) | (uint32_t(ubytes[1]) << 8) | (uint32_t(ubytes[2]) << 16) | (uint32_t(ubytes[3]) << 24);
+}
+
+bool isBinaryStl(std::string_view contents)
+{
+    if (contents.size() < StlBinaryHeaderSize)
+        return false;
+
+    const uint64_t triangleCount = readUInt32(contents.data() + 80);
+    return contents.size() == StlBinaryHeaderSize + triangleCount * StlBinaryRecordSize;
+}
+
+StlVertex readVertex(const char* bytes)
+{
+    StlVertex vertex;
+    std::memcpy(vertex.coords, bytes, sizeof(vertex.coords));
+    // Turns -0 into +0, so vertices can be merged by comparing their bits
+    for (float& coord : vertex.coords)
+        coord += 0.f;
+
+    return vertex;
+}
+
+uint32_t hashVertex(const StlVertex& vertex)
+{
+    uint32_t bits[3];
+    std::memcpy(bits, vertex.coords, sizeof(bits));
+    uint32_t h = bits[0] * 0x9E3779B1u;
+    h = (h ^ (h >> 15) ^ bits[1]) * 0x85EBCA77u;
+    h = (h ^ (h >> 13) ^ bits[2]) * 0xC2B2AE3Du;
+    return h ^ (h >> 16);
+}
+
+gp_Pnt toPnt(const StlVertex& vertex)
+{
+    return { vertex.coords[0], vertex.coords[1], vertex.coords[2] };
+}
+
+char* writeFloats(char* bytes, std::initializer_list<float> values)
+{
+    for (float value : values) {
+        std::memcpy(bytes, &value, sizeof(float));
+        bytes += sizeof(float);
     }
 
-    return shape;
+    return bytes;
 }
 
 } // namespace
@@ -56,6 +142,26 @@ struct OccStlWriterI18N {
     MAYO_DECLARE_TEXT_ID_FUNCTIONS(Mayo::IO::OccStlWriterI18N)
 };
 
+class OccStlReader::Properties : public PropertyGroup {
+    MAYO_DECLARE_TEXT_ID_FUNCTIONS(Mayo::IO::OccStlReader::Properties)
+public:
+    Properties(PropertyGroup* parentGroup)
+        : PropertyGroup(parentGroup)
+    {
+        this->mergeNodes.setDescription(
+            textIdTr("Merge vertices having the same coordinates into shared mesh nodes(binary STL only).\n"
+                     "When disabled each triangle has its own nodes, which is faster and requires less "
+                     "temporary memory")
+        );
+    }
+
+    void restoreDefaults() override {
+        this->mergeNodes.setValue(true);
+    }
+
+    PropertyBool mergeNodes{ this, textId("mergeNodes") };
+};
+
 class OccStlWriter::Properties : public PropertyGroup {
 public:
     Properties(PropertyGroup* parentGroup)
@@ -73,12 +179,150 @@ public:
 
 bool OccStlReader::readFile(const FilePath& filepath, TaskProgress* progress)
 {
-    auto indicator = makeOccHandle<OccProgressIndicator>(progress);
     m_baseFilename = filepath.stem();
+    m_mesh.Nullify();
+    {
+        MemoryMappedFile file;
+        if (file.open(filepath) && isBinaryStl(file.contents()))
+            return this->readBinary(Span<const char>(file.data(), file.size()), progress);
+    }
+
+    // ASCII STL(or binary STL with unexpected file size)
+    auto indicator = makeOccHandle<OccProgressIndicator>(progress);
     m_mesh = RWStl::ReadFile(filepath.u8string().c_str(), TKernelUtils::start(indicator));
     return !m_mesh.IsNull();
 }
 
+bool OccStlReader::readBinary(Span<const char> contents, TaskProgress* progress)
+{
+    const char* recordsBegin = contents.data() + StlBinaryHeaderSize;
+    const int triangleCount = CppUtils::safeStaticCast<int>(readUInt32(contents.data() + 80));
+    const int chunkCount = (triangleCount + ChunkTriangleCount - 1) / ChunkTriangleCount;
+    auto fnVertex = [=](int itri, int ivertex) {
+        return readVertex(recordsBegin + size_t(itri) * StlBinaryRecordSize + 12 * (1 + ivertex));
+    };
+
+    // Helper function to execute 'fn' on all chunks of triangles [itriBegin, itriEnd) concurrently
+    // Chunks are processed by batches so progress can be reported(and abort checked) in the calling thread
+    auto fnParallelForEachChunk = [=](TaskProgress* stepProgress, const std::function<void(int, int)>& fn) {
+        const int batchSize = std::max(1, 2 * int(std::thread::hardware_concurrency()));
+        for (int i = 0; i < chunkCount; i += batchSize) {
+            if (TaskProgress::isAbortRequested(stepProgress))
+                return false;
+
+            const int iEnd = std::min(chunkCount, i + batchSize);
+            OSD_Parallel::For(i, iEnd, [&](int iChunk) {
+                const int itriBegin = iChunk * ChunkTriangleCount;
+                fn(itriBegin, std::min(triangleCount, itriBegin + ChunkTriangleCount));
+            }, (iEnd - i) == 1);
+            stepProgress->setValue(MathUtils::toPercent(iEnd, 0, chunkCount));
+        }
+
+        return true;
+    };
+
+    if (!m_params.mergeNodes) {
+        // Each triangle has its own nodes, so all data can be filled in parallel
+        const int nodeCount = CppUtils::safeStaticCast<int>(3 * size_t(triangleCount));
+        auto mesh = makeOccHandle<Poly_Triangulation>(nodeCount, triangleCount, false/*!hasUvNodes*/);
+        TaskProgress stepProgress(progress, 100);
+        const bool ok = fnParallelForEachChunk(&stepProgress, [&](int itriBegin, int itriEnd) {
+            for (int itri = itriBegin; itri < itriEnd; ++itri) {
+                for (int ivertex = 0; ivertex < 3; ++ivertex)
+                    MeshUtils::setNode(mesh, 3 * itri + ivertex + 1, toPnt(fnVertex(itri, ivertex)));
+
+                MeshUtils::setTriangle(mesh, itri + 1, Poly_Triangle(3 * itri + 1, 3 * itri + 2, 3 * itri + 3));
+            }
+        });
+        if (ok)
+            m_mesh = mesh;
+
+        return ok;
+    }
+
+    // Decode vertices and compute their hash codes
+    const size_t vertexCount = 3 * size_t(triangleCount);
+    std::vector<StlVertex> vecVertex(vertexCount);
+    std::vector<uint32_t> vecVertexHash(vertexCount);
+    {
+        TaskProgress stepProgress(progress, 30);
+        const bool ok = fnParallelForEachChunk(&stepProgress, [&](int itriBegin, int itriEnd) {
+            for (int itri = itriBegin; itri < itriEnd; ++itri) {
+                for (int ivertex = 0; ivertex < 3; ++ivertex) {
+                    const size_t index = 3 * size_t(itri) + ivertex;
+                    vecVertex[index] = fnVertex(itri, ivertex);
+                    vecVertexHash[index] = hashVertex(vecVertex[index]);
+                }
+            }
+        });
+        if (!ok)
+            return false;
+    }
+
+    // Merge vertices with the same coordinates, using an open addressing hash table
+    // Nodes are numbered in order of first occurrence, so 'vecNodeVertex' is sorted
+    std::vector<int> vecVertexNode(vertexCount); // 1-based node index of each vertex
+    std::vector<size_t> vecNodeVertex; // Index of the first vertex of each node
+    {
+        TaskProgress stepProgress(progress, 40);
+        size_t tableSize = 1;
+        while (tableSize < 2 * vertexCount)
+            tableSize <<= 1;
+
+        std::vector<int> vecTableNode(tableSize, 0); // 1-based node index, 0 for empty slot
+        const size_t tableMask = tableSize - 1;
+        for (size_t i = 0; i < vertexCount; ++i) {
+            const StlVertex& vertex = vecVertex[i];
+            size_t slot = vecVertexHash[i] & tableMask;
+            while (true) {
+                const int node = vecTableNode[slot];
+                if (node == 0) {
+                    vecNodeVertex.push_back(i);
+                    vecTableNode[slot] = int(vecNodeVertex.size());
+                    vecVertexNode[i] = int(vecNodeVertex.size());
+                    break;
+                }
+
+                if (std::memcmp(&vecVertex[vecNodeVertex[node - 1]], &vertex, sizeof(StlVertex)) == 0) {
+                    vecVertexNode[i] = node;
+                    break;
+                }
+
+                slot = (slot + 1) & tableMask;
+            }
+
+            if ((i & 0xFFFFF) == 0) {
+                if (stepProgress.isAbortRequested())
+                    return false;
+
+                stepProgress.setValue(MathUtils::toPercent(i, 0, vertexCount));
+            }
+        }
+    }
+
+    // Fill the mesh, nodes of a chunk are the ones first found in its triangles
+    const int nodeCount = CppUtils::safeStaticCast<int>(vecNodeVertex.size());
+    auto mesh = makeOccHandle<Poly_Triangulation>(nodeCount, triangleCount, false/*!hasUvNodes*/);
+    TaskProgress stepProgress(progress, 30);
+    const bool ok = fnParallelForEachChunk(&stepProgress, [&](int itriBegin, int itriEnd) {
+        auto itNodeBegin = std::lower_bound(vecNodeVertex.cbegin(), vecNodeVertex.cend(), 3 * size_t(itriBegin));
+        auto itNodeEnd = std::lower_bound(itNodeBegin, vecNodeVertex.cend(), 3 * size_t(itriEnd));
+        for (auto it = itNodeBegin; it != itNodeEnd; ++it) {
+            const int node = int(it - vecNodeVertex.cbegin()) + 1;
+            MeshUtils::setNode(mesh, node, toPnt(vecVertex[*it]));
+        }
+
+        for (int itri = itriBegin; itri < itriEnd; ++itri) {
+            const int* triNodes = vecVertexNode.data() + 3 * size_t(itri);
+            MeshUtils::setTriangle(mesh, itri + 1, Poly_Triangle(triNodes[0], triNodes[1], triNodes[2]));
+        }
+    });
+    if (ok)
+        m_mesh = mesh;
+
+    return ok;
+}
+
 TDF_LabelSequence OccStlReader::transfer(DocumentPtr doc, TaskProgress* /*progress*/)
 {
     if (m_mesh.IsNull())
@@ -91,55 +335,33 @@ TDF_LabelSequence OccStlReader::transfer(DocumentPtr doc, TaskProgress* /*progre
     return CafUtils::makeLabelSequence({ entityLabel });
 }
 
-bool OccStlWriter::transfer(Span<const ApplicationItem> appItems, TaskProgress* /*progress*/)
+std::unique_ptr<PropertyGroup> OccStlReader::createProperties(PropertyGroup* parentGroup)
 {
-    m_shape = BRepUtils::makeEmptyCompound();
-    System::visitUniqueItems(appItems, [=](const ApplicationItem& appItem) {
-        if (appItem.isDocument()) {
-            BRepUtils::addShape(&m_shape, asShape(appItem.document()));
-        }
-        else if (appItem.isDocumentTreeNode()) {
-            const TDF_Label label = appItem.documentTreeNode().label();
-            if (XCaf::isShape(label))
-                BRepUtils::addShape(&m_shape, XCaf::shape(label));
-        }
-    });
+    return std::make_unique<Properties>(parentGroup);
+}
 
-    return !m_shape.IsNull();
+void OccStlReader::applyProperties(const PropertyGroup* params)
+{
+    auto ptr = dynamic_cast<const Properties*>(params);
+    if (ptr)
+        m_params.mergeNodes = ptr->mergeNodes;
 }
 
-bool OccStlWriter::writeFile(const FilePath& filepath, TaskProgress* progress)
+bool OccStlWriter::transfer(Span<const ApplicationItem> appItems, TaskProgress* /*progress*/)
 {
-    if (!m_shape.IsNull()) {
-        bool facesMeshed = true;
-        BRepUtils::forEachSubFace(m_shape, [&](const TopoDS_Face& face) {
-            TopLoc_Location loc;
-            const auto& mesh = BRep_Tool::Triangulation(face, loc);
-            if (mesh.IsNull())
-                facesMeshed = false;
-        });
-        if (!facesMeshed) {
-#if OCC_VERSION_HEX <= OCC_VERSION_CHECK(7, 3, 0)
-            this->messenger()->emitError(OccStlWriterI18N::textIdTr("Not all BRep faces are meshed"));
-            return false; // Continuing would crash
-#else
-            this->messenger()->emitWarning(OccStlWriterI18N::textIdTr("Not all BRep faces are meshed"));
-#endif
-        }
+    // Shapes are just gathered, triangles are encoded in writeFile()
+    m_vecShape = itemShapes(appItems);
+    return true;
+}
 
-        StlAPI_Writer writer;
-        writer.ASCIIMode() = m_params.format == Format::Ascii;
-        const std::string strFilepath = filepath.u8string();
-#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 5, 0)
-        auto indicator = makeOccHandle<OccProgressIndicator>(progress);
-        return writer.Write(m_shape, strFilepath.c_str(), TKernelUtils::start(indicator));
-#else
-        MAYO_UNUSED(progress);
-        return writer.Write(m_shape, strFilepath.c_str());
-#endif
-    }
+bool OccStlWriter::writeFile(const FilePath& filepath, TaskProgress* progress)
+{
+    return this->writeTriangles(m_vecShape, filepath, progress);
+}
 
-    return false;
+bool OccStlWriter::writeStreamed(Span<const ApplicationItem> appItems, const FilePath& filepath, TaskProgress* progress)
+{
+    return this->writeTriangles(itemShapes(appItems), filepath, progress);
 }
 
 std::unique_ptr<PropertyGroup> OccStlWriter::createProperties(PropertyGroup* parentGroup)
@@ -154,5 +376,130 @@ void OccStlWriter::applyProperties(const PropertyGroup* params)
         m_params.format = ptr->targetFormat;
 }
 
+bool OccStlWriter::writeTriangles(Span<const TopoDS_Shape> spanShape, const FilePath& filepath, TaskProgress* progress)
+{
+    progress = progress ? progress : &TaskProgress::null();
+    const bool isBinary = m_params.format == Format::Binary;
+
+    // Faces are visited twice(count of triangles needed by binary header, then encoding), so
+    // triangulations aren't gathered. Instances are visited as many times
+    using FunctionFaceMesh =
+        std::function<void(const TopoDS_Face&, const OccHandle<Poly_Triangulation>&, const TopLoc_Location&)>;
+    auto fnForEachFaceMesh = [=](const FunctionFaceMesh& fn) {
+        for (const TopoDS_Shape& shape : spanShape) {
+            BRepUtils::forEachSubFace(shape, [&](const TopoDS_Face& face) {
+                TopLoc_Location loc;
+                const OccHandle<Poly_Triangulation>& triangulation = BRep_Tool::Triangulation(face, loc);
+                fn(face, triangulation, loc);
+            });
+        }
+    };
+
+    uint64_t triangleCount = 0;
+    bool facesMeshed = true;
+    fnForEachFaceMesh([&](const TopoDS_Face&, const OccHandle<Poly_Triangulation>& triangulation, const TopLoc_Location&) {
+        if (triangulation.IsNull())
+            facesMeshed = false;
+        else
+            triangleCount += triangulation->NbTriangles();
+    });
+    if (!facesMeshed)
+        this->messenger()->emitWarning(OccStlWriterI18N::textIdTr("Not all BRep faces are meshed"));
+
+    if (isBinary && triangleCount > std::numeric_limits<uint32_t>::max()) {
+        this->messenger()->emitError(OccStlWriterI18N::textIdTr("Too many triangles for binary STL format"));
+        return false;
+    }
+
+    std::ofstream fstr(filepath, std::ios::out | std::ios::binary);
+    if (!fstr.is_open()) {
+        this->messenger()->emitError(OccStlWriterI18N::textIdTr("Failed to open file"));
+        return false;
+    }
+
+    if (isBinary) {
+        // Header must not start with "solid", otherwise the file could be read as ASCII STL
+        char header[StlBinaryHeaderSize] = {};
+        const char strHeader[] = "Binary STL written by Mayo";
+        std::memcpy(header, strHeader, sizeof(strHeader) - 1);
+        for (int i = 0; i < 4; ++i)
+            header[80 + i] = char((triangleCount >> (8 * i)) & 0xFF);
+
+        fstr.write(header, sizeof(header));
+    }
+    else {
+        fstr << "solid mayo\n";
+    }
+
+    // Records are encoded in a memory block which is written once full
+    constexpr size_t BlockCapacity = 1024 * 1024;
+    std::string block;
+    block.reserve(BlockCapacity + 1024);
+    uint64_t encodedTriangleCount = 0;
+    auto fnFlushBlock = [&]{
+        fstr.write(block.data(), block.size());
+        block.clear();
+        progress->setValue(MathUtils::toPercent(encodedTriangleCount, 0, triangleCount));
+    };
+
+    bool isAborted = false;
+    fnForEachFaceMesh([&](const TopoDS_Face& face, const OccHandle<Poly_Triangulation>& triangulation, const TopLoc_Location& loc) {
+        if (triangulation.IsNull() || isAborted)
+            return;
+
+        const gp_Trsf& trsf = loc.Transformation();
+        const bool isReversed = face.Orientation() == TopAbs_REVERSED;
+        for (int i = 1; i <= triangulation->NbTriangles(); ++i) {
+            int n1, n2, n3;
+            triangulation->Triangle(i).Get(n1, n2, n3);
+            if (isReversed)
+                std::swap(n2, n3);
+
+            const gp_Pnt p1 = triangulation->Node(n1).Transformed(trsf);
+            const gp_Pnt p2 = triangulation->Node(n2).Transformed(trsf);
+            const gp_Pnt p3 = triangulation->Node(n3).Transformed(trsf);
+            gp_XYZ normal = (p2.XYZ() - p1.XYZ()).Crossed(p3.XYZ() - p1.XYZ());
+            const double normalModulus = normal.Modulus();
+            normal = normalModulus > gp::Resolution() ? normal / normalModulus : gp_XYZ();
+
+            if (isBinary) {
+                char record[StlBinaryRecordSize];
+                char* ptr = writeFloats(record, { float(normal.X()), float(normal.Y()), float(normal.Z()) });
+                for (const gp_Pnt* pnt : { &p1, &p2, &p3 })
+                    ptr = writeFloats(ptr, { float(pnt->X()), float(pnt->Y()), float(pnt->Z()) });
+
+                ptr[0] = ptr[1] = 0; // Attribute byte count
+                block.append(record, StlBinaryRecordSize);
+            }
+            else {
+                auto itOut = std::back_inserter(block);
+                fmt::format_to(itOut, " facet normal {:e} {:e} {:e}\n  outer loop\n", normal.X(), normal.Y(), normal.Z());
+                for (const gp_Pnt* pnt : { &p1, &p2, &p3 })
+                    fmt::format_to(itOut, "   vertex {:e} {:e} {:e}\n", pnt->X(), pnt->Y(), pnt->Z());
+
+                block += "  endloop\n endfacet\n";
+            }
+
+            ++encodedTriangleCount;
+            if (block.size() >= BlockCapacity) {
+                fnFlushBlock();
+                isAborted = progress->isAbortRequested();
+                if (isAborted)
+                    return;
+            }
+        }
+    });
+    if (isAborted)
+        return false;
+
+    if (!isBinary)
+        block += "endsolid mayo\n";
+
+    fnFlushBlock();
+    // Closing flushes the stream buffer, write errors may only show up then
+    fstr.close();
+    return !fstr.fail();
+}
+
 } // namespace IO
 } // namespace Mayo
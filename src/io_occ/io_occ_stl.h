@@ -9,30 +9,54 @@
 #include "../base/io_reader.h"
 #include "../base/io_writer.h"
 #include "../base/occ_handle.h"
+#include "../base/span.h"
 #include <Poly_Triangulation.hxx>
 #include <TopoDS_Shape.hxx>
+#include <vector>
 
 namespace Mayo {
 namespace IO {
 
 // Opencascade-based reader for STL file format
+// Binary STL files are decoded directly from the memory-mapped file contents, in parallel chunks
 class OccStlReader : public Reader {
 public:
     bool readFile(const FilePath& filepath, TaskProgress* progress) override;
     TDF_LabelSequence transfer(DocumentPtr doc, TaskProgress* progress) override;
-    void applyProperties(const PropertyGroup*) override {}
+
+    static std::unique_ptr<PropertyGroup> createProperties(PropertyGroup* parentGroup);
+    void applyProperties(const PropertyGroup* params) override;
+
+    // Parameters
+    struct Parameters {
+        // Merge vertices having the exact same coordinates into shared mesh nodes(binary STL only)
+        // Otherwise each triangle gets its own three nodes, which is faster to read
+        bool mergeNodes = true;
+    };
+    Parameters& parameters() { return m_params; }
+    const Parameters& constParameters() const { return m_params; }
 
 private:
+    class Properties;
+    bool readBinary(Span<const char> contents, TaskProgress* progress);
+
+    Parameters m_params;
     OccHandle<Poly_Triangulation> m_mesh;
     FilePath m_baseFilename;
 };
 
 // Opencascade-based writer for STL file format
+// STL files are written directly from face triangulations and their locations, records being
+// encoded on the fly into a bounded buffer
+// Supports streaming: item shapes are walked face by face, without any mesh data staging
 class OccStlWriter : public Writer {
 public:
     bool transfer(Span<const ApplicationItem> appItems, TaskProgress* progress) override;
     bool writeFile(const FilePath& filepath, TaskProgress* progress) override;
 
+    bool supportsStreaming() const override { return true; }
+    bool writeStreamed(Span<const ApplicationItem> appItems, const FilePath& filepath, TaskProgress* progress) override;
+
     static std::unique_ptr<PropertyGroup> createProperties(PropertyGroup* parentGroup);
     void applyProperties(const PropertyGroup* params) override;
 
@@ -47,8 +71,10 @@ public:
 
 private:
     class Properties;
+    bool writeTriangles(Span<const TopoDS_Shape> spanShape, const FilePath& filepath, TaskProgress* progress);
+
     Parameters m_params;
-    TopoDS_Shape m_shape;
+    std::vector<TopoDS_Shape> m_vecShape;
 };
 
 } // namespace IO
@@ -13,27 +13,23 @@
 #include "../base/document.h"
 #include "../base/filepath_conv.h"
 #include "../base/math_utils.h"
+#include "../base/memory_mapped_file.h"
 #include "../base/mesh_utils.h"
 #include "../base/messenger.h"
-#include "../base/property_builtins.h"
-#include "../base/span.h"
 #include "../base/task_progress.h"
 #include "../base/tkernel_utils.h"
 
+#include <OSD_Parallel.hxx>
 #include <Quantity_Color.hxx>
-#include <Poly_Triangulation.hxx>
 #include <TDataStd_Name.hxx>
 
-#if __cpp_lib_to_chars
-#  include <charconv>
-#else
-#  include <cstdlib>
-#endif
-#include <array>
-#include <fstream>
-#include <locale>
-#include <string>
-#include <type_traits>
+#include <fast_float/fast_float.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <string_view>
+#include <thread>
 
 namespace Mayo {
 namespace IO {
@@ -42,128 +38,168 @@ struct OffReaderI18N { MAYO_DECLARE_TEXT_ID_FUNCTIONS(Mayo::IO::OffReaderI18N) }
 
 namespace {
 
-const char* strEnd(std::string_view str)
+bool isBlank(char ch)
 {
-    return str.data() + str.size();
+    return ch == ' ' || ch == '\t' || ch == '\r' || ch == '\v' || ch == '\f';
 }
 
-std::string_view getWord(const std::string& strLine, std::string::size_type pos = 0)
-{
-    using IntType = std::string::size_type;
-    auto fnIsSpace = [](char ch) {
-        return std::isspace(ch, std::locale::classic());
-    };
+// Parsing cursor over a single line of text(end-of-line character excluded)
+// Parsing stops at the end of the line or at the start of a comment('#')
+struct LineCursor {
+    const char* pos = nullptr;
+    const char* end = nullptr;
 
-    IntType wordStart = pos;
-    for (; wordStart < strLine.size() && fnIsSpace(strLine.at(wordStart)); ++wordStart);
+    bool atEnd() {
+        while (pos != end && isBlank(*pos))
+            ++pos;
 
-    IntType wordEnd = wordStart;
-    for (; wordEnd < strLine.size() && !fnIsSpace(strLine.at(wordEnd)) && strLine.at(wordEnd) != '#'; ++wordEnd);
+        return pos == end || *pos == '#';
+    }
 
-    return std::string_view{ strLine.c_str() + wordStart, wordEnd - wordStart };
-}
+    bool readDouble(double* value) {
+        if (this->atEnd())
+            return false;
 
-template<unsigned N>
-std::array<std::string_view, N> getWords(const std::string& strLine, std::string::size_type pos = 0)
-{
-    std::array<std::string_view, N> arrayWord;
-    for (unsigned i = 0; i < N; ++i) {
-        const std::string::size_type offset = i > 0 ? strEnd(arrayWord[i - 1]) - strLine.data() : pos;
-        std::string_view word = getWord(strLine, offset);
-        if (!word.empty())
-            arrayWord[i] = word;
-        else
-            return arrayWord;
+        if (*pos == '+')
+            ++pos;
+
+        const auto res = fast_float::from_chars(pos, end, *value);
+        if (res.ec != std::errc())
+            return false;
+
+        pos = res.ptr;
+        return true;
     }
 
-    return arrayWord;
+    bool readInt(int* value) {
+        if (this->atEnd())
+            return false;
+
+        const bool isNegative = *pos == '-';
+        if (*pos == '-' || *pos == '+')
+            ++pos;
+
+        if (pos == end || *pos < '0' || *pos > '9')
+            return false;
+
+        std::int64_t num = 0;
+        for (; pos != end && *pos >= '0' && *pos <= '9'; ++pos)
+            num = num * 10 + (*pos - '0');
+
+        *value = static_cast<int>(isNegative ? -num : num);
+        return true;
+    }
+
+    std::string_view readWord() {
+        if (this->atEnd())
+            return {};
+
+        const char* wordStart = pos;
+        while (pos != end && !isBlank(*pos) && *pos != '#')
+            ++pos;
+
+        return { wordStart, std::size_t(pos - wordStart) };
+    }
+};
+
+// Returns the end of the line starting at 'pos'(ie position of '\n' or 'end')
+const char* findLineEnd(const char* pos, const char* end)
+{
+    auto posNewLine = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+    return posNewLine ? posNewLine : end;
 }
 
-void getWords(const std::string& strLine, std::vector<std::string_view>& vecOutWord, std::string::size_type pos = 0)
+// Does the line contain anything else than blank characters and comments?
+bool isDataLine(const char* lineBegin, const char* lineEnd)
 {
-    vecOutWord.clear();
-    while (true) {
-        const std::string::size_type offset = !vecOutWord.empty() ? strEnd(vecOutWord.back()) - strLine.data() : pos;
-        std::string_view word = getWord(strLine, offset);
-        if (!word.empty())
-            vecOutWord.push_back(word);
-        else
-            return;
-    }
+    LineCursor cursor{ lineBegin, lineEnd };
+    return !cursor.atEnd();
 }
 
-bool hasEmptyString(Span<const std::string_view> spanStr)
+// Calls 'fn(lineBegin, lineEnd)' for each data line found in [begin, end)
+// Iteration is stopped as soon as 'fn' returns false
+template<typename Function>
+void forEachDataLine(const char* begin, const char* end, Function fn)
 {
-    for (std::string_view str : spanStr) {
-        if (str.empty())
-            return true;
-    }
+    const char* pos = begin;
+    while (pos < end) {
+        const char* lineEnd = findLineEnd(pos, end);
+        if (isDataLine(pos, lineEnd) && !fn(pos, lineEnd))
+            return;
 
-    return false;
+        pos = lineEnd != end ? lineEnd + 1 : end;
+    }
 }
 
-bool isAnyOf(std::string_view str, std::initializer_list<std::string_view> listCandidates)
+// Header keyword is [ST][C][N][4]OFF
+struct OffHeaderFlags {
+    bool hasTextureCoords = false;
+    bool hasColors = false;
+    bool hasNormals = false;
+    bool hasHomogeneousCoords = false;
+};
+
+bool parseHeaderKeyword(std::string_view keyword, OffHeaderFlags* flags)
 {
-    for (std::string_view candidate : listCandidates) {
-        if (str == candidate)
+    auto fnConsumePrefix = [&](std::string_view prefix) {
+        if (keyword.substr(0, prefix.size()) == prefix) {
+            keyword.remove_prefix(prefix.size());
             return true;
-    }
+        }
 
-    return false;
-}
+        return false;
+    };
 
-template<typename T>
-T strToNum(std::string_view str)
-{
-    static_assert(std::is_arithmetic_v<std::remove_cv_t<T>>, "Input template type must be arithmetic type");
-    T num = {};
-    if (str.empty())
-        return num;
-
-#if __cpp_lib_to_chars
-    auto result = std::from_chars(str.data(), str.data() + str.size(), num);
-    if (result.ec != std::errc()) {
-        // TODO Handle error code
-        // throw std::runtime_error(std::make_error_code(err).message());
-    }
-#else
-    errno = 0;
-    num = std::strtod(str.data(), nullptr);
-    if (errno != 0) {
-        // TODO Handle error code
-        // throw std::runtime_error(std::strerror(errno));
-    }
-#endif
-    return num;
+    flags->hasTextureCoords = fnConsumePrefix("ST");
+    flags->hasColors = fnConsumePrefix("C");
+    flags->hasNormals = fnConsumePrefix("N");
+    flags->hasHomogeneousCoords = fnConsumePrefix("4");
+    return keyword == "OFF";
 }
 
-void getNonCommentLine(std::istream& istr, std::string& strLine)
+std::uint32_t toColorComponent(double v)
 {
-    std::getline(istr >> std::ws, strLine);
-    while (!istr.eof() && !strLine.empty() && strLine.front() == '#')
-        std::getline(istr >> std::ws, strLine);
+    const double c = v > 1. ? v : v * 255;
+    return static_cast<std::uint32_t>(std::clamp(c, 0., 255.));
 }
 
-std::uint32_t strToColorComponent(std::string_view str)
+std::uint32_t toRgbaColor(const double* values, int count)
 {
-    const double v = strToNum<double>(str);
-    return unsigned(v > 1. ? v : v * 255);
+    const std::uint32_t r = count > 0 ? toColorComponent(values[0]) : 0;
+    const std::uint32_t g = count > 1 ? toColorComponent(values[1]) : 0;
+    const std::uint32_t b = count > 2 ? toColorComponent(values[2]) : 0;
+    const std::uint32_t a = count > 3 ? toColorComponent(values[3]) : 0;
+    return (r << 24) | (g << 16) | (b << 8) | a;
 }
 
-std::uint32_t toRgbaColor(Span<const std::string_view> spanWord)
+std::uint32_t toRgbaColor(const Quantity_Color& color)
 {
-    const unsigned r = spanWord.size() > 0 ? strToColorComponent(spanWord[0]) : 0;
-    const unsigned g = spanWord.size() > 1 ? strToColorComponent(spanWord[1]) : 0;
-    const unsigned b = spanWord.size() > 2 ? strToColorComponent(spanWord[2]) : 0;
-    const unsigned a = spanWord.size() > 3 ? strToColorComponent(spanWord[3]) : 0;
-    const std::uint32_t color =
-            ((r << 24)   & 0xFF000000)
-            | ((g << 16) & 0x00FF0000)
-            | ((b << 8)  & 0x0000FF00)
-            | (a         & 0x000000FF);
-    return color;
+    double r, g, b;
+    color.Values(r, g, b, TKernelUtils::preferredRgbColorType());
+    const double values[] = { r, g, b };
+    return toRgbaColor(values, 3);
 }
 
+// Part of the file body to be processed in one go by a parsing thread
+// Chunks always start at the beginning of a line
+struct Chunk {
+    const char* begin = nullptr;
+    const char* end = nullptr;
+    std::int64_t dataLineCount = 0;
+    std::int64_t firstDataLine = 0; // Index of the first data line within the body
+    std::int64_t triangleCount = 0;
+    std::int64_t firstTriangle = 0; // Index(0-based) of the first triangle within the mesh
+};
+
+enum class ParseError {
+    None,
+    VertexCoords,
+    FacetVertexCount,
+    FacetVertexIndex
+};
+
+constexpr std::size_t ChunkSize = 4 * 1024 * 1024;
+
 } // namespace
 
 bool OffReader::readFile(const FilePath& filepath, TaskProgress* progress)
@@ -175,113 +211,272 @@ bool OffReader::readFile(const FilePath& filepath, TaskProgress* progress)
 
     // Reset internal data
     m_baseFilename = filepath.stem();
-    m_vecVertex.clear();
-    m_vecAllFacetIndex.clear();
-    m_vecFacet.clear();
+    m_vertexCount = 0;
+    m_mesh.Nullify();
+    m_vecVertexColor.clear();
+    m_vecVertexColor.shrink_to_fit();
 
-    std::ifstream ifs(filepath);
-    if (!ifs.is_open())
+    MemoryMappedFile file;
+    if (!file.open(filepath))
         return fnError(OffReaderI18N::textIdTr("Can't open input file"));
 
-    std::string strLine;
+    const char* const fileEnd = file.end();
+    const char* bodyBegin = fileEnd;
+
+    // Consume header: keyword followed by count of vertices/faces/edges
+    OffHeaderFlags headerFlags;
+    int vertexCount = -1;
+    int facetCount = -1;
+    bool isHeaderKeywordValid = false;
+    bool hasHeaderKeyword = false;
+    forEachDataLine(file.begin(), fileEnd, [&](const char* lineBegin, const char* lineEnd) {
+        LineCursor cursor{ lineBegin, lineEnd };
+        if (!hasHeaderKeyword) {
+            hasHeaderKeyword = true;
+            isHeaderKeywordValid = parseHeaderKeyword(cursor.readWord(), &headerFlags);
+            if (!isHeaderKeywordValid)
+                return false;
+
+            // Normally vertex/face/edge counts are specified on a dedicated line coming after OFF
+            // But for some files they are wrongly specified on the line containing OFF token, eg "OFF 24 12 0"
+            if (cursor.atEnd())
+                return true;
+        }
 
-    // Consume header keyword
-    {
-        getNonCommentLine(ifs, strLine);
-        if (!ifs.good())
-            return fnError(OffReaderI18N::textIdTr("Unexpected end of file"));
+        if (!cursor.readInt(&vertexCount) || !cursor.readInt(&facetCount)) {
+            vertexCount = -1;
+            facetCount = -1;
+        }
 
-        std::string_view headerKeyword = getWord(strLine);
-        if (!isAnyOf(headerKeyword, { "OFF", "COFF", "NOFF", "4OFF" }))
-            return fnError(OffReaderI18N::textIdTr("Wrong header keyword(should be [C][N][4]OFF"));
+        bodyBegin = lineEnd != fileEnd ? lineEnd + 1 : fileEnd;
+        return false;
+    });
+
+    if (!hasHeaderKeyword)
+        return fnError(OffReaderI18N::textIdTr("Unexpected end of file"));
+
+    if (!isHeaderKeywordValid)
+        return fnError(OffReaderI18N::textIdTr("Wrong header keyword(should be [C][N][4]OFF"));
+
+    if (vertexCount < 0 || facetCount < 0)
+        return fnError(OffReaderI18N::textIdTr("No vertex or face count"));
+
+    // Split file body into chunks starting at line boundaries
+    std::vector<Chunk> vecChunk;
+    for (const char* pos = bodyBegin; pos < fileEnd; ) {
+        Chunk chunk;
+        chunk.begin = pos;
+        chunk.end = fileEnd;
+        if (CppUtils::cmpLess(ChunkSize, fileEnd - pos)) {
+            const char* lineEnd = findLineEnd(pos + ChunkSize, fileEnd);
+            chunk.end = lineEnd != fileEnd ? lineEnd + 1 : fileEnd;
+        }
+
+        vecChunk.push_back(chunk);
+        pos = chunk.end;
     }
 
-    // Consume count of vertices/faces/edges
-    int vertexCount = 0;
-    int facetCount = 0;
-    {
-        // Normally vertex/face/edge counts are specified on a dedicated line coming after OFF
-        // But for some files they are wrongly specified on the line containing OFF token, eg "OFF 24 12 0"
-        const auto arrayStrFirstLine = getWords<3>(strLine);
-        if (!arrayStrFirstLine[1].empty() && !arrayStrFirstLine[2].empty()) {
-            vertexCount = strToNum<int>(arrayStrFirstLine[1]);
-            facetCount = strToNum<int>(arrayStrFirstLine[2]);
-        }
-        else {
-            if (!ifs.good())
-                return fnError(OffReaderI18N::textIdTr("Unexpected end of file"));
+    const int chunkCount = CppUtils::safeStaticCast<int>(vecChunk.size());
 
-            getNonCommentLine(ifs, strLine);
-            const auto arrayStrCount = getWords<2>(strLine);
-            if (hasEmptyString(arrayStrCount))
-                return fnError(OffReaderI18N::textIdTr("No vertex or face count"));
+    // Helper function to execute 'fn' on all chunks concurrently
+    // Chunks are processed by batches so progress can be reported(and abort checked) in the calling thread
+    auto fnParallelForEachChunk = [&](TaskProgress* stepProgress, const std::function<void(Chunk&)>& fn) {
+        const int batchSize = std::max(1, 2 * int(std::thread::hardware_concurrency()));
+        for (int i = 0; i < chunkCount; i += batchSize) {
+            if (TaskProgress::isAbortRequested(stepProgress))
+                return false;
 
-            vertexCount = strToNum<int>(arrayStrCount[0]);
-            facetCount = strToNum<int>(arrayStrCount[1]);
+            const int iEnd = std::min(chunkCount, i + batchSize);
+            OSD_Parallel::For(i, iEnd, [&](int iChunk) { fn(vecChunk.at(iChunk)); }, (iEnd - i) == 1);
+            stepProgress->setValue(MathUtils::toPercent(iEnd, 0, chunkCount));
         }
+
+        return true;
+    };
+
+    // Count data lines of each chunk, so the global index of any data line can be deduced
+    {
+        TaskProgress stepProgress(progress, 10);
+        const bool ok = fnParallelForEachChunk(&stepProgress, [](Chunk& chunk) {
+            forEachDataLine(chunk.begin, chunk.end, [&](const char*, const char*) {
+                ++chunk.dataLineCount;
+                return true;
+            });
+        });
+        if (!ok)
+            return false;
     }
 
-    // Helper function for progress report
-    auto fnUpdateProgress = [=]{
-        const auto total = vertexCount + facetCount;
-        const auto current = m_vecVertex.size() + m_vecFacet.size();
-        if (current % 100 || CppUtils::cmpGreaterEqual(current, total))
-            progress->setValue(MathUtils::toPercent(current, 0, total));
+    std::int64_t dataLineCount = 0;
+    for (Chunk& chunk : vecChunk) {
+        chunk.firstDataLine = dataLineCount;
+        dataLineCount += chunk.dataLineCount;
+    }
+
+    // Lines missing at the end of the file are tolerated
+    vertexCount = int(std::min<std::int64_t>(vertexCount, dataLineCount));
+    facetCount = int(std::min<std::int64_t>(facetCount, dataLineCount - vertexCount));
+    const std::int64_t facetLineBegin = vertexCount;
+    const std::int64_t facetLineEnd = facetLineBegin + facetCount;
+    auto fnChunkHasLines = [](const Chunk& chunk, std::int64_t lineBegin, std::int64_t lineEnd) {
+        return chunk.firstDataLine < lineEnd && lineBegin < chunk.firstDataLine + chunk.dataLineCount;
     };
 
-    // Consume vertices
-    m_vecVertex.reserve(vertexCount);
-    while (!ifs.eof() && CppUtils::cmpLess(m_vecVertex.size(), vertexCount)) {
-        getNonCommentLine(ifs, strLine);
-        const auto arrayStrCoord = getWords<3>(strLine);
-        if (hasEmptyString(arrayStrCoord))
-            return fnError(OffReaderI18N::textIdTr("No vertex coordinates at current line"));
-
-        Vertex vertex = {};
-        vertex.coords.SetX(strToNum<double>(arrayStrCoord[0]));
-        vertex.coords.SetY(strToNum<double>(arrayStrCoord[1]));
-        vertex.coords.SetZ(strToNum<double>(arrayStrCoord[2]));
-
-        const auto arrayStrColor = getWords<4>(strLine, strEnd(arrayStrCoord.back()) - strLine.data());
-        vertex.hasColor = !arrayStrColor.front().empty();
-        if (vertex.hasColor)
-            vertex.color = toRgbaColor(arrayStrColor);
-
-        m_vecVertex.push_back(std::move(vertex));
-        fnUpdateProgress();
+    // Count triangles resulting from fan triangulation of the facets within each chunk
+    {
+        TaskProgress stepProgress(progress, 10);
+        const bool ok = fnParallelForEachChunk(&stepProgress, [&](Chunk& chunk) {
+            if (!fnChunkHasLines(chunk, facetLineBegin, facetLineEnd))
+                return;
+
+            std::int64_t lineId = chunk.firstDataLine;
+            forEachDataLine(chunk.begin, chunk.end, [&](const char* lineBegin, const char* lineEnd) {
+                if (lineId >= facetLineEnd)
+                    return false;
+
+                if (lineId++ >= facetLineBegin) {
+                    LineCursor cursor{ lineBegin, lineEnd };
+                    int facetVertexCount = 0;
+                    if (cursor.readInt(&facetVertexCount) && facetVertexCount > 2)
+                        chunk.triangleCount += facetVertexCount - 2;
+                }
+
+                return true;
+            });
+        });
+        if (!ok)
+            return false;
     }
 
-    // Consume faces
-    m_vecAllFacetIndex.reserve(facetCount * 3);
-    m_vecFacet.reserve(facetCount);
-    std::vector<std::string_view> vecWord;
-    while (!ifs.eof() && CppUtils::cmpLess(m_vecFacet.size(), facetCount)) {
-        getNonCommentLine(ifs, strLine);
-        getWords(strLine, vecWord);
-        const Facet facet = { int(m_vecAllFacetIndex.size()), strToNum<int>(vecWord.front()) };
-        if (CppUtils::cmpLess((vecWord.size() + 1), facet.vertexCount))
-            return fnError(OffReaderI18N::textIdTr("Inconsistent vertex count of face"));
-
-        for (int i = 0; i < facet.vertexCount; ++i) {
-            const int facetVertexId = strToNum<int>(vecWord.at(i + 1));
-            m_vecAllFacetIndex.push_back(facetVertexId);
-        }
+    std::int64_t triangleCount = 0;
+    for (Chunk& chunk : vecChunk) {
+        chunk.firstTriangle = triangleCount;
+        triangleCount += chunk.triangleCount;
+    }
 
-#if 0
-        const bool facetHasColor = (vecWord.size() - 1 - facet.vertexCount) >= 3;
-        std::uint32_t facetColor = 0;
-        if (facetHasColor) {
-            const std::size_t colorComponentCount = vecWord.size() - (facet.vertexCount + 1);
-            facetColor = toRgbaColor({ &vecWord.at(facet.vertexCount + 1), colorComponentCount });
-            for (int i = 0; i < facet.vertexCount; ++i) {
-                const int ivertex = m_vecAllFacetIndex.at(facet.startIndexInArray + i);
-                Vertex& vertex = m_vecVertex.at(ivertex);
-            }
-        }
-#endif
+    m_vertexCount = vertexCount;
+    if (triangleCount == 0) {
+        progress->setValue(100);
+        return true; // Point cloud
+    }
 
-        m_vecFacet.push_back(std::move(facet));
-        fnUpdateProgress();
+    // Vertex colors are expected if header keyword tells so, but some files provide colors without
+    // COFF keyword. For such case check that first vertex has trailing values after its coordinates
+    bool hasVertexColors = headerFlags.hasColors;
+    if (!hasVertexColors && !headerFlags.hasNormals && !headerFlags.hasTextureCoords && vertexCount > 0) {
+        forEachDataLine(bodyBegin, fileEnd, [&](const char* lineBegin, const char* lineEnd) {
+            LineCursor cursor{ lineBegin, lineEnd };
+            double coord;
+            const int coordCount = headerFlags.hasHomogeneousCoords ? 4 : 3;
+            for (int i = 0; i < coordCount; ++i)
+                cursor.readDouble(&coord);
+
+            hasVertexColors = !cursor.atEnd();
+            return false;
+        });
+    }
+
+    // Allocate final data
+    m_mesh = makeOccHandle<Poly_Triangulation>(
+        vertexCount, CppUtils::safeStaticCast<int>(triangleCount), false/*!hasUvNodes*/
+    );
+    if (hasVertexColors)
+        m_vecVertexColor.resize(vertexCount, toRgbaColor(Quantity_Color(Quantity_NOC_BEIGE)));
+
+    // Fill vertices and triangles
+    std::atomic<ParseError> parseError = ParseError::None;
+    {
+        TaskProgress stepProgress(progress, 80);
+        const bool ok = fnParallelForEachChunk(&stepProgress, [&](Chunk& chunk) {
+            if (!fnChunkHasLines(chunk, 0, facetLineEnd))
+                return;
+
+            std::int64_t lineId = chunk.firstDataLine;
+            std::int64_t triangleId = chunk.firstTriangle;
+            forEachDataLine(chunk.begin, chunk.end, [&](const char* lineBegin, const char* lineEnd) {
+                if (lineId >= facetLineEnd || parseError != ParseError::None)
+                    return false;
+
+                LineCursor cursor{ lineBegin, lineEnd };
+                if (lineId < facetLineBegin) { // Vertex
+                    const auto vertexId = static_cast<int>(lineId);
+                    double coords[4] = { 0., 0., 0., 1. };
+                    const int coordCount = headerFlags.hasHomogeneousCoords ? 4 : 3;
+                    for (int i = 0; i < coordCount; ++i) {
+                        if (!cursor.readDouble(&coords[i])) {
+                            parseError = ParseError::VertexCoords;
+                            return false;
+                        }
+                    }
+
+                    if (headerFlags.hasHomogeneousCoords && coords[3] != 0.) {
+                        for (int i = 0; i < 3; ++i)
+                            coords[i] /= coords[3];
+                    }
+
+                    MeshUtils::setNode(m_mesh, vertexId + 1, gp_Pnt{ coords[0], coords[1], coords[2] });
+                    if (hasVertexColors) {
+                        double normal[3];
+                        if (headerFlags.hasNormals) {
+                            for (double& n : normal)
+                                cursor.readDouble(&n);
+                        }
+
+                        // Color values(possibly followed by texture coordinates)
+                        double values[6] = {};
+                        int valueCount = 0;
+                        while (valueCount < 6 && cursor.readDouble(&values[valueCount]))
+                            ++valueCount;
+
+                        if (headerFlags.hasTextureCoords)
+                            valueCount = std::max(0, valueCount - 2);
+
+                        if (valueCount >= 3)
+                            m_vecVertexColor[vertexId] = toRgbaColor(values, std::min(valueCount, 4));
+                    }
+                }
+                else { // Facet
+                    int facetVertexCount = 0;
+                    cursor.readInt(&facetVertexCount);
+                    int vertexIds[3] = {};
+                    for (int i = 0; i < facetVertexCount; ++i) {
+                        int& vertexId = vertexIds[std::min(i, 2)];
+                        if (!cursor.readInt(&vertexId)) {
+                            parseError = ParseError::FacetVertexCount;
+                            return false;
+                        }
+
+                        if (vertexId < 0 || vertexId >= vertexCount) {
+                            parseError = ParseError::FacetVertexIndex;
+                            return false;
+                        }
+
+                        // Fan triangulation: triangle(v0, vPrevious, vCurrent)
+                        if (i >= 2) {
+                            const Poly_Triangle triangle(vertexIds[0] + 1, vertexIds[1] + 1, vertexIds[2] + 1);
+                            MeshUtils::setTriangle(m_mesh, static_cast<int>(++triangleId), triangle);
+                            vertexIds[1] = vertexIds[2];
+                        }
+                    }
+                }
+
+                ++lineId;
+                return true;
+            });
+        });
+        if (!ok)
+            return false;
+    }
+
+    switch (parseError.load()) {
+    case ParseError::None:
+        return true;
+    case ParseError::VertexCoords:
+        return fnError(OffReaderI18N::textIdTr("No vertex coordinates at current line"));
+    case ParseError::FacetVertexCount:
+        return fnError(OffReaderI18N::textIdTr("Inconsistent vertex count of face"));
+    case ParseError::FacetVertexIndex:
+        return fnError(OffReaderI18N::textIdTr("Invalid vertex index in face"));
     }
 
     return true;
@@ -289,11 +484,11 @@ bool OffReader::readFile(const FilePath& filepath, TaskProgress* progress)
 
 TDF_LabelSequence OffReader::transfer(DocumentPtr doc, TaskProgress* progress)
 {
-    if (m_vecVertex.empty())
+    if (m_vertexCount == 0)
         return {};
 
     TDF_Label entityLabel;
-    if (!m_vecAllFacetIndex.empty())
+    if (!m_mesh.IsNull())
         entityLabel = this->transferMesh(doc, progress);
     else
         entityLabel = this->transferPointCloud(doc, progress);
@@ -308,70 +503,35 @@ TDF_LabelSequence OffReader::transfer(DocumentPtr doc, TaskProgress* progress)
 
 TDF_Label OffReader::transferMesh(DocumentPtr doc, TaskProgress* progress)
 {
-    // Vertex and triangle count
-    const int vertexCount = CppUtils::safeStaticCast<int>(m_vecVertex.size());
-    int triangleCount = 0;
-    for (const Facet& facet : m_vecFacet)
-        triangleCount += facet.vertexCount - 2;
-
-    // Create mesh object
-    auto mesh = makeOccHandle<Poly_Triangulation>(vertexCount, triangleCount, false/*!hasUvNodes*/);
-
-    // Helper function for progress report
-    auto fnUpdateProgress = [=](int current) {
-        const auto total = vertexCount + triangleCount;
-        if (current % 100 || current >= total)
-            progress->setValue(MathUtils::toPercent(current, 0, total));
-    };
-
-    // Transfer vertices and prepare vertex colors
-    std::vector<Quantity_Color> vecVertexColor;
-    vecVertexColor.reserve(m_vecVertex.size());
-    for (const Vertex& vertex : m_vecVertex) {
-        const auto ivertex = Span_itemIndex(m_vecVertex, vertex);
-        MeshUtils::setNode(mesh, ivertex + 1, vertex.coords);
-        const std::uint32_t c = vertex.color;
-        if (vertex.hasColor) {
-            vecVertexColor.push_back(
-                        Quantity_Color{
-                            ((c & 0xFF000000) >> 24) / 255.f,
-                            ((c & 0x00FF0000) >> 16) / 255.f,
-                            ((c & 0x0000FF00) >> 8)  / 255.f,
-                            TKernelUtils::preferredRgbColorType()
-                        });
-        }
-        else {
-            vecVertexColor.push_back(Quantity_NOC_BEIGE);
-        }
-
-        fnUpdateProgress(ivertex);
+    // Insert mesh as a document entity
+    const TDF_Label entityLabel = doc->newEntityShapeLabel();
+    doc->xcaf().setShape(entityLabel, BRepUtils::makeFace(m_mesh)); // IMPORTANT: pure mesh part marker!
+    m_mesh.Nullify();
+    if (m_vecVertexColor.empty()) {
+        TriangulationAnnexData::Set(entityLabel);
+        progress->setValue(100);
+        return entityLabel;
     }
 
-    // Transfer faces
-    int iTriangle = 0;
-    for (const Facet& facet: m_vecFacet) {
-        const int facet0 = m_vecAllFacetIndex.at(facet.startIndexInArray);
-        if (facet.vertexCount == 3) {
-            const int facet1 = m_vecAllFacetIndex.at(facet.startIndexInArray + 1);
-            const int facet2 = m_vecAllFacetIndex.at(facet.startIndexInArray + 2);
-            MeshUtils::setTriangle(mesh, iTriangle + 1, { facet0 + 1, facet1 + 1, facet2 + 1 });
-            ++iTriangle;
-        }
-        else if (facet.vertexCount > 3) {
-            for (int i = 1; i <= facet.vertexCount - 2; ++i) {
-                const int facetN = m_vecAllFacetIndex.at(facet.startIndexInArray + i);
-                const int facetM = m_vecAllFacetIndex.at(facet.startIndexInArray + i + 1);
-                MeshUtils::setTriangle(mesh, iTriangle + 1, { facet0 + 1, facetN + 1, facetM + 1 });
-                ++iTriangle;
+    // Unpack vertex colors
+    std::vector<Quantity_Color> vecVertexColor;
+    vecVertexColor.reserve(m_vecVertexColor.size());
+    for (const std::uint32_t c : m_vecVertexColor) {
+        vecVertexColor.push_back(
+            Quantity_Color{
+                ((c & 0xFF000000) >> 24) / 255.f,
+                ((c & 0x00FF0000) >> 16) / 255.f,
+                ((c & 0x0000FF00) >> 8)  / 255.f,
+                TKernelUtils::preferredRgbColorType()
             }
-        }
-
-        fnUpdateProgress(vertexCount + iTriangle);
+        );
+        const auto current = vecVertexColor.size();
+        if (current % 1000 == 0 || current == m_vecVertexColor.size())
+            progress->setValue(MathUtils::toPercent(current, 0, m_vecVertexColor.size()));
     }
 
-    // Insert mesh as a document entity
-    const TDF_Label entityLabel = doc->newEntityShapeLabel();
-    doc->xcaf().setShape(entityLabel, BRepUtils::makeFace(mesh)); // IMPORTANT: pure mesh part marker!
+    m_vecVertexColor.clear();
+    m_vecVertexColor.shrink_to_fit();
     TriangulationAnnexData::Set(entityLabel, std::move(vecVertexColor));
     return entityLabel;
 }
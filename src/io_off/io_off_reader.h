@@ -9,9 +9,11 @@
 #include "../base/io_reader.h"
 #include "../base/io_single_format_factory.h"
 
-#include <gp_Pnt.hxx>
+#include "../base/occ_handle.h"
+
+#include <Poly_Triangulation.hxx>
+#include <cstdint>
 #include <vector>
-#include <type_traits>
 
 namespace Mayo {
 namespace IO {
@@ -29,21 +31,12 @@ private:
     TDF_Label transferMesh(DocumentPtr doc, TaskProgress* progress);
     TDF_Label transferPointCloud(DocumentPtr doc, TaskProgress* progress);
 
-    struct Vertex {
-        gp_Pnt coords;
-        std::uint32_t color;
-        bool hasColor = false;
-    };
-
-    struct Facet {
-        int startIndexInArray;
-        int vertexCount;
-    };
-
     FilePath m_baseFilename;
-    std::vector<Vertex> m_vecVertex;
-    std::vector<int> m_vecAllFacetIndex;
-    std::vector<Facet> m_vecFacet;
+    int m_vertexCount = 0;
+    // Final mesh, directly filled by readFile()
+    OccHandle<Poly_Triangulation> m_mesh;
+    // Vertex colors packed as RGBA(8 bits per component), empty if no vertex has color
+    std::vector<std::uint32_t> m_vecVertexColor;
 };
 
 // Provides factory to create OffReader objects
@@ -29,18 +29,25 @@ struct OffWriterI18N { MAYO_DECLARE_TEXT_ID_FUNCTIONS(Mayo::IO::OffWriterI18N) }
 
 bool OffWriter::transfer(Span<const ApplicationItem> appItems, TaskProgress* /*progress*/)
 {
-    m_vecTreeNode.clear();
-    m_vecTreeNode.reserve(appItems.size());
-    System::traverseUniqueItems(appItems, [&](const DocumentTreeNode& treeNode) {
-        if (treeNode.isLeaf())
-            m_vecTreeNode.push_back(treeNode);
-    });
+    // Items are traversed and written in writeFile(), nothing is staged here
+    m_vecAppItem.assign(appItems.begin(), appItems.end());
     return true;
 }
 
 bool OffWriter::writeFile(const FilePath& filepath, TaskProgress* progress)
+{
+    return this->writeStreamed(m_vecAppItem, filepath, progress);
+}
+
+bool OffWriter::writeStreamed(Span<const ApplicationItem> appItems, const FilePath& filepath, TaskProgress* progress)
 {
     progress = progress ? progress : &TaskProgress::null();
+    std::vector<DocumentTreeNode> vecTreeNode;
+    System::traverseUniqueItems(appItems, [&](const DocumentTreeNode& treeNode) {
+        if (treeNode.isLeaf())
+            vecTreeNode.push_back(treeNode);
+    });
+
     std::ofstream fstr(filepath);
     if (!fstr.is_open()) {
         this->messenger()->emitError(OffWriterI18N::textIdTr("Failed to open file"));
@@ -53,7 +60,7 @@ bool OffWriter::writeFile(const FilePath& filepath, TaskProgress* progress)
     // Count vertices and facets
     int vertexCount = 0;
     int facetCount = 0;
-    for (const DocumentTreeNode& treeNode : m_vecTreeNode) {
+    for (const DocumentTreeNode& treeNode : vecTreeNode) {
         IMeshAccess_visitMeshes(treeNode, [&](const IMeshAccess& mesh) {
             vertexCount += mesh.triangulation()->NbNodes();
             facetCount += mesh.triangulation()->NbTriangles();
@@ -70,7 +77,7 @@ bool OffWriter::writeFile(const FilePath& filepath, TaskProgress* progress)
     fstr << vertexCount << " " << facetCount << " " << 0/*edgeCount*/ << "\n";
     // Write vertices
     int ivertex = 0;
-    for (const DocumentTreeNode& treeNode : m_vecTreeNode) {
+    for (const DocumentTreeNode& treeNode : vecTreeNode) {
         IMeshAccess_visitMeshes(treeNode, [&](const IMeshAccess& mesh) {
             const gp_Trsf& meshTrsf = mesh.location().Transformation();
             const OccHandle<Poly_Triangulation>& triangulation = mesh.triangulation();
@@ -94,7 +101,7 @@ bool OffWriter::writeFile(const FilePath& filepath, TaskProgress* progress)
     // Write facets(triangles)
     int offsetVertex = 0;
     int ifacet = 0;
-    for (const DocumentTreeNode& treeNode : m_vecTreeNode) {
+    for (const DocumentTreeNode& treeNode : vecTreeNode) {
         IMeshAccess_visitMeshes(treeNode, [&](const IMeshAccess& mesh) {
             const OccHandle<Poly_Triangulation>& triangulation = mesh.triangulation();
             for (int i = 1; i <= triangulation->NbTriangles(); ++i) {
@@ -6,7 +6,7 @@
 
 #pragma once
 
-#include "../base/document_tree_node.h"
+#include "../base/application_item.h"
 #include "../base/io_writer.h"
 #include "../base/io_single_format_factory.h"
 
@@ -16,16 +16,20 @@ namespace Mayo {
 namespace IO {
 
 // Writer for OFF file format
+// Supports streaming: vertices and facets are written on the fly from the meshes of the items
 class OffWriter : public Writer {
 public:
     bool transfer(Span<const ApplicationItem> appItems, TaskProgress* progress) override;
     bool writeFile(const FilePath& filepath, TaskProgress* progress) override;
     void applyProperties(const PropertyGroup* group) override;
 
+    bool supportsStreaming() const override { return true; }
+    bool writeStreamed(Span<const ApplicationItem> appItems, const FilePath& filepath, TaskProgress* progress) override;
+
     static std::unique_ptr<PropertyGroup> createProperties(PropertyGroup*)  { return {}; }
 
 private:
-    std::vector<DocumentTreeNode> m_vecTreeNode;
+    std::vector<ApplicationItem> m_vecAppItem;
 };
 
 // Provides factory to create OffWriter objects
@@ -22,6 +22,8 @@
 
 #include <Poly_Triangulation.hxx>
 #include <TDataStd_Name.hxx>
+#include <cstring>
+#include <memory>
 
 namespace Mayo {
 namespace IO {
@@ -200,42 +202,23 @@ TDF_Label PlyReader::transferMesh(DocumentPtr doc, TaskProgress* /*progress*/)
 
 TDF_Label PlyReader::transferPointCloud(DocumentPtr doc, TaskProgress* /*progress*/)
 {
-    const bool hasColors = !m_vecColorComponent.empty();
-    const bool hasNormals = false; //!m_vecNormalCoord.empty();
-    auto gfxPoints = new Graphic3d_ArrayOfPoints(
-        CppUtils::safeStaticCast<int>(m_vecNodeCoord.size()), hasColors, hasNormals
-    );
-
-    // Add nodes(vertices) into point cloud
-    for (int i = 0; CppUtils::cmpLess(i, m_vecNodeCoord.size()); i += 3) {
-        const auto& vec = m_vecNodeCoord;
-        const gp_Pnt node = { vec.at(i), vec.at(i + 1), vec.at(i + 2) };
-        gfxPoints->AddVertex(node);
+    auto pointCloud = std::make_shared<PointCloud>();
+    const size_t pointCount = m_vecNodeCoord.size() / 3;
+    pointCloud->resize(pointCount);
+    std::memcpy(pointCloud->positions().data(), m_vecNodeCoord.data(), pointCount * sizeof(PointCloud::Vec3f));
+    if (m_vecColorComponent.size() == pointCount * 3) {
+        pointCloud->allocateColors();
+        std::memcpy(pointCloud->colors().data(), m_vecColorComponent.data(), pointCount * sizeof(PointCloud::Color));
     }
 
-    if (hasColors) {
-        for (int i = 0; CppUtils::cmpLess(i, m_vecColorComponent.size()); i += 3) {
-            const auto& vec = m_vecColorComponent;
-            const Quantity_Color color{
-                        vec.at(i) / 255., vec.at(i + 1) / 255., vec.at(i + 2) / 255.,
-                        TKernelUtils::preferredRgbColorType()
-            };
-            gfxPoints->SetVertexColor((i / 3) + 1, color);
-        }
-    }
-
-#if 0
-    if (hasNormals) {
-        for (int i = 0; CppUtils::cmpLess(i, m_vecNormalCoord.size()); i += 3) {
-            const auto& vec = m_vecNormalCoord;
-            gfxPoints->SetVertexNormal((i / 3) + 1, vec.at(i), vec.at(i + 1), vec.at(i + 2));
-        }
+    if (m_vecNormalCoord.size() == pointCount * 3) {
+        pointCloud->allocateNormals();
+        std::memcpy(pointCloud->normals().data(), m_vecNormalCoord.data(), pointCount * sizeof(PointCloud::Vec3f));
     }
-#endif
 
     // Insert point cloud as a document entity
     const TDF_Label entityLabel = doc->newEntityLabel();
-    PointCloudData::Set(entityLabel, gfxPoints);
+    PointCloudData::Set(entityLabel, pointCloud);
     return entityLabel;
 }
 
@@ -14,6 +14,7 @@
 #include "../base/math_utils.h"
 #include "../base/mesh_access.h"
 #include "../base/messenger.h"
+#include "../base/point_cloud_data.h"
 #include "../base/property_builtins.h"
 #include "../base/property_enumeration.h"
 #include "../base/task_progress.h"
@@ -25,9 +26,13 @@
 #include <fmt/format.h>
 
 #include <algorithm>
+#include <climits>
 #include <fstream>
+#include <iterator>
 #include <locale>
+#include <optional>
 #include <string>
+#include <vector>
 
 namespace Mayo {
 namespace IO {
@@ -53,6 +58,33 @@ Endianness hostEndianness()
     return Endianness::Unknown;
 }
 
+// Memory buffer written to the output stream once its capacity is reached
+class OutputBuffer {
+public:
+    OutputBuffer(std::ostream& ostr, size_t capacity)
+        : m_ostr(ostr), m_capacity(capacity)
+    {
+        m_data.reserve(capacity + 256);
+    }
+
+    std::string& data() { return m_data; }
+    bool isFull() const { return m_data.size() >= m_capacity; }
+
+    template<typename T> void appendBytes(const T& value) {
+        m_data.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void flush() {
+        m_ostr.write(m_data.data(), m_data.size());
+        m_data.clear();
+    }
+
+private:
+    std::ostream& m_ostr;
+    size_t m_capacity = 0;
+    std::string m_data;
+};
+
 } // namespace
 
 struct PlyWriterI18N {
@@ -82,55 +114,59 @@ public:
     PropertyString comment{ this, PlyWriterI18N::textId("comment") };
 };
 
-bool PlyWriter::transfer(Span<const ApplicationItem> appItems, TaskProgress* progress)
+bool PlyWriter::transfer(Span<const ApplicationItem> appItems, TaskProgress* /*progress*/)
+{
+    // Items are traversed and written in writeFile(), nothing is staged here
+    m_vecAppItem.assign(appItems.begin(), appItems.end());
+    return true;
+}
+
+bool PlyWriter::writeFile(const FilePath& filepath, TaskProgress* progress)
+{
+    return this->writeStreamed(m_vecAppItem, filepath, progress);
+}
+
+bool PlyWriter::writeStreamed(Span<const ApplicationItem> appItems, const FilePath& filepath, TaskProgress* progress)
 {
     progress = progress ? progress : &TaskProgress::null();
-    m_vecNode.clear();
-    m_vecNodeColor.clear();
-    m_vecFace.clear();
+    const bool isBinary = m_params.format == Format::Binary;
 
     // TODO Investigate bad looking 3D mesh when defining vertex colors
-    // TODO Investigate task abort issue
-
-    // Count number of faces for progress report
-    int count = 0;
-    System::traverseUniqueItems(appItems, [&](const DocumentTreeNode& docTreeNode) {
-        if (docTreeNode.isLeaf()) {
-            IMeshAccess_visitMeshes(docTreeNode, [&](const IMeshAccess&) { ++count; });
-            if (findLabelDataFlags(docTreeNode.label()) & LabelData_HasPointCloudData)
-                ++count;
-        }
-    });
 
-    // Record face meshes
-    int iCount = 0;
-    System::traverseUniqueItems(appItems, [&](const DocumentTreeNode& docTreeNode) {
-        if (docTreeNode.isLeaf() && !progress->isAbortRequested()) {
-            IMeshAccess_visitMeshes(docTreeNode, [&](const IMeshAccess& mesh) {
-                this->addMesh(mesh);
-                progress->setValue(MathUtils::toPercent(++iCount, 0, count));
-            });
-        }
+    std::vector<DocumentTreeNode> vecTreeNode;
+    System::traverseUniqueItems(appItems, [&](const DocumentTreeNode& treeNode) {
+        if (treeNode.isLeaf())
+            vecTreeNode.push_back(treeNode);
     });
 
-    // Record point clouds
-    System::traverseUniqueItems(appItems, [&](const DocumentTreeNode& docTreeNode) {
-        if (docTreeNode.isLeaf()
-                && (findLabelDataFlags(docTreeNode.label()) & LabelData_HasPointCloudData)
-                && !progress->isAbortRequested())
-        {
-            this->addPointCloud(CafUtils::findAttribute<PointCloudData>(docTreeNode.label()));
-            progress->setValue(MathUtils::toPercent(++iCount, 0, count));
+    auto fnPointCloud = [](const DocumentTreeNode& treeNode) -> PointCloudDataPtr {
+        if (treeNode.labelDataFlags() & LabelData_HasPointCloudData) {
+            auto attrPointCloudData = CafUtils::findAttribute<PointCloudData>(treeNode.label());
+            if (attrPointCloudData && attrPointCloudData->pointCloud())
+                return attrPointCloudData;
         }
-    });
 
-    return true;
-}
+        return {};
+    };
+
+    // Count elements, needed by PLY header
+    uint64_t vertexCount = 0;
+    uint64_t faceCount = 0;
+    for (const DocumentTreeNode& treeNode : vecTreeNode) {
+        IMeshAccess_visitMeshes(treeNode, [&](const IMeshAccess& mesh) {
+            vertexCount += mesh.triangulation()->NbNodes();
+            faceCount += mesh.triangulation()->NbTriangles();
+        });
+        const PointCloudDataPtr pntCloud = fnPointCloud(treeNode);
+        if (pntCloud)
+            vertexCount += pntCloud->pointCount();
+    }
+
+    if (vertexCount > uint64_t(INT32_MAX)) {
+        this->messenger()->emitError(PlyWriterI18N::textIdTr("Too many vertices"));
+        return false;
+    }
 
-bool PlyWriter::writeFile(const FilePath& filepath, TaskProgress* progress)
-{
-    progress = progress ? progress : &TaskProgress::null();
-    const bool isBinary = m_params.format == Format::Binary;
     std::ios_base::openmode mode = std::ios_base::out;
     if (isBinary)
         mode |= std::ios_base::binary;
@@ -168,10 +204,10 @@ bool PlyWriter::writeFile(const FilePath& filepath, TaskProgress* progress)
         std::string strComment = m_params.comment;
         std::replace(strComment.begin(), strComment.end(), '\n', ' ');
         std::replace(strComment.begin(), strComment.end(), '\r', ' ');
-        fstr << "comment " << m_params.comment << "\n";
+        fstr << "comment " << strComment << "\n";
     }
 
-    fstr << "element vertex " << m_vecNode.size() << "\n"
+    fstr << "element vertex " << vertexCount << "\n"
          << "property float x\n"
          << "property float y\n"
          << "property float z\n";
@@ -182,64 +218,106 @@ bool PlyWriter::writeFile(const FilePath& filepath, TaskProgress* progress)
              << "property uchar blue\n";
     }
 
-    fstr << "element face " << m_vecFace.size() << "\n"
+    fstr << "element face " << faceCount << "\n"
          << "property list uchar int vertex_indices\n"
          << "end_header\n";
 
-    // Helpers for progress report
-    const int elementCount = int(m_vecNode.size() + m_vecFace.size());
-    int iElement = 0;
-    auto fnUpdateProgress = [&]{
+    // Elements are encoded into a bounded buffer, which is written to file once full
+    OutputBuffer buffer(fstr, 1024 * 1024);
+    const uint64_t elementCount = vertexCount + faceCount;
+    uint64_t iElement = 0;
+    bool ok = true;
+    auto fnElementWritten = [&]{
         ++iElement;
-        if (iElement % 50 == 0) {
+        if (buffer.isFull()) {
+            buffer.flush();
             progress->setValue(MathUtils::toPercent(iElement, 0, elementCount));
-            if (progress->isAbortRequested())
-                return false;
+            ok = !progress->isAbortRequested();
         }
-
-        return true;
     };
 
-    // Write vertices
-    for (const Vertex& node : m_vecNode) {
-        const auto inode = &node - &m_vecNode.front();
+    auto fnWriteVertex = [&](const Vertex& vertex, const Color& color) {
         if (isBinary) {
-            fstr.write(reinterpret_cast<const char*>(&node.x), 12);
+            buffer.appendBytes(vertex);
             if (m_params.writeColors)
-                fstr.write(reinterpret_cast<const char*>(&m_vecNodeColor.at(inode).red), 3);
+                buffer.appendBytes(color);
         }
         else {
-            fstr << node.x << " " << node.y << " " << node.z;
-            if (m_params.writeColors) {
-                const Color& c = m_vecNodeColor.at(inode);
-                fstr << " " << int(c.red) << " " << int(c.green) << " " << int(c.blue);
-            }
+            auto itOut = std::back_inserter(buffer.data());
+            fmt::format_to(itOut, "{} {} {}", vertex.x, vertex.y, vertex.z);
+            if (m_params.writeColors)
+                fmt::format_to(itOut, " {} {} {}", int(color.red), int(color.green), int(color.blue));
 
-            fstr << "\n";
+            buffer.data() += '\n';
         }
 
-        if (!fnUpdateProgress())
-            return true;
+        fnElementWritten();
+    };
+
+    // Write vertices of meshes and then vertices of point clouds
+    const Color defaultColor = PlyWriter::toColor(m_params.defaultColor.GetRGB());
+    for (const DocumentTreeNode& treeNode : vecTreeNode) {
+        IMeshAccess_visitMeshes(treeNode, [&](const IMeshAccess& mesh) {
+            const gp_Trsf& meshTrsf = mesh.location().Transformation();
+            const OccHandle<Poly_Triangulation>& triangulation = mesh.triangulation();
+            for (int i = 1; i <= triangulation->NbNodes() && ok; ++i) {
+                const std::optional<Quantity_Color> nodeColor =
+                    m_params.writeColors ? mesh.nodeColor(i - 1) : std::optional<Quantity_Color>{};
+                fnWriteVertex(
+                    PlyWriter::toVertex(triangulation->Node(i).Transformed(meshTrsf)),
+                    nodeColor ? PlyWriter::toColor(nodeColor.value()) : defaultColor
+                );
+            }
+        });
     }
 
-    fstr.flush();
-    // Write face indices
-    for (const Face& face : m_vecFace) {
-        if (isBinary) {
-            const uint8_t indexCount = 3;
-            fstr.write(reinterpret_cast<const char*>(&indexCount), 1);
-            fstr.write(reinterpret_cast<const char*>(&face.v1), 12);
-        }
-        else {
-            fstr << "3 " << face.v1 << " " << face.v2 << " " << face.v3 << "\n";
+    for (const DocumentTreeNode& treeNode : vecTreeNode) {
+        const PointCloudDataPtr pntCloud = fnPointCloud(treeNode);
+        if (!pntCloud)
+            continue;
+
+        // Point cloud attributes are written as stored, without conversion(except absolute positions)
+        const PointCloud& pointCloud = *pntCloud->pointCloud();
+        const bool hasColors = m_params.writeColors && pointCloud.hasColors();
+        for (size_t i = 0; i < pointCloud.pointCount() && ok; ++i) {
+            const PointCloud::Color* color = hasColors ? &pointCloud.colors()[i] : nullptr;
+            fnWriteVertex(
+                PlyWriter::toVertex(pointCloud.point(i)),
+                color ? Color{ color->red, color->green, color->blue } : defaultColor
+            );
         }
+    }
+
+    // Write face indices
+    int32_t offsetVertex = 0;
+    for (const DocumentTreeNode& treeNode : vecTreeNode) {
+        IMeshAccess_visitMeshes(treeNode, [&](const IMeshAccess& mesh) {
+            const OccHandle<Poly_Triangulation>& triangulation = mesh.triangulation();
+            for (int i = 1; i <= triangulation->NbTriangles() && ok; ++i) {
+                const Poly_Triangle& triangle = triangulation->Triangle(i);
+                const Face face{
+                    offsetVertex + triangle(1) - 1, offsetVertex + triangle(2) - 1, offsetVertex + triangle(3) - 1
+                };
+                if (isBinary) {
+                    buffer.appendBytes(uint8_t(3));
+                    buffer.appendBytes(face);
+                }
+                else {
+                    fmt::format_to(std::back_inserter(buffer.data()), "3 {} {} {}\n", face.v1, face.v2, face.v3);
+                }
+
+                fnElementWritten();
+            }
 
-        if (!fnUpdateProgress())
-            return true;
+            offsetVertex += triangulation->NbNodes();
+        });
     }
 
-    fstr.flush();
-    return true;
+    if (!ok)
+        return false;
+
+    buffer.flush();
+    return fstr.good();
 }
 
 std::unique_ptr<PropertyGroup> PlyWriter::createProperties(PropertyGroup* parentGroup)
@@ -258,50 +336,6 @@ void PlyWriter::applyProperties(const PropertyGroup* params)
     }
 }
 
-void PlyWriter::addMesh(const IMeshAccess& mesh)
-{
-    const OccHandle<Poly_Triangulation>& triangulation = mesh.triangulation();
-    for (int i = 1; i <= triangulation->NbTriangles(); ++i) {
-        const Poly_Triangle& triangle = triangulation->Triangle(i);
-        const int32_t offset = CppUtils::safeStaticCast<int32_t>(m_vecNode.size());
-        const Face face{
-            offset + triangle(1) - 1, offset + triangle(2) - 1, offset + triangle(3) - 1
-        };
-        m_vecFace.push_back(std::move(face));
-    }
-
-    for (int i = 1; i <= triangulation->NbNodes(); ++i) {
-        const Vertex vertex = PlyWriter::toVertex(triangulation->Node(i).Transformed(mesh.location()));
-        m_vecNode.push_back(std::move(vertex));
-    }
-
-    if (m_params.writeColors) {
-        for (int i = 0; i < triangulation->NbNodes(); ++i) {
-            const std::optional<Quantity_Color> nodeColor = mesh.nodeColor(i);
-            const Quantity_Color& defaultNodeColor = m_params.defaultColor.GetRGB();
-            m_vecNodeColor.push_back(PlyWriter::toColor(nodeColor ? nodeColor.value() : defaultNodeColor));
-        }
-    }
-}
-
-void PlyWriter::addPointCloud(const PointCloudDataPtr& pntCloud)
-{
-    const OccHandle<Graphic3d_ArrayOfPoints>& points = pntCloud->points();
-    const int pntCount = points->VertexNumber();
-    for (int i = 1; i <= pntCount; ++i) {
-        const Vertex vertex = PlyWriter::toVertex(points->Vertice(i));
-        m_vecNode.push_back(std::move(vertex));
-    }
-
-    if (m_params.writeColors) {
-        const bool hasColors = points->HasVertexColors();
-        for (int i = 1; i <= pntCount; ++i) {
-            const Quantity_Color pntColor = hasColors ? points->VertexColor(i) : m_params.defaultColor.GetRGB();
-            m_vecNodeColor.push_back(PlyWriter::toColor(pntColor));
-        }
-    }
-}
-
 PlyWriter::Vertex PlyWriter::toVertex(const gp_Pnt& pnt)
 {
     return Vertex{ float(pnt.X()), float(pnt.Y()), float(pnt.Z()) };
@@ -6,25 +6,27 @@
 
 #pragma once
 
-#include "../base/document_ptr.h"
+#include "../base/application_item.h"
 #include "../base/io_writer.h"
 #include "../base/io_single_format_factory.h"
-#include "../base/point_cloud_data.h"
 
+#include <gp_Pnt.hxx>
 #include <Quantity_ColorRGBA.hxx>
 #include <vector>
 
-namespace Mayo { class IMeshAccess; }
-
 namespace Mayo {
 namespace IO {
 
 // Writer for PLY file format
+// Supports streaming: meshes and point clouds are encoded on the fly into a bounded buffer
 class PlyWriter : public Writer {
 public:
     bool transfer(Span<const ApplicationItem> appItems, TaskProgress* progress) override;
     bool writeFile(const FilePath& filepath, TaskProgress* progress) override;
 
+    bool supportsStreaming() const override { return true; }
+    bool writeStreamed(Span<const ApplicationItem> appItems, const FilePath& filepath, TaskProgress* progress) override;
+
     static std::unique_ptr<PropertyGroup> createProperties(PropertyGroup* parentGroup);
     void applyProperties(const PropertyGroup* params) override;
 
@@ -50,14 +52,9 @@ private:
     static Vertex toVertex(const gp_Pnt& pnt);
     static Color toColor(const Quantity_Color& c);
 
-    void addMesh(const IMeshAccess& mesh);
-    void addPointCloud(const PointCloudDataPtr& pntCloud);
-
     class Properties;
     Parameters m_params;
-    std::vector<Vertex> m_vecNode;
-    std::vector<Color> m_vecNodeColor;
-    std::vector<Face> m_vecFace;
+    std::vector<ApplicationItem> m_vecAppItem;
 };
 
 // Provides factory to create PlyWriter objects
@@ -0,0 +1,268 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "io_las_reader.h"
+#include "io_point_cloud_common.h"
+
+#include "../base/caf_utils.h"
+#include "../base/cpp_utils.h"
+#include "../base/math_utils.h"
+#include "../base/memory_mapped_file.h"
+#include "../base/messenger.h"
+#include "../base/task_progress.h"
+
+#include <OSD_Parallel.hxx>
+
+#include <fmt/format.h>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace Mayo {
+namespace IO {
+
+struct LasReaderI18N { MAYO_DECLARE_TEXT_ID_FUNCTIONS(Mayo::IO::LasReaderI18N) };
+
+namespace {
+
+constexpr size_t LasMinHeaderSize = 227; // LAS 1.0
+constexpr size_t Las14HeaderSize = 375;
+constexpr uint64_t ChunkPointCount = 1024 * 1024;
+
+// LAS files are little-endian, like all supported hosts
+template<typename T> T readValue(const char* bytes)
+{
+    T value;
+    std::memcpy(&value, bytes, sizeof(T));
+    return value;
+}
+
+struct LasHeader {
+    uint8_t versionMajor = 0;
+    uint8_t versionMinor = 0;
+    uint32_t offsetToPointData = 0;
+    uint8_t pointFormat = 0;
+    uint16_t pointRecordLength = 0;
+    uint64_t pointCount = 0;
+    double scale[3] = {};
+    double offset[3] = {};
+};
+
+LasHeader readLasHeader(const char* bytes, size_t size)
+{
+    LasHeader header;
+    header.versionMajor = readValue<uint8_t>(bytes + 24);
+    header.versionMinor = readValue<uint8_t>(bytes + 25);
+    header.offsetToPointData = readValue<uint32_t>(bytes + 96);
+    header.pointFormat = readValue<uint8_t>(bytes + 104);
+    header.pointRecordLength = readValue<uint16_t>(bytes + 105);
+    header.pointCount = readValue<uint32_t>(bytes + 107);
+    for (int i = 0; i < 3; ++i) {
+        header.scale[i] = readValue<double>(bytes + 131 + 8 * i);
+        header.offset[i] = readValue<double>(bytes + 155 + 8 * i);
+    }
+
+    // LAS 1.4 provides a 64-bit point count, the legacy one being zero for formats 6 to 10
+    const auto headerSize = readValue<uint16_t>(bytes + 94);
+    if (header.versionMinor >= 4 && headerSize >= Las14HeaderSize && size >= Las14HeaderSize) {
+        const auto pointCount = readValue<uint64_t>(bytes + 247);
+        if (pointCount != 0)
+            header.pointCount = pointCount;
+    }
+
+    return header;
+}
+
+// Location of point attributes within a point data record
+struct LasPointLayout {
+    uint16_t minRecordLength = 0;
+    int classificationOffset = -1;
+    uint8_t classificationMask = 0;
+    int rgbOffset = -1;
+};
+
+std::optional<LasPointLayout> findLasPointLayout(uint8_t pointFormat)
+{
+    switch (pointFormat) {
+    case 0:  return LasPointLayout{ 20, 15, 0x1F, -1 };
+    case 1:  return LasPointLayout{ 28, 15, 0x1F, -1 };
+    case 2:  return LasPointLayout{ 26, 15, 0x1F, 20 };
+    case 3:  return LasPointLayout{ 34, 15, 0x1F, 28 };
+    case 4:  return LasPointLayout{ 57, 15, 0x1F, -1 };
+    case 5:  return LasPointLayout{ 63, 15, 0x1F, 28 };
+    case 6:  return LasPointLayout{ 30, 16, 0xFF, -1 };
+    case 7:  return LasPointLayout{ 36, 16, 0xFF, 30 };
+    case 8:  return LasPointLayout{ 38, 16, 0xFF, 30 };
+    case 9:  return LasPointLayout{ 59, 16, 0xFF, -1 };
+    case 10: return LasPointLayout{ 67, 16, 0xFF, 30 };
+    }
+
+    return {};
+}
+
+} // namespace
+
+bool LasReader::readFile(const FilePath& filepath, TaskProgress* progress)
+{
+    progress = progress ? progress : &TaskProgress::null();
+    auto fnError = [=](std::string_view strMessage) {
+        this->messenger()->emitError(strMessage);
+        return false;
+    };
+
+    m_baseFilename = filepath.stem();
+    m_pointCloud.reset();
+
+    MemoryMappedFile file;
+    if (!file.open(filepath))
+        return fnError(LasReaderI18N::textIdTr("Can't open input file"));
+
+    if (file.size() < LasMinHeaderSize || file.contents().substr(0, 4) != "LASF")
+        return fnError(LasReaderI18N::textIdTr("Invalid LAS header"));
+
+    const LasHeader header = readLasHeader(file.data(), file.size());
+    // Compressors(eg LASzip) flag the point data format with bits 6 and 7
+    if (header.pointFormat & 0xC0)
+        return fnError(LasReaderI18N::textIdTr("Compressed LAS files(LAZ) aren't supported"));
+
+    const std::optional<LasPointLayout> pointLayout = findLasPointLayout(header.pointFormat);
+    if (!pointLayout)
+        return fnError(fmt::format(LasReaderI18N::textIdTr("Unsupported point data format {}"), int(header.pointFormat)));
+
+    if (header.pointRecordLength < pointLayout->minRecordLength)
+        return fnError(LasReaderI18N::textIdTr("Invalid point data record length"));
+
+    if (header.offsetToPointData > file.size())
+        return fnError(LasReaderI18N::textIdTr("Invalid offset to point data"));
+
+    // Point records missing at the end of the file are tolerated
+    const uint64_t recordLength = header.pointRecordLength;
+    const uint64_t availablePointCount = (file.size() - header.offsetToPointData) / recordLength;
+    const uint64_t pointCount = std::min(header.pointCount, availablePointCount);
+    if (pointCount < header.pointCount) {
+        this->messenger()->emitWarning(
+            fmt::format(LasReaderI18N::textIdTr("File truncated, {} points missing"), header.pointCount - pointCount)
+        );
+    }
+
+    const PointCloudDecimation& decimation = m_params.decimation;
+    const uint64_t step = decimation.mode == PointCloudDecimation::Mode::EveryNth ? std::max(1, decimation.step) : 1;
+    if (pointCount / step > std::numeric_limits<uint32_t>::max())
+        return fnError(LasReaderI18N::textIdTr("Too many points, consider decimation on import"));
+
+    const char* recordsBegin = file.data() + header.offsetToPointData;
+    auto fnRecord = [=](uint64_t index) { return recordsBegin + index * recordLength; };
+
+    // RGB components are 16 bits, but some files store 8 bits values
+    int colorShift = 0;
+    if (pointLayout->rgbOffset >= 0) {
+        uint16_t maxComponent = 0;
+        for (uint64_t i = 0; i < std::min<uint64_t>(pointCount, 64 * 1024); ++i) {
+            const char* rgb = fnRecord(i) + pointLayout->rgbOffset;
+            for (int c = 0; c < 3; ++c)
+                maxComponent = std::max(maxComponent, readValue<uint16_t>(rgb + 2 * c));
+        }
+
+        colorShift = maxComponent > 255 ? 8 : 0;
+    }
+
+    // Positions are stored relative to the header offset, which is usually close to the points
+    // Absolute coordinates(eg georeferenced) would exceed the precision of floats
+    const gp_XYZ origin(header.offset[0], header.offset[1], header.offset[2]);
+
+    // Decode point records concurrently, by chunks
+    // Chunks are processed by batches so progress(bytes consumed) can be reported and abort
+    // checked in the calling thread
+    const uint64_t chunkCount = (pointCount + ChunkPointCount - 1) / ChunkPointCount;
+    std::vector<PointCloud> vecPart(chunkCount);
+    auto fnDecodeChunk = [&](int ichunk) {
+        const uint64_t begin = uint64_t(ichunk) * ChunkPointCount;
+        const uint64_t end = std::min(pointCount, begin + ChunkPointCount);
+        std::optional<VoxelGridSampler> voxelSampler;
+        if (decimation.mode == PointCloudDecimation::Mode::VoxelGrid)
+            voxelSampler.emplace(decimation.voxelSize);
+
+        PointCloud& part = vecPart.at(ichunk);
+        part.setOrigin(origin);
+        part.reserve((end - begin) / step + 1);
+        std::vector<float>& classifications = part.addScalarField("Classification").values;
+        const uint64_t first = ((begin + step - 1) / step) * step;
+        for (uint64_t i = first; i < end; i += step) {
+            const char* record = fnRecord(i);
+            const PointCloud::Vec3f position(
+                float(readValue<int32_t>(record + 0) * header.scale[0]),
+                float(readValue<int32_t>(record + 4) * header.scale[1]),
+                float(readValue<int32_t>(record + 8) * header.scale[2])
+            );
+            if (voxelSampler && !voxelSampler->tryAdd(position))
+                continue;
+
+            part.positions().push_back(position);
+            part.intensities().push_back(readValue<uint16_t>(record + 12));
+            const uint8_t classification = readValue<uint8_t>(record + pointLayout->classificationOffset);
+            classifications.push_back(classification & pointLayout->classificationMask);
+            if (pointLayout->rgbOffset >= 0) {
+                const char* rgb = record + pointLayout->rgbOffset;
+                part.colors().push_back({
+                    uint8_t(readValue<uint16_t>(rgb + 0) >> colorShift),
+                    uint8_t(readValue<uint16_t>(rgb + 2) >> colorShift),
+                    uint8_t(readValue<uint16_t>(rgb + 4) >> colorShift)
+                });
+            }
+        }
+    };
+
+    {
+        TaskProgress stepProgress(progress, 90, LasReaderI18N::textIdTr("Decode points"));
+        const int batchSize = std::max(1, 2 * int(std::thread::hardware_concurrency()));
+        for (int i = 0; CppUtils::cmpLess(i, chunkCount); i += batchSize) {
+            if (stepProgress.isAbortRequested())
+                return false;
+
+            const int iEnd = int(std::min<uint64_t>(chunkCount, i + batchSize));
+            OSD_Parallel::For(i, iEnd, fnDecodeChunk, (iEnd - i) == 1);
+            const uint64_t decodedPointCount = std::min(pointCount, uint64_t(iEnd) * ChunkPointCount);
+            stepProgress.setValue(MathUtils::toPercent(decodedPointCount * recordLength, 0, pointCount * recordLength));
+        }
+    }
+
+    auto pointCloud = std::make_shared<PointCloud>(PointCloudUtils::concatenate(vecPart));
+    vecPart.clear();
+    // Points kept in each chunk may still share voxels with points from other chunks
+    if (decimation.mode == PointCloudDecimation::Mode::VoxelGrid)
+        PointCloudUtils::decimate(pointCloud.get(), decimation);
+
+    m_pointCloud = pointCloud;
+    progress->setValue(100);
+    return true;
+}
+
+TDF_LabelSequence LasReader::transfer(DocumentPtr doc, TaskProgress* /*progress*/)
+{
+    if (!m_pointCloud)
+        return {};
+
+    const TDF_Label entityLabel = PointCloudReaderCommon::addPointCloudEntity(doc, m_pointCloud, m_baseFilename);
+    return CafUtils::makeLabelSequence({ entityLabel });
+}
+
+std::unique_ptr<PropertyGroup> LasReader::createProperties(PropertyGroup* parentGroup)
+{
+    return std::make_unique<PointCloudReaderProperties>(parentGroup);
+}
+
+void LasReader::applyProperties(const PropertyGroup* params)
+{
+    auto ptr = dynamic_cast<const PointCloudReaderProperties*>(params);
+    if (ptr)
+        m_params.decimation = ptr->decimation();
+}
+
+} // namespace IO
+} // namespace Mayo
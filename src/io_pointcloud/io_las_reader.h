@@ -0,0 +1,47 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "../base/io_reader.h"
+#include "../base/io_single_format_factory.h"
+#include "../base/point_cloud.h"
+#include "../base/point_cloud_utils.h"
+
+#include <memory>
+
+namespace Mayo {
+namespace IO {
+
+// Reader for ASPRS LAS file format(versions 1.0 to 1.4, point data record formats 0 to 10)
+// Point records are decoded directly from the memory-mapped file, in parallel chunks
+// Compressed files(LAZ) aren't supported
+class LasReader : public Reader {
+public:
+    bool readFile(const FilePath& filepath, TaskProgress* progress) override;
+    TDF_LabelSequence transfer(DocumentPtr doc, TaskProgress* progress) override;
+
+    static std::unique_ptr<PropertyGroup> createProperties(PropertyGroup* parentGroup);
+    void applyProperties(const PropertyGroup* params) override;
+
+    // Parameters
+    struct Parameters {
+        PointCloudDecimation decimation;
+    };
+    Parameters& parameters() { return m_params; }
+    const Parameters& constParameters() const { return m_params; }
+
+private:
+    Parameters m_params;
+    FilePath m_baseFilename;
+    std::shared_ptr<PointCloud> m_pointCloud;
+};
+
+// Provides factory to create LasReader objects
+class LasFactoryReader : public SingleFormatFactoryReader<Format_LAS, LasReader> {};
+
+} // namespace IO
+} // namespace Mayo
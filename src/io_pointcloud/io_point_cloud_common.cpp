@@ -0,0 +1,62 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "io_point_cloud_common.h"
+
+#include "../base/document.h"
+#include "../base/filepath_conv.h"
+#include "../base/point_cloud_data.h"
+
+#include <TDataStd_Name.hxx>
+#include <limits>
+
+namespace Mayo {
+namespace IO {
+
+PointCloudReaderProperties::PointCloudReaderProperties(PropertyGroup* parentGroup)
+    : PropertyGroup(parentGroup)
+{
+    this->decimationMode.mutableEnumeration().changeTrContext(PointCloudReaderProperties::textIdContext());
+    this->decimationMode.setDescription(
+        textIdTr("Reduce the count of points while reading the file.\n"
+                 "'EveryNth' keeps one point every 'decimationStep' points, 'VoxelGrid' keeps the "
+                 "first point found in each cubic cell of size 'voxelSize'")
+    );
+    this->decimationStep.setConstraintsEnabled(true);
+    this->decimationStep.setRange(1, std::numeric_limits<int>::max());
+    this->voxelSize.setConstraintsEnabled(true);
+    this->voxelSize.setRange(1e-6, std::numeric_limits<double>::max());
+}
+
+void PointCloudReaderProperties::restoreDefaults()
+{
+    const PointCloudDecimation defaults;
+    this->decimationMode.setValue(defaults.mode);
+    this->decimationStep.setValue(defaults.step);
+    this->voxelSize.setValue(defaults.voxelSize);
+}
+
+PointCloudDecimation PointCloudReaderProperties::decimation() const
+{
+    PointCloudDecimation decimation;
+    decimation.mode = this->decimationMode;
+    decimation.step = this->decimationStep;
+    decimation.voxelSize = this->voxelSize;
+    return decimation;
+}
+
+TDF_Label PointCloudReaderCommon::addPointCloudEntity(
+        DocumentPtr doc, const std::shared_ptr<const PointCloud>& pointCloud, const FilePath& baseFilename
+    )
+{
+    const TDF_Label entityLabel = doc->newEntityLabel();
+    PointCloudData::Set(entityLabel, pointCloud);
+    TDataStd_Name::Set(entityLabel, filepathTo<TCollection_ExtendedString>(baseFilename));
+    return entityLabel;
+}
+
+} // namespace IO
+} // namespace Mayo
@@ -0,0 +1,45 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "../base/document_ptr.h"
+#include "../base/filepath.h"
+#include "../base/point_cloud.h"
+#include "../base/point_cloud_utils.h"
+#include "../base/property_builtins.h"
+#include "../base/property_enumeration.h"
+
+#include <TDF_Label.hxx>
+#include <memory>
+
+namespace Mayo {
+namespace IO {
+
+// Properties shared by point cloud readers
+class PointCloudReaderProperties : public PropertyGroup {
+    MAYO_DECLARE_TEXT_ID_FUNCTIONS(Mayo::IO::PointCloudReaderProperties)
+public:
+    PointCloudReaderProperties(PropertyGroup* parentGroup);
+
+    void restoreDefaults() override;
+
+    PointCloudDecimation decimation() const;
+
+    PropertyEnum<PointCloudDecimation::Mode> decimationMode{ this, textId("decimationMode") };
+    PropertyInt decimationStep{ this, textId("decimationStep") };
+    PropertyDouble voxelSize{ this, textId("voxelSize") };
+};
+
+struct PointCloudReaderCommon {
+    // Adds 'pointCloud' as a new entity of 'doc', named 'baseFilename'
+    static TDF_Label addPointCloudEntity(
+            DocumentPtr doc, const std::shared_ptr<const PointCloud>& pointCloud, const FilePath& baseFilename
+    );
+};
+
+} // namespace IO
+} // namespace Mayo
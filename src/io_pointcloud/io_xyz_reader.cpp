@@ -0,0 +1,481 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "io_xyz_reader.h"
+#include "io_point_cloud_common.h"
+
+#include "../base/caf_utils.h"
+#include "../base/cpp_utils.h"
+#include "../base/math_utils.h"
+#include "../base/memory_mapped_file.h"
+#include "../base/messenger.h"
+#include "../base/task_progress.h"
+
+#include <OSD_Parallel.hxx>
+
+#include <fast_float/fast_float.h>
+#include <fmt/format.h>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace Mayo {
+namespace IO {
+
+struct XyzReaderI18N { MAYO_DECLARE_TEXT_ID_FUNCTIONS(Mayo::IO::XyzReaderI18N) };
+
+namespace {
+
+constexpr size_t ChunkSize = 4 * 1024 * 1024;
+constexpr int MaxColumnCount = 32;
+
+bool isBlank(char ch)
+{
+    return ch == ' ' || ch == '\t' || ch == '\r';
+}
+
+bool isSeparator(char ch)
+{
+    return isBlank(ch) || ch == ',' || ch == ';';
+}
+
+// Returns the end of the line starting at 'pos'(ie position of '\n' or 'end')
+const char* findLineEnd(const char* pos, const char* end)
+{
+    auto posNewLine = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+    return posNewLine ? posNewLine : end;
+}
+
+bool isBlankOrCommentLine(const char* pos, const char* end)
+{
+    while (pos != end && isBlank(*pos))
+        ++pos;
+
+    return pos == end || *pos == '#' || (end - pos >= 2 && pos[0] == '/' && pos[1] == '/');
+}
+
+// Reads at most 'maxCount' numbers from line [pos, end) into 'values'
+// Reading stops at the first token that isn't a number. Returns the count of values read
+int readValues(const char* pos, const char* end, double* values, int maxCount)
+{
+    int count = 0;
+    while (count < maxCount) {
+        while (pos != end && isSeparator(*pos))
+            ++pos;
+
+        if (pos == end)
+            break;
+
+        if (*pos == '+')
+            ++pos;
+
+        const auto res = fast_float::from_chars(pos, end, values[count]);
+        if (res.ec != std::errc())
+            break;
+
+        pos = res.ptr;
+        ++count;
+    }
+
+    return count;
+}
+
+// Splits header line into lower-case column names, quotes and leading '/'(eg "//X") are removed
+std::vector<std::string> splitColumnNames(const char* pos, const char* end)
+{
+    std::vector<std::string> vecName;
+    while (pos != end) {
+        while (pos != end && isSeparator(*pos))
+            ++pos;
+
+        std::string name;
+        for (; pos != end && !isSeparator(*pos); ++pos) {
+            if (*pos != '"' && *pos != '\'' && !(*pos == '/' && name.empty()))
+                name += char(std::tolower(static_cast<unsigned char>(*pos)));
+        }
+
+        if (!name.empty())
+            vecName.push_back(std::move(name));
+    }
+
+    return vecName;
+}
+
+// Indices of the columns providing point attributes, -1 if absent
+struct ColumnLayout {
+    int x = 0;
+    int y = 1;
+    int z = 2;
+    int intensity = -1;
+    int red = -1;
+    int green = -1;
+    int blue = -1;
+    int nx = -1;
+    int ny = -1;
+    int nz = -1;
+
+    bool hasCoords() const { return x >= 0 && y >= 0 && z >= 0; }
+    bool hasColors() const { return red >= 0 && green >= 0 && blue >= 0; }
+    bool hasNormals() const { return nx >= 0 && ny >= 0 && nz >= 0; }
+    bool hasIntensity() const { return intensity >= 0; }
+
+    // Minimum count of values a line must provide
+    int requiredValueCount() const {
+        return 1 + std::max({ x, y, z, intensity, red, green, blue, nx, ny, nz });
+    }
+};
+
+ColumnLayout columnLayoutFromNames(const std::vector<std::string>& vecName)
+{
+    ColumnLayout layout;
+    layout.x = layout.y = layout.z = -1;
+    auto fnIsAnyOf = [](const std::string& name, std::initializer_list<std::string_view> candidates) {
+        return std::find(candidates.begin(), candidates.end(), name) != candidates.end();
+    };
+    const int count = std::min(int(vecName.size()), MaxColumnCount);
+    for (int i = 0; i < count; ++i) {
+        const std::string& name = vecName.at(i);
+        if (fnIsAnyOf(name, { "x" }))
+            layout.x = i;
+        else if (fnIsAnyOf(name, { "y" }))
+            layout.y = i;
+        else if (fnIsAnyOf(name, { "z" }))
+            layout.z = i;
+        else if (fnIsAnyOf(name, { "i", "intensity", "scalar_intensity" }))
+            layout.intensity = i;
+        else if (fnIsAnyOf(name, { "r", "red" }))
+            layout.red = i;
+        else if (fnIsAnyOf(name, { "g", "green" }))
+            layout.green = i;
+        else if (fnIsAnyOf(name, { "b", "blue" }))
+            layout.blue = i;
+        else if (fnIsAnyOf(name, { "nx", "normal_x", "normalx" }))
+            layout.nx = i;
+        else if (fnIsAnyOf(name, { "ny", "normal_y", "normaly" }))
+            layout.ny = i;
+        else if (fnIsAnyOf(name, { "nz", "normal_z", "normalz" }))
+            layout.nz = i;
+    }
+
+    return layout;
+}
+
+// Guess attributes from the count of values per line, following common conventions:
+//     "x y z i", "x y z r g b", "x y z nx ny nz"(xyzn files), "x y z i r g b"(PTS), "x y z r g b nx ny nz"
+ColumnLayout columnLayoutFromCount(int count, bool preferNormals)
+{
+    ColumnLayout layout;
+    if (count == 4) {
+        layout.intensity = 3;
+    }
+    else if (count == 6 && preferNormals) {
+        layout.nx = 3; layout.ny = 4; layout.nz = 5;
+    }
+    else if (count == 6 || count == 8) {
+        layout.red = 3; layout.green = 4; layout.blue = 5;
+    }
+    else if (count == 7) {
+        layout.intensity = 3;
+        layout.red = 4; layout.green = 5; layout.blue = 6;
+    }
+    else if (count >= 9) {
+        layout.red = 3; layout.green = 4; layout.blue = 5;
+        layout.nx = 6; layout.ny = 7; layout.nz = 8;
+    }
+
+    return layout;
+}
+
+// Part of the file body to be processed in one go by a parsing thread
+// Chunks always start at the beginning of a line
+struct Chunk {
+    const char* begin = nullptr;
+    const char* end = nullptr;
+    PointCloud pointCloud;
+    int64_t invalidLineCount = 0;
+    // Color values as read, converted once the range of values in the whole file is known
+    std::vector<PointCloud::Vec3f> vecRawColor;
+    bool hasColorAboveOne = false;
+    bool hasFractionalColor = false;
+};
+
+void parseChunk(
+        Chunk* chunk, const ColumnLayout& layout, Format format, const gp_XYZ& origin, const PointCloudDecimation& decimation
+    )
+{
+    std::optional<VoxelGridSampler> voxelSampler;
+    if (decimation.mode == PointCloudDecimation::Mode::VoxelGrid)
+        voxelSampler.emplace(decimation.voxelSize);
+
+    // Decimation by step is applied on the data lines of each chunk
+    const int64_t step = decimation.mode == PointCloudDecimation::Mode::EveryNth ? std::max(1, decimation.step) : 1;
+    int64_t dataLineId = 0;
+
+    // Rough estimation, assuming ~32 bytes per line
+    PointCloud& pointCloud = chunk->pointCloud;
+    pointCloud.setOrigin(origin);
+    pointCloud.reserve(size_t(chunk->end - chunk->begin) / (32 * step));
+
+    const int requiredValueCount = layout.requiredValueCount();
+    double values[MaxColumnCount] = {};
+    const char* pos = chunk->begin;
+    while (pos < chunk->end) {
+        const char* lineEnd = findLineEnd(pos, chunk->end);
+        const char* lineBegin = pos;
+        pos = lineEnd != chunk->end ? lineEnd + 1 : chunk->end;
+        if (isBlankOrCommentLine(lineBegin, lineEnd))
+            continue;
+
+        const int valueCount = readValues(lineBegin, lineEnd, values, requiredValueCount);
+        if (valueCount < requiredValueCount) {
+            // PTS files might be made of several scans, each one starting with a count of points
+            if (!(format == Format_PTS && valueCount == 1))
+                ++chunk->invalidLineCount;
+
+            continue;
+        }
+
+        if (dataLineId++ % step != 0)
+            continue;
+
+        const PointCloud::Vec3f position(
+            float(values[layout.x] - origin.X()), float(values[layout.y] - origin.Y()), float(values[layout.z] - origin.Z())
+        );
+        if (voxelSampler && !voxelSampler->tryAdd(position))
+            continue;
+
+        pointCloud.positions().push_back(position);
+        if (layout.hasColors()) {
+            for (int icol : { layout.red, layout.green, layout.blue }) {
+                const double value = values[icol];
+                chunk->hasColorAboveOne = chunk->hasColorAboveOne || value > 1.;
+                chunk->hasFractionalColor = chunk->hasFractionalColor || value != std::floor(value);
+            }
+
+            chunk->vecRawColor.emplace_back(
+                float(values[layout.red]), float(values[layout.green]), float(values[layout.blue])
+            );
+        }
+
+        if (layout.hasNormals()) {
+            pointCloud.normals().emplace_back(
+                float(values[layout.nx]), float(values[layout.ny]), float(values[layout.nz])
+            );
+        }
+
+        if (layout.hasIntensity())
+            pointCloud.intensities().push_back(float(values[layout.intensity]));
+    }
+}
+
+} // namespace
+
+XyzReader::XyzReader(Format format)
+    : m_format(format)
+{
+}
+
+bool XyzReader::readFile(const FilePath& filepath, TaskProgress* progress)
+{
+    progress = progress ? progress : &TaskProgress::null();
+    auto fnError = [=](std::string_view strMessage) {
+        this->messenger()->emitError(strMessage);
+        return false;
+    };
+
+    m_baseFilename = filepath.stem();
+    m_pointCloud.reset();
+
+    MemoryMappedFile file;
+    if (!file.open(filepath))
+        return fnError(XyzReaderI18N::textIdTr("Can't open input file"));
+
+    // Consume header: count of points(PTS) and/or column names(CSV), until first data line
+    const char* const fileEnd = file.end();
+    const char* bodyBegin = fileEnd;
+    bool hasPointCountLine = false;
+    std::vector<std::string> vecColumnName;
+    double firstLineValues[MaxColumnCount] = {};
+    int firstLineValueCount = 0;
+    for (const char* pos = file.begin(); pos < fileEnd; ) {
+        const char* lineEnd = findLineEnd(pos, fileEnd);
+        const char* lineBegin = pos;
+        pos = lineEnd != fileEnd ? lineEnd + 1 : fileEnd;
+        if (isBlankOrCommentLine(lineBegin, lineEnd))
+            continue;
+
+        const int valueCount = readValues(lineBegin, lineEnd, firstLineValues, MaxColumnCount);
+        if (m_format == Format_PTS && valueCount == 1 && !hasPointCountLine) {
+            hasPointCountLine = true;
+        }
+        else if (valueCount == 0 && vecColumnName.empty()) {
+            vecColumnName = splitColumnNames(lineBegin, lineEnd);
+        }
+        else {
+            firstLineValueCount = valueCount;
+            bodyBegin = lineBegin;
+            break;
+        }
+    }
+
+    if (bodyBegin == fileEnd)
+        return fnError(XyzReaderI18N::textIdTr("No point found"));
+
+    const bool preferNormals = filepath.extension().u8string() == ".xyzn";
+    const ColumnLayout layout =
+        !vecColumnName.empty() ?
+            columnLayoutFromNames(vecColumnName) :
+            columnLayoutFromCount(firstLineValueCount, preferNormals)
+        ;
+    if (!layout.hasCoords())
+        return fnError(XyzReaderI18N::textIdTr("Missing X, Y or Z column"));
+
+    // Positions are stored relative to the first point, absolute coordinates(eg georeferenced)
+    // would exceed the precision of floats
+    gp_XYZ origin;
+    if (layout.requiredValueCount() <= firstLineValueCount)
+        origin.SetCoord(firstLineValues[layout.x], firstLineValues[layout.y], firstLineValues[layout.z]);
+
+    // Split file body into chunks starting at line boundaries
+    std::vector<Chunk> vecChunk;
+    for (const char* pos = bodyBegin; pos < fileEnd; ) {
+        Chunk chunk;
+        chunk.begin = pos;
+        chunk.end = fileEnd;
+        if (CppUtils::cmpLess(ChunkSize, fileEnd - pos)) {
+            const char* lineEnd = findLineEnd(pos + ChunkSize, fileEnd);
+            chunk.end = lineEnd != fileEnd ? lineEnd + 1 : fileEnd;
+        }
+
+        vecChunk.push_back(std::move(chunk));
+        pos = vecChunk.back().end;
+    }
+
+    // Parse chunks concurrently
+    // Chunks are processed by batches so progress(bytes consumed) can be reported and abort
+    // checked in the calling thread
+    {
+        TaskProgress stepProgress(progress, 90, XyzReaderI18N::textIdTr("Parse points"));
+        const int chunkCount = CppUtils::safeStaticCast<int>(vecChunk.size());
+        const int batchSize = std::max(1, 2 * int(std::thread::hardware_concurrency()));
+        for (int i = 0; i < chunkCount; i += batchSize) {
+            if (stepProgress.isAbortRequested())
+                return false;
+
+            const int iEnd = std::min(chunkCount, i + batchSize);
+            OSD_Parallel::For(i, iEnd, [&](int iChunk) {
+                parseChunk(&vecChunk.at(iChunk), layout, m_format, origin, m_params.decimation);
+            }, (iEnd - i) == 1);
+            stepProgress.setValue(MathUtils::toPercent(vecChunk.at(iEnd - 1).end - bodyBegin, 0, fileEnd - bodyBegin));
+        }
+    }
+
+    // Color values are normalized in [0, 1] if none of them exceeds 1 and some aren't integers
+    if (layout.hasColors()) {
+        auto fnHas = [&](bool Chunk::*flag) {
+            return std::any_of(vecChunk.cbegin(), vecChunk.cend(), [=](const Chunk& chunk) { return chunk.*flag; });
+        };
+        const bool isNormalized = !fnHas(&Chunk::hasColorAboveOne) && fnHas(&Chunk::hasFractionalColor);
+        const float colorFactor = isNormalized ? 255.f : 1.f;
+        auto fnToColorComponent = [=](float value) {
+            return uint8_t(std::clamp(value * colorFactor, 0.f, 255.f));
+        };
+        OSD_Parallel::For(0, int(vecChunk.size()), [&](int iChunk) {
+            Chunk& chunk = vecChunk.at(iChunk);
+            std::vector<PointCloud::Color>& colors = chunk.pointCloud.colors();
+            colors.reserve(chunk.vecRawColor.size());
+            for (const PointCloud::Vec3f& rawColor : chunk.vecRawColor) {
+                colors.push_back({
+                    fnToColorComponent(rawColor.r()), fnToColorComponent(rawColor.g()), fnToColorComponent(rawColor.b())
+                });
+            }
+
+            chunk.vecRawColor = {};
+        }, vecChunk.size() == 1);
+    }
+
+    int64_t invalidLineCount = 0;
+    size_t pointCount = 0;
+    std::vector<PointCloud> vecPart;
+    for (Chunk& chunk : vecChunk) {
+        invalidLineCount += chunk.invalidLineCount;
+        pointCount += chunk.pointCloud.pointCount();
+        vecPart.push_back(std::move(chunk.pointCloud));
+    }
+
+    vecChunk.clear();
+    if (invalidLineCount > 0) {
+        this->messenger()->emitWarning(
+            fmt::format(XyzReaderI18N::textIdTr("{} lines ignored(not enough values)"), invalidLineCount)
+        );
+    }
+
+    if (pointCount > std::numeric_limits<uint32_t>::max())
+        return fnError(XyzReaderI18N::textIdTr("Too many points, consider decimation on import"));
+
+    auto pointCloud = std::make_shared<PointCloud>(PointCloudUtils::concatenate(vecPart));
+    vecPart.clear();
+    // Points kept in each chunk may still share voxels with points from other chunks
+    if (m_params.decimation.mode == PointCloudDecimation::Mode::VoxelGrid)
+        PointCloudUtils::decimate(pointCloud.get(), m_params.decimation);
+
+    m_pointCloud = pointCloud;
+    progress->setValue(100);
+    return true;
+}
+
+TDF_LabelSequence XyzReader::transfer(DocumentPtr doc, TaskProgress* /*progress*/)
+{
+    if (!m_pointCloud)
+        return {};
+
+    const TDF_Label entityLabel = PointCloudReaderCommon::addPointCloudEntity(doc, m_pointCloud, m_baseFilename);
+    return CafUtils::makeLabelSequence({ entityLabel });
+}
+
+std::unique_ptr<PropertyGroup> XyzReader::createProperties(PropertyGroup* parentGroup)
+{
+    return std::make_unique<PointCloudReaderProperties>(parentGroup);
+}
+
+void XyzReader::applyProperties(const PropertyGroup* params)
+{
+    auto ptr = dynamic_cast<const PointCloudReaderProperties*>(params);
+    if (ptr)
+        m_params.decimation = ptr->decimation();
+}
+
+Span<const Format> XyzFactoryReader::formats() const
+{
+    static const Format arrayFormat[] = { Format_XYZ, Format_PTS };
+    return arrayFormat;
+}
+
+std::unique_ptr<Reader> XyzFactoryReader::create(Format format) const
+{
+    if (format == Format_XYZ || format == Format_PTS)
+        return std::make_unique<XyzReader>(format);
+
+    return {};
+}
+
+std::unique_ptr<PropertyGroup> XyzFactoryReader::createProperties(Format format, PropertyGroup* parentGroup) const
+{
+    if (format == Format_XYZ || format == Format_PTS)
+        return XyzReader::createProperties(parentGroup);
+
+    return {};
+}
+
+} // namespace IO
+} // namespace Mayo
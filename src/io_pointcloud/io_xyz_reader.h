@@ -0,0 +1,54 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "../base/io_reader.h"
+#include "../base/point_cloud.h"
+#include "../base/point_cloud_utils.h"
+
+#include <memory>
+
+namespace Mayo {
+namespace IO {
+
+// Reader for ASCII point cloud files: XYZ(one point per line, values separated by blanks, ',' or
+// ';'), CSV with optional header line providing column names, and PTS(count of points on first line)
+// The memory-mapped file is parsed in parallel chunks starting at line boundaries
+class XyzReader : public Reader {
+public:
+    XyzReader(Format format = Format_XYZ);
+
+    bool readFile(const FilePath& filepath, TaskProgress* progress) override;
+    TDF_LabelSequence transfer(DocumentPtr doc, TaskProgress* progress) override;
+
+    static std::unique_ptr<PropertyGroup> createProperties(PropertyGroup* parentGroup);
+    void applyProperties(const PropertyGroup* params) override;
+
+    // Parameters
+    struct Parameters {
+        PointCloudDecimation decimation;
+    };
+    Parameters& parameters() { return m_params; }
+    const Parameters& constParameters() const { return m_params; }
+
+private:
+    Format m_format = Format_XYZ;
+    Parameters m_params;
+    FilePath m_baseFilename;
+    std::shared_ptr<PointCloud> m_pointCloud;
+};
+
+// Provides factory to create XyzReader objects for XYZ and PTS formats
+class XyzFactoryReader : public FactoryReader {
+public:
+    Span<const Format> formats() const override;
+    std::unique_ptr<Reader> create(Format format) const override;
+    std::unique_ptr<PropertyGroup> createProperties(Format format, PropertyGroup* parentGroup) const override;
+};
+
+} // namespace IO
+} // namespace Mayo
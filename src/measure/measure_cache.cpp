@@ -0,0 +1,53 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "measure_cache.h"
+#include "../base/mesh_bvh.h"
+
+namespace Mayo {
+
+std::optional<MassProperties> MeasureCache::findMassProperties(const TopoDS_Shape& shape) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto itEntry = m_mapMassProps.find(shape.TShape().get());
+    if (itEntry != m_mapMassProps.cend())
+        return itEntry->second.props;
+
+    return {};
+}
+
+void MeasureCache::addMassProperties(const TopoDS_Shape& shape, const MassProperties& props)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_mapMassProps.insert({ shape.TShape().get(), MassPropertiesEntry{ shape, props } });
+}
+
+MeasureCache::MeshBvhPtr MeasureCache::findMeshBvh(const OccHandle<Poly_Triangulation>& triangulation) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto itEntry = m_mapMeshBvh.find(triangulation.get());
+    if (itEntry != m_mapMeshBvh.cend())
+        return itEntry->second.bvh;
+
+    return {};
+}
+
+MeasureCache::MeshBvhPtr MeasureCache::addMeshBvh(const OccHandle<Poly_Triangulation>& triangulation, const MeshBvhPtr& bvh)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto itEntry = m_mapMeshBvh.insert({ triangulation.get(), MeshBvhEntry{ triangulation, bvh } }).first;
+    return itEntry->second.bvh;
+}
+
+void MeasureCache::clear()
+{
+    m_bndBoxCache.clear();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_mapMassProps.clear();
+    m_mapMeshBvh.clear();
+}
+
+} // namespace Mayo
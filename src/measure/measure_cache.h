@@ -0,0 +1,64 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "../base/brep_bnd_box_cache.h"
+#include "../base/mass_properties.h"
+#include "../base/occ_handle.h"
+
+#include <Poly_Triangulation.hxx>
+#include <TopoDS_Shape.hxx>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+namespace Mayo {
+
+class MeshBvh;
+
+// Results of costly computations shared by the measure tools working on the same document
+//
+// Results are kept per product(location-free shape or triangulation), so instances of a product
+// share them. Cached products are held by the cache, it has to be cleared(eg by its owner
+// when entities of the document are destroyed) so they can be released
+// All functions are thread-safe
+class MeasureCache {
+public:
+    // Optimal bounding boxes of BRep shapes
+    BRepBndBoxCache& bndBoxCache() { return m_bndBoxCache; }
+
+    // Volume properties of location-free 'shape'
+    std::optional<MassProperties> findMassProperties(const TopoDS_Shape& shape) const;
+    void addMassProperties(const TopoDS_Shape& shape, const MassProperties& props);
+
+    // Bounding volume hierarchy of whole 'triangulation'
+    using MeshBvhPtr = std::shared_ptr<const MeshBvh>;
+    MeshBvhPtr findMeshBvh(const OccHandle<Poly_Triangulation>& triangulation) const;
+    // Returns the hierarchy actually stored, which can be one added concurrently
+    MeshBvhPtr addMeshBvh(const OccHandle<Poly_Triangulation>& triangulation, const MeshBvhPtr& bvh);
+
+    void clear();
+
+private:
+    struct MassPropertiesEntry {
+        TopoDS_Shape shape;
+        MassProperties props;
+    };
+
+    struct MeshBvhEntry {
+        OccHandle<Poly_Triangulation> triangulation;
+        MeshBvhPtr bvh;
+    };
+
+    BRepBndBoxCache m_bndBoxCache{ BRepBndBoxCache::Mode::Optimal };
+    mutable std::mutex m_mutex;
+    std::unordered_map<const TopoDS_TShape*, MassPropertiesEntry> m_mapMassProps;
+    std::unordered_map<const Poly_Triangulation*, MeshBvhEntry> m_mapMeshBvh;
+};
+
+} // namespace Mayo
@@ -51,6 +51,8 @@ std::unique_ptr<IMeasureDisplay> BaseMeasureDisplay::createFrom(MeasureType type
         return std::make_unique<MeasureDisplayArea>(std::get<MeasureArea>(value));
     case MeasureType::BoundingBox:
         return std::make_unique<MeasureDisplayBoundingBox>(std::get<MeasureBoundingBox>(value));
+    case MeasureType::MassProperties:
+        return std::make_unique<MeasureDisplayMassProperties>(std::get<MeasureMassProperties>(value));
     default:
         return {};
     }
@@ -63,6 +65,8 @@ std::unique_ptr<IMeasureDisplay> BaseMeasureDisplay::createEmptySumFrom(MeasureT
         return std::make_unique<MeasureDisplayLength>(Mayo::MeasureLength{});
     case MeasureType::Area:
         return std::make_unique<MeasureDisplayArea>(Mayo::MeasureArea{});
+    case MeasureType::MassProperties:
+        return std::make_unique<MeasureDisplayMassProperties>(Mayo::MeasureMassProperties{});
     default:
         return {};
     }
@@ -533,4 +537,95 @@ GraphicsObjectPtr MeasureDisplayBoundingBox::graphicsObjectAt(int i) const
     return {};
 }
 
+// --
+// -- Mass Properties
+// --
+
+MeasureDisplayMassProperties::MeasureDisplayMassProperties(const MeasureMassProperties& props)
+    : m_props(props),
+      m_gfxCenterPoint(new AIS_Point(new Geom_CartesianPoint(this->centerOfMass()))),
+      m_gfxText(new AIS_TextLabel)
+{
+    m_gfxText->SetPosition(this->centerOfMass());
+    BaseMeasureDisplay::applyGraphicsDefaults(this);
+}
+
+void MeasureDisplayMassProperties::update(const MeasureDisplayConfig& config)
+{
+    const auto trVolume = UnitSystem::translateVolume(m_props.volumeProps.mass * Quantity_CubicMillimeter, config.volumeUnit);
+    const auto strVolume = BaseMeasureDisplay::text(trVolume, config);
+    std::string strText = fmt::format(
+        MeasureDisplayI18N::textIdTr("{0}: {1}{2}"),
+        BaseMeasureDisplay::sumTextOr(MeasureDisplayI18N::textIdTr("Volume")),
+        strVolume,
+        trVolume.strUnit
+    );
+    if (m_props.massProps) {
+        const MassProperties& massProps = *m_props.massProps;
+        const auto trMass = UnitSystem::translate(UnitSystem::SI, massProps.mass * Quantity_Kilogram);
+        // Inertia is stored in kg.mm², converted to kg.L² where L is the length unit of 'config'
+        const auto trUnitLength = UnitSystem::translateLength(1 * Quantity_Millimeter, config.lengthUnit);
+        const double inertiaFactor = trUnitLength.value * trUnitLength.value;
+        auto fnInertia = [&](int row, int col) {
+            return BaseMeasureDisplay::text(massProps.inertia.Value(row, col) * inertiaFactor, config);
+        };
+        strText += fmt::format(
+            MeasureDisplayI18N::textIdTr(
+                "<br>Mass: {0}{1}<br>Center of mass: {2}"
+                "<br>Inertia(kg.{3}²): Ixx {4} Iyy {5} Izz {6}"
+                "<br>Ixy {7} Ixz {8} Iyz {9}"
+            ),
+            BaseMeasureDisplay::text(trMass, config),
+            trMass.strUnit,
+            BaseMeasureDisplay::text(massProps.centerOfMass, config),
+            trUnitLength.strUnit,
+            fnInertia(1, 1), fnInertia(2, 2), fnInertia(3, 3),
+            fnInertia(1, 2), fnInertia(1, 3), fnInertia(2, 3)
+        );
+    }
+    else {
+        strText += fmt::format(
+            MeasureDisplayI18N::textIdTr("<br>Mass: unknown(material density not defined)<br>Center of volume: {0}"),
+            BaseMeasureDisplay::text(m_props.volumeProps.centerOfMass, config)
+        );
+    }
+
+    this->setText(strText);
+    m_gfxText->SetText(to_OccExtString(" " + strVolume + trVolume.strUnit));
+    BaseMeasureDisplay::adaptScale(m_gfxText, config);
+}
+
+GraphicsObjectPtr MeasureDisplayMassProperties::graphicsObjectAt(int i) const
+{
+    switch (i) {
+    case 0: return m_gfxCenterPoint;
+    case 1: return m_gfxText;
+    }
+
+    return {};
+}
+
+void MeasureDisplayMassProperties::sumAdd(const IMeasureDisplay& other)
+{
+    const auto& otherProps = dynamic_cast<const MeasureDisplayMassProperties&>(other).m_props;
+    if (BaseMeasureDisplay::sumCount() == 0) {
+        m_props = otherProps;
+    }
+    else {
+        // Mass is known only if density is known for all the measured entities
+        m_props.volumeProps.add(otherProps.volumeProps);
+        if (m_props.massProps && otherProps.massProps)
+            m_props.massProps->add(*otherProps.massProps);
+        else
+            m_props.massProps.reset();
+    }
+
+    BaseMeasureDisplay::sumAdd(other);
+}
+
+gp_Pnt MeasureDisplayMassProperties::centerOfMass() const
+{
+    return m_props.massProps ? m_props.massProps->centerOfMass : m_props.volumeProps.centerOfMass;
+}
+
 } // namespace Mayo
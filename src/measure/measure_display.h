@@ -250,4 +250,26 @@ private:
     OccHandle<AIS_TextLabel> m_gfxZLengthText;
 };
 
+// --
+// -- Mass Properties
+// --
+
+class MeasureDisplayMassProperties : public BaseMeasureDisplay {
+public:
+    MeasureDisplayMassProperties(const MeasureMassProperties& props);
+    void update(const MeasureDisplayConfig& config) override;
+    int graphicsObjectsCount() const override { return 2; }
+    GraphicsObjectPtr graphicsObjectAt(int i) const override;
+
+    bool isSumSupported() const override { return true; }
+    void sumAdd(const IMeasureDisplay& other) override;
+
+private:
+    gp_Pnt centerOfMass() const;
+
+    MeasureMassProperties m_props;
+    OccHandle<AIS_Point> m_gfxCenterPoint;
+    OccHandle<AIS_TextLabel> m_gfxText;
+};
+
 } // namespace Mayo
@@ -6,10 +6,12 @@
 
 #include "measure_tool.h"
 
+#include "../base/task_progress.h"
+
 namespace Mayo {
 
 MeasureValue IMeasureTool_computeValue(
-        const IMeasureTool& tool, MeasureType type, const GraphicsOwnerPtr& owner
+        const IMeasureTool& tool, MeasureType type, const GraphicsOwnerPtr& owner, TaskProgress* progress
     )
 {
     MeasureValue value;
@@ -25,6 +27,13 @@ MeasureValue IMeasureTool_computeValue(
         return tool.area(owner);
     case MeasureType::BoundingBox:
         return tool.boundingBox(owner);
+    case MeasureType::MassProperties: {
+        const MeasureMassProperties measure = tool.massProperties(owner, progress);
+        if (progress && progress->isAbortRequested())
+            return value;
+
+        return measure;
+    }
     default:
         return value;
     } // endswitch
@@ -55,4 +64,18 @@ bool MeasureValue_isValid(const MeasureValue& value)
     return !std::holds_alternative<MeasureNone>(value);
 }
 
+void MeasureMassProperties_applyDensity(MeasureMassProperties* measure, QuantityDensity density)
+{
+    if (!measure)
+        return;
+
+    if (density.value() > 0.) {
+        // Density is in kg/m³ and volume in mm³
+        measure->massProps = measure->volumeProps.scaled(density.value() * 1e-9);
+    }
+    else {
+        measure->massProps.reset();
+    }
+}
+
 } // namespace Mayo
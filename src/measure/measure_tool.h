@@ -7,6 +7,7 @@
 #pragma once
 
 #include "measure_type.h"
+#include "../base/mass_properties.h"
 #include "../base/quantity.h"
 #include "../base/span.h"
 #include "../graphics/graphics_object_ptr.h"
@@ -16,11 +17,14 @@
 #include <gp_Lin.hxx>
 #include <gp_Pnt.hxx>
 
+#include <optional>
 #include <string_view>
 #include <variant>
 
 namespace Mayo {
 
+class TaskProgress;
+
 enum class DistanceType {
     None,
     Mininmum,
@@ -96,8 +100,19 @@ struct MeasureBoundingBox {
     QuantityVolume volume;
 };
 
+// Measure of the mass properties of solid entities
+struct MeasureMassProperties {
+    // Properties at unit density: mass is the volume(mm³), inertia the second moment of volume(mm⁵)
+    MassProperties volumeProps;
+    // Properties taking into account the material density: mass in kg, inertia in kg.mm²
+    // Available only if the density of all measured entities is known
+    std::optional<MassProperties> massProps;
+};
+
 // Provides an interface to various measurement services
 // Input data of a measure service is one or many graphics entities pointed to by GraphicsOwner objects
+// Measure services can be called concurrently from worker threads, so they must not modify any
+// shared state without synchronization
 class IMeasureTool {
 public:
     virtual ~IMeasureTool() = default;
@@ -114,6 +129,9 @@ public:
     virtual MeasureLength length(const GraphicsOwnerPtr& owner) const = 0;
     virtual MeasureArea area(const GraphicsOwnerPtr& owner) const = 0;
     virtual MeasureBoundingBox boundingBox(const GraphicsOwnerPtr& owner) const = 0;
+    // Might be a long operation, can be aborted with 'progress'
+    // Returned measure provides only volume properties, see MeasureMassProperties_applyDensity()
+    virtual MeasureMassProperties massProperties(const GraphicsOwnerPtr& owner, TaskProgress* progress) const = 0;
 };
 
 // Base interface for errors reported by measurement services of IMeasureTool
@@ -131,15 +149,21 @@ using MeasureValue = std::variant<
             MeasureAngle,
             MeasureLength,
             MeasureArea,
-            MeasureBoundingBox
+            MeasureBoundingBox,
+            MeasureMassProperties
       >;
 
 bool MeasureValue_isValid(const MeasureValue& res);
 
+// Completes 'measure' with mass properties of a material of uniform 'density'
+// Null density means the density is unknown, mass properties are then dropped
+void MeasureMassProperties_applyDensity(MeasureMassProperties* measure, QuantityDensity density);
+
 MeasureValue IMeasureTool_computeValue(
         const IMeasureTool& tool,
         MeasureType type,
-        const GraphicsOwnerPtr& owner
+        const GraphicsOwnerPtr& owner,
+        TaskProgress* progress = nullptr
 );
 
 MeasureValue IMeasureTool_computeValue(
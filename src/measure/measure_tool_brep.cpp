@@ -11,16 +11,15 @@
 #include "../base/math_utils.h"
 #include "../base/mesh_utils.h"
 #include "../base/occ_handle.h"
+#include "../base/task_progress.h"
 #include "../base/text_id.h"
 #include "../graphics/graphics_shape_object_driver.h"
 
 #include <gp_Elips.hxx>
 #include <AIS_Shape.hxx>
-#include <Bnd_OBB.hxx>
 #include <BRep_Tool.hxx>
 #include <BRepAdaptor_Curve.hxx>
 #include <BRepAdaptor_Surface.hxx>
-#include <BRepBndLib.hxx>
 #include <BRepBuilderAPI_Transform.hxx>
 #include <BRepExtrema_DistShapeShape.hxx>
 #include <BRepGProp.hxx>
@@ -61,7 +60,8 @@ enum class ErrorCode {
     NotLinearEdge,
     NotAllFaces,
     ParallelEdges,
-    BoundingBoxIsVoid
+    BoundingBoxIsVoid,
+    NullVolume
 };
 
 template<ErrorCode Err>
@@ -95,6 +95,8 @@ public:
             return textIdTr("Entities must not be parallel");
         case ErrorCode::BoundingBoxIsVoid:
             return textIdTr("Bounding box computed is void");
+        case ErrorCode::NullVolume:
+            return textIdTr("Entity has no volume");
         default:
             return textIdTr("Unknown error");
         }
@@ -160,6 +162,11 @@ gp_Pnt computeShapeCenter(const TopoDS_Shape& shape)
 }
 } // namespace
 
+MeasureToolBRep::MeasureToolBRep(const std::shared_ptr<MeasureCache>& cache)
+    : m_cache(cache ? cache : std::make_shared<MeasureCache>())
+{
+}
+
 Span<const GraphicsObjectSelectionMode> MeasureToolBRep::selectionModes(MeasureType type) const
 {
     switch (type) {
@@ -187,7 +194,8 @@ Span<const GraphicsObjectSelectionMode> MeasureToolBRep::selectionModes(MeasureT
         static const GraphicsObjectSelectionMode modes[] = { AIS_Shape::SelectionMode(TopAbs_FACE) };
         return modes;
     }
-    case MeasureType::BoundingBox: {
+    case MeasureType::BoundingBox:
+    case MeasureType::MassProperties: {
         static const GraphicsObjectSelectionMode modes[] = {
             //AIS_Shape::SelectionMode(TopAbs_FACE),
             //AIS_Shape::SelectionMode(TopAbs_SOLID)
@@ -249,7 +257,30 @@ MeasureArea MeasureToolBRep::area(const GraphicsOwnerPtr& owner) const
 
 MeasureBoundingBox MeasureToolBRep::boundingBox(const GraphicsOwnerPtr& owner) const
 {
-    return brepBoundingBox(getShape(owner));
+    return toMeasureBoundingBox(m_cache->bndBoxCache().get(getShape(owner)));
+}
+
+MeasureMassProperties MeasureToolBRep::massProperties(const GraphicsOwnerPtr& owner, TaskProgress* progress) const
+{
+    const TopoDS_Shape shape = getShape(owner);
+    throwErrorIf<ErrorCode::NotBRepShape>(shape.IsNull());
+
+    // Properties are computed once per product, then moved to the location of the instance
+    const TopoDS_Shape productShape = shape.Located(TopLoc_Location());
+    std::optional<MassProperties> productProps = m_cache->findMassProperties(productShape);
+    if (!productProps) {
+        productProps = MassProperties::compute(productShape, progress);
+        if (progress && progress->isAbortRequested())
+            return {};
+
+        m_cache->addMassProperties(productShape, *productProps);
+    }
+
+    throwErrorIf<ErrorCode::NullVolume>(productProps->isNull());
+    MeasureMassProperties measure;
+    const TopLoc_Location& loc = shape.Location();
+    measure.volumeProps = loc.IsIdentity() ? *productProps : productProps->transformed(loc.Transformation());
+    return measure;
 }
 
 gp_Pnt MeasureToolBRep::brepVertexPosition(const TopoDS_Shape& shape)
@@ -540,28 +571,31 @@ MeasureArea MeasureToolBRep::brepArea(const TopoDS_Shape& shape)
 
 MeasureBoundingBox MeasureToolBRep::brepBoundingBox(const TopoDS_Shape& shape)
 {
-    MeasureBoundingBox measure;
-#if 0
-    Bnd_OBB bnd;
-    BRepBndLib::AddOBB(shape, bnd);
-    //BRepBndLib::AddOBB(shape, bnd, false/*!useTriangulation*/, true/*optimal*/, false/*!useShapeTolerance*/);
-
-    gp_Pnt points[8] = {};
-    bnd.GetVertex(points);
-    measure.cornerMin = points[0];
-    measure.cornerMax = points[7];
-    //measure.isAxisAligned = bnd.IsAABox();
-#else
-    Bnd_Box bnd;
-    BRepBndLib::AddOptimal(shape, bnd);
+    return toMeasureBoundingBox(BRepBndBoxCache::compute(shape, BRepBndBoxCache::Mode::Optimal));
+}
+
+MeasureMassProperties MeasureToolBRep::brepMassProperties(const TopoDS_Shape& shape, TaskProgress* progress)
+{
+    throwErrorIf<ErrorCode::NotBRepShape>(shape.IsNull());
+    MeasureMassProperties measure;
+    measure.volumeProps = MassProperties::compute(shape, progress);
+    if (progress && progress->isAbortRequested())
+        return measure;
+
+    throwErrorIf<ErrorCode::NullVolume>(measure.volumeProps.isNull());
+    return measure;
+}
+
+MeasureBoundingBox MeasureToolBRep::toMeasureBoundingBox(const Bnd_Box& bnd)
+{
     throwErrorIf<ErrorCode::BoundingBoxIsVoid>(bnd.IsVoid());
+    MeasureBoundingBox measure;
     measure.cornerMin = bnd.CornerMin();
     measure.cornerMax = bnd.CornerMax();
     measure.xLength = std::abs(measure.cornerMax.X() - measure.cornerMin.X()) * Quantity_Millimeter;
     measure.yLength = std::abs(measure.cornerMax.Y() - measure.cornerMin.Y()) * Quantity_Millimeter;
     measure.zLength = std::abs(measure.cornerMax.Z() - measure.cornerMin.Z()) * Quantity_Millimeter;
     measure.volume = measure.xLength * measure.yLength * measure.zLength;
-#endif
     return measure;
 }
 
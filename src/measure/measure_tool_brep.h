@@ -6,8 +6,11 @@
 
 #pragma once
 
+#include "measure_cache.h"
 #include "measure_tool.h"
 
+#include <memory>
+
 class TopoDS_Edge;
 class TopoDS_Shape;
 
@@ -16,6 +19,9 @@ namespace Mayo {
 // Provides measurement services for BRep shapes
 class MeasureToolBRep : public IMeasureTool {
 public:
+    // Results are stored in 'cache', a private one is created if null
+    MeasureToolBRep(const std::shared_ptr<MeasureCache>& cache = {});
+
     Span<const GraphicsObjectSelectionMode> selectionModes(MeasureType type) const override;
     bool supports(const GraphicsObjectPtr& object) const override;
     bool supports(MeasureType type) const override;
@@ -28,6 +34,7 @@ public:
     MeasureLength length(const GraphicsOwnerPtr& owner) const override;
     MeasureArea area(const GraphicsOwnerPtr& owner) const override;
     MeasureBoundingBox boundingBox(const GraphicsOwnerPtr& owner) const override;
+    MeasureMassProperties massProperties(const GraphicsOwnerPtr& owner, TaskProgress* progress) const override;
 
     static gp_Pnt brepVertexPosition(const TopoDS_Shape& shape);
     static MeasureCircle brepCircle(const TopoDS_Shape& shape);
@@ -37,10 +44,14 @@ public:
     static MeasureLength brepLength(const TopoDS_Shape& shape);
     static MeasureArea brepArea(const TopoDS_Shape& shape);
     static MeasureBoundingBox brepBoundingBox(const TopoDS_Shape& shape);
+    static MeasureMassProperties brepMassProperties(const TopoDS_Shape& shape, TaskProgress* progress = nullptr);
 
 private:
     static MeasureCircle brepCircleFromGeometricEdge(const TopoDS_Edge& edge);
     static MeasureCircle brepCircleFromPolygonEdge(const TopoDS_Edge& edge);
+    static MeasureBoundingBox toMeasureBoundingBox(const Bnd_Box& bndBox);
+
+    std::shared_ptr<MeasureCache> m_cache;
 };
 
 } // namespace Mayo
@@ -0,0 +1,487 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "measure_tool_mesh.h"
+
+#include "../base/mesh_bvh.h"
+#include "../base/mesh_utils.h"
+#include "../base/text_id.h"
+#include "../graphics/graphics_mesh_data_source.h"
+#include "../graphics/graphics_mesh_object_driver.h"
+
+#include <Bnd_Box.hxx>
+#include <MeshVS_Mesh.hxx>
+#include <MeshVS_MeshEntityOwner.hxx>
+#include <MeshVS_MeshOwner.hxx>
+#include <MeshVS_SelectionModeFlags.hxx>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+
+namespace Mayo {
+
+namespace {
+
+using Entity = MeasureToolMesh::Entity;
+
+enum class ErrorCode {
+    Unknown,
+    NotMeshEntity,
+    NotNode,
+    NotMeshOrTriangle,
+    NotMesh,
+    NotSupported,
+    MinDistanceFailure,
+    NoFreeBoundary,
+    BoundingBoxIsVoid,
+    NullVolume
+};
+
+template<ErrorCode Err>
+class MeshMeasureError : public IMeasureError {
+    MAYO_DECLARE_TEXT_ID_FUNCTIONS(Mayo::MeshMeasureError)
+public:
+    std::string_view message() const override
+    {
+        switch (Err) {
+        case ErrorCode::NotMeshEntity:
+            return textIdTr("Entity must be a mesh, a mesh triangle or a mesh node");
+        case ErrorCode::NotNode:
+            return textIdTr("Entity must be a mesh node");
+        case ErrorCode::NotMeshOrTriangle:
+            return textIdTr("Entity must be a mesh or a mesh triangle");
+        case ErrorCode::NotMesh:
+            return textIdTr("Entity must be a mesh");
+        case ErrorCode::NotSupported:
+            return textIdTr("Measure isn't supported for meshes");
+        case ErrorCode::MinDistanceFailure:
+            return textIdTr("Computation of minimum distance failed");
+        case ErrorCode::NoFreeBoundary:
+            return textIdTr("Mesh has no free boundary");
+        case ErrorCode::BoundingBoxIsVoid:
+            return textIdTr("Bounding box computed is void");
+        case ErrorCode::NullVolume:
+            return textIdTr("Entity has no volume");
+        default:
+            return textIdTr("Unknown error");
+        }
+    }
+};
+
+template<ErrorCode Err> void throwErrorIf(bool cond)
+{
+    if (cond)
+        throw MeshMeasureError<Err>();
+}
+
+bool isSurface(const Entity& entity)
+{
+    return entity.type == Entity::Type::Triangle || entity.type == Entity::Type::Mesh;
+}
+
+gp_XYZ nodeOf(const Entity& entity, int i)
+{
+    return entity.triangulation->Node(i).XYZ();
+}
+
+// Calls 'fn' with the node indices of the triangles of a surface entity
+template<typename Function>
+void foreachTriangle(const Entity& entity, Function fn)
+{
+    auto fnCall = [&](int itri) {
+        int n1, n2, n3;
+        entity.triangulation->Triangle(itri).Get(n1, n2, n3);
+        fn(n1, n2, n3);
+    };
+
+    if (entity.type == Entity::Type::Triangle) {
+        fnCall(entity.index);
+    }
+    else if (entity.type == Entity::Type::Mesh) {
+        for (int i = 1; i <= entity.triangulation->NbTriangles(); ++i)
+            fnCall(i);
+    }
+}
+
+// Area and center of area of a surface entity, in triangulation coordinates
+struct SurfaceProps {
+    double area = 0.;
+    gp_XYZ center;
+};
+
+SurfaceProps computeSurfaceProps(const Entity& entity)
+{
+    SurfaceProps props;
+    gp_XYZ weightedCenter;
+    foreachTriangle(entity, [&](int n1, int n2, int n3) {
+        const gp_XYZ p1 = nodeOf(entity, n1);
+        const gp_XYZ p2 = nodeOf(entity, n2);
+        const gp_XYZ p3 = nodeOf(entity, n3);
+        const double area = MeshUtils::triangleArea(p1, p2, p3);
+        props.area += area;
+        weightedCenter += (p1 + p2 + p3) * (area / 3.);
+    });
+
+    if (props.area > 0.)
+        props.center = weightedCenter / props.area;
+    else if (entity.triangulation->NbNodes() > 0)
+        props.center = nodeOf(entity, 1);
+
+    return props;
+}
+
+// Center of an entity, in the global frame
+gp_Pnt computeCenter(const Entity& entity)
+{
+    if (entity.type == Entity::Type::Node)
+        return MeasureToolMesh::meshVertexPosition(entity);
+
+    throwErrorIf<ErrorCode::NotMeshEntity>(!isSurface(entity));
+    return gp_Pnt(computeSurfaceProps(entity).center).Transformed(entity.trsf);
+}
+
+double scaleOf(const gp_Trsf& trsf)
+{
+    return std::abs(trsf.ScaleFactor());
+}
+
+} // namespace
+
+MeasureToolMesh::MeasureToolMesh(const std::shared_ptr<MeasureCache>& cache)
+    : m_cache(cache ? cache : std::make_shared<MeasureCache>())
+{
+}
+
+MeasureToolMesh::Entity MeasureToolMesh::Entity::fromOwner(const GraphicsOwnerPtr& owner)
+{
+    Entity entity;
+    auto meshVisu = owner ? OccHandle<MeshVS_Mesh>::DownCast(owner->Selectable()) : OccHandle<MeshVS_Mesh>();
+    auto dataSource =
+        meshVisu ? OccHandle<GraphicsMeshDataSource>::DownCast(meshVisu->GetDataSource()) : OccHandle<GraphicsMeshDataSource>();
+    if (!dataSource || !dataSource->triangulation())
+        return entity;
+
+    if (auto entityOwner = OccHandle<MeshVS_MeshEntityOwner>::DownCast(owner)) {
+        if (entityOwner->IsGroup())
+            return entity;
+
+        if (entityOwner->Type() == MeshVS_ET_Node)
+            entity.type = Type::Node;
+        else if (entityOwner->Type() == MeshVS_ET_Face)
+            entity.type = Type::Triangle;
+
+        entity.index = entityOwner->ID();
+    }
+    else if (OccHandle<MeshVS_MeshOwner>::DownCast(owner)) {
+        entity.type = Type::Mesh;
+    }
+
+    entity.triangulation = dataSource->triangulation();
+    entity.trsf = owner->Location().Transformation();
+    return entity;
+}
+
+Span<const GraphicsObjectSelectionMode> MeasureToolMesh::selectionModes(MeasureType type) const
+{
+    switch (type) {
+    case MeasureType::VertexPosition: {
+        static const GraphicsObjectSelectionMode modes[] = { MeshVS_SMF_Node };
+        return modes;
+    }
+    case MeasureType::MinDistance: {
+        static const GraphicsObjectSelectionMode modes[] = { MeshVS_SMF_Node, MeshVS_SMF_Mesh };
+        return modes;
+    }
+    case MeasureType::CenterDistance: {
+        static const GraphicsObjectSelectionMode modes[] = { MeshVS_SMF_Node, MeshVS_SMF_Face };
+        return modes;
+    }
+    case MeasureType::Length:
+    case MeasureType::Area:
+    case MeasureType::BoundingBox:
+    case MeasureType::MassProperties: {
+        static const GraphicsObjectSelectionMode modes[] = { MeshVS_SMF_Mesh };
+        return modes;
+    }
+    default: {
+        return {};
+    }
+    } // endswitch
+}
+
+bool MeasureToolMesh::supports(const GraphicsObjectPtr& object) const
+{
+    auto gfxDriver = GraphicsObjectDriver::get(object);
+    return gfxDriver ? !GraphicsMeshObjectDriverPtr::DownCast(gfxDriver).IsNull() : false;
+}
+
+bool MeasureToolMesh::supports(MeasureType type) const
+{
+    switch (type) {
+    case MeasureType::VertexPosition:
+    case MeasureType::MinDistance:
+    case MeasureType::CenterDistance:
+    case MeasureType::Length:
+    case MeasureType::Area:
+    case MeasureType::BoundingBox:
+    case MeasureType::MassProperties:
+        return true;
+    default:
+        return false;
+    }
+}
+
+gp_Pnt MeasureToolMesh::vertexPosition(const GraphicsOwnerPtr& owner) const
+{
+    return meshVertexPosition(Entity::fromOwner(owner));
+}
+
+MeasureCircle MeasureToolMesh::circle(const GraphicsOwnerPtr& /*owner*/) const
+{
+    throw MeshMeasureError<ErrorCode::NotSupported>();
+}
+
+MeasureDistance MeasureToolMesh::minDistance(const GraphicsOwnerPtr& owner1, const GraphicsOwnerPtr& owner2) const
+{
+    const Entity entity1 = Entity::fromOwner(owner1);
+    const Entity entity2 = Entity::fromOwner(owner2);
+    return minDistance(entity1, this->findBvh(entity1), entity2, this->findBvh(entity2));
+}
+
+MeasureDistance MeasureToolMesh::centerDistance(const GraphicsOwnerPtr& owner1, const GraphicsOwnerPtr& owner2) const
+{
+    return meshCenterDistance(Entity::fromOwner(owner1), Entity::fromOwner(owner2));
+}
+
+MeasureAngle MeasureToolMesh::angle(const GraphicsOwnerPtr& /*owner1*/, const GraphicsOwnerPtr& /*owner2*/) const
+{
+    throw MeshMeasureError<ErrorCode::NotSupported>();
+}
+
+MeasureLength MeasureToolMesh::length(const GraphicsOwnerPtr& owner) const
+{
+    return meshBoundaryLength(Entity::fromOwner(owner));
+}
+
+MeasureArea MeasureToolMesh::area(const GraphicsOwnerPtr& owner) const
+{
+    return meshArea(Entity::fromOwner(owner));
+}
+
+MeasureBoundingBox MeasureToolMesh::boundingBox(const GraphicsOwnerPtr& owner) const
+{
+    return meshBoundingBox(Entity::fromOwner(owner));
+}
+
+MeasureMassProperties MeasureToolMesh::massProperties(const GraphicsOwnerPtr& owner, TaskProgress* /*progress*/) const
+{
+    return meshMassProperties(Entity::fromOwner(owner));
+}
+
+gp_Pnt MeasureToolMesh::meshVertexPosition(const Entity& entity)
+{
+    throwErrorIf<ErrorCode::NotNode>(entity.type != Entity::Type::Node);
+    return gp_Pnt(nodeOf(entity, entity.index)).Transformed(entity.trsf);
+}
+
+MeasureDistance MeasureToolMesh::meshMinDistance(const Entity& entity1, const Entity& entity2)
+{
+    return minDistance(entity1, createBvh(entity1), entity2, createBvh(entity2));
+}
+
+MeasureDistance MeasureToolMesh::meshCenterDistance(const Entity& entity1, const Entity& entity2)
+{
+    MeasureDistance distResult;
+    distResult.pnt1 = computeCenter(entity1);
+    distResult.pnt2 = computeCenter(entity2);
+    distResult.value = distResult.pnt1.Distance(distResult.pnt2) * Quantity_Millimeter;
+    distResult.type = DistanceType::CenterToCenter;
+    return distResult;
+}
+
+MeasureLength MeasureToolMesh::meshBoundaryLength(const Entity& entity)
+{
+    throwErrorIf<ErrorCode::NotMeshOrTriangle>(!isSurface(entity));
+
+    // Count the triangles bound to each edge, edge key is made of its sorted node indices
+    std::unordered_map<uint64_t, int> mapEdgeCount;
+    mapEdgeCount.reserve(entity.type == Entity::Type::Mesh ? 2 * entity.triangulation->NbTriangles() : 3);
+    auto fnAddEdge = [&](int n1, int n2) {
+        const auto key = (uint64_t(std::min(n1, n2)) << 32) | uint64_t(std::max(n1, n2));
+        ++mapEdgeCount[key];
+    };
+    foreachTriangle(entity, [&](int n1, int n2, int n3) {
+        fnAddEdge(n1, n2);
+        fnAddEdge(n2, n3);
+        fnAddEdge(n3, n1);
+    });
+
+    // Free edges, along with the center of the boundary
+    struct Edge {
+        gp_XYZ middle;
+        double length;
+    };
+    std::vector<Edge> vecFreeEdge;
+    double len = 0.;
+    gp_XYZ weightedCenter;
+    for (const auto& [key, count] : mapEdgeCount) {
+        if (count != 1)
+            continue;
+
+        const gp_XYZ p1 = nodeOf(entity, int(key >> 32));
+        const gp_XYZ p2 = nodeOf(entity, int(key & 0xFFFFFFFF));
+        const Edge edge{ (p1 + p2) / 2., (p2 - p1).Modulus() };
+        len += edge.length;
+        weightedCenter += edge.middle * edge.length;
+        vecFreeEdge.push_back(edge);
+    }
+
+    throwErrorIf<ErrorCode::NoFreeBoundary>(vecFreeEdge.empty());
+
+    // Label point is the middle of the free edge nearest to the center of the boundary
+    const gp_XYZ center = len > 0. ? weightedCenter / len : vecFreeEdge.front().middle;
+    const Edge* ptrEdgeNearest = &vecFreeEdge.front();
+    for (const Edge& edge : vecFreeEdge) {
+        if ((edge.middle - center).SquareModulus() < (ptrEdgeNearest->middle - center).SquareModulus())
+            ptrEdgeNearest = &edge;
+    }
+
+    MeasureLength lenResult;
+    lenResult.value = len * scaleOf(entity.trsf) * Quantity_Millimeter;
+    lenResult.middlePnt = gp_Pnt(ptrEdgeNearest->middle).Transformed(entity.trsf);
+    return lenResult;
+}
+
+MeasureArea MeasureToolMesh::meshArea(const Entity& entity)
+{
+    throwErrorIf<ErrorCode::NotMeshOrTriangle>(!isSurface(entity));
+    const SurfaceProps props = computeSurfaceProps(entity);
+
+    // Label point is the centroid of the triangle nearest to the center of area, so it's on the mesh
+    gp_XYZ labelPnt = props.center;
+    double sqDistMin = std::numeric_limits<double>::max();
+    foreachTriangle(entity, [&](int n1, int n2, int n3) {
+        const gp_XYZ centroid = (nodeOf(entity, n1) + nodeOf(entity, n2) + nodeOf(entity, n3)) / 3.;
+        const double sqDist = (centroid - props.center).SquareModulus();
+        if (sqDist < sqDistMin) {
+            sqDistMin = sqDist;
+            labelPnt = centroid;
+        }
+    });
+
+    const double scale = scaleOf(entity.trsf);
+    MeasureArea areaResult;
+    areaResult.value = props.area * scale * scale * Quantity_SquareMillimeter;
+    areaResult.middlePnt = gp_Pnt(labelPnt).Transformed(entity.trsf);
+    return areaResult;
+}
+
+MeasureBoundingBox MeasureToolMesh::meshBoundingBox(const Entity& entity)
+{
+    throwErrorIf<ErrorCode::NotMeshEntity>(entity.type == Entity::Type::None);
+    Bnd_Box bndBox;
+    if (entity.type == Entity::Type::Mesh) {
+        for (int i = 1; i <= entity.triangulation->NbNodes(); ++i)
+            bndBox.Add(gp_Pnt(nodeOf(entity, i)).Transformed(entity.trsf));
+    }
+    else if (entity.type == Entity::Type::Triangle) {
+        foreachTriangle(entity, [&](int n1, int n2, int n3) {
+            for (int n : { n1, n2, n3 })
+                bndBox.Add(gp_Pnt(nodeOf(entity, n)).Transformed(entity.trsf));
+        });
+    }
+    else {
+        bndBox.Add(meshVertexPosition(entity));
+    }
+
+    throwErrorIf<ErrorCode::BoundingBoxIsVoid>(bndBox.IsVoid());
+    MeasureBoundingBox measure;
+    measure.cornerMin = bndBox.CornerMin();
+    measure.cornerMax = bndBox.CornerMax();
+    measure.xLength = std::abs(measure.cornerMax.X() - measure.cornerMin.X()) * Quantity_Millimeter;
+    measure.yLength = std::abs(measure.cornerMax.Y() - measure.cornerMin.Y()) * Quantity_Millimeter;
+    measure.zLength = std::abs(measure.cornerMax.Z() - measure.cornerMin.Z()) * Quantity_Millimeter;
+    measure.volume = measure.xLength * measure.yLength * measure.zLength;
+    return measure;
+}
+
+MeasureMassProperties MeasureToolMesh::meshMassProperties(const Entity& entity)
+{
+    throwErrorIf<ErrorCode::NotMesh>(entity.type != Entity::Type::Mesh);
+    MassProperties props = MassProperties::computeFromTriangulation(entity.triangulation);
+    throwErrorIf<ErrorCode::NullVolume>(props.isNull());
+    // Orientation of triangles is arbitrary for some mesh formats, then volume would be negative
+    if (props.mass < 0.)
+        props = props.scaled(-1.);
+
+    MeasureMassProperties measure;
+    measure.volumeProps = props.transformed(entity.trsf);
+    return measure;
+}
+
+MeasureToolMesh::MeshBvhPtr MeasureToolMesh::createBvh(const Entity& entity)
+{
+    if (entity.type == Entity::Type::Mesh)
+        return std::make_shared<MeshBvh>(entity.triangulation);
+    else if (entity.type == Entity::Type::Triangle)
+        return std::make_shared<MeshBvh>(entity.triangulation, Span<const int>(&entity.index, 1));
+    else
+        return {};
+}
+
+MeasureDistance MeasureToolMesh::minDistance(
+        const Entity& entity1, const MeshBvhPtr& bvh1, const Entity& entity2, const MeshBvhPtr& bvh2
+    )
+{
+    throwErrorIf<ErrorCode::NotMeshEntity>(entity1.type == Entity::Type::None);
+    throwErrorIf<ErrorCode::NotMeshEntity>(entity2.type == Entity::Type::None);
+
+    MeasureDistance distResult;
+    distResult.type = DistanceType::Mininmum;
+    // Nearest point on the surface 'entity' to node 'pnt'
+    auto fnNearestToNode = [](const gp_Pnt& pnt, const Entity& entity, const MeshBvhPtr& bvh) {
+        const MeshBvh::Nearest nearest = bvh->nearestTo(pnt.Transformed(entity.trsf.Inverted()));
+        throwErrorIf<ErrorCode::MinDistanceFailure>(!nearest.isValid());
+        return nearest.pnt1.Transformed(entity.trsf);
+    };
+
+    const bool isNode1 = entity1.type == Entity::Type::Node;
+    const bool isNode2 = entity2.type == Entity::Type::Node;
+    if (isNode1) {
+        distResult.pnt1 = meshVertexPosition(entity1);
+        distResult.pnt2 = isNode2 ? meshVertexPosition(entity2) : fnNearestToNode(distResult.pnt1, entity2, bvh2);
+    }
+    else if (isNode2) {
+        distResult.pnt2 = meshVertexPosition(entity2);
+        distResult.pnt1 = fnNearestToNode(distResult.pnt2, entity1, bvh1);
+    }
+    else {
+        const MeshBvh::Nearest nearest = bvh1->nearestTo(entity1.trsf, *bvh2, entity2.trsf);
+        throwErrorIf<ErrorCode::MinDistanceFailure>(!nearest.isValid());
+        distResult.pnt1 = nearest.pnt1;
+        distResult.pnt2 = nearest.pnt2;
+    }
+
+    distResult.value = distResult.pnt1.Distance(distResult.pnt2) * Quantity_Millimeter;
+    return distResult;
+}
+
+MeasureToolMesh::MeshBvhPtr MeasureToolMesh::findBvh(const Entity& entity) const
+{
+    if (entity.type != Entity::Type::Mesh)
+        return createBvh(entity);
+
+    MeshBvhPtr bvh = m_cache->findMeshBvh(entity.triangulation);
+    if (bvh)
+        return bvh;
+
+    // Built outside of the cache lock, so other measures aren't blocked meanwhile
+    return m_cache->addMeshBvh(entity.triangulation, createBvh(entity));
+}
+
+} // namespace Mayo
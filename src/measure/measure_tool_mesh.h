@@ -0,0 +1,78 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "measure_cache.h"
+#include "measure_tool.h"
+#include "../base/occ_handle.h"
+
+#include <gp_Trsf.hxx>
+#include <Poly_Triangulation.hxx>
+
+#include <memory>
+
+namespace Mayo {
+
+class MeshBvh;
+
+// Provides measurement services for meshes(triangulations) displayed with MeshVS_Mesh objects
+// Nodes are picked as vertices, triangles and whole meshes as surfaces
+// Distances are exact, bounding volume hierarchies of meshes are built once and shared by the
+// measures. All other measures run in linear time with the count of triangles
+class MeasureToolMesh : public IMeasureTool {
+public:
+    // Mesh entity targeted by a measure
+    struct Entity {
+        enum class Type { None, Node, Triangle, Mesh };
+        Type type = Type::None;
+        OccHandle<Poly_Triangulation> triangulation;
+        int index = 0; // Index(1-based) of the node or triangle in the triangulation
+        gp_Trsf trsf; // Location of the triangulation
+
+        static Entity fromOwner(const GraphicsOwnerPtr& owner);
+    };
+
+    // Results are stored in 'cache', a private one is created if null
+    MeasureToolMesh(const std::shared_ptr<MeasureCache>& cache = {});
+
+    Span<const GraphicsObjectSelectionMode> selectionModes(MeasureType type) const override;
+    bool supports(const GraphicsObjectPtr& object) const override;
+    bool supports(MeasureType type) const override;
+
+    gp_Pnt vertexPosition(const GraphicsOwnerPtr& owner) const override;
+    MeasureCircle circle(const GraphicsOwnerPtr& owner) const override;
+    MeasureDistance minDistance(const GraphicsOwnerPtr& owner1, const GraphicsOwnerPtr& owner2) const override;
+    MeasureDistance centerDistance(const GraphicsOwnerPtr& owner1, const GraphicsOwnerPtr& owner2) const override;
+    MeasureAngle angle(const GraphicsOwnerPtr& owner1, const GraphicsOwnerPtr& owner2) const override;
+    MeasureLength length(const GraphicsOwnerPtr& owner) const override;
+    MeasureArea area(const GraphicsOwnerPtr& owner) const override;
+    MeasureBoundingBox boundingBox(const GraphicsOwnerPtr& owner) const override;
+    MeasureMassProperties massProperties(const GraphicsOwnerPtr& owner, TaskProgress* progress) const override;
+
+    static gp_Pnt meshVertexPosition(const Entity& entity);
+    static MeasureDistance meshMinDistance(const Entity& entity1, const Entity& entity2);
+    static MeasureDistance meshCenterDistance(const Entity& entity1, const Entity& entity2);
+    // Length of the free boundary(edges bound to a single triangle)
+    static MeasureLength meshBoundaryLength(const Entity& entity);
+    static MeasureArea meshArea(const Entity& entity);
+    static MeasureBoundingBox meshBoundingBox(const Entity& entity);
+    static MeasureMassProperties meshMassProperties(const Entity& entity);
+
+private:
+    using MeshBvhPtr = MeasureCache::MeshBvhPtr;
+    static MeshBvhPtr createBvh(const Entity& entity);
+    static MeasureDistance minDistance(
+            const Entity& entity1, const MeshBvhPtr& bvh1, const Entity& entity2, const MeshBvhPtr& bvh2
+    );
+
+    // Hierarchy of whole meshes are cached, the ones of single triangles are built on the fly
+    MeshBvhPtr findBvh(const Entity& entity) const;
+
+    std::shared_ptr<MeasureCache> m_cache;
+};
+
+} // namespace Mayo
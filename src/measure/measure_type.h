@@ -18,7 +18,8 @@ enum class MeasureType {
     Angle,
     Length,
     Area,
-    BoundingBox
+    BoundingBox,
+    MassProperties
 };
 
 } // namespace Mayo
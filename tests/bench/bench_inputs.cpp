@@ -0,0 +1,130 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "bench_inputs.h"
+
+#include "../../src/base/brep_utils.h"
+#include "../../src/base/document.h"
+#include "../../src/base/mesh_utils.h"
+#include "../../src/base/triangulation_annex_data.h"
+
+#include <BRepPrimAPI_MakeBox.hxx>
+#include <BRepPrimAPI_MakeCylinder.hxx>
+#include <BRepPrimAPI_MakeSphere.hxx>
+#include <BRepPrimAPI_MakeTorus.hxx>
+#include <TDataStd_Name.hxx>
+#include <TopLoc_Location.hxx>
+#include <XCAFDoc_ShapeTool.hxx>
+#include <gp_Trsf.hxx>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iterator>
+
+namespace Mayo {
+namespace Bench {
+
+OccHandle<Poly_Triangulation> createGridMesh(int triangleCount)
+{
+    // Grid of N x N cells, each cell being split into two triangles
+    const int cellCount = std::max(1, int(std::ceil(std::sqrt(triangleCount / 2.))));
+    const int nodeCount = (cellCount + 1) * (cellCount + 1);
+    auto mesh = makeOccHandle<Poly_Triangulation>(nodeCount, 2 * cellCount * cellCount, false);
+    const double cellSize = 1.;
+    auto fnNodeId = [=](int i, int j) { return j * (cellCount + 1) + i + 1; };
+    for (int j = 0; j <= cellCount; ++j) {
+        for (int i = 0; i <= cellCount; ++i) {
+            const double x = i * cellSize;
+            const double y = j * cellSize;
+            const double z = std::sin(x * 0.05) * std::cos(y * 0.05) * 10 * cellSize;
+            MeshUtils::setNode(mesh, fnNodeId(i, j), gp_Pnt{ x, y, z });
+        }
+    }
+
+    int iTriangle = 1;
+    for (int j = 0; j < cellCount; ++j) {
+        for (int i = 0; i < cellCount; ++i) {
+            const int n00 = fnNodeId(i, j);
+            const int n10 = fnNodeId(i + 1, j);
+            const int n01 = fnNodeId(i, j + 1);
+            const int n11 = fnNodeId(i + 1, j + 1);
+            MeshUtils::setTriangle(mesh, iTriangle++, { n00, n10, n11 });
+            MeshUtils::setTriangle(mesh, iTriangle++, { n00, n11, n01 });
+        }
+    }
+
+    return mesh;
+}
+
+TDF_Label addMeshEntity(const DocumentPtr& doc, const OccHandle<Poly_Triangulation>& mesh)
+{
+    const TDF_Label entityLabel = doc->newEntityShapeLabel();
+    doc->xcaf().setShape(entityLabel, BRepUtils::makeFace(mesh));
+    TriangulationAnnexData::Set(entityLabel);
+    TDataStd_Name::Set(entityLabel, "grid_mesh");
+    doc->addEntityTreeNode(entityLabel);
+    return entityLabel;
+}
+
+TDF_Label addAssemblyEntity(const DocumentPtr& doc, int instanceCount)
+{
+    OccHandle<XCAFDoc_ShapeTool> shapeTool = doc->xcaf().shapeTool();
+    const TDF_Label parts[] = {
+        shapeTool->AddShape(BRepPrimAPI_MakeBox(10, 8, 6).Shape(), false),
+        shapeTool->AddShape(BRepPrimAPI_MakeCylinder(4, 12).Shape(), false),
+        shapeTool->AddShape(BRepPrimAPI_MakeSphere(5).Shape(), false),
+        shapeTool->AddShape(BRepPrimAPI_MakeTorus(6, 2).Shape(), false)
+    };
+    TDataStd_Name::Set(parts[0], "box");
+    TDataStd_Name::Set(parts[1], "cylinder");
+    TDataStd_Name::Set(parts[2], "sphere");
+    TDataStd_Name::Set(parts[3], "torus");
+
+    const TDF_Label asmLabel = shapeTool->NewShape();
+    TDataStd_Name::Set(asmLabel, "assembly");
+    const int rowSize = std::max(1, int(std::ceil(std::sqrt(double(instanceCount)))));
+    for (int i = 0; i < instanceCount; ++i) {
+        gp_Trsf trsf;
+        trsf.SetTranslation(gp_Vec{ (i % rowSize) * 20., (i / rowSize) * 20., 0. });
+        shapeTool->AddComponent(asmLabel, parts[i % std::size(parts)], TopLoc_Location(trsf));
+    }
+
+    shapeTool->UpdateAssemblies();
+    doc->addEntityTreeNode(asmLabel);
+    return asmLabel;
+}
+
+bool writeDxfFaces(const FilePath& fp, int faceCount)
+{
+    std::ofstream ofs(fp, std::ios::out | std::ios::trunc);
+    if (!ofs.is_open())
+        return false;
+
+    auto fnWriteVertex = [&](int codeOffset, double x, double y, double z) {
+        ofs << 10 + codeOffset << '\n' << x << '\n'
+            << 20 + codeOffset << '\n' << y << '\n'
+            << 30 + codeOffset << '\n' << z << '\n';
+    };
+
+    ofs << "0\nSECTION\n2\nENTITIES\n";
+    const int rowSize = std::max(1, int(std::ceil(std::sqrt(double(faceCount)))));
+    for (int i = 0; i < faceCount; ++i) {
+        const double x = i % rowSize;
+        const double y = i / rowSize;
+        ofs << "0\n3DFACE\n8\n0\n";
+        fnWriteVertex(0, x, y, 0.);
+        fnWriteVertex(1, x + 1, y, 0.);
+        fnWriteVertex(2, x + 1, y + 1, 0.);
+        fnWriteVertex(3, x, y + 1, 0.);
+    }
+
+    ofs << "0\nENDSEC\n0\nEOF\n";
+    return ofs.good();
+}
+
+} // namespace Bench
+} // namespace Mayo
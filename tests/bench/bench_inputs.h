@@ -0,0 +1,35 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "../../src/base/document_ptr.h"
+#include "../../src/base/filepath.h"
+#include "../../src/base/occ_handle.h"
+
+#include <Poly_Triangulation.hxx>
+#include <TDF_Label.hxx>
+
+namespace Mayo {
+namespace Bench {
+
+// Synthetic inputs used by the benchmark suite, so no large files have to be stored in the repository
+
+// Creates a wavy grid mesh having at least 'triangleCount' triangles
+OccHandle<Poly_Triangulation> createGridMesh(int triangleCount);
+
+// Adds in document 'doc' an entity holding pure mesh 'mesh'
+TDF_Label addMeshEntity(const DocumentPtr& doc, const OccHandle<Poly_Triangulation>& mesh);
+
+// Adds in document 'doc' an assembly entity made of 'instanceCount' located components
+// Components are references to a few BRep primitive parts(box, cylinder, sphere, torus)
+TDF_Label addAssemblyEntity(const DocumentPtr& doc, int instanceCount);
+
+// Writes at 'fp' an ASCII DXF file made of 'faceCount' 3DFACE entities
+bool writeDxfFaces(const FilePath& fp, int faceCount);
+
+} // namespace Bench
+} // namespace Mayo
@@ -0,0 +1,498 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+// mayo-bench: reproducible benchmark suite covering IO readers/writers, BRep meshing and
+// creation of graphics objects. Inputs are generated synthetically so results are comparable
+// across machines and commits. Results are written as a JSON document
+
+#include "bench_inputs.h"
+#include "bench_report.h"
+
+#include "../../src/base/application.h"
+#include "../../src/base/application_item.h"
+#include "../../src/base/brep_utils.h"
+#include "../../src/base/document.h"
+#include "../../src/base/filepath_conv.h"
+#include "../../src/base/io_reader.h"
+#include "../../src/base/io_system.h"
+#include "../../src/base/io_writer.h"
+#include "../../src/base/libtree.h"
+#include "../../src/base/memory_utils.h"
+#include "../../src/base/task_progress.h"
+#include "../../src/base/xcaf.h"
+#include "../../src/graphics/graphics_mesh_object_driver.h"
+#include "../../src/graphics/graphics_point_cloud_object_driver.h"
+#include "../../src/graphics/graphics_shape_object_driver.h"
+#include "../../src/gui/gui_application.h"
+#include "../../src/io_dxf/io_dxf.h"
+#include "../../src/io_occ/io_occ.h"
+#include "../../src/io_occ/io_occ_brep.h"
+#include "../../src/io_off/io_off_reader.h"
+#include "../../src/io_off/io_off_writer.h"
+#include "../../src/io_ply/io_ply_reader.h"
+#include "../../src/io_ply/io_ply_writer.h"
+#include "../../src/io_pointcloud/io_las_reader.h"
+#include "../../src/io_pointcloud/io_xyz_reader.h"
+#include <common/mayo_version.h>
+
+#include <Bnd_Box.hxx>
+#include <BRepBndLib.hxx>
+#include <BRep_Tool.hxx>
+#include <Standard_Version.hxx>
+
+#include <fmt/format.h>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace Mayo {
+namespace Bench {
+
+namespace {
+
+struct CommandLineArgs {
+    int triangleCount = 10'000'000;
+    int instanceCount = 1000;
+    int dxfFaceCount = 200'000;
+    FilePath workDir = std::filesystem::temp_directory_path() / "mayo-bench";
+    FilePath outputFile; // Empty means stdout
+    bool keepFiles = false;
+};
+
+void printUsage()
+{
+    std::cout <<
+        "Usage: mayo-bench [options]\n"
+        "Options:\n"
+        "  --triangles <n>   Triangle count of the synthetic mesh(default: 10000000)\n"
+        "  --instances <n>   Component count of the synthetic STEP/BRep assembly(default: 1000)\n"
+        "  --dxf-faces <n>   3DFACE entity count of the synthetic DXF file(default: 200000)\n"
+        "  --work-dir <dir>  Directory where intermediate files are written\n"
+        "  --keep-files      Don't delete intermediate files once finished\n"
+        "  -o <file>         Write JSON report to <file> instead of standard output\n"
+        "  -h, --help        Display this help\n";
+}
+
+// Parses command-line arguments, returns false if program must exit
+bool parseCommandLine(int argc, char* argv[], CommandLineArgs* args, int* exitCode)
+{
+    auto fnNextValue = [&](int& i) -> const char* {
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for option " << argv[i] << std::endl;
+            return nullptr;
+        }
+
+        return argv[++i];
+    };
+    auto fnParseInt = [&](int& i, int* value) {
+        const char* str = fnNextValue(i);
+        if (!str)
+            return false;
+
+        *value = std::atoi(str);
+        if (*value <= 0) {
+            std::cerr << "Invalid value for option " << argv[i - 1] << std::endl;
+            return false;
+        }
+
+        return true;
+    };
+
+    *exitCode = EXIT_FAILURE;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "-h" || arg == "--help") {
+            printUsage();
+            *exitCode = EXIT_SUCCESS;
+            return false;
+        }
+        else if (arg == "--triangles") {
+            if (!fnParseInt(i, &args->triangleCount))
+                return false;
+        }
+        else if (arg == "--instances") {
+            if (!fnParseInt(i, &args->instanceCount))
+                return false;
+        }
+        else if (arg == "--dxf-faces") {
+            if (!fnParseInt(i, &args->dxfFaceCount))
+                return false;
+        }
+        else if (arg == "--work-dir") {
+            const char* str = fnNextValue(i);
+            if (!str)
+                return false;
+
+            args->workDir = filepathFrom(std::string_view{str});
+        }
+        else if (arg == "--keep-files") {
+            args->keepFiles = true;
+        }
+        else if (arg == "-o") {
+            const char* str = fnNextValue(i);
+            if (!str)
+                return false;
+
+            args->outputFile = filepathFrom(std::string_view{str});
+        }
+        else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            printUsage();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Executes and measures a benchmark stage
+// Function 'fn' is expected to fill the 'bytes' and 'items' fields of StageResult if relevant
+bool runStage(
+        Report* report,
+        std::string_view caseName,
+        std::string_view stage,
+        const std::function<bool(StageResult*)>& fn
+    )
+{
+    StageResult result;
+    result.caseName = caseName;
+    result.stage = stage;
+    std::cerr << fmt::format("{}/{} ...", caseName, stage) << std::flush;
+    const auto timeStart = std::chrono::steady_clock::now();
+    result.ok = fn(&result);
+    const auto timeEnd = std::chrono::steady_clock::now();
+    result.seconds = std::chrono::duration<double>(timeEnd - timeStart).count();
+    result.peakRssBytes = MemoryUtils::peakResidentSetSize();
+    std::cerr << fmt::format(" {} {:.3f}s", result.ok ? "ok" : "FAILED", result.seconds) << std::endl;
+    report->addResult(result);
+    return result.ok;
+}
+
+// Returns sum of the triangle counts of all the triangulations found in 'shape'
+std::uint64_t triangleCount(const TopoDS_Shape& shape)
+{
+    std::uint64_t count = 0;
+    BRepUtils::forEachSubFace(shape, [&](const TopoDS_Face& face) {
+        TopLoc_Location loc;
+        const OccHandle<Poly_Triangulation>& mesh = BRep_Tool::Triangulation(face, loc);
+        if (!mesh.IsNull())
+            count += mesh->NbTriangles();
+    });
+    return count;
+}
+
+// Returns sum of the triangle counts of all the entities found in 'doc'
+std::uint64_t triangleCount(const DocumentPtr& doc)
+{
+    std::uint64_t count = 0;
+    for (int i = 0; i < doc->entityCount(); ++i)
+        count += triangleCount(XCaf::shape(doc->entityLabel(i)));
+
+    return count;
+}
+
+// Context shared by all the benchmark cases
+struct BenchContext {
+    ApplicationPtr app;
+    IO::System ioSystem;
+    Report report;
+    CommandLineArgs args;
+    std::vector<FilePath> vecWorkFile; // Files written in the work directory, deleted once finished
+};
+
+// Returns the path of file 'name' in the work directory, registered so it gets deleted once finished
+FilePath workFilePath(BenchContext* ctx, std::string_view name)
+{
+    ctx->vecWorkFile.push_back(ctx->args.workDir / filepathFrom(name));
+    return ctx->vecWorkFile.back();
+}
+
+// Benchmarks writing of 'doc' into file 'fp' then reading it back into a new document
+// Optional function 'fnSetupWriter' is called to change the writer parameters, in such case
+// 'caseName' should identify the parameters used
+// Returns the document created by the read stages, or null if some stage failed
+DocumentPtr benchWriteThenRead(
+        BenchContext* ctx, IO::Format format, const DocumentPtr& doc, std::uint64_t itemCount,
+        std::string_view itemsUnit, const FilePath& fp,
+        std::string_view caseNameOverride = {},
+        const std::function<void(IO::Writer*)>& fnSetupWriter = {}
+    )
+{
+    const std::string caseName{!caseNameOverride.empty() ? caseNameOverride : IO::formatIdentifier(format)};
+    auto writer = ctx->ioSystem.createWriter(format);
+    auto reader = ctx->ioSystem.createReader(format);
+    if (!writer || !reader) {
+        std::cerr << fmt::format("{}: reader or writer not available, skipped", caseName) << std::endl;
+        return {};
+    }
+
+    if (fnSetupWriter)
+        fnSetupWriter(writer.get());
+
+    const ApplicationItem appItem(doc);
+    bool ok = runStage(&ctx->report, caseName, "writer.transfer", [&](StageResult* res) {
+        res->items = itemCount;
+        res->itemsUnit = itemsUnit;
+        return writer->transfer(Span<const ApplicationItem>(&appItem, 1), &TaskProgress::null());
+    });
+    ok = ok && runStage(&ctx->report, caseName, "writer.writeFile", [&](StageResult* res) {
+        const bool okWrite = writer->writeFile(fp, &TaskProgress::null());
+        res->bytes = okWrite ? filepathFileSize(fp) : 0;
+        res->items = itemCount;
+        res->itemsUnit = itemsUnit;
+        return okWrite;
+    });
+    writer.reset();
+    if (!ok)
+        return {};
+
+    ok = runStage(&ctx->report, caseName, "probe", [&](StageResult* res) {
+        res->bytes = filepathFileSize(fp);
+        return ctx->ioSystem.probeFormat(fp) == format;
+    });
+    ok = ok && runStage(&ctx->report, caseName, "reader.readFile", [&](StageResult* res) {
+        res->bytes = filepathFileSize(fp);
+        res->items = itemCount;
+        res->itemsUnit = itemsUnit;
+        return reader->readFile(fp, &TaskProgress::null());
+    });
+
+    DocumentPtr docRead;
+    ok = ok && runStage(&ctx->report, caseName, "reader.transfer", [&](StageResult* res) {
+        docRead = ctx->app->newDocument();
+        const TDF_LabelSequence seqLabel = reader->transfer(docRead, &TaskProgress::null());
+        docRead->addEntityTreeNodeSequence(seqLabel);
+        res->items = itemCount;
+        res->itemsUnit = itemsUnit;
+        return !seqLabel.IsEmpty();
+    });
+    return ok ? docRead : DocumentPtr{};
+}
+
+void benchMeshFormats(BenchContext* ctx)
+{
+    OccHandle<Poly_Triangulation> mesh;
+    runStage(&ctx->report, "Mesh", "generate", [&](StageResult* res) {
+        mesh = createGridMesh(ctx->args.triangleCount);
+        res->items = mesh->NbTriangles();
+        res->itemsUnit = "triangles";
+        return true;
+    });
+    DocumentPtr doc = ctx->app->newDocument();
+    addMeshEntity(doc, mesh);
+    const std::uint64_t itemCount = mesh->NbTriangles();
+    mesh.Nullify();
+
+    const IO::Format formats[] = {
+        IO::Format_STL, IO::Format_PLY, IO::Format_OFF, IO::Format_OBJ, IO::Format_GLTF
+    };
+    for (IO::Format format : formats) {
+        const std::string suffix{IO::formatFileSuffixes(format).front()};
+        const FilePath fp = workFilePath(ctx, "grid_mesh." + suffix);
+        if (format == IO::Format_GLTF)
+            workFilePath(ctx, "grid_mesh.bin"); // Buffers of text glTF file
+        DocumentPtr docRead = benchWriteThenRead(ctx, format, doc, itemCount, "triangles", fp);
+        if (docRead)
+            ctx->app->closeDocument(docRead);
+    }
+
+    ctx->app->closeDocument(doc);
+}
+
+void benchStep(BenchContext* ctx)
+{
+    DocumentPtr doc = ctx->app->newDocument();
+    addAssemblyEntity(doc, ctx->args.instanceCount);
+    const std::uint64_t itemCount = ctx->args.instanceCount;
+    const FilePath fp = workFilePath(ctx, "assembly.step");
+    DocumentPtr docRead = benchWriteThenRead(ctx, IO::Format_STEP, doc, itemCount, "instances", fp);
+    ctx->app->closeDocument(doc);
+    if (!docRead)
+        return;
+
+    // BRep meshing of the entities read, deflection is relative to the size of the entity
+    runStage(&ctx->report, "STEP", "brepMesh", [&](StageResult* res) {
+        for (int i = 0; i < docRead->entityCount(); ++i) {
+            const TopoDS_Shape shape = XCaf::shape(docRead->entityLabel(i));
+            Bnd_Box bndBox;
+            BRepBndLib::Add(shape, bndBox);
+            OccBRepMeshParameters params;
+            params.InParallel = true;
+            params.Deflection = bndBox.IsVoid() ? 0.1 : std::sqrt(bndBox.SquareExtent()) * 0.001;
+            params.Angle = 0.35;
+            BRepUtils::computeMesh(shape, params, &TaskProgress::null());
+        }
+
+        res->items = triangleCount(docRead);
+        res->itemsUnit = "triangles";
+        return res->items > 0;
+    });
+
+    // Creation of graphics objects for all the leaf nodes of the model tree
+    runStage(&ctx->report, "STEP", "graphicsObjects", [&](StageResult* res) {
+        GuiApplication guiApp(ctx->app);
+        guiApp.setAutomaticDocumentMapping(false);
+        guiApp.addGraphicsObjectDriver(std::make_unique<GraphicsShapeObjectDriver>());
+        guiApp.addGraphicsObjectDriver(std::make_unique<GraphicsMeshObjectDriver>());
+        guiApp.addGraphicsObjectDriver(std::make_unique<GraphicsPointCloudObjectDriver>());
+        const Tree<TDF_Label>& modelTree = docRead->modelTree();
+        bool ok = true;
+        traverseTree_unorder(modelTree, [&](TreeNodeId nodeId) {
+            if (modelTree.nodeIsLeaf(nodeId)) {
+                GraphicsObjectPtr gfxObject = guiApp.createGraphicsObject(modelTree.nodeData(nodeId));
+                ok = ok && !gfxObject.IsNull();
+                ++res->items;
+            }
+        });
+        res->itemsUnit = "objects";
+        return ok;
+    });
+
+    ctx->app->closeDocument(docRead);
+}
+
+void benchBRep(BenchContext* ctx)
+{
+    // Meshed assembly, so triangulations are part of the BRep data written
+    DocumentPtr doc = ctx->app->newDocument();
+    const TDF_Label asmLabel = addAssemblyEntity(doc, ctx->args.instanceCount);
+    OccBRepMeshParameters params;
+    params.Deflection = 0.05;
+    params.Angle = 0.35;
+    BRepUtils::computeMesh(XCaf::shape(asmLabel), params, &TaskProgress::null());
+    const std::uint64_t itemCount = triangleCount(doc);
+
+    const std::pair<IO::OccBRepWriter::Format, std::string_view> variants[] = {
+        { IO::OccBRepWriter::Format::Text, "OCCBREP.text" },
+        { IO::OccBRepWriter::Format::Binary, "OCCBREP.binary" }
+    };
+    for (const auto& [variantFormat, caseName] : variants) {
+        const FilePath fp = workFilePath(ctx, fmt::format("assembly_{}.brep", caseName));
+        auto fnSetupWriter = [=](IO::Writer* writer) {
+            auto brepWriter = static_cast<IO::OccBRepWriter*>(writer);
+            brepWriter->parameters().format = variantFormat;
+            brepWriter->parameters().withTriangles = true;
+        };
+        DocumentPtr docRead = benchWriteThenRead(
+            ctx, IO::Format_OCCBREP, doc, itemCount, "triangles", fp, caseName, fnSetupWriter
+        );
+        if (docRead)
+            ctx->app->closeDocument(docRead);
+    }
+
+    ctx->app->closeDocument(doc);
+}
+
+void benchDxf(BenchContext* ctx)
+{
+    const FilePath fp = workFilePath(ctx, "faces.dxf");
+    const std::uint64_t itemCount = ctx->args.dxfFaceCount;
+    if (!writeDxfFaces(fp, ctx->args.dxfFaceCount)) {
+        std::cerr << "DXF: failed to write input file, skipped" << std::endl;
+        return;
+    }
+
+    auto reader = ctx->ioSystem.createReader(IO::Format_DXF);
+    bool ok = runStage(&ctx->report, "DXF", "probe", [&](StageResult* res) {
+        res->bytes = filepathFileSize(fp);
+        return ctx->ioSystem.probeFormat(fp) == IO::Format_DXF;
+    });
+    ok = ok && runStage(&ctx->report, "DXF", "reader.readFile", [&](StageResult* res) {
+        res->bytes = filepathFileSize(fp);
+        res->items = itemCount;
+        res->itemsUnit = "entities";
+        return reader->readFile(fp, &TaskProgress::null());
+    });
+    ok = ok && runStage(&ctx->report, "DXF", "reader.transfer", [&](StageResult* res) {
+        DocumentPtr doc = ctx->app->newDocument();
+        const TDF_LabelSequence seqLabel = reader->transfer(doc, &TaskProgress::null());
+        res->items = itemCount;
+        res->itemsUnit = "entities";
+        ctx->app->closeDocument(doc);
+        return !seqLabel.IsEmpty();
+    });
+}
+
+} // namespace
+
+} // namespace Bench
+} // namespace Mayo
+
+int main(int argc, char* argv[])
+{
+    using namespace Mayo;
+    using namespace Mayo::Bench;
+
+    BenchContext ctx;
+    int exitCode = EXIT_SUCCESS;
+    if (!parseCommandLine(argc, argv, &ctx.args, &exitCode))
+        return exitCode;
+
+    std::error_code ec;
+    const bool isWorkDirCreated = std::filesystem::create_directories(ctx.args.workDir, ec);
+    if (ec) {
+        std::cerr << "Failed to create work directory: " << ec.message() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    ctx.app = makeOccHandle<Application>();
+    ctx.ioSystem.addFactoryReader(std::make_unique<IO::DxfFactoryReader>());
+    ctx.ioSystem.addFactoryReader(std::make_unique<IO::OccFactoryReader>());
+    ctx.ioSystem.addFactoryReader(std::make_unique<IO::OffFactoryReader>());
+    ctx.ioSystem.addFactoryReader(std::make_unique<IO::PlyFactoryReader>());
+    ctx.ioSystem.addFactoryReader(std::make_unique<IO::XyzFactoryReader>());
+    ctx.ioSystem.addFactoryReader(std::make_unique<IO::LasFactoryReader>());
+    ctx.ioSystem.addFactoryWriter(std::make_unique<IO::OccFactoryWriter>());
+    ctx.ioSystem.addFactoryWriter(std::make_unique<IO::OffFactoryWriter>());
+    ctx.ioSystem.addFactoryWriter(std::make_unique<IO::PlyFactoryWriter>());
+    IO::addPredefinedFormatProbes(&ctx.ioSystem);
+
+    ctx.report.addConfig("mayo_version", strVersion);
+    ctx.report.addConfig("mayo_commit", strVersionCommitId);
+    ctx.report.addConfig("occ_version", OCC_VERSION_COMPLETE);
+    ctx.report.addConfig("triangles", ctx.args.triangleCount);
+    ctx.report.addConfig("instances", ctx.args.instanceCount);
+    ctx.report.addConfig("dxf_faces", ctx.args.dxfFaceCount);
+
+    benchMeshFormats(&ctx);
+    benchStep(&ctx);
+    benchBRep(&ctx);
+    benchDxf(&ctx);
+
+    if (!ctx.args.keepFiles) {
+        // Work directory might be provided by the user, so only the files written are deleted
+        for (const FilePath& fp : ctx.vecWorkFile)
+            std::filesystem::remove(fp, ec);
+
+        if (isWorkDirCreated)
+            std::filesystem::remove(ctx.args.workDir, ec); // Fails if not empty
+    }
+
+    if (ctx.args.outputFile.empty()) {
+        ctx.report.writeJson(std::cout);
+    }
+    else {
+        std::ofstream ofs(ctx.args.outputFile, std::ios::out | std::ios::trunc);
+        ctx.report.writeJson(ofs);
+        if (!ofs.good()) {
+            std::cerr << "Failed to write report file" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    for (const StageResult& res : ctx.report.results()) {
+        if (!res.ok)
+            return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
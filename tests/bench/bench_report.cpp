@@ -0,0 +1,72 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "bench_report.h"
+#include "../../src/base/string_conv.h"
+
+#include <fmt/format.h>
+
+namespace Mayo {
+namespace Bench {
+
+namespace {
+
+// Returns 'count / seconds' or zero if division isn't meaningful
+double throughput(double count, double seconds)
+{
+    return seconds > 0. ? count / seconds : 0.;
+}
+
+} // namespace
+
+void Report::addConfig(const std::string& key, std::uint64_t value)
+{
+    m_vecConfig.emplace_back(key, std::to_string(value));
+}
+
+void Report::addConfig(const std::string& key, const std::string& value)
+{
+    m_vecConfig.emplace_back(key, to_jsonString(value));
+}
+
+void Report::addResult(const StageResult& result)
+{
+    m_vecResult.push_back(result);
+}
+
+void Report::writeJson(std::ostream& ostr) const
+{
+    ostr << "{\n";
+    ostr << "  \"config\": {";
+    for (const auto& [key, value] : m_vecConfig) {
+        ostr << (&key == &m_vecConfig.front().first ? "\n" : ",\n");
+        ostr << "    " << to_jsonString(key) << ": " << value;
+    }
+
+    ostr << (m_vecConfig.empty() ? "},\n" : "\n  },\n");
+    ostr << "  \"results\": [";
+    for (const StageResult& res : m_vecResult) {
+        ostr << (&res == &m_vecResult.front() ? "\n" : ",\n");
+        ostr << "    {";
+        ostr << "\"case\": " << to_jsonString(res.caseName);
+        ostr << ", \"stage\": " << to_jsonString(res.stage);
+        ostr << ", \"ok\": " << (res.ok ? "true" : "false");
+        ostr << ", \"seconds\": " << fmt::format("{:.6f}", res.seconds);
+        ostr << ", \"bytes\": " << res.bytes;
+        ostr << ", \"mb_per_sec\": " << fmt::format("{:.3f}", throughput(res.bytes / (1024. * 1024.), res.seconds));
+        ostr << ", \"items\": " << res.items;
+        ostr << ", \"items_unit\": " << to_jsonString(res.itemsUnit);
+        ostr << ", \"items_per_sec\": " << fmt::format("{:.1f}", throughput(double(res.items), res.seconds));
+        ostr << ", \"peak_rss_bytes\": " << res.peakRssBytes;
+        ostr << "}";
+    }
+
+    ostr << (m_vecResult.empty() ? "]\n" : "\n  ]\n");
+    ostr << "}\n";
+}
+
+} // namespace Bench
+} // namespace Mayo
@@ -0,0 +1,47 @@
+/****************************************************************************
+** Copyright (c) 2024, Fougue Ltd. <https://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Mayo {
+namespace Bench {
+
+// Measures of a single benchmark stage(eg "STL/readFile")
+struct StageResult {
+    std::string caseName; // Name of the benchmark case, typically a format identifier
+    std::string stage;    // Name of the stage within the case(eg "readFile", "transfer", ...)
+    bool ok = false;
+    double seconds = 0.;
+    std::uint64_t bytes = 0; // Count of bytes consumed or produced, 0 if not relevant
+    std::uint64_t items = 0; // Count of items processed(triangles, entities, ...), 0 if not relevant
+    std::string itemsUnit;
+    std::uint64_t peakRssBytes = 0; // Process peak resident set size once stage is finished
+};
+
+// Collects results of benchmark stages and serializes them as a JSON document
+class Report {
+public:
+    void addConfig(const std::string& key, std::uint64_t value);
+    void addConfig(const std::string& key, const std::string& value);
+
+    void addResult(const StageResult& result);
+    const std::vector<StageResult>& results() const { return m_vecResult; }
+
+    void writeJson(std::ostream& ostr) const;
+
+private:
+    std::vector<std::pair<std::string, std::string>> m_vecConfig; // Values are JSON literals
+    std::vector<StageResult> m_vecResult;
+};
+
+} // namespace Bench
+} // namespace Mayo
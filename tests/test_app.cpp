@@ -18,9 +18,22 @@
 #include "../src/app/recent_files.h"
 #include "../src/app/theme.h"
 #include "../src/base/application.h"
+#include "../src/base/brep_deferred_mesh.h"
 #include "../src/base/document.h"
+#include "../src/base/task_progress.h"
+#include "../src/base/tkernel_utils.h"
+#include "../src/base/xcaf.h"
+#include "../src/graphics/graphics_shape_object_driver.h"
+#include "../src/gui/gui_application.h"
+#include "../src/gui/gui_document.h"
+#include "../src/io_occ/io_occ_gltf_reader.h"
 #include "../src/qtcommon/filepath_conv.h"
 #include "../src/qtcommon/qstring_conv.h"
+#include <common/mayo_config.h>
+
+#include <BRep_Tool.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS.hxx>
 
 #include <QtCore/QtDebug>
 #include <QtCore/QDataStream>
@@ -32,6 +45,9 @@
 #include <QtWidgets/QWidget>
 #include <QtTest/QSignalSpy>
 
+#include <gsl/util>
+#include <memory>
+
 namespace Mayo {
 
 namespace {
@@ -297,4 +313,53 @@ void TestApp::QtGuiUtils_test()
     QCOMPARE(QtGuiUtils::toQColor(occColorA), qtColorA);
 }
 
+void TestApp::GuiDocument_deferredMesh_test()
+{
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0) && defined(OPENCASCADE_HAVE_RAPIDJSON)
+    auto app = makeOccHandle<Application>();
+    GuiApplication guiApp(app);
+    guiApp.addGraphicsObjectDriver(std::make_unique<GraphicsShapeObjectDriver>());
+    DocumentPtr doc = app->newDocument();
+    auto _ = gsl::finally([=]{ app->closeDocument(doc); });
+
+    IO::OccGltfReader reader;
+    reader.parameters().deferredMeshDataLoading = true;
+    QVERIFY(reader.readFile("tests/inputs/cube.gltf", &TaskProgress::null()));
+    const TDF_LabelSequence seqEntity = reader.transfer(doc, &TaskProgress::null());
+    QVERIFY(!seqEntity.IsEmpty());
+    const TopoDS_Shape shape = XCaf::shape(seqEntity.First());
+    QVERIFY(BRepDeferredMesh::hasDeferredData(shape));
+
+    auto fnIsMeshLoaded = [&]{
+        for (TopExp_Explorer expl(shape, TopAbs_FACE); expl.More(); expl.Next()) {
+            TopLoc_Location loc;
+            if (!BRep_Tool::Triangulation(TopoDS::Face(expl.Current()), loc)->HasGeometry())
+                return false;
+        }
+
+        return true;
+    };
+
+    // Mesh data is unloaded as soon as it's not pinned anymore
+    const size_t memoryLimit = BRepDeferredMesh::memoryLimit();
+    BRepDeferredMesh::setMemoryLimit(0);
+    auto _restoreMemoryLimit = gsl::finally([=]{ BRepDeferredMesh::setMemoryLimit(memoryLimit); });
+
+    // Progressive mapping isn't enabled, so graphics are created at once
+    doc->addEntityTreeNodeSequence(seqEntity);
+    GuiDocument* guiDoc = guiApp.findGuiDocument(doc);
+    QVERIFY(guiDoc);
+    const TreeNodeId entityTreeNodeId = doc->entityTreeNodeId(0);
+    QVERIFY(fnIsMeshLoaded());
+
+    guiDoc->setNodeVisible(entityTreeNodeId, false);
+    QVERIFY(!fnIsMeshLoaded());
+
+    guiDoc->setNodeVisible(entityTreeNodeId, true);
+    QVERIFY(fnIsMeshLoaded());
+#else
+    QSKIP("Deferred mesh data requires OpenCascade >= 7.6 with RapidJSON");
+#endif
+}
+
 } // namespace Mayo
@@ -31,6 +31,8 @@ private slots:
     void StringConv_test();
 
     void QtGuiUtils_test();
+
+    void GuiDocument_deferredMesh_test();
 };
 
 } // namespace Mayo
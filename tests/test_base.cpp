@@ -12,18 +12,31 @@
 #include "test_base.h"
 
 #include "../src/base/application.h"
+#include "../src/base/application_item_selection_model.h"
+#include "../src/base/assembly_graph.h"
+#include "../src/base/brep_bnd_box_cache.h"
+#include "../src/base/brep_deferred_mesh.h"
+#include "../src/base/brep_mesh_lod.h"
 #include "../src/base/brep_utils.h"
 #include "../src/base/caf_utils.h"
+#include "../src/base/document.h"
 #include "../src/base/cpp_utils.h"
 #include "../src/base/enumeration.h"
 #include "../src/base/enumeration_fromenum.h"
 #include "../src/base/filepath.h"
 #include "../src/base/filepath_conv.h"
 #include "../src/base/geom_utils.h"
+#include "../src/base/instrumentation.h"
 #include "../src/base/io_system.h"
+#include "../src/base/label_data.h"
 #include "../src/base/occ_static_variables_rollback.h"
 #include "../src/base/libtree.h"
+#include "../src/base/mesh_bvh.h"
 #include "../src/base/occ_handle.h"
+#include "../src/base/point_cloud.h"
+#include "../src/base/point_cloud_data.h"
+#include "../src/base/point_cloud_octree.h"
+#include "../src/base/point_cloud_utils.h"
 #include "../src/base/mesh_utils.h"
 #include "../src/base/meta_enum.h"
 #include "../src/base/property_builtins.h"
@@ -33,42 +46,69 @@
 #include "../src/base/string_conv.h"
 #include "../src/base/task_manager.h"
 #include "../src/base/tkernel_utils.h"
+#include "../src/base/triangulation_annex_data.h"
 #include "../src/base/unit.h"
 #include "../src/base/unit_system.h"
+#include "../src/graphics/ais_merged_parts.h"
+#include "../src/graphics/ais_point_cloud_lod.h"
 #include "../src/io_dxf/io_dxf.h"
 #include "../src/io_occ/io_occ.h"
+#include "../src/io_occ/io_occ_brep.h"
+#include "../src/io_occ/io_occ_gltf_reader.h"
+#include "../src/io_occ/io_occ_obj_reader.h"
+#include "../src/io_occ/io_occ_obj_writer.h"
+#include "../src/io_occ/io_occ_stl.h"
 #include "../src/io_off/io_off_reader.h"
 #include "../src/io_off/io_off_writer.h"
 #include "../src/io_ply/io_ply_reader.h"
 #include "../src/io_ply/io_ply_writer.h"
+#include "../src/io_pointcloud/io_las_reader.h"
+#include "../src/io_pointcloud/io_xyz_reader.h"
 #include <common/mayo_config.h>
+#ifdef MAYO_HAVE_GMIO
+#  include "../src/io_gmio/io_gmio_amf_writer.h"
+#endif
 
 #include <BRep_Tool.hxx>
+#include <BRepBndLib.hxx>
 #include <BRepAdaptor_Curve.hxx>
 #include <BRepMesh_IncrementalMesh.hxx>
 #include <BRepPrimAPI_MakeBox.hxx>
+#include <BRepPrimAPI_MakeSphere.hxx>
 #include <GCPnts_TangentialDeflection.hxx>
+#include <Graphic3d_Camera.hxx>
 #include <Interface_ParamType.hxx>
 #include <Interface_Static.hxx>
 #include <NCollection_String.hxx>
+#include <Precision.hxx>
+#include <SelectMgr_SelectingVolumeManager.hxx>
+#include <TDataStd_Name.hxx>
+#include <TDF_Data.hxx>
 #include <TopAbs_ShapeEnum.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS.hxx>
+#include <XCAFDoc_DocumentTool.hxx>
 
 #include <QtCore/QtDebug>
 #include <QtCore/QFile>
 #include <QtCore/QVariant>
 
+#include <fmt/format.h>
 #include <gsl/util>
 #include <algorithm>
 #include <cassert>
 #include <clocale>
 #include <cmath>
 #include <climits>
+#include <limits>
 #include <cstring>
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <type_traits>
 #include <utility>
 #include <variant>
@@ -259,6 +299,53 @@ void TestBase::Application_test()
 
 }
 
+void TestBase::Application_saveDocument_test()
+{
+    auto app = makeOccHandle<Application>();
+    Application::defineMayoFormat(app);
+    const FilePath filepath = std_filesystem::temp_directory_path() / "mayo_test_save_document.myb";
+    auto _removeFile = gsl::finally([=]{ std_filesystem::remove(filepath); });
+
+    [[maybe_unused]] auto fnTriangleCount = [](const TopoDS_Shape& shape) {
+        int count = 0;
+        BRepUtils::forEachSubFace(shape, [&](const TopoDS_Face& face) {
+            TopLoc_Location loc;
+            const OccHandle<Poly_Triangulation>& triangulation = BRep_Tool::Triangulation(face, loc);
+            count += triangulation ? triangulation->NbTriangles() : 0;
+        });
+        return count;
+    };
+
+    const TopoDS_Shape shape = BRepPrimAPI_MakeSphere(50.);
+    BRepMesh_IncrementalMesh mesher(shape, 0.5);
+    {
+        DocumentPtr doc = app->newDocument();
+        auto _ = gsl::finally([=]{ app->closeDocument(doc); });
+        const TDF_Label label = doc->newEntityShapeLabel();
+        doc->xcaf().setShape(label, shape);
+        doc->addEntityTreeNode(label);
+        QCOMPARE(app->saveDocument(doc, filepath), PCDM_SS_OK);
+        QCOMPARE(doc->filePath(), filepath);
+    }
+
+    SignalEmitSpy spyEntityAdded(&app->signalDocumentEntityAdded);
+    PCDM_ReaderStatus readStatus = PCDM_RS_OK;
+    DocumentPtr doc = app->openDocument(filepath, &readStatus);
+    QCOMPARE(readStatus, PCDM_RS_OK);
+    QVERIFY(!doc.IsNull());
+    auto _ = gsl::finally([=]{ app->closeDocument(doc); });
+    QCOMPARE(app->documentCount(), 1);
+    QCOMPARE(doc->filePath(), filepath);
+    QCOMPARE(doc->entityCount(), 1);
+    QCOMPARE(spyEntityAdded.count, 1);
+    const TopoDS_Shape shapeRead = XCaf::shape(doc->entityLabel(0));
+    QCOMPARE(shapeRead.ShapeType(), shape.ShapeType());
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+    // Triangulations were stored along with the document
+    QCOMPARE(fnTriangleCount(shapeRead), fnTriangleCount(shape));
+#endif
+}
+
 void TestBase::DocumentRefCount_test()
 {
     auto app = makeOccHandle<Application>();
@@ -268,6 +355,319 @@ void TestBase::DocumentRefCount_test()
     QCOMPARE(doc->GetRefCount(), 1);
 }
 
+void TestBase::Document_labelDataFlags_test()
+{
+    auto app = makeOccHandle<Application>();
+    DocumentPtr doc = app->newDocument();
+    auto _ = gsl::finally([=]{ app->closeDocument(doc); });
+
+    // Part instanced twice in an assembly, and a point cloud entity
+    const OccHandle<XCAFDoc_ShapeTool> shapeTool = doc->xcaf().shapeTool();
+    const TDF_Label labelPart = shapeTool->AddShape(BRepPrimAPI_MakeBox(10, 10, 10), false/*makeAssembly*/);
+    const TDF_Label labelAssembly = shapeTool->NewShape();
+    for (int i = 0; i < 2; ++i) {
+        gp_Trsf trsf;
+        trsf.SetTranslation(gp_Vec(i * 20, 0, 0));
+        shapeTool->AddComponent(labelAssembly, labelPart, trsf);
+    }
+
+    shapeTool->UpdateAssemblies();
+    doc->addEntityTreeNode(labelAssembly);
+
+    auto pointCloud = std::make_shared<PointCloud>();
+    pointCloud->addPoint(gp_Pnt(1, 2, 3));
+    const TDF_Label labelPointCloud = doc->newEntityLabel();
+    PointCloudData::Set(labelPointCloud, pointCloud);
+    doc->addEntityTreeNode(labelPointCloud);
+
+    // Cached flags are the same as the ones found on the fly
+    int nodeCount = 0;
+    traverseTree(doc->modelTree(), [&](TreeNodeId id) {
+        ++nodeCount;
+        const TDF_Label& label = doc->modelTree().nodeData(id);
+        QCOMPARE(doc->labelDataFlags(id), findLabelDataFlags(label));
+        QCOMPARE(DocumentTreeNode(doc, id).labelDataFlags(), findLabelDataFlags(label));
+    });
+    QCOMPARE(nodeCount, 1 + 2 * 2 + 1);
+    QVERIFY(doc->labelDataFlags(labelPart) & LabelData_HasShape);
+    QVERIFY(doc->labelDataFlags(labelPointCloud) & LabelData_HasPointCloudData);
+    QVERIFY(!(doc->labelDataFlags(labelPointCloud) & LabelData_HasShape));
+
+    // Flags are read from the cache, not found on the fly
+    const TopoDS_Face face = TopoDS::Face(TopExp_Explorer(BRepPrimAPI_MakeBox(1, 1, 1), TopAbs_FACE).Current());
+    shapeTool->SetShape(labelPart, face); // Doesn't notify the document
+    QVERIFY(findLabelDataFlags(labelPart) & LabelData_ShapeIsFace);
+    QVERIFY(!(doc->labelDataFlags(labelPart) & LabelData_ShapeIsFace));
+    doc->invalidateLabelDataFlags(labelPart);
+    QCOMPARE(doc->labelDataFlags(labelPart), findLabelDataFlags(labelPart));
+
+    // Cache is updated when Mayo attributes are added or forgotten
+    const LabelDataFlags flagsAssembly = doc->labelDataFlags(labelAssembly);
+    TriangulationAnnexData::Set(labelAssembly);
+    QCOMPARE(doc->labelDataFlags(labelAssembly), flagsAssembly | LabelData_HasTriangulationAnnexData);
+    labelPointCloud.ForgetAttribute(PointCloudData::GetID());
+    QCOMPARE(doc->labelDataFlags(labelPointCloud), LabelDataFlags(LabelData_None));
+    PointCloudData::Set(labelPointCloud, pointCloud);
+    QVERIFY(doc->labelDataFlags(labelPointCloud) & LabelData_HasPointCloudData);
+
+    // Cache is dropped along with the entity
+    doc->destroyEntity(doc->entityTreeNodeId(1));
+    QCOMPARE(doc->labelDataFlags(labelPointCloud), LabelDataFlags(LabelData_None));
+}
+
+void TestBase::ApplicationItemSelectionModel_test()
+{
+    auto app = makeOccHandle<Application>();
+    DocumentPtr doc = app->newDocument();
+    auto _ = gsl::finally([=]{ app->closeDocument(doc); });
+    std::vector<ApplicationItem> vecItem;
+    for (TreeNodeId id = 1; id <= 5; ++id)
+        vecItem.push_back(DocumentTreeNode(doc, id));
+
+    ApplicationItemSelectionModel model;
+    int signalCount = 0;
+    std::vector<ApplicationItem> vecLastSelected;
+    std::vector<ApplicationItem> vecLastDeselected;
+    model.signalChanged.connectSlot([&](Span<const ApplicationItem> selected, Span<const ApplicationItem> deselected) {
+        ++signalCount;
+        vecLastSelected.assign(selected.begin(), selected.end());
+        vecLastDeselected.assign(deselected.begin(), deselected.end());
+    });
+
+    model.add(vecItem);
+    model.add(vecItem.front()); // Already selected, no notification
+    QCOMPARE(signalCount, 1);
+    QCOMPARE(model.selectedItems().size(), vecItem.size());
+    QVERIFY(model.isSelected(vecItem.at(2)));
+    QVERIFY(!model.isSelected(ApplicationItem(doc)));
+
+    // Selection order is kept after removal
+    const std::vector<ApplicationItem> vecRemoved = { vecItem.at(1), vecItem.at(3) };
+    model.remove(vecRemoved);
+    QCOMPARE(signalCount, 2);
+    QCOMPARE(vecLastDeselected.size(), vecRemoved.size());
+    const std::vector<ApplicationItem> vecExpected = { vecItem.at(0), vecItem.at(2), vecItem.at(4) };
+    QVERIFY(std::equal(vecExpected.cbegin(), vecExpected.cend(), model.selectedItems().begin(), model.selectedItems().end()));
+    QVERIFY(!model.isSelected(vecItem.at(1)));
+    QVERIFY(model.isSelected(vecItem.at(4)));
+
+    // Batched changes are notified once, items whose state finally didn't change are skipped
+    {
+        ApplicationItemSelectionModel::BatchScope batchScope(&model);
+        model.add(vecItem.at(1));
+        model.remove(vecItem.at(0));
+        model.add(vecItem.at(3));
+        model.remove(vecItem.at(3));
+        QCOMPARE(signalCount, 2);
+    }
+
+    QCOMPARE(signalCount, 3);
+    QCOMPARE(vecLastSelected.size(), size_t(1));
+    QVERIFY(vecLastSelected.front() == vecItem.at(1));
+    QCOMPARE(vecLastDeselected.size(), size_t(1));
+    QVERIFY(vecLastDeselected.front() == vecItem.at(0));
+
+    model.clear();
+    QCOMPARE(signalCount, 4);
+    QVERIFY(model.selectedItems().empty());
+    QVERIFY(!model.isSelected(vecItem.at(2)));
+}
+
+void TestBase::AssemblyGraph_test()
+{
+    auto app = makeOccHandle<Application>();
+    DocumentPtr doc = app->newDocument();
+    auto _ = gsl::finally([=]{ app->closeDocument(doc); });
+
+    // Sub-assembly made of 3 parts, instanced 4 times in the top assembly
+    const OccHandle<XCAFDoc_ShapeTool> shapeTool = doc->xcaf().shapeTool();
+    const TDF_Label labelPart = shapeTool->AddShape(BRepPrimAPI_MakeBox(10, 10, 10), false/*makeAssembly*/);
+    const TDF_Label labelSubAssembly = shapeTool->NewShape();
+    for (int i = 0; i < 3; ++i) {
+        gp_Trsf trsf;
+        trsf.SetTranslation(gp_Vec(i * 20, 0, 0));
+        shapeTool->AddComponent(labelSubAssembly, labelPart, trsf);
+    }
+
+    const TDF_Label labelTopAssembly = shapeTool->NewShape();
+    for (int i = 0; i < 4; ++i) {
+        gp_Trsf trsf;
+        trsf.SetTranslation(gp_Vec(0, i * 20, 0));
+        shapeTool->AddComponent(labelTopAssembly, labelSubAssembly, trsf);
+    }
+
+    shapeTool->UpdateAssemblies();
+    doc->addEntityTreeNode(labelTopAssembly);
+
+    const AssemblyGraph& graph = doc->assemblyGraph();
+    QCOMPARE(graph.roots().size(), size_t(1));
+    QCOMPARE(graph.productCount(), 3);
+    QCOMPARE(graph.occurrenceCount(), 1 + 4 + 3);
+    QCOMPARE(graph.occurrencePathCount(), uint64_t(1 + 4 + 4 * 3));
+    QVERIFY(graph.findProduct(labelSubAssembly) != 0);
+    QCOMPARE(graph.product(graph.findProduct(labelSubAssembly)).vecChildOccurrence.size(), size_t(3));
+
+    // Each reference node of the expanded model tree is followed by the node of the referred product
+    int modelTreeNodeCount = 0;
+    traverseTree(doc->modelTree(), [&](TreeNodeId) { ++modelTreeNodeCount; });
+    QCOMPARE(uint64_t(modelTreeNodeCount), 2 * graph.occurrencePathCount() - 1);
+
+    // Leaf placements are the same as in the expanded model tree
+    std::vector<gp_XYZ> vecGraphLeafPos;
+    uint64_t pathCount = 0;
+    graph.traverseOccurrencePaths([&](AssemblyGraph::OccurrencePath path) {
+        ++pathCount;
+        const AssemblyGraph::Occurrence& occurrence = graph.occurrence(path.back());
+        if (graph.product(occurrence.product).vecChildOccurrence.empty())
+            vecGraphLeafPos.push_back(graph.absoluteLocation(path).Transformation().TranslationPart());
+
+        return true;
+    });
+    QCOMPARE(pathCount, graph.occurrencePathCount());
+
+    std::vector<gp_XYZ> vecTreeLeafPos;
+    traverseTree(doc->modelTree(), [&](TreeNodeId id) {
+        if (doc->modelTree().nodeIsLeaf(id))
+            vecTreeLeafPos.push_back(doc->xcaf().shapeAbsoluteLocation(id).Transformation().TranslationPart());
+    });
+    QCOMPARE(vecGraphLeafPos.size(), size_t(4 * 3));
+    QCOMPARE(vecGraphLeafPos.size(), vecTreeLeafPos.size());
+    for (size_t i = 0; i < vecGraphLeafPos.size(); ++i)
+        QVERIFY(vecGraphLeafPos.at(i).IsEqual(vecTreeLeafPos.at(i), Precision::Confusion()));
+
+    // Skipping sub-occurrences
+    pathCount = 0;
+    graph.traverseOccurrencePaths([&](AssemblyGraph::OccurrencePath path) {
+        ++pathCount;
+        return path.size() < 2;
+    });
+    QCOMPARE(pathCount, uint64_t(1 + 4));
+
+    // Occurrence paths of the entity are matched with the nodes of the expanded model tree
+    const TreeNodeId entityTreeNodeId = doc->entityTreeNodeId(0);
+    std::vector<TreeNodeId> vecGraphLeafNode;
+    doc->traverseAssemblyGraphPaths(entityTreeNodeId, [&](AssemblyGraph::OccurrencePath path, TreeNodeId id) {
+        const AssemblyGraph::Product& product = graph.product(graph.occurrence(path.back()).product);
+        QCOMPARE(doc->modelTree().nodeData(id), product.label);
+        if (product.vecChildOccurrence.empty())
+            vecGraphLeafNode.push_back(id);
+    });
+    std::vector<TreeNodeId> vecTreeLeafNode;
+    traverseTree(entityTreeNodeId, doc->modelTree(), [&](TreeNodeId id) {
+        if (doc->modelTree().nodeIsLeaf(id))
+            vecTreeLeafNode.push_back(id);
+    });
+    QCOMPARE(vecGraphLeafNode, vecTreeLeafNode);
+
+    // Unique products, visited once
+    int productVisitCount = 0;
+    graph.traverseProducts(doc->assemblyGraphRoot(entityTreeNodeId), [&](AssemblyGraph::ProductId) {
+        ++productVisitCount;
+    });
+    QCOMPARE(productVisitCount, 3);
+
+    // Products shared with a remaining entity are kept when an entity is destroyed
+    doc->addEntityTreeNode(labelSubAssembly);
+    QCOMPARE(doc->entityCount(), 2);
+    QCOMPARE(graph.roots().size(), size_t(2));
+    QCOMPARE(graph.productCount(), 3);
+    doc->destroyEntity(entityTreeNodeId);
+    QCOMPARE(graph.roots().size(), size_t(1));
+    QCOMPARE(graph.productCount(), 2);
+    QCOMPARE(graph.occurrenceCount(), 1 + 3);
+    QVERIFY(graph.findProduct(labelTopAssembly) == 0);
+    QCOMPARE(graph.occurrencePathCount(), uint64_t(1 + 3));
+}
+
+void TestBase::BRepBndBoxCache_test()
+{
+    auto fnCompareBndBox = [](const Bnd_Box& lhs, const Bnd_Box& rhs) {
+        QVERIFY(!lhs.IsVoid() && !rhs.IsVoid());
+        QVERIFY(lhs.CornerMin().IsEqual(rhs.CornerMin(), Precision::Confusion()));
+        QVERIFY(lhs.CornerMax().IsEqual(rhs.CornerMax(), Precision::Confusion()));
+    };
+
+    {   // Box computed once and shared by instances
+        BRepBndBoxCache cache(BRepBndBoxCache::Mode::Optimal);
+        const TopoDS_Shape shape = BRepPrimAPI_MakeBox(10, 20, 30);
+        fnCompareBndBox(cache.get(shape), Bnd_Box(gp_Pnt(0, 0, 0), gp_Pnt(10, 20, 30)));
+        QCOMPARE(cache.size(), 1);
+
+        gp_Trsf trsf;
+        trsf.SetTranslation(gp_Vec(100, 0, 0));
+        const TopoDS_Shape shapeMoved = shape.Moved(trsf);
+        fnCompareBndBox(cache.get(shapeMoved), Bnd_Box(gp_Pnt(100, 0, 0), gp_Pnt(110, 20, 30)));
+        QCOMPARE(cache.size(), 1);
+
+        const TopoDS_Shape arrayShape[] = { shape, shapeMoved };
+        fnCompareBndBox(cache.get(arrayShape), Bnd_Box(gp_Pnt(0, 0, 0), gp_Pnt(110, 20, 30)));
+
+        // Rotated instance gets a tight box, not the transformed box of the product
+        gp_Trsf trsfRotation;
+        trsfRotation.SetRotation(gp::OZ(), M_PI / 4.);
+        const TopoDS_Shape shapeRotated = shape.Moved(trsfRotation);
+        Bnd_Box bndBoxRotated;
+        BRepBndLib::AddOptimal(shapeRotated, bndBoxRotated);
+        fnCompareBndBox(cache.get(shapeRotated), bndBoxRotated);
+        QCOMPARE(cache.size(), 1);
+
+        cache.remove(shape);
+        QCOMPARE(cache.size(), 0);
+    }
+
+    {   // Parallel computation gives the same result as serial one
+        TopoDS_Shape shape = BRepUtils::makeEmptyCompound();
+        for (int i = 0; i < 5; ++i)
+            BRepUtils::addShape(&shape, BRepPrimAPI_MakeSphere(gp_Pnt(i * 30, 0, 0), 10 + i));
+
+        BRepUtils::addShape(&shape, BRepPrimAPI_MakeBox(gp_Pnt(-50, -50, -50), 10, 10, 10));
+        Bnd_Box bndBoxSerial;
+        BRepBndLib::AddOptimal(shape, bndBoxSerial);
+        fnCompareBndBox(BRepBndBoxCache::compute(shape, BRepBndBoxCache::Mode::Optimal), bndBoxSerial);
+    }
+
+    {   // Assembly: one box per product
+        auto app = makeOccHandle<Application>();
+        DocumentPtr doc = app->newDocument();
+        auto _ = gsl::finally([=]{ app->closeDocument(doc); });
+        const OccHandle<XCAFDoc_ShapeTool> shapeTool = doc->xcaf().shapeTool();
+        const TDF_Label labelPart = shapeTool->AddShape(BRepPrimAPI_MakeBox(10, 10, 10), false/*makeAssembly*/);
+        const TDF_Label labelAssembly = shapeTool->NewShape();
+        for (int i = 0; i < 4; ++i) {
+            gp_Trsf trsf;
+            trsf.SetTranslation(gp_Vec(i * 20, 0, 0));
+            shapeTool->AddComponent(labelAssembly, labelPart, trsf);
+        }
+
+        shapeTool->UpdateAssemblies();
+        doc->addEntityTreeNode(labelAssembly);
+        BRepBndBoxCache cache(BRepBndBoxCache::Mode::Optimal);
+        fnCompareBndBox(cache.get(doc->assemblyGraph()), Bnd_Box(gp_Pnt(0, 0, 0), gp_Pnt(70, 10, 10)));
+        QCOMPARE(cache.size(), 1);
+    }
+
+    if (BRepMeshLod::isSupported()) {
+        // Fast mode boxes are computed again once active triangulations got changed
+        const TopoDS_Shape shape = BRepPrimAPI_MakeSphere(50.);
+        OccBRepMeshParameters coarseParams;
+        coarseParams.Deflection = 5.;
+        BRepUtils::computeMesh(shape, coarseParams);
+        OccBRepMeshParameters fineParams;
+        fineParams.Deflection = 0.05;
+        QVERIFY(BRepMeshLod::addLevel(BRepMeshLod::computeLevel(shape, fineParams)));
+
+        BRepBndBoxCache cache(BRepBndBoxCache::Mode::Fast);
+        const Bnd_Box coarseBndBox = cache.get(shape);
+        const uint64_t lodChangeCount = BRepMeshLod::activeLevelChangeCount();
+        QVERIFY(BRepMeshLod::setActiveLevel(shape, 1));
+        QVERIFY(BRepMeshLod::activeLevelChangeCount() > lodChangeCount);
+        const Bnd_Box fineBndBox = cache.get(shape);
+        fnCompareBndBox(fineBndBox, BRepBndBoxCache::compute(shape, BRepBndBoxCache::Mode::Fast));
+        QVERIFY(fineBndBox.SquareExtent() < coarseBndBox.SquareExtent());
+        QCOMPARE(cache.size(), 1);
+    }
+}
+
 void TestBase::CppUtils_toggle_test()
 {
     bool v = false;
@@ -686,6 +1086,514 @@ void TestBase::IO_bugGitHub258_test()
     QCOMPARE(triangulation->NbTriangles(), 12);
 }
 
+void TestBase::IO_OccBRep_test()
+{
+    auto app = makeOccHandle<Application>();
+    DocumentPtr doc = app->newDocument();
+    auto _ = gsl::finally([=]{ app->closeDocument(doc); });
+    const TopoDS_Shape shape = BRepPrimAPI_MakeSphere(50.);
+    BRepMesh_IncrementalMesh mesher(shape, 0.5);
+    const TDF_Label label = doc->newEntityShapeLabel();
+    doc->xcaf().setShape(label, shape);
+    doc->addEntityTreeNode(label);
+
+    auto fnTriangleCount = [](const TopoDS_Shape& shape) {
+        int count = 0;
+        BRepUtils::forEachSubFace(shape, [&](const TopoDS_Face& face) {
+            TopLoc_Location loc;
+            const OccHandle<Poly_Triangulation>& triangulation = BRep_Tool::Triangulation(face, loc);
+            count += triangulation ? triangulation->NbTriangles() : 0;
+        });
+        return count;
+    };
+
+    const ApplicationItem appItem(doc);
+    size_t textSize = 0;
+    size_t binarySize = 0;
+    for (auto format : { IO::OccBRepWriter::Format::Text, IO::OccBRepWriter::Format::Binary }) {
+        IO::OccBRepWriter writer;
+        writer.parameters().format = format;
+        writer.parameters().withTriangles = true;
+        QVERIFY(writer.transfer(Span<const ApplicationItem>(&appItem, 1), &TaskProgress::null()));
+        std::stringstream sstr(std::ios::in | std::ios::out | std::ios::binary);
+        QVERIFY(writer.writeStream(sstr, &TaskProgress::null()));
+
+        const std::string strContents = sstr.str();
+        (format == IO::OccBRepWriter::Format::Binary ? binarySize : textSize) = strContents.size();
+        IO::System::FormatProbeInput probeInput = {};
+        probeInput.contentsBegin = std::string_view(strContents).substr(0, 2048);
+        probeInput.hintFullSize = strContents.size();
+        QCOMPARE(IO::probeFormat_OCCBREP(probeInput), IO::Format_OCCBREP);
+
+        IO::OccBRepReader reader;
+        QVERIFY(reader.readStream(sstr, &TaskProgress::null()));
+        const TDF_LabelSequence seqLabel = reader.transfer(doc, &TaskProgress::null());
+        QCOMPARE(seqLabel.Size(), 1);
+        const TopoDS_Shape shapeRead = XCaf::shape(seqLabel.First());
+        QCOMPARE(shapeRead.ShapeType(), shape.ShapeType());
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+        QCOMPARE(fnTriangleCount(shapeRead), fnTriangleCount(shape));
+#endif
+    }
+
+    QVERIFY(binarySize < textSize);
+}
+
+void TestBase::IO_OccStl_test()
+{
+    auto app = makeOccHandle<Application>();
+    DocumentPtr doc = app->newDocument();
+    auto _ = gsl::finally([=]{ app->closeDocument(doc); });
+    const FilePath filepath = std_filesystem::temp_directory_path() / "mayo_test_occ_stl.stl";
+    auto _removeFile = gsl::finally([=]{ std_filesystem::remove(filepath); });
+
+    // Box faces are meshed with 2 triangles each, sharing the 8 box corners
+    const TopoDS_Shape shape = BRepPrimAPI_MakeBox(10., 20., 30.);
+    BRepMesh_IncrementalMesh mesher(shape, 0.5);
+    const TDF_Label label = doc->newEntityShapeLabel();
+    doc->xcaf().setShape(label, shape);
+    doc->addEntityTreeNode(label);
+
+    const ApplicationItem appItem(doc);
+    IO::OccStlWriter writer;
+    writer.parameters().format = IO::OccStlWriter::Format::Binary;
+    QVERIFY(writer.transfer(Span<const ApplicationItem>(&appItem, 1), &TaskProgress::null()));
+    QVERIFY(writer.writeFile(filepath, &TaskProgress::null()));
+    QCOMPARE(std_filesystem::file_size(filepath), uintmax_t(84 + 12 * 50));
+
+    for (bool mergeNodes : { true, false }) {
+        IO::OccStlReader reader;
+        reader.parameters().mergeNodes = mergeNodes;
+        QVERIFY(reader.readFile(filepath, &TaskProgress::null()));
+        const TDF_LabelSequence seqLabel = reader.transfer(doc, &TaskProgress::null());
+        QCOMPARE(seqLabel.Size(), 1);
+        const TopoDS_Face face = TopoDS::Face(XCaf::shape(seqLabel.First()));
+        TopLoc_Location loc;
+        const OccHandle<Poly_Triangulation>& triangulation = BRep_Tool::Triangulation(face, loc);
+        QVERIFY(triangulation);
+        QCOMPARE(triangulation->NbTriangles(), 12);
+        QCOMPARE(triangulation->NbNodes(), mergeNodes ? 8 : 36);
+    }
+}
+
+void TestBase::IO_OccBaseMeshReader_test()
+{
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+    auto app = makeOccHandle<Application>();
+    auto fnTriangleCount = [](const TDF_LabelSequence& seqLabel) {
+        int count = 0;
+        for (const TDF_Label& label : seqLabel) {
+            BRepUtils::forEachSubFace(XCaf::shape(label), [&](const TopoDS_Face& face) {
+                TopLoc_Location loc;
+                const OccHandle<Poly_Triangulation>& triangulation = BRep_Tool::Triangulation(face, loc);
+                count += triangulation ? triangulation->NbTriangles() : 0;
+            });
+        }
+
+        return count;
+    };
+    // Entities must be free shapes of the target document, which gets the length unit of the file
+    auto fnCheckImport = [](const DocumentPtr& doc, const TDF_LabelSequence& seqLabel) {
+        QVERIFY(!seqLabel.IsEmpty());
+        QCOMPARE(doc->xcaf().topLevelFreeShapes().Size(), seqLabel.Size());
+        const TDF_Label shapesLabel = XCAFDoc_DocumentTool::ShapesLabel(doc->Main());
+        for (const TDF_Label& label : seqLabel)
+            QVERIFY(label.Father() == shapesLabel);
+
+        double lengthUnit = 0.;
+        QVERIFY(XCAFDoc_DocumentTool::GetLengthUnit(doc, lengthUnit));
+        QCOMPARE(lengthUnit, 0.001);
+    };
+
+    DocumentPtr doc = app->newDocument();
+    auto _ = gsl::finally([=]{ app->closeDocument(doc); });
+    IO::OccObjReader reader;
+    reader.parameters().systemLengthUnit = IO::OccObjReader::LengthUnit::Millimeter;
+    QVERIFY(reader.readFile("tests/inputs/cube.obj", &TaskProgress::null()));
+    const TDF_LabelSequence seqLabel = reader.transfer(doc, &TaskProgress::null());
+    fnCheckImport(doc, seqLabel);
+    const int triangleCount = fnTriangleCount(seqLabel);
+    QVERIFY(triangleCount > 0);
+
+    // Export then import again
+    const FilePath filepath = std_filesystem::temp_directory_path() / "mayo_test_occ_base_mesh.obj";
+    auto _removeFile = gsl::finally([=]{ std_filesystem::remove(filepath); });
+    const ApplicationItem appItem(doc);
+    IO::OccObjWriter writer;
+    QVERIFY(writer.transfer(Span<const ApplicationItem>(&appItem, 1), &TaskProgress::null()));
+    QVERIFY(writer.writeFile(filepath, &TaskProgress::null()));
+
+    DocumentPtr docRead = app->newDocument();
+    auto _closeDocRead = gsl::finally([=]{ app->closeDocument(docRead); });
+    QVERIFY(reader.readFile(filepath, &TaskProgress::null()));
+    const TDF_LabelSequence seqLabelRead = reader.transfer(docRead, &TaskProgress::null());
+    fnCheckImport(docRead, seqLabelRead);
+    QCOMPARE(fnTriangleCount(seqLabelRead), triangleCount);
+#else
+    QSKIP("Staging document of mesh readers requires OpenCascade >= 7.6");
+#endif
+}
+
+void TestBase::IO_OffReader_test()
+{
+    auto app = makeOccHandle<Application>();
+    DocumentPtr doc = app->newDocument();
+    auto _ = gsl::finally([=]{ app->closeDocument(doc); });
+
+    auto fnReadMesh = [=](const FilePath& filepath) -> TDF_Label {
+        IO::OffReader reader;
+        if (!reader.readFile(filepath, &TaskProgress::null()))
+            return {};
+
+        const TDF_LabelSequence seqLabel = reader.transfer(doc, &TaskProgress::null());
+        return seqLabel.Size() == 1 ? seqLabel.First() : TDF_Label();
+    };
+    auto fnTriangulation = [](const TDF_Label& label) {
+        TopLoc_Location loc;
+        return BRep_Tool::Triangulation(TopoDS::Face(XCaf::shape(label)), loc);
+    };
+    auto fnNodeColors = [](const TDF_Label& label) {
+        auto attrAnnexData = CafUtils::findAttribute<TriangulationAnnexData>(label);
+        return attrAnnexData ? attrAnnexData->nodeColors() : Span<const Quantity_Color>{};
+    };
+    auto fnColor = [](double r, double g, double b) {
+        return Quantity_Color(r, g, b, TKernelUtils::preferredRgbColorType());
+    };
+
+    {   // Comments and blank lines are skipped, quad facet is fan triangulated
+        const TDF_Label label = fnReadMesh("tests/inputs/off_coff_comments.off");
+        QVERIFY(!label.IsNull());
+        const OccHandle<Poly_Triangulation> triangulation = fnTriangulation(label);
+        QCOMPARE(triangulation->NbNodes(), 4);
+        QCOMPARE(triangulation->NbTriangles(), 2);
+        QVERIFY(triangulation->Node(3).IsEqual(gp_Pnt(1, 1, 0), Precision::Confusion()));
+        const Span<const Quantity_Color> spanColor = fnNodeColors(label);
+        QCOMPARE(spanColor.size(), size_t(4));
+        QVERIFY(spanColor[0].IsEqual(fnColor(1, 0, 0)));
+        QVERIFY(spanColor[2].IsEqual(fnColor(0, 0, 1)));
+    }
+
+    {   // Normals must not be mistaken for vertex colors
+        const TDF_Label label = fnReadMesh("tests/inputs/off_noff.off");
+        QVERIFY(!label.IsNull());
+        QCOMPARE(fnTriangulation(label)->NbTriangles(), 1);
+        QVERIFY(fnNodeColors(label).empty());
+    }
+
+    {   // Colors come after normals
+        const TDF_Label label = fnReadMesh("tests/inputs/off_cnoff.off");
+        QVERIFY(!label.IsNull());
+        const Span<const Quantity_Color> spanColor = fnNodeColors(label);
+        QCOMPARE(spanColor.size(), size_t(3));
+        QVERIFY(spanColor[0].IsEqual(fnColor(1, 0, 0)));
+        QVERIFY(spanColor[1].IsEqual(fnColor(0, 1, 0)));
+    }
+
+    {   // Texture coordinates trailing colors are ignored
+        const TDF_Label label = fnReadMesh("tests/inputs/off_stcnoff.off");
+        QVERIFY(!label.IsNull());
+        const Span<const Quantity_Color> spanColor = fnNodeColors(label);
+        QCOMPARE(spanColor.size(), size_t(3));
+        QVERIFY(spanColor[2].IsEqual(fnColor(0, 1, 0)));
+    }
+
+    {   // Homogeneous coordinates, counts specified on the header keyword line
+        const TDF_Label label = fnReadMesh("tests/inputs/off_4off.off");
+        QVERIFY(!label.IsNull());
+        const OccHandle<Poly_Triangulation> triangulation = fnTriangulation(label);
+        QCOMPARE(triangulation->NbNodes(), 3);
+        QVERIFY(triangulation->Node(1).IsEqual(gp_Pnt(1, 2, 3), Precision::Confusion()));
+        QVERIFY(triangulation->Node(2).IsEqual(gp_Pnt(1, 0, 0), Precision::Confusion()));
+        QVERIFY(fnNodeColors(label).empty());
+    }
+
+    // Grid file bigger than the parsing chunk size(4MB), so lines are spread over several chunks
+    const FilePath filepath = std_filesystem::temp_directory_path() / "mayo_test_off_reader.off";
+    auto _removeFile = gsl::finally([=]{ std_filesystem::remove(filepath); });
+    constexpr int gridSize = 400;
+    constexpr int quadCount = (gridSize - 1) * (gridSize - 1);
+    {
+        std::ofstream ofs(filepath);
+        ofs << "OFF\n" << gridSize * gridSize << ' ' << quadCount << " 0\n";
+        for (int i = 0; i < gridSize; ++i) {
+            for (int j = 0; j < gridSize; ++j)
+                ofs << i << ".5 " << j << ".25 0 # Vertex " << i * gridSize + j << '\n';
+        }
+
+        for (int i = 0; i + 1 < gridSize; ++i) {
+            ofs << "# Row " << i << "\n\n";
+            for (int j = 0; j + 1 < gridSize; ++j) {
+                const int v = i * gridSize + j;
+                ofs << "4 " << v << ' ' << v + 1 << ' ' << v + gridSize + 1 << ' ' << v + gridSize << '\n';
+            }
+        }
+    }
+
+    QVERIFY(std_filesystem::file_size(filepath) > 4 * 1024 * 1024);
+    const TDF_Label label = fnReadMesh(filepath);
+    QVERIFY(!label.IsNull());
+    const OccHandle<Poly_Triangulation> triangulation = fnTriangulation(label);
+    QCOMPARE(triangulation->NbNodes(), gridSize * gridSize);
+    QCOMPARE(triangulation->NbTriangles(), 2 * quadCount);
+    for (int i = 0; i < gridSize; ++i) {
+        for (int j = 0; j < gridSize; ++j) {
+            const gp_Pnt pnt = triangulation->Node(i * gridSize + j + 1);
+            QVERIFY(pnt.IsEqual(gp_Pnt(i + 0.5, j + 0.25, 0), Precision::Confusion()));
+        }
+    }
+
+    for (int i = 0; i < quadCount; ++i) {
+        int n1, n2, n3;
+        triangulation->Triangle(2 * i + 1).Get(n1, n2, n3);
+        const int v = (i / (gridSize - 1)) * gridSize + (i % (gridSize - 1)) + 1;
+        QCOMPARE(n1, v);
+        QCOMPARE(n2, v + 1);
+        QCOMPARE(n3, v + gridSize + 1);
+    }
+
+    QVERIFY(fnNodeColors(label).empty());
+}
+
+void TestBase::IO_PointCloudReaders_test()
+{
+    auto app = makeOccHandle<Application>();
+    DocumentPtr doc = app->newDocument();
+    auto _ = gsl::finally([=]{ app->closeDocument(doc); });
+
+    // CSV file with header line
+    const FilePath csvFilepath = std_filesystem::temp_directory_path() / "mayo_test_point_cloud.csv";
+    auto _removeCsvFile = gsl::finally([=]{ std_filesystem::remove(csvFilepath); });
+    {
+        std::ofstream ofs(csvFilepath);
+        ofs << "X,Y,Z,Intensity,R,G,B\n";
+        for (int i = 0; i < 1000; ++i)
+            ofs << i * 0.01 << ',' << -i * 0.01 << ",0.5," << i << ",255,128,0\n";
+    }
+
+    for (int step : { 1, 10 }) {
+        IO::XyzReader reader;
+        reader.parameters().decimation.mode = PointCloudDecimation::Mode::EveryNth;
+        reader.parameters().decimation.step = step;
+        QVERIFY(reader.readFile(csvFilepath, &TaskProgress::null()));
+        const TDF_LabelSequence seqLabel = reader.transfer(doc, &TaskProgress::null());
+        QCOMPARE(seqLabel.Size(), 1);
+        auto attrPointCloudData = CafUtils::findAttribute<PointCloudData>(seqLabel.First());
+        QVERIFY(attrPointCloudData);
+        const PointCloud& pointCloud = *attrPointCloudData->pointCloud();
+        QCOMPARE(pointCloud.pointCount(), size_t(1000 / step));
+        QVERIFY(pointCloud.hasColors());
+        QVERIFY(pointCloud.hasIntensities());
+        QVERIFY(!pointCloud.hasNormals());
+        QCOMPARE(int(pointCloud.colors().back().green), 128);
+        QCOMPARE(pointCloud.intensities().at(1), float(step));
+        QVERIFY(pointCloud.point(1).IsEqual(gp_Pnt(step * 0.01, -step * 0.01, 0.5), 1e-6));
+    }
+
+    {
+        IO::XyzReader reader;
+        reader.parameters().decimation.mode = PointCloudDecimation::Mode::VoxelGrid;
+        reader.parameters().decimation.voxelSize = 100.;
+        QVERIFY(reader.readFile(csvFilepath, &TaskProgress::null()));
+        const TDF_LabelSequence seqLabel = reader.transfer(doc, &TaskProgress::null());
+        // Points lie in two voxels, on each side of plane y=0
+        QCOMPARE(CafUtils::findAttribute<PointCloudData>(seqLabel.First())->pointCount(), size_t(2));
+    }
+
+    // XYZ file with georeferenced coordinates and colors in [0, 1], first colors look like integers
+    const FilePath xyzFilepath = std_filesystem::temp_directory_path() / "mayo_test_point_cloud.xyz";
+    auto _removeXyzFile = gsl::finally([=]{ std_filesystem::remove(xyzFilepath); });
+    {
+        std::ofstream ofs(xyzFilepath);
+        ofs << "600000.25 5400000.5 120 0 0 0\n";
+        ofs << "600000.75 5400001 121 0.5 1 0.25\n";
+    }
+
+    {
+        IO::XyzReader reader;
+        QVERIFY(reader.readFile(xyzFilepath, &TaskProgress::null()));
+        const TDF_LabelSequence seqLabel = reader.transfer(doc, &TaskProgress::null());
+        const PointCloud& pointCloud = *CafUtils::findAttribute<PointCloudData>(seqLabel.First())->pointCloud();
+        QCOMPARE(pointCloud.pointCount(), size_t(2));
+        QVERIFY(pointCloud.origin().IsEqual(gp_XYZ(600000.25, 5400000.5, 120), 0.));
+        QVERIFY(pointCloud.point(1).IsEqual(gp_Pnt(600000.75, 5400001, 121), 1e-6));
+        QCOMPARE(int(pointCloud.colors().at(1).red), 127);
+        QCOMPARE(int(pointCloud.colors().at(1).green), 255);
+    }
+
+    // LAS 1.2 file, point data record format 2(with 16-bit RGB)
+    const FilePath lasFilepath = std_filesystem::temp_directory_path() / "mayo_test_point_cloud.las";
+    auto _removeLasFile = gsl::finally([=]{ std_filesystem::remove(lasFilepath); });
+    {
+        std::string header(227, '\0');
+        auto fnSetValue = [&](size_t offset, auto value) {
+            std::memcpy(header.data() + offset, &value, sizeof(value));
+        };
+        header.replace(0, 4, "LASF");
+        fnSetValue(24, uint8_t(1));
+        fnSetValue(25, uint8_t(2));
+        fnSetValue(94, uint16_t(227));
+        fnSetValue(96, uint32_t(227));
+        fnSetValue(104, uint8_t(2));
+        fnSetValue(105, uint16_t(26));
+        fnSetValue(107, uint32_t(3));
+        const double offsets[] = { 600000., 5400000., 100. };
+        for (int i = 0; i < 3; ++i) {
+            fnSetValue(131 + 8 * i, 0.01);
+            fnSetValue(155 + 8 * i, offsets[i]);
+        }
+
+        std::ofstream ofs(lasFilepath, std::ios::binary);
+        ofs.write(header.data(), header.size());
+        for (int i = 0; i < 3; ++i) {
+            std::string record(26, '\0');
+            const int32_t coords[] = { i * 100, -i * 100, 50 };
+            std::memcpy(record.data(), coords, sizeof(coords));
+            const uint16_t intensity = uint16_t(10 * i);
+            std::memcpy(record.data() + 12, &intensity, sizeof(intensity));
+            record[15] = char(0x20 | 2); // Classification "Ground" with synthetic flag
+            const uint16_t rgb[] = { 65535, 32768, 0 };
+            std::memcpy(record.data() + 20, rgb, sizeof(rgb));
+            ofs.write(record.data(), record.size());
+        }
+    }
+
+    {
+        QCOMPARE(m_ioSystem->probeFormat(lasFilepath), IO::Format_LAS);
+        IO::LasReader reader;
+        QVERIFY(reader.readFile(lasFilepath, &TaskProgress::null()));
+        const TDF_LabelSequence seqLabel = reader.transfer(doc, &TaskProgress::null());
+        QCOMPARE(seqLabel.Size(), 1);
+        const PointCloud& pointCloud = *CafUtils::findAttribute<PointCloudData>(seqLabel.First())->pointCloud();
+        QCOMPARE(pointCloud.pointCount(), size_t(3));
+        QVERIFY(pointCloud.origin().IsEqual(gp_XYZ(600000, 5400000, 100), 0.));
+        QVERIFY(pointCloud.point(2).IsEqual(gp_Pnt(600002, 5399998, 100.5), 1e-6));
+        QCOMPARE(pointCloud.intensities().at(2), 20.f);
+        QCOMPARE(int(pointCloud.colors().at(0).red), 255);
+        QCOMPARE(int(pointCloud.colors().at(0).green), 128);
+        const PointCloud::ScalarField* classification = pointCloud.findScalarField("Classification");
+        QVERIFY(classification);
+        QCOMPARE(classification->values.at(1), 2.f);
+    }
+}
+
+void TestBase::IO_instrumentation_test()
+{
+    // Sink collecting all the records reported
+    struct RecordsSink : public InstrumentationSink {
+        void addRecord(const InstrumentationRecord& record) override {
+            std::lock_guard<std::mutex> lock(mutex);
+            vecRecord.push_back(record);
+        }
+
+        bool contains(std::string_view operation, std::string_view stage) const {
+            return std::any_of(vecRecord.cbegin(), vecRecord.cend(), [=](const InstrumentationRecord& rec) {
+                return rec.operation == operation && rec.stage == stage && rec.ok;
+            });
+        }
+
+        std::mutex mutex;
+        std::vector<InstrumentationRecord> vecRecord;
+    };
+
+    RecordsSink sink;
+    m_ioSystem->setInstrumentationSink(&sink);
+    auto _ = gsl::finally([=]{ m_ioSystem->setInstrumentationSink(nullptr); });
+
+    auto app = makeOccHandle<Application>();
+    DocumentPtr doc = app->newDocument();
+    const bool okImport = m_ioSystem->importInDocument()
+                              .targetDocument(doc)
+                              .withFilepath("tests/inputs/cube.stla")
+                              .execute();
+    QVERIFY(okImport);
+    QVERIFY(sink.contains("import", "probe"));
+    QVERIFY(sink.contains("import", "readFile"));
+    QVERIFY(sink.contains("import", "transfer"));
+    QVERIFY(sink.contains("import", "total"));
+    QVERIFY(!sink.contains("import", "postProcess"));
+
+    const bool okExport = m_ioSystem->exportApplicationItems()
+                              .targetFile("tests/outputs/cube_instrumentation.ply")
+                              .targetFormat(IO::Format_PLY)
+                              .withItem(doc)
+                              .execute();
+    QVERIFY(okExport);
+    // PLY writer supports streaming, so there is no separate transfer step
+    QVERIFY(sink.contains("export", "writeStreamed"));
+    QVERIFY(!sink.contains("export", "transfer"));
+    QVERIFY(sink.contains("export", "total"));
+
+    for (const InstrumentationRecord& record : sink.vecRecord) {
+        QVERIFY(record.seconds >= 0.);
+        const std::string strJson = InstrumentationJsonLinesSink::toJson(record);
+        QVERIFY(strJson.front() == '{' && strJson.back() == '}');
+        QVERIFY(strJson.find('\n') == std::string::npos);
+        QVERIFY(strJson.find(fmt::format("\"stage\":\"{}\"", record.stage)) != std::string::npos);
+    }
+
+    // No record must be reported once sink is reset
+    m_ioSystem->setInstrumentationSink(nullptr);
+    const auto recordCount = sink.vecRecord.size();
+    DocumentPtr doc2 = app->newDocument();
+    m_ioSystem->importInDocument().targetDocument(doc2).withFilepath("tests/inputs/cube.stla").execute();
+    QCOMPARE(sink.vecRecord.size(), recordCount);
+}
+
+void TestBase::IO_GmioAmfWriter_test()
+{
+#ifdef MAYO_HAVE_GMIO
+    auto app = makeOccHandle<Application>();
+    DocumentPtr doc = app->newDocument();
+    auto _ = gsl::finally([=]{ app->closeDocument(doc); });
+
+    // Parts A and B share the same color, part C is instanced in a nested sub-assembly
+    const OccHandle<XCAFDoc_ShapeTool> shapeTool = doc->xcaf().shapeTool();
+    const OccHandle<XCAFDoc_ColorTool> colorTool = doc->xcaf().colorTool();
+    auto fnAddPart = [&](const char* name, const Quantity_Color& color) {
+        const TopoDS_Shape shape = BRepPrimAPI_MakeBox(10, 10, 10);
+        BRepMesh_IncrementalMesh mesher(shape, 0.5);
+        const TDF_Label label = shapeTool->AddShape(shape, false/*makeAssembly*/);
+        TDataStd_Name::Set(label, name);
+        colorTool->SetColor(label, color, XCAFDoc_ColorGen);
+        return label;
+    };
+    auto fnAddComponent = [&](const TDF_Label& labelAssembly, const TDF_Label& labelRef, const char* name) {
+        const TDF_Label label = shapeTool->AddComponent(labelAssembly, labelRef, gp_Trsf{});
+        TDataStd_Name::Set(label, name);
+    };
+
+    const TDF_Label labelPartA = fnAddPart("PartA", Quantity_NOC_RED);
+    const TDF_Label labelPartB = fnAddPart("PartB", Quantity_NOC_RED);
+    const TDF_Label labelPartC = fnAddPart("PartC", Quantity_NOC_BLUE);
+    const TDF_Label labelSub = shapeTool->NewShape();
+    TDataStd_Name::Set(labelSub, "Sub");
+    fnAddComponent(labelSub, labelPartC, "C");
+    const TDF_Label labelRoot = shapeTool->NewShape();
+    TDataStd_Name::Set(labelRoot, "Root");
+    fnAddComponent(labelRoot, labelPartA, "A");
+    fnAddComponent(labelRoot, labelPartB, "B");
+    fnAddComponent(labelRoot, labelSub, "S");
+    shapeTool->UpdateAssemblies();
+    doc->addEntityTreeNode(labelRoot);
+
+    const ApplicationItem appItem(doc);
+    IO::GmioAmfWriter writer;
+    QVERIFY(writer.transfer(Span<const ApplicationItem>(&appItem, 1), &TaskProgress::null()));
+
+    // Default material plus one per distinct color
+    QCOMPARE(writer.materialCount(), 3);
+    QCOMPARE(writer.objectCount(), 3);
+    QCOMPARE(writer.instanceCount(), 3);
+    QCOMPARE(writer.instanceName(0), std::string_view("Root/A"));
+    QCOMPARE(writer.instanceName(1), std::string_view("Root/B"));
+    QCOMPARE(writer.instanceName(2), std::string_view("Root/S/Sub/C"));
+    for (int i = 0; i < writer.instanceCount(); ++i)
+        QCOMPARE(writer.instanceObjectId(i), i);
+#else
+    QSKIP("AMF writer requires gmio");
+#endif
+}
+
 void TestBase::DoubleToString_test()
 {
     const std::locale frLocale = getFrLocale();
@@ -738,6 +1646,428 @@ void TestBase::BRepUtils_test()
     }
 }
 
+void TestBase::BRepMeshLod_test()
+{
+    if (!BRepMeshLod::isSupported())
+        QSKIP("Multiple triangulations per face requires OpenCascade >= 7.6");
+
+    const TopoDS_Shape shape = BRepPrimAPI_MakeSphere(50.);
+    OccBRepMeshParameters coarseParams;
+    coarseParams.Deflection = 5.;
+    coarseParams.Angle = 1.;
+    BRepUtils::computeMesh(shape, coarseParams);
+    QCOMPARE(BRepMeshLod::levelCount(shape), 1);
+
+    OccBRepMeshParameters fineParams;
+    fineParams.Deflection = 0.05;
+    fineParams.Angle = 0.2;
+    const BRepMeshLod::Level level = BRepMeshLod::computeLevel(shape, fineParams);
+    QVERIFY(!level.empty());
+    QCOMPARE(BRepMeshLod::levelCount(shape), 1); // Input shape is left unchanged by computeLevel()
+
+    QVERIFY(BRepMeshLod::addLevel(level));
+    QCOMPARE(BRepMeshLod::levelCount(shape), 2);
+    QCOMPARE(BRepMeshLod::activeLevel(shape), 0);
+    QVERIFY(BRepMeshLod::levelDeflection(shape, 1) < BRepMeshLod::levelDeflection(shape, 0));
+
+    TopLoc_Location loc;
+    const TopoDS_Face face = TopoDS::Face(TopExp_Explorer(shape, TopAbs_FACE).Current());
+    const int coarseTriangleCount = BRep_Tool::Triangulation(face, loc)->NbTriangles();
+    QVERIFY(BRepMeshLod::setActiveLevel(shape, 1));
+    QVERIFY(!BRepMeshLod::setActiveLevel(shape, 1));
+    QCOMPARE(BRepMeshLod::activeLevel(shape), 1);
+    QVERIFY(BRep_Tool::Triangulation(face, loc)->NbTriangles() > coarseTriangleCount);
+
+    // Level is clamped to the finest one available
+    QVERIFY(BRepMeshLod::setActiveLevel(shape, 0));
+    QVERIFY(BRepMeshLod::setActiveLevel(shape, 5));
+    QCOMPARE(BRepMeshLod::activeLevel(shape), 1);
+
+    // Finest level is activated and pinned, without keeping the mutex locked
+    QVERIFY(BRepMeshLod::setActiveLevel(shape, 0));
+    const uint64_t unpinCount = BRepMeshLod::unpinCount();
+    {
+        BRepMeshLod::FinestLevelPin finestLevelPin(Span<const TopoDS_Shape>(&shape, 1));
+        QCOMPARE(BRepMeshLod::activeLevel(shape), 1);
+        QVERIFY(!BRepMeshLod::setActiveLevel(shape, 0));
+        QCOMPARE(BRepMeshLod::activeLevel(shape), 1);
+        QVERIFY(!BRepMeshLod::addLevel(level));
+        QCOMPARE(BRepMeshLod::levelCount(shape), 2);
+        bool isLocked = false;
+        std::thread([&]{
+            isLocked = BRepMeshLod::mutex().try_lock();
+            if (isLocked)
+                BRepMeshLod::mutex().unlock();
+        }).join();
+        QVERIFY(isLocked);
+    }
+
+    // Active triangulations aren't restored, faces can be changed again
+    QCOMPARE(BRepMeshLod::unpinCount(), unpinCount + 1);
+    QCOMPARE(BRepMeshLod::activeLevel(shape), 1);
+    QVERIFY(BRepMeshLod::setActiveLevel(shape, 0));
+    QCOMPARE(BRepMeshLod::activeLevel(shape), 0);
+}
+
+void TestBase::BRepDeferredMesh_test()
+{
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0) && defined(OPENCASCADE_HAVE_RAPIDJSON)
+    IO::OccGltfReader reader;
+    reader.parameters().deferredMeshDataLoading = true;
+    QVERIFY(reader.readFile("tests/inputs/cube.gltf", &TaskProgress::null()));
+
+    auto app = makeOccHandle<Application>();
+    DocumentPtr doc = app->newDocument();
+    auto _ = gsl::finally([=]{ app->closeDocument(doc); });
+    const TDF_LabelSequence seqEntity = reader.transfer(doc, &TaskProgress::null());
+    QVERIFY(!seqEntity.IsEmpty());
+    const TopoDS_Shape shape = XCaf::shape(seqEntity.First());
+    QVERIFY(BRepDeferredMesh::hasDeferredData(shape));
+
+    auto fnHasGeometry = [&]{
+        for (TopExp_Explorer expl(shape, TopAbs_FACE); expl.More(); expl.Next()) {
+            TopLoc_Location loc;
+            if (!BRep_Tool::Triangulation(TopoDS::Face(expl.Current()), loc)->HasGeometry())
+                return false;
+        }
+
+        return true;
+    };
+    QVERIFY(!fnHasGeometry());
+
+    BRepDeferredMesh::pin(shape);
+    QVERIFY(fnHasGeometry());
+    QVERIFY(BRepDeferredMesh::residentMemory() > 0);
+
+    // Unpinned data is unloaded only when memory limit is exceeded
+    const size_t memoryLimit = BRepDeferredMesh::memoryLimit();
+    BRepDeferredMesh::unpin(shape);
+    QVERIFY(fnHasGeometry());
+    BRepDeferredMesh::setMemoryLimit(0);
+    QVERIFY(!fnHasGeometry());
+    QCOMPARE(BRepDeferredMesh::residentMemory(), size_t(0));
+    BRepDeferredMesh::setMemoryLimit(memoryLimit);
+#else
+    QSKIP("Deferred mesh data requires OpenCascade >= 7.6 with RapidJSON");
+#endif
+}
+
+void TestBase::PointCloudOctree_test()
+{
+    // Regular grid of points, spacing 0.1
+    const int dimX = 50, dimY = 50, dimZ = 40;
+    std::vector<float> vecCoord;
+    for (int i = 0; i < dimX; ++i) {
+        for (int j = 0; j < dimY; ++j) {
+            for (int k = 0; k < dimZ; ++k)
+                vecCoord.insert(vecCoord.end(), { i * 0.1f, j * 0.1f, k * 0.1f });
+        }
+    }
+
+    PointCloudOctree::PointsView pointsView;
+    pointsView.data = reinterpret_cast<const char*>(vecCoord.data());
+    pointsView.count = uint32_t(vecCoord.size() / 3);
+    PointCloudOctree::Parameters params;
+    params.maxLeafPointCount = 1000;
+    PointCloudOctree octree;
+    QVERIFY(octree.build(pointsView, params));
+    QVERIFY(!octree.isEmpty());
+
+    // Sorted point indices are a permutation
+    std::vector<uint32_t> vecPointIndex(octree.pointIndices().begin(), octree.pointIndices().end());
+    std::sort(vecPointIndex.begin(), vecPointIndex.end());
+    for (uint32_t i = 0; i < pointsView.count; ++i)
+        QCOMPARE(vecPointIndex.at(i), i);
+
+    // Children partition their parent, and points are inside their node cell
+    for (const PointCloudOctree::Node& node : octree.nodes()) {
+        if (node.isLeaf()) {
+            QVERIFY(node.pointCount() <= params.maxLeafPointCount);
+        }
+        else {
+            uint32_t begin = node.begin;
+            for (int32_t ichild = node.firstChild; ichild < node.firstChild + node.childCount; ++ichild) {
+                QCOMPARE(octree.node(ichild).begin, begin);
+                QCOMPARE(int(octree.node(ichild).depth), node.depth + 1);
+                begin = octree.node(ichild).end;
+            }
+
+            QCOMPARE(begin, node.end);
+        }
+
+        Bnd_Box nodeBox = node.box;
+        nodeBox.Enlarge(1e-5);
+        for (uint32_t i = node.begin; i < node.end; ++i)
+            QVERIFY(!nodeBox.IsOut(pointsView.point(octree.pointIndices()[i])));
+    }
+
+    {   // Level of detail selection fits the point budget
+        Graphic3d_Camera camera;
+        camera.SetEye(gp_Pnt(2.5, 2.5, 20.));
+        camera.SetCenter(gp_Pnt(2.5, 2.5, 2.));
+        camera.SetUp(gp::DY());
+        camera.SetAspect(1.);
+        PointCloudOctree::LodParameters lodParams;
+        lodParams.pointBudget = 20000;
+        lodParams.nodeSampleCount = 1000;
+        const auto vecSample = octree.selectLod(camera, 1000, lodParams);
+        QVERIFY(!vecSample.empty());
+        QCOMPARE(vecSample.front().node, 0);
+        size_t pointCount = 0;
+        for (const PointCloudOctree::NodeSample& sample : vecSample)
+            pointCount += sample.pointCount;
+
+        QVERIFY(pointCount <= lodParams.pointBudget);
+        QVERIFY(vecSample.size() > 1);
+    }
+
+    {   // Traversal restricted to the nodes overlapping a box finds the same points as brute force
+        Bnd_Box queryBox;
+        queryBox.Update(1.05, 2.05, 0.55, 1.55, 2.55, 1.25);
+        int visitedNodeCount = 0;
+        std::vector<uint32_t> vecFoundIndex;
+        octree.traversePoints(
+            [&](const PointCloudOctree::Node& node) {
+                ++visitedNodeCount;
+                return !node.box.IsOut(queryBox);
+            },
+            [&](uint32_t ipnt) {
+                if (!queryBox.IsOut(pointsView.point(ipnt)))
+                    vecFoundIndex.push_back(ipnt);
+
+                return true;
+            }
+        );
+        std::vector<uint32_t> vecExpectedIndex;
+        for (uint32_t i = 0; i < pointsView.count; ++i) {
+            if (!queryBox.IsOut(pointsView.point(i)))
+                vecExpectedIndex.push_back(i);
+        }
+
+        std::sort(vecFoundIndex.begin(), vecFoundIndex.end());
+        QCOMPARE(vecFoundIndex.size(), size_t(5 * 5 * 7));
+        QVERIFY(vecFoundIndex == vecExpectedIndex);
+        QVERIFY(visitedNodeCount < int(octree.nodes().size()));
+
+        // Traversal stops as soon as the point visitor returns false
+        int visitedPointCount = 0;
+        octree.traversePoints(
+            [](const PointCloudOctree::Node&) { return true; },
+            [&](uint32_t) { return ++visitedPointCount < 10; }
+        );
+        QCOMPARE(visitedPointCount, 10);
+    }
+}
+
+void TestBase::PointCloudData_test()
+{
+    auto pointCloud = std::make_shared<PointCloud>();
+    for (int i = 0; i < 1000; ++i)
+        pointCloud->addPoint(gp_Pnt(i, -i, 0.5 * i));
+
+    QVERIFY(!pointCloud->hasColors());
+    pointCloud->allocateColors();
+    QVERIFY(pointCloud->hasColors());
+    QCOMPARE(pointCloud->colors().size(), pointCloud->pointCount());
+    pointCloud->colors().at(10) = { 255, 128, 0 };
+    pointCloud->addScalarField("Classification").values.at(10) = 2.f;
+    QCOMPARE(&pointCloud->addScalarField("Classification"), pointCloud->findScalarField("Classification"));
+    QCOMPARE(pointCloud->scalarFields().size(), size_t(1));
+    QVERIFY(!pointCloud->findScalarField("Intensity"));
+
+    // Allocated attributes follow positions
+    pointCloud->resize(1200);
+    QCOMPARE(pointCloud->colors().size(), size_t(1200));
+    QCOMPARE(pointCloud->findScalarField("Classification")->values.size(), size_t(1200));
+    QVERIFY(!pointCloud->hasNormals());
+    pointCloud->resize(1000);
+    QCOMPARE(int(pointCloud->colors().at(10).green), 128);
+    QCOMPARE(pointCloud->point(999).Y(), -999.);
+    QCOMPARE(pointCloud->memorySize(), size_t(1000 * (12 + 3 + 4)));
+
+    const Bnd_Box bndBox = pointCloud->computeBoundingBox();
+    QVERIFY(bndBox.CornerMin().IsEqual(gp_Pnt(0, -999, 0), Precision::Confusion()));
+    QVERIFY(bndBox.CornerMax().IsEqual(gp_Pnt(999, 0, 499.5), Precision::Confusion()));
+
+    // Attribute shares the point cloud and indexes its positions
+    OccHandle<TDF_Data> data = new TDF_Data;
+    const PointCloudDataPtr attrPointCloudData = PointCloudData::Set(data->Root(), pointCloud);
+    QCOMPARE(attrPointCloudData->pointCloud().get(), pointCloud.get());
+    QCOMPARE(attrPointCloudData->pointCount(), size_t(1000));
+    QVERIFY(!attrPointCloudData->builtOctree());
+    const std::shared_ptr<const PointCloudOctree> octree = attrPointCloudData->octree();
+    QVERIFY(octree);
+    QCOMPARE(octree->points().count, uint32_t(1000));
+    QCOMPARE(attrPointCloudData->octree(), octree);
+    QCOMPARE(attrPointCloudData->builtOctree(), octree);
+}
+
+void TestBase::PointCloudUtils_test()
+{
+    // Lattice of 10x10x10 points spaced by 1
+    PointCloud lattice;
+    for (int x = 0; x < 10; ++x) {
+        for (int y = 0; y < 10; ++y) {
+            for (int z = 0; z < 10; ++z)
+                lattice.addPoint(gp_Pnt(x, y, z));
+        }
+    }
+
+    lattice.allocateIntensities();
+    for (size_t i = 0; i < lattice.pointCount(); ++i)
+        lattice.intensities().at(i) = float(i);
+
+    // Each voxel of size 5 holds 5x5x5 points, the one at the centroid is kept
+    const PointCloud downsampled = PointCloudUtils::voxelGridDownsample(lattice, 5.);
+    QCOMPARE(downsampled.pointCount(), size_t(8));
+    QCOMPARE(downsampled.intensities().size(), size_t(8));
+    QCOMPARE(downsampled.point(0).Distance(gp_Pnt(2, 2, 2)), 0.);
+    QCOMPARE(downsampled.point(7).Distance(gp_Pnt(7, 7, 7)), 0.);
+
+    // Isolated point far from the lattice is an outlier
+    PointCloud noisyLattice = lattice;
+    noisyLattice.resize(1001);
+    noisyLattice.positions().back() = PointCloud::Vec3f(100.f, 100.f, 100.f);
+    const std::vector<uint32_t> vecInlierIndex = PointCloudUtils::statisticalInlierIndices(noisyLattice, 8, 1.);
+    QCOMPARE(vecInlierIndex.size(), size_t(1000));
+    QCOMPARE(vecInlierIndex.back(), uint32_t(999));
+    QCOMPARE(PointCloudUtils::removeStatisticalOutliers(noisyLattice, 8, 1.).pointCount(), size_t(1000));
+
+    Bnd_Box box;
+    box.Update(0, 0, 0, 4.5, 4.5, 4.5);
+    QCOMPARE(PointCloudUtils::cropBox(lattice, box).pointCount(), size_t(125));
+    QVERIFY(PointCloudUtils::cropBox(lattice, Bnd_Box()).isEmpty());
+}
+
+void TestBase::MergedParts_test()
+{
+    const TopoDS_Shape box = BRepPrimAPI_MakeBox(10., 20., 30.);
+    auto mergedParts = makeOccHandle<AIS_MergedParts>(
+        Quantity_NOC_RED, Graphic3d_MaterialAspect(Graphic3d_NOM_PLASTER)
+    );
+    // Shape isn't meshed yet
+    QCOMPARE(AIS_MergedParts::shapeTriangleCount(box), -1);
+    QCOMPARE(mergedParts->addPart(1, box), -1);
+    QCOMPARE(mergedParts->partCount(), 0);
+
+    BRepMesh_IncrementalMesh mesher(box, 0.1);
+    QCOMPARE(AIS_MergedParts::shapeTriangleCount(box), 12);
+    gp_Trsf trsf;
+    trsf.SetTranslation(gp_Vec(100., 0., 0.));
+    QCOMPARE(mergedParts->addPart(1, box), 0);
+    QCOMPARE(mergedParts->addPart(5, box.Moved(TopLoc_Location(trsf))), 1);
+    QCOMPARE(mergedParts->partCount(), 2);
+    QCOMPARE(mergedParts->partId(1), AIS_MergedParts::PartId(5));
+    QCOMPARE(mergedParts->partTriangleCount(1), 12);
+    QCOMPARE(mergedParts->triangleCount(), 24);
+
+    // Location of the part is applied
+    double xmin, ymin, zmin, xmax, ymax, zmax;
+    mergedParts->partBoundingBox(1).Get(xmin, ymin, zmin, xmax, ymax, zmax);
+    QCOMPARE(xmin, 100.);
+    QCOMPARE(xmax, 110.);
+    QCOMPARE(ymax, 20.);
+    QCOMPARE(zmax, 30.);
+
+    QCOMPARE(mergedParts->visiblePartCount(), 2);
+    mergedParts->setPartVisible(0, false);
+    mergedParts->setPartVisible(0, false);
+    QVERIFY(!mergedParts->isPartVisible(0));
+    QCOMPARE(mergedParts->visiblePartCount(), 1);
+    mergedParts->setPartVisible(0, true);
+    QCOMPARE(mergedParts->visiblePartCount(), 2);
+
+    // Selection owner of a part is created once
+    const OccHandle<AIS_MergedParts::PartOwner> owner = mergedParts->partOwner(1);
+    QCOMPARE(owner->partIndex(), 1);
+    QVERIFY(owner->Selectable().get() == mergedParts.get());
+    QVERIFY(mergedParts->partOwner(1) == owner);
+}
+
+void TestBase::PointCloudLodPicking_test()
+{
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+    // Two points aligned along the view direction and a third one aside
+    const std::vector<float> vecCoord = { 0.f, 0.f, 0.f,  0.f, 0.f, 5.f,  3.f, 0.f, 0.f };
+    PointCloudOctree::PointsView pointsView;
+    pointsView.data = reinterpret_cast<const char*>(vecCoord.data());
+    pointsView.count = 3;
+    PointCloudOctree::Parameters params;
+    params.maxLeafPointCount = 1;
+    auto octree = std::make_shared<PointCloudOctree>();
+    QVERIFY(octree->build(pointsView, params));
+    QVERIFY(octree->nodes().size() > 1);
+    auto sensitive = makeOccHandle<Select3D_SensitivePointCloudOctree>(OccHandle<SelectMgr_EntityOwner>(), octree);
+    QCOMPARE(sensitive->NbSubElements(), 3);
+
+    // Orthographic camera looking down the Z axis, 20 units shown over 200 pixels
+    auto camera = makeOccHandle<Graphic3d_Camera>();
+    camera->SetProjectionType(Graphic3d_Camera::Projection_Orthographic);
+    camera->SetEye(gp_Pnt(0., 0., 100.));
+    camera->SetCenter(gp::Origin());
+    camera->SetUp(gp::DY());
+    camera->SetScale(20.);
+    camera->SetAspect(1.);
+    camera->SetZRange(1., 200.);
+    const int viewSize = 200;
+    auto fnPixel = [&](const gp_Pnt& pnt) {
+        const gp_Pnt pntNdc = camera->Project(pnt);
+        return gp_Pnt2d((pntNdc.X() + 1.) * 0.5 * viewSize, (1. - pntNdc.Y()) * 0.5 * viewSize);
+    };
+    auto fnSetupVolume = [&](SelectMgr_SelectingVolumeManager& mgr) {
+        mgr.SetPixelTolerance(2);
+        mgr.SetCamera(camera);
+        mgr.SetWindowSize(viewSize, viewSize);
+        mgr.BuildSelectingVolume();
+    };
+    auto fnPickAt = [&](const gp_Pnt& pnt, SelectBasics_PickResult& pickResult) {
+        SelectMgr_SelectingVolumeManager mgr;
+        mgr.InitPointSelectingVolume(fnPixel(pnt));
+        fnSetupVolume(mgr);
+        return sensitive->Matches(mgr, pickResult);
+    };
+
+    {   // Nearest point to the eye is picked
+        SelectBasics_PickResult pickResult;
+        QVERIFY(fnPickAt(gp::Origin(), pickResult));
+        QVERIFY(pickResult.PickedPoint().IsEqual(gp_Pnt(0., 0., 5.), Precision::Confusion()));
+    }
+
+    {
+        SelectBasics_PickResult pickResult;
+        QVERIFY(fnPickAt(gp_Pnt(3., 0., 0.), pickResult));
+        QVERIFY(pickResult.PickedPoint().IsEqual(gp_Pnt(3., 0., 0.), Precision::Confusion()));
+    }
+
+    {   // Nothing picked between the points, though inside the bounding box
+        SelectBasics_PickResult pickResult;
+        QVERIFY(!fnPickAt(gp_Pnt(1.5, 0., 0.), pickResult));
+    }
+
+    auto fnBoxSelect = [&](const gp_Pnt& pntMin, const gp_Pnt& pntMax, bool allowOverlap) {
+        SelectMgr_SelectingVolumeManager mgr;
+        const gp_Pnt2d pixMin = fnPixel(pntMin);
+        const gp_Pnt2d pixMax = fnPixel(pntMax);
+        mgr.InitBoxSelectingVolume(
+            gp_Pnt2d(std::min(pixMin.X(), pixMax.X()), std::min(pixMin.Y(), pixMax.Y())),
+            gp_Pnt2d(std::max(pixMin.X(), pixMax.X()), std::max(pixMin.Y(), pixMax.Y()))
+        );
+        mgr.AllowOverlapDetection(allowOverlap);
+        fnSetupVolume(mgr);
+        SelectBasics_PickResult pickResult;
+        return sensitive->Matches(mgr, pickResult);
+    };
+
+    // Box selection needs all points inside, unless overlap is allowed
+    QVERIFY(fnBoxSelect(gp_Pnt(-1., -1., 0.), gp_Pnt(4., 1., 0.), false));
+    QVERIFY(!fnBoxSelect(gp_Pnt(2., -1., 0.), gp_Pnt(4., 1., 0.), false));
+    QVERIFY(fnBoxSelect(gp_Pnt(2., -1., 0.), gp_Pnt(4., 1., 0.), true));
+    QVERIFY(!fnBoxSelect(gp_Pnt(1., -1., 0.), gp_Pnt(2., 1., 0.), true));
+#else
+    QSKIP("Picking of point cloud octree requires OpenCascade >= 7.6");
+#endif
+}
+
 void TestBase::CafUtils_test()
 {
     // TODO Add CafUtils::labelTag() test for multi-threaded safety
@@ -940,6 +2270,96 @@ void TestBase::MeshUtils_test_data()
     QTest::newRow("case4") << 40. << 50. << 70.;
 }
 
+void TestBase::MeshUtils_decimateVertexClustering_test()
+{
+    // Planar grid of 10x10 nodes spaced by 1, each quad split into two triangles
+    auto grid = makeOccHandle<Poly_Triangulation>(100, 2 * 81, false);
+    auto fnNodeIndex = [](int x, int y) { return y * 10 + x + 1; };
+    for (int y = 0; y < 10; ++y) {
+        for (int x = 0; x < 10; ++x)
+            MeshUtils::setNode(grid, fnNodeIndex(x, y), gp_Pnt(x, y, 0));
+    }
+
+    int triangleIndex = 1;
+    for (int y = 0; y < 9; ++y) {
+        for (int x = 0; x < 9; ++x) {
+            const int n1 = fnNodeIndex(x, y);
+            const int n2 = fnNodeIndex(x + 1, y);
+            const int n3 = fnNodeIndex(x + 1, y + 1);
+            const int n4 = fnNodeIndex(x, y + 1);
+            MeshUtils::setTriangle(grid, triangleIndex++, { n1, n2, n3 });
+            MeshUtils::setTriangle(grid, triangleIndex++, { n1, n3, n4 });
+        }
+    }
+
+    // Cells of size 5 merge the grid into 2x2 nodes, only the two triangles of the central quad
+    // have their nodes in distinct cells
+    std::vector<int> nodeMap;
+    const OccHandle<Poly_Triangulation> mesh = MeshUtils::decimateVertexClustering(grid, 5., &nodeMap);
+    QCOMPARE(mesh->NbNodes(), 4);
+    QCOMPARE(mesh->NbTriangles(), 2);
+    QCOMPARE(nodeMap.size(), size_t(100));
+    QCOMPARE(mesh->Node(nodeMap.at(0)).Distance(gp_Pnt(2, 2, 0)), 0.);
+    QCOMPARE(mesh->Node(nodeMap.at(99)).Distance(gp_Pnt(7, 7, 0)), 0.);
+    QCOMPARE(MeshUtils::triangulationArea(mesh), 25.);
+
+    // Nodes distant by less than float precision at such coordinates are still told apart
+    const double farX = 1 << 25;
+    QVERIFY(VoxelKey::of(gp_XYZ(farX, 0, 0), 1.) != VoxelKey::of(gp_XYZ(farX + 1, 0, 0), 1.));
+}
+
+void TestBase::MeshBvh_test()
+{
+    const TopoDS_Shape sphere = BRepPrimAPI_MakeSphere(10.);
+    BRepMesh_IncrementalMesh mesher(sphere, 1.);
+    const TopoDS_Face face = TopoDS::Face(TopExp_Explorer(sphere, TopAbs_FACE).Current());
+    TopLoc_Location loc;
+    const OccHandle<Poly_Triangulation> mesh = BRep_Tool::Triangulation(face, loc);
+    QVERIFY(mesh);
+
+    const MeshBvh bvh(mesh);
+    QCOMPARE(bvh.triangleCount(), size_t(mesh->NbTriangles()));
+
+    // Reference results are given by exhaustive search over single triangle hierarchies
+    std::vector<MeshBvh> vecTriangleBvh;
+    for (int i = 1; i <= mesh->NbTriangles(); ++i)
+        vecTriangleBvh.emplace_back(mesh, Span<const int>(&i, 1));
+
+    const gp_Pnt points[] = { {0, 0, 0}, {15, 0, 0}, {3, -4, 20}, {-7, 7, 1}, {0, 0, -10} };
+    for (const gp_Pnt& pnt : points) {
+        const MeshBvh::Nearest nearest = bvh.nearestTo(pnt);
+        QVERIFY(nearest.isValid());
+        double distMin = std::numeric_limits<double>::max();
+        for (const MeshBvh& triangleBvh : vecTriangleBvh)
+            distMin = std::min(distMin, triangleBvh.nearestTo(pnt).distance);
+
+        QVERIFY(std::abs(nearest.distance - distMin) < 1e-9);
+        QVERIFY(std::abs(nearest.pnt1.Distance(pnt) - nearest.distance) < 1e-9);
+        // Nearest point lies on the mesh, query point is given back as pnt2
+        QVERIFY(bvh.nearestTo(nearest.pnt1).distance < 1e-9);
+        QVERIFY(nearest.pnt2.IsEqual(pnt, 0.));
+        QVERIFY(nearest.triangle1 > 0);
+    }
+
+    // Distance between the sphere and a rotated copy whose center is 25 away
+    gp_Trsf trsf;
+    trsf.SetRotation(gp::OY(), M_PI / 5.);
+    trsf.SetTranslationPart(gp_Vec(25, 0, 0));
+    const MeshBvh::Nearest nearest = bvh.nearestTo(gp_Trsf(), bvh, trsf);
+    QVERIFY(nearest.isValid());
+    double distMin = std::numeric_limits<double>::max();
+    for (const MeshBvh& triangleBvh : vecTriangleBvh)
+        distMin = std::min(distMin, bvh.nearestTo(gp_Trsf(), triangleBvh, trsf).distance);
+
+    QVERIFY(std::abs(nearest.distance - distMin) < 1e-9);
+    QVERIFY(nearest.distance >= 5.);
+    QVERIFY(nearest.distance < 5. + 2 * 1.);
+
+    // Sphere is intersecting a copy moved by less than its diameter
+    trsf.SetTranslationPart(gp_Vec(12, 0, 0));
+    QCOMPARE(bvh.nearestTo(gp_Trsf(), bvh, trsf).distance, 0.);
+}
+
 void TestBase::Quantity_test()
 {
     const QuantityArea area = (10 * Quantity_Millimeter) * (5 * Quantity_Centimeter);
@@ -1165,6 +2585,90 @@ void TestBase::LibTask_test()
     QCOMPARE(vecProgressRec.back().value, 100);
 }
 
+void TestBase::LibTask_progress_test()
+{
+    TaskManager taskMgr;
+    taskMgr.setProgressSignalInterval(60 * 60 * 1000);
+    std::mutex mutexProgressValue;
+    std::vector<int> vecProgressValue;
+    taskMgr.signalProgressChanged.connectSlot([&](TaskId, int pct) {
+        std::lock_guard<std::mutex> lock(mutexProgressValue);
+        vecProgressValue.push_back(pct);
+    });
+
+    // Deeply nested portions which don't divide evenly, updated from many threads
+    int subProgressValue = 0;
+    const TaskId taskId = taskMgr.newTask([&](TaskProgress* progress) {
+        TaskProgress subProgress(progress, 100);
+        std::vector<std::thread> vecThread;
+        for (int i = 0; i < 7; ++i) {
+            vecThread.emplace_back([&]{
+                TaskProgress threadProgress(&subProgress, 100 / 7.);
+                for (int j = 0; j < 3; ++j) {
+                    TaskProgress stepProgress(&threadProgress, 100 / 3.);
+                    for (int k = 0; k <= 1000; ++k)
+                        stepProgress.setValue(k / 10.);
+                }
+            });
+        }
+
+        for (std::thread& thread : vecThread)
+            thread.join();
+
+        subProgressValue = subProgress.value();
+    });
+
+    taskMgr.run(taskId, TaskAutoDestroy::Off);
+    taskMgr.waitForDone(taskId);
+    QCOMPARE(subProgressValue, 100);
+    QCOMPARE(taskMgr.progress(taskId), 100);
+
+    // Intermediate values were coalesced as signal interval is far longer than task duration
+    QVERIFY(!vecProgressValue.empty());
+    QVERIFY(vecProgressValue.size() <= 2);
+    QCOMPARE(vecProgressValue.back(), 100);
+
+    // Own value of a parent doesn't overwrite the values of its children, abort is seen by children
+    // and the last(throttled) value is notified
+    vecProgressValue.clear();
+    int parentValue = 0;
+    bool isChildAbortRequested = false;
+    const TaskId abortTaskId = taskMgr.newTask([&](TaskProgress* progress) {
+        TaskProgress subProgress(progress, 50);
+        subProgress.setValue(40);
+        progress->setValue(30);
+        parentValue = progress->value();
+        taskMgr.requestAbort(progress->taskId());
+        isChildAbortRequested = subProgress.isAbortRequested();
+        subProgress.setValue(80);
+    });
+
+    taskMgr.run(abortTaskId, TaskAutoDestroy::Off);
+    taskMgr.waitForDone(abortTaskId);
+    QCOMPARE(parentValue, 50);
+    QVERIFY(isChildAbortRequested);
+    QCOMPARE(taskMgr.progress(abortTaskId), 50);
+    QVERIFY(!vecProgressValue.empty());
+    QCOMPARE(vecProgressValue.back(), 50);
+
+    // Throttled value is notified once the interval has elapsed, without waiting for the task end
+    taskMgr.setProgressSignalInterval(50);
+    vecProgressValue.clear();
+    std::vector<int> vecProgressValueBeforeEnd;
+    const TaskId trailingTaskId = taskMgr.newTask([&](TaskProgress* progress) {
+        progress->setValue(10);
+        progress->setValue(20);
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        std::lock_guard<std::mutex> lock(mutexProgressValue);
+        vecProgressValueBeforeEnd = vecProgressValue;
+    });
+
+    taskMgr.run(trailingTaskId);
+    taskMgr.waitForDone(trailingTaskId);
+    QVERIFY(!vecProgressValueBeforeEnd.empty());
+    QCOMPARE(vecProgressValueBeforeEnd.back(), 20);
+}
+
 void TestBase::LibTree_test()
 {
     const TreeNodeId nullptrId = 0;
@@ -1241,6 +2745,8 @@ void TestBase::initTestCase()
     m_ioSystem->addFactoryReader(std::make_unique<IO::OccFactoryReader>());
     m_ioSystem->addFactoryReader(std::make_unique<IO::OffFactoryReader>());
     m_ioSystem->addFactoryReader(std::make_unique<IO::PlyFactoryReader>());
+    m_ioSystem->addFactoryReader(std::make_unique<IO::XyzFactoryReader>());
+    m_ioSystem->addFactoryReader(std::make_unique<IO::LasFactoryReader>());
 
     m_ioSystem->addFactoryWriter(std::make_unique<IO::OccFactoryWriter>());
     m_ioSystem->addFactoryWriter(std::make_unique<IO::OffFactoryWriter>());
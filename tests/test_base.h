@@ -17,7 +17,12 @@ class TestBase : public QObject {
     Q_OBJECT
 private slots:
     void Application_test();
+    void Application_saveDocument_test();
     void DocumentRefCount_test();
+    void Document_labelDataFlags_test();
+    void ApplicationItemSelectionModel_test();
+    void AssemblyGraph_test();
+    void BRepBndBoxCache_test();
 
     void CppUtils_toggle_test();
     void CppUtils_safeStaticCast_test();
@@ -46,16 +51,32 @@ private slots:
     void IO_bugGitHub166_test();
     void IO_bugGitHub166_test_data();
     void IO_bugGitHub258_test();
+    void IO_OccBRep_test();
+    void IO_OccStl_test();
+    void IO_OccBaseMeshReader_test();
+    void IO_OffReader_test();
+    void IO_PointCloudReaders_test();
+    void IO_instrumentation_test();
+    void IO_GmioAmfWriter_test();
 
     void DoubleToString_test();
     void StringConv_test();
 
     void BRepUtils_test();
+    void BRepMeshLod_test();
+    void BRepDeferredMesh_test();
+    void PointCloudOctree_test();
+    void PointCloudData_test();
+    void PointCloudUtils_test();
+    void MergedParts_test();
+    void PointCloudLodPicking_test();
 
     void CafUtils_test();
 
     void MeshUtils_test();
     void MeshUtils_test_data();
+    void MeshUtils_decimateVertexClustering_test();
+    void MeshBvh_test();
     void MeshUtils_orientation_test();
     void MeshUtils_orientation_test_data();
 
@@ -75,6 +96,7 @@ private slots:
     void UnitSystem_test_data();
 
     void LibTask_test();
+    void LibTask_progress_test();
     void LibTree_test();
 
     void Span_test();
@@ -11,29 +11,65 @@
 #include "../src/base/task_progress.h"
 #include "../src/base/unit_system.h"
 #include "../src/io_occ/io_occ_stl.h"
+#include "../src/base/mesh_bvh.h"
+#include "../src/base/mesh_utils.h"
+#include "../src/measure/measure_cache.h"
 #include "../src/measure/measure_tool_brep.h"
+#include "../src/measure/measure_tool_mesh.h"
 
 #include <BRep_Builder.hxx>
 #include <BRepAdaptor_Curve.hxx>
 #include <BRepBuilderAPI_MakeVertex.hxx>
 #include <BRepBuilderAPI_MakeEdge.hxx>
 #include <BRepBuilderAPI_MakeFace.hxx>
+#include <BRepMesh_IncrementalMesh.hxx>
 #include <BRepPrimAPI_MakeBox.hxx>
 #include <BRepPrimAPI_MakeSphere.hxx>
 #include <Geom_BSplineCurve.hxx>
 #include <GeomConvert_ApproxCurve.hxx>
 #include <GC_MakeCircle.hxx>
 #include <GC_MakeEllipse.hxx>
+#include <TopoDS_Compound.hxx>
 #include <TopoDS_Edge.hxx>
 #include <TopoDS_Vertex.hxx>
 
 #include <QtCore/QtDebug>
+#include <algorithm>
 #include <cmath>
 
 namespace Mayo {
 
 namespace {
 
+// Triangulation of the box [0, dx]x[0, dy]x[0, dz], triangles are oriented outwards
+OccHandle<Poly_Triangulation> makeBoxTriangulation(double dx, double dy, double dz)
+{
+    auto mesh = makeOccHandle<Poly_Triangulation>(8, 12, false);
+    auto fnNodeIndex = [](int x, int y, int z) { return 1 + x + 2 * y + 4 * z; };
+    for (int z = 0; z < 2; ++z) {
+        for (int y = 0; y < 2; ++y) {
+            for (int x = 0; x < 2; ++x)
+                MeshUtils::setNode(mesh, fnNodeIndex(x, y, z), gp_Pnt(x * dx, y * dy, z * dz));
+        }
+    }
+
+    const int quads[6][4] = {
+        { fnNodeIndex(0, 0, 0), fnNodeIndex(0, 1, 0), fnNodeIndex(1, 1, 0), fnNodeIndex(1, 0, 0) },
+        { fnNodeIndex(0, 0, 1), fnNodeIndex(1, 0, 1), fnNodeIndex(1, 1, 1), fnNodeIndex(0, 1, 1) },
+        { fnNodeIndex(0, 0, 0), fnNodeIndex(1, 0, 0), fnNodeIndex(1, 0, 1), fnNodeIndex(0, 0, 1) },
+        { fnNodeIndex(0, 1, 0), fnNodeIndex(0, 1, 1), fnNodeIndex(1, 1, 1), fnNodeIndex(1, 1, 0) },
+        { fnNodeIndex(0, 0, 0), fnNodeIndex(0, 0, 1), fnNodeIndex(0, 1, 1), fnNodeIndex(0, 1, 0) },
+        { fnNodeIndex(1, 0, 0), fnNodeIndex(1, 1, 0), fnNodeIndex(1, 1, 1), fnNodeIndex(1, 0, 1) }
+    };
+    int triangleIndex = 1;
+    for (const int* quad : quads) {
+        MeshUtils::setTriangle(mesh, triangleIndex++, { quad[0], quad[1], quad[2] });
+        MeshUtils::setTriangle(mesh, triangleIndex++, { quad[0], quad[2], quad[3] });
+    }
+
+    return mesh;
+}
+
 bool compareCircle(const gp_Circ& lhs, const gp_Circ& rhs, double tolerance = Precision::Confusion())
 {
     return lhs.Location().IsEqual(rhs.Location(), tolerance)
@@ -223,4 +259,158 @@ void TestMeasure::BRepBoundingBox_NullShape_test()
     QVERIFY_EXCEPTION_THROWN(MeasureToolBRep::brepBoundingBox(nullShape), IMeasureError);
 }
 
+void TestMeasure::BRepMassProperties_Box_test()
+{
+    auto fnFuzzyEqual = [](double lhs, double rhs) {
+        return std::abs(lhs - rhs) <= 1e-6 * std::max(1., std::abs(rhs));
+    };
+    auto fnCompareProps = [=](const MassProperties& lhs, const MassProperties& rhs) {
+        if (!fnFuzzyEqual(lhs.mass, rhs.mass) || !lhs.centerOfMass.IsEqual(rhs.centerOfMass, 1e-6))
+            return false;
+
+        for (int row = 1; row <= 3; ++row) {
+            for (int col = 1; col <= 3; ++col) {
+                if (!fnFuzzyEqual(lhs.inertia.Value(row, col), rhs.inertia.Value(row, col)))
+                    return false;
+            }
+        }
+
+        return true;
+    };
+
+    // Box of dimensions 10x20x30
+    const TopoDS_Shape box = BRepPrimAPI_MakeBox(gp_Pnt{1, 2, 3}, 10, 20, 30);
+    MeasureMassProperties measure = MeasureToolBRep::brepMassProperties(box);
+    const MassProperties& props = measure.volumeProps;
+    QVERIFY(fnFuzzyEqual(props.mass, 6000.));
+    QVERIFY(props.centerOfMass.IsEqual(gp_Pnt{6, 12, 18}, 1e-6));
+    QVERIFY(fnFuzzyEqual(props.inertia.Value(1, 1), 6000. * (20 * 20 + 30 * 30) / 12.));
+    QVERIFY(fnFuzzyEqual(props.inertia.Value(2, 2), 6000. * (10 * 10 + 30 * 30) / 12.));
+    QVERIFY(fnFuzzyEqual(props.inertia.Value(3, 3), 6000. * (10 * 10 + 20 * 20) / 12.));
+    QVERIFY(fnFuzzyEqual(props.inertia.Value(1, 2), 0.));
+
+    // Material density of 7.8g/cm³
+    QVERIFY(!measure.massProps);
+    MeasureMassProperties_applyDensity(&measure, 7.8 * Quantity_GramPerCubicCentimeter);
+    QVERIFY(measure.massProps);
+    QVERIFY(fnFuzzyEqual(measure.massProps->mass, 0.0468));
+    QVERIFY(measure.massProps->centerOfMass.IsEqual(props.centerOfMass, 1e-6));
+
+    // Integration over the triangulation is exact for planar faces
+    BRepMesh_IncrementalMesh mesher(box, 1.);
+    QVERIFY(fnCompareProps(MassProperties::computeFromTriangulations(box), props));
+
+    // Properties of instances are deduced from the product properties moved by locations
+    gp_Trsf trsf;
+    trsf.SetRotation(gp::OZ(), M_PI / 3.);
+    trsf.SetTranslationPart(gp_Vec{100, -20, 5});
+    QVERIFY(fnCompareProps(MeasureToolBRep::brepMassProperties(box.Moved(trsf)).volumeProps, props.transformed(trsf)));
+
+    // Solids are accumulated
+    TopoDS_Compound compound;
+    BRep_Builder builder;
+    builder.MakeCompound(compound);
+    builder.Add(compound, box);
+    builder.Add(compound, box.Moved(trsf));
+    MassProperties sumProps = props;
+    sumProps.add(props.transformed(trsf));
+    QVERIFY(fnCompareProps(MassProperties::compute(compound), sumProps));
+
+    // Reversed solid gives the same properties
+    QVERIFY(fnCompareProps(MassProperties::compute(box.Reversed()), props));
+}
+
+void TestMeasure::MeshMeasure_Box_test()
+{
+    // Mesh of box of dimensions 10x20x30 located at (1, 2, 3)
+    MeasureToolMesh::Entity mesh;
+    mesh.type = MeasureToolMesh::Entity::Type::Mesh;
+    mesh.triangulation = makeBoxTriangulation(10, 20, 30);
+    mesh.trsf.SetTranslation(gp_Vec{1, 2, 3});
+
+    MeasureToolMesh::Entity node = mesh;
+    node.type = MeasureToolMesh::Entity::Type::Node;
+    node.index = 8;
+    QVERIFY(MeasureToolMesh::meshVertexPosition(node).IsEqual(gp_Pnt{11, 22, 33}, Precision::Confusion()));
+    QVERIFY_EXCEPTION_THROWN(MeasureToolMesh::meshVertexPosition(mesh), IMeasureError);
+
+    const MeasureArea area = MeasureToolMesh::meshArea(mesh);
+    QVERIFY(std::abs(double(UnitSystem::squareMillimeters(area.value)) - 2 * (200 + 600 + 300)) < 1e-9);
+
+    const MeasureBoundingBox bndBox = MeasureToolMesh::meshBoundingBox(mesh);
+    QVERIFY(bndBox.cornerMin.IsEqual(gp_Pnt{1, 2, 3}, Precision::Confusion()));
+    QVERIFY(bndBox.cornerMax.IsEqual(gp_Pnt{11, 22, 33}, Precision::Confusion()));
+
+    const MeasureMassProperties measure = MeasureToolMesh::meshMassProperties(mesh);
+    QVERIFY(std::abs(measure.volumeProps.mass - 6000.) < 1e-6);
+    QVERIFY(measure.volumeProps.centerOfMass.IsEqual(gp_Pnt{6, 12, 18}, 1e-6));
+
+    // Closed mesh has no free boundary, whereas boundary of a triangle is its perimeter
+    QVERIFY_EXCEPTION_THROWN(MeasureToolMesh::meshBoundaryLength(mesh), IMeasureError);
+    MeasureToolMesh::Entity triangle = mesh;
+    triangle.type = MeasureToolMesh::Entity::Type::Triangle;
+    triangle.index = 1;
+    const MeasureLength len = MeasureToolMesh::meshBoundaryLength(triangle);
+    QVERIFY(std::abs(double(UnitSystem::millimeters(len.value)) - (20 + 10 + std::sqrt(500.))) < 1e-9);
+}
+
+void TestMeasure::MeshMinDistance_TwoBoxes_test()
+{
+    const OccHandle<Poly_Triangulation> boxMesh = makeBoxTriangulation(10, 20, 30);
+    // 1st box occupies [1, 11]x[2, 22]x[3, 33]
+    MeasureToolMesh::Entity mesh1;
+    mesh1.type = MeasureToolMesh::Entity::Type::Mesh;
+    mesh1.triangulation = boxMesh;
+    mesh1.trsf.SetTranslation(gp_Vec{1, 2, 3});
+
+    // 2nd box is rotated by 90° around Z, it occupies [80, 100]x[0, 10]x[0, 30]
+    MeasureToolMesh::Entity mesh2 = mesh1;
+    mesh2.trsf.SetRotation(gp::OZ(), M_PI / 2.);
+    mesh2.trsf.SetTranslationPart(gp_Vec{100, 0, 0});
+
+    const MeasureDistance dist = MeasureToolMesh::meshMinDistance(mesh1, mesh2);
+    QVERIFY(std::abs(double(UnitSystem::millimeters(dist.value)) - 69.) < 1e-9);
+    QVERIFY(std::abs(dist.pnt1.X() - 11.) < 1e-9);
+    QVERIFY(std::abs(dist.pnt2.X() - 80.) < 1e-9);
+
+    // Node (100, 0, 0) of the 2nd box to the 1st box
+    MeasureToolMesh::Entity node2 = mesh2;
+    node2.type = MeasureToolMesh::Entity::Type::Node;
+    node2.index = 1;
+    const MeasureDistance distNode = MeasureToolMesh::meshMinDistance(node2, mesh1);
+    QVERIFY(distNode.pnt2.IsEqual(gp_Pnt{11, 2, 3}, 1e-9));
+    QVERIFY(std::abs(double(UnitSystem::millimeters(distNode.value)) - std::sqrt(89. * 89. + 4 + 9)) < 1e-9);
+
+    // Centers of area
+    const MeasureDistance distCenter = MeasureToolMesh::meshCenterDistance(mesh1, mesh2);
+    QVERIFY(distCenter.pnt1.IsEqual(gp_Pnt{6, 12, 18}, 1e-9));
+    QVERIFY(distCenter.pnt2.IsEqual(gp_Pnt{90, 5, 15}, 1e-9));
+}
+
+void TestMeasure::MeasureCache_test()
+{
+    const TopoDS_Shape box = BRepPrimAPI_MakeBox(10, 20, 30);
+    const OccHandle<Poly_Triangulation> mesh = makeBoxTriangulation(10, 20, 30);
+    auto cache = std::make_shared<MeasureCache>();
+    QVERIFY(!cache->findMassProperties(box));
+    QVERIFY(!cache->findMeshBvh(mesh));
+
+    // Results are shared by the tools created with the same cache, a mesh hierarchy added
+    // concurrently by another measure is kept
+    cache->addMassProperties(box, MassProperties::compute(box));
+    auto bvh = std::make_shared<MeshBvh>(mesh);
+    QCOMPARE(cache->addMeshBvh(mesh, bvh), MeasureCache::MeshBvhPtr(bvh));
+    QCOMPARE(cache->addMeshBvh(mesh, std::make_shared<MeshBvh>(mesh)), MeasureCache::MeshBvhPtr(bvh));
+    QVERIFY(cache->findMassProperties(box));
+    QCOMPARE(cache->findMeshBvh(mesh), MeasureCache::MeshBvhPtr(bvh));
+    cache->bndBoxCache().get(box);
+    QCOMPARE(cache->bndBoxCache().size(), 1);
+
+    // Cached products are released on clear
+    cache->clear();
+    QVERIFY(!cache->findMassProperties(box));
+    QVERIFY(!cache->findMeshBvh(mesh));
+    QCOMPARE(cache->bndBoxCache().size(), 0);
+}
+
 } // namespace Mayo
@@ -37,6 +37,13 @@ private slots:
 
     void BRepBoundingBox_Sphere_test();
     void BRepBoundingBox_NullShape_test();
+
+    void BRepMassProperties_Box_test();
+
+    void MeshMeasure_Box_test();
+    void MeshMinDistance_TwoBoxes_test();
+
+    void MeasureCache_test();
 };
 
 } // namespace Mayo